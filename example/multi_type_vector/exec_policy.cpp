@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <execution>
+#include <functional>
 #include <random>
 
 /**
@@ -106,6 +107,26 @@ int main() try
     bool identical = store == cloned;
     std::cout << "identical? " << std::boolalpha << identical << std::endl;
 
+    //!code-start: parallel-reduce-blocks
+    // Add up the buffer sizes of all stored streams, with the blocks
+    // visited concurrently.
+    std::size_t total = store.parallel_reduce_blocks(
+        std::execution::par, std::size_t(0),
+        [](mdds::mtv::element_t type, std::size_t /*position*/, std::size_t /*size*/,
+           const mdds::mtv::base_element_block* data) {
+            std::size_t bytes = 0;
+            if (type == stream_store_id)
+            {
+                for (const stream_store* p : stream_store_block_type::get(*data).store())
+                    bytes += p->get_buffer().size();
+            }
+            return bytes;
+        },
+        std::plus<std::size_t>{});
+    //!code-end: parallel-reduce-blocks
+
+    std::cout << "total buffer size: " << total << std::endl;
+
     return EXIT_SUCCESS;
 }
 catch (const std::exception&)
@@ -7,6 +7,10 @@
 #pragma once
 
 #include "../../global.hpp"
+#include "../env.hpp"
+#include "../find.hpp"
+#include "../permute.hpp"
+#include "../reduce.hpp"
 #include "../types.hpp"
 #include "../util.hpp"
 #include "./iterator.hpp"
@@ -16,6 +20,9 @@
 #include <iostream>
 #endif
 
+#include <iosfwd>
+#include <span>
+
 namespace mdds { namespace mtv { namespace aos {
 
 /**
@@ -369,6 +376,64 @@ public:
      */
     multi_type_vector clone() const;
 
+#if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+    /**
+     * Save the content of this container to a binary stream.  Only the
+     * standard element types are supported.
+     *
+     * <p>The state consists of a header, followed by a table that stores
+     * the element type, size and payload size of each block, followed by
+     * the payloads of the non-empty blocks in the same order.  Each payload
+     * starts at an 8-byte boundary relative to the top of the state.  The
+     * numeric values are stored as a contiguous array in the native byte
+     * order, the boolean values as one byte per value, and each string as
+     * its length in 8 bytes followed by its characters.</p>
+     *
+     * @param os output stream to write the state to.
+     *
+     * @exception mdds::mtv::element_block_error the container stores an
+     *                element type that is not one of the standard element
+     *                types.
+     */
+    void save_state(std::ostream& os) const;
+
+    /**
+     * Replace the content of this container with the state previously
+     * written by save_state().  The numeric values of each block get read
+     * in bulk as a single array rather than one value at a time.
+     *
+     * <p>Should the state be invalid, this container is left unchanged.</p>
+     *
+     * @param is input stream to load the state from.
+     *
+     * @exception mdds::invalid_arg_error the state is invalid, truncated,
+     *                or has been written on a platform of a different byte
+     *                order.
+     * @exception mdds::mtv::element_block_error the state stores an element
+     *                type that is not supported by this container.
+     */
+    void load_state(std::istream& is);
+
+    /**
+     * Replace the content of this container with the state previously
+     * written by save_state(), stored in a memory buffer such as a
+     * memory-mapped file.  The values of each numeric block get copied out
+     * of the buffer as a single array, and the buffer is no longer
+     * referenced once this call returns.
+     *
+     * <p>Should the state be invalid, this container is left unchanged.</p>
+     *
+     * @param buffer buffer that stores the state.
+     *
+     * @exception mdds::invalid_arg_error the state is invalid, truncated,
+     *                or has been written on a platform of a different byte
+     *                order.
+     * @exception mdds::mtv::element_block_error the state stores an element
+     *                type that is not supported by this container.
+     */
+    void load_state(std::span<const char> buffer);
+#endif
+
     /**
      * Set a value of an arbitrary type to a specified position.  The type of
      * the value is inferred from the value passed to this method.  The new
@@ -487,6 +552,30 @@ public:
     template<typename T>
     iterator set(const iterator& pos_hint, size_type pos, const T& it_begin, const T& it_end);
 
+    /**
+     * Set multiple values of identical type to scattered positions in one
+     * call.  The result is the same as calling set() for each pair of
+     * position and value.  In this storage variant, the values get set one
+     * at a time, with the block of each set value used as the position hint
+     * for the next one.
+     *
+     * <p>The positions must be sorted in strictly ascending order.  The
+     * method will throw an <code>mdds::invalid_arg_error</code> exception if
+     * they are not, or an <code>std::out_of_range</code> exception if any of
+     * the positions is outside the current container range.</p>
+     *
+     * <p>Calling this method will not change the size of the container.</p>
+     *
+     * @param values span of pairs of position and value, where the position
+     *               is stored in the <code>first</code> member and the value
+     *               in the <code>second</code> member.
+     * @return iterator position pointing to the block where the first value
+     *         is set.  When no value is set because the span is empty, the
+     *         end iterator position is returned.
+     */
+    template<typename T, std::size_t Extent>
+    iterator set_batch(std::span<T, Extent> values);
+
     /**
      * Append a new value to the end of the container.
      *
@@ -535,6 +624,43 @@ public:
     template<typename T, typename... Args>
     iterator emplace_back(Args&&... args);
 
+    /**
+     * Append multiple values of identical type to the end of the container.
+     *
+     * When the last block is of the same type as the new values, the values
+     * get appended directly to the storage of that block, with a single
+     * reallocation at most.  Otherwise a new block is created to store all
+     * the new values.  The values are copied into the destination storage
+     * without any intermediate buffering.
+     *
+     * @param it_begin iterator that points to the beginning of the range of
+     *                 values to append.
+     * @param it_end iterator that points to the end-position of the range of
+     *               values to append.
+     *
+     * @return iterator position pointing to the block where the values are
+     *         appended, which in this case is always the last block of the
+     *         container.  When no value insertion occurs because the value
+     *         set is empty, the end iterator position is returned.
+     */
+    template<typename T>
+    iterator append_range(const T& it_begin, const T& it_end);
+
+    /**
+     * Append multiple values of identical type to the end of the container.
+     * This is equivalent of calling append_range() with the begin and end
+     * iterators of the span.
+     *
+     * @param values span of values to append.
+     *
+     * @return iterator position pointing to the block where the values are
+     *         appended, which in this case is always the last block of the
+     *         container.  When no value insertion occurs because the span is
+     *         empty, the end iterator position is returned.
+     */
+    template<typename T, std::size_t Extent>
+    iterator append(std::span<T, Extent> values);
+
     /**
      * Insert multiple values of identical type to a specified position.
      * Existing values that occur at or below the specified position will get
@@ -865,6 +991,99 @@ public:
     iterator transfer(
         const iterator& pos_hint, size_type start_pos, size_type end_pos, multi_type_vector& dest, size_type dest_pos);
 
+    /**
+     * Reduce the values of a specific element block type stored in a range
+     * of positions into a single value.  Elements of any other type in the
+     * range, including empty elements, are skipped one whole block at a
+     * time.  The values of each block are processed directly on the
+     * underlying storage of the block, using SIMD instructions where
+     * available.
+     *
+     * Note that the order in which the values get added may differ from the
+     * order in which they are stored, which may cause the result of a
+     * floating-point sum to differ slightly from that of a sequential sum.
+     * The result of the min and max operations is NaN when any of the
+     * floating-point values is NaN, as with the sum operation.
+     *
+     * @tparam Blk element block type to reduce the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param op operation to perform.  It must be one of the types defined
+     *           in the mdds::mtv::reduce_op namespace.
+     *
+     * @return result of the operation.  Refer to the documentation of each
+     *         operation type for its result type.
+     */
+    template<typename Blk, typename Op>
+    typename mdds::mtv::detail::reduce_state<Blk, Op>::result_type reduce(
+        size_type start_pos, size_type end_pos, Op op) const
+        requires(std::is_arithmetic_v<typename Blk::value_type> || std::is_same_v<Op, reduce_op::count>);
+
+    /**
+     * Find the first value equal to the specified value among the values of
+     * a specific element block type stored in a range of positions.  Blocks
+     * of any other type, including empty blocks, are skipped as a whole.
+     * The values of each block are searched directly on the underlying
+     * storage of the block, using memchr for single-byte integral values,
+     * SIMD compares for double and 32-bit integral values where available,
+     * and word-level searches for boolean values stored in bit_vector.
+     *
+     * @tparam Blk element block type to search the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param value value to search for.
+     *
+     * @return position object that references the first matching value, or
+     *         that references the end position when no value matches.
+     */
+    template<typename Blk>
+    const_position_type find_first(
+        size_type start_pos, size_type end_pos, const typename Blk::value_type& value) const;
+
+    /**
+     * Find the first value that satisfies a predicate among the values of a
+     * specific element block type stored in a range of positions.  Blocks of
+     * any other type, including empty blocks, are skipped as a whole.  For
+     * boolean values stored in bit_vector, the predicate gets evaluated
+     * once for each of the two values, and the values get searched a word
+     * at a time.
+     *
+     * @tparam Blk element block type to search the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param pred predicate that takes a value of the block type and returns
+     *             true when the value matches.  The same predicate instance
+     *             gets applied to the values in their stored order.
+     *
+     * @return position object that references the first matching value, or
+     *         that references the end position when no value matches.
+     */
+    template<typename Blk, typename Pred>
+    const_position_type find_if(size_type start_pos, size_type end_pos, Pred pred) const;
+
+    /**
+     * Count the values that satisfy a predicate among the values of a
+     * specific element block type stored in a range of positions.  Blocks of
+     * any other type, including empty blocks, are skipped as a whole.  For
+     * boolean values stored in bit_vector, the predicate gets evaluated
+     * once for each of the two values, and the values get counted a word at
+     * a time.
+     *
+     * @tparam Blk element block type to count the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param pred predicate that takes a value of the block type and returns
+     *             true when the value matches.
+     *
+     * @return number of the matching values.
+     */
+    template<typename Blk, typename Pred>
+    size_type count_if(size_type start_pos, size_type end_pos, Pred pred) const;
+
     /**
      * Get the type of an element at specified position.
      *
@@ -1071,11 +1290,72 @@ public:
      */
     void swap(size_type start_pos, size_type end_pos, multi_type_vector& other, size_type other_pos);
 
+    /**
+     * Reorder the elements of the container by a permutation of their
+     * positions.  After the call, the element at each position is the one
+     * that was previously at the position stored at the same index of the
+     * permutation.  This is meant for applying the result of sorting the
+     * rows of a table to each of its columns.
+     *
+     * <p>The block store gets rebuilt in a single pass, by gathering the
+     * values into new blocks in the order of the permutation.  Adjacent
+     * elements of the same type end up in the same block, and runs of
+     * elements that keep their relative order get copied in bulk.  This
+     * avoids the fragmentation of the blocks that results from setting the
+     * elements one at a time.  Managed elements get moved to the new blocks
+     * without being copied.</p>
+     *
+     * <p>The method throws an mdds::invalid_arg_error exception if the size
+     * of the permutation differs from the size of the container, or if any
+     * position appears in it more than once, and an
+     * <code>std::out_of_range</code> exception if any position in it is out
+     * of bound.  The container remains unchanged in either case.</p>
+     *
+     * @param perm permutation of the positions of the container.
+     */
+    void apply_permutation(std::span<const size_type> perm);
+
     /**
      * Trim excess capacity from all non-empty blocks.
      */
     void shrink_to_fit();
 
+    /**
+     * Report the amount of memory used by this container, broken down by
+     * the element types of the blocks, and the memory used by the block
+     * store.  The reported slack and front offset amounts indicate how much
+     * memory shrink_to_fit() may reclaim.
+     *
+     * @return memory usage of this container in bytes.
+     */
+    memory_usage_stats memory_usage() const;
+
+    /**
+     * Reclaim the memory occupied by the values that have been erased from
+     * the front of the element block stores but not yet released, such as
+     * the values erased from the front of delayed_delete_vector.  Unlike
+     * shrink_to_fit(), this does not release the excess capacity of the
+     * stores, but makes the reclaimed memory available for new values.
+     *
+     * @return number of the compacted blocks and the amount of the reclaimed
+     *         memory.
+     */
+    compaction_stats compact();
+
+    /**
+     * Same as above, except that it only compacts the blocks that overlap
+     * with the specified range of positions.  Call this repeatedly with
+     * successive ranges to spread the work of compacting a large container
+     * over time.
+     *
+     * @param start_pos position of the first element of the range.
+     * @param end_pos position of the last element of the range, inclusive.
+     *
+     * @return number of the compacted blocks and the amount of the reclaimed
+     *         memory.
+     */
+    compaction_stats compact(size_type start_pos, size_type end_pos);
+
     bool operator==(const multi_type_vector& other) const;
 
     multi_type_vector& operator=(const multi_type_vector& other);
@@ -1098,6 +1378,11 @@ public:
 #endif
 
 private:
+#if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+    template<typename Reader>
+    void load_state_impl(Reader& reader);
+#endif
+
     /**
      * Delete only the element block owned by an outer block.
      *
@@ -1127,6 +1412,9 @@ private:
     template<typename T, typename... Args>
     iterator emplace_back_impl(Args&&... args);
 
+    template<typename T>
+    iterator append_range_impl(const T& it_begin, const T& it_end);
+
     /**
      * Find the correct block position for a given logical row ID.
      *
@@ -1144,6 +1432,24 @@ private:
      */
     size_type get_block_position(const typename value_type::private_data& pos_data, size_type row) const;
 
+    /**
+     * Search the values of a specific element block type stored in a range
+     * of positions one block at a time, and stop at the first block that
+     * contains a match.
+     *
+     * @param method_name name of the calling method, used in the error
+     *                    message when the range is invalid.
+     * @param find_block function that takes an element block, the offset of
+     *                   the first value to search within the block and the
+     *                   number of the values to search, and returns the
+     *                   offset of the first match from the first value
+     *                   searched, or the number of the values searched when
+     *                   there is no match.
+     */
+    template<typename Blk, typename Func>
+    const_position_type find_in_blocks(
+        const char* method_name, size_type start_pos, size_type end_pos, Func find_block) const;
+
     void resize_impl(size_type new_size);
 
     template<typename T>
@@ -1167,6 +1473,17 @@ private:
     template<typename T>
     void set_cell_to_top_of_data_block(size_type block_index, const T& cell);
 
+    /**
+     * Erase the first value of a non-empty block, and compact its store if
+     * the values erased from its front exceed the threshold set by the
+     * front_offset_compaction_ratio trait.
+     *
+     * @param data element block to erase the first value from.
+     */
+    void erase_first_value(base_element_block& data);
+
+    compaction_stats compact_blocks(size_type block_index1, size_type block_index2);
+
     template<typename T>
     void set_cell_to_bottom_of_data_block(size_type block_index, const T& cell);
 
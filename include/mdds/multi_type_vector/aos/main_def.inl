@@ -7,6 +7,7 @@
 #include "../env.hpp"
 #include "../util.hpp"
 #if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+#include "../serialize.hpp"
 #include "../standard_element_blocks.hpp"
 #endif
 
@@ -345,6 +346,72 @@ auto multi_type_vector<Traits>::clone() const -> multi_type_vector
     return multi_type_vector(mtv::detail::clone_construction_type{}, *this);
 }
 
+#if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+template<typename Traits>
+void multi_type_vector<Traits>::save_state(std::ostream& os) const
+{
+    mtv::detail::write_state(os, m_cur_size, m_blocks.size(), [this](size_type i) {
+        const block& blk = m_blocks[i];
+        return std::pair<size_type, const base_element_block*>(blk.size, blk.data);
+    });
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::load_state(std::istream& is)
+{
+    mtv::detail::istream_state_reader reader(is);
+    load_state_impl(reader);
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::load_state(std::span<const char> buffer)
+{
+    mtv::detail::buffer_state_reader reader(buffer);
+    load_state_impl(reader);
+}
+
+template<typename Traits>
+template<typename Reader>
+void multi_type_vector<Traits>::load_state_impl(Reader& reader)
+{
+    auto loaded = mtv::detail::read_state<block_funcs>(reader);
+
+    blocks_type blocks;
+    size_type cur_size = 0;
+
+    try
+    {
+        blocks.reserve(loaded.size());
+    }
+    catch (...)
+    {
+        for (const auto& blk : loaded)
+            block_funcs::delete_block(blk.data);
+        throw;
+    }
+
+    for (const auto& blk : loaded)
+    {
+        blocks.emplace_back(cur_size, blk.size, blk.data);
+        cur_size += blk.size;
+    }
+
+    clear();
+    m_blocks.swap(blocks);
+    m_cur_size = cur_size;
+
+    for (const block& blk : m_blocks)
+    {
+        if (blk.data)
+            m_hdl_event.element_block_acquired(blk.data);
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    debug_check_full("load_state");
+#endif
+}
+#endif
+
 template<typename Traits>
 template<typename T>
 typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set(size_type pos, const T& value)
@@ -489,8 +556,7 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_impl
             // Append to the previous block.
             blk->size -= 1;
             blk->position += 1;
-            block_funcs::overwrite_values(*blk->data, 0, 1);
-            block_funcs::erase(*blk->data, 0);
+            erase_first_value(*blk->data);
             blk_prev->size += 1;
             mdds_mtv_append_value(*blk_prev->data, value);
             return get_iterator(block_index - 1);
@@ -723,6 +789,80 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::emplace_
     return ret;
 }
 
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append_range(
+    const T& it_begin, const T& it_end)
+{
+    if (it_begin == it_end)
+        return end();
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    auto ret = append_range_impl(it_begin, it_end);
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in append_range" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+
+    return ret;
+}
+
+template<typename Traits>
+template<typename T, std::size_t Extent>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append(std::span<T, Extent> values)
+{
+    return append_range(values.begin(), values.end());
+}
+
+template<typename Traits>
+template<typename T, std::size_t Extent>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_batch(std::span<T, Extent> values)
+{
+    if (values.empty())
+        return end();
+
+    for (std::size_t i = 1; i < values.size(); ++i)
+    {
+        if (values[i - 1].first >= values[i].first)
+        {
+            std::ostringstream os;
+            os << "multi_type_vector::set_batch: positions are not in strictly ascending order (index=" << i
+               << "; previous position=" << values[i - 1].first << "; position=" << values[i].first << ")";
+            throw invalid_arg_error(os.str());
+        }
+    }
+
+    if (values.back().first >= m_cur_size)
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::set_batch", __LINE__, values.back().first, block_size(), size());
+
+    iterator it = set(values.front().first, values.front().second);
+
+    for (auto it_val = std::next(values.begin()); it_val != values.end(); ++it_val)
+        it = set(it, it_val->first, it_val->second);
+
+    // The block where the first value has been set may have been merged with
+    // other blocks since.
+    return position(values.front().first).first;
+}
+
 template<typename Traits>
 template<typename T>
 typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_back_impl(T&& value)
@@ -794,6 +934,45 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::emplace_
     return get_iterator(block_index);
 }
 
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append_range_impl(
+    const T& it_begin, const T& it_end)
+{
+    assert(it_begin != it_end);
+
+    size_type length = std::distance(it_begin, it_end);
+    element_t cat = mdds_mtv_get_element_type(*it_begin);
+
+    block* blk_last = m_blocks.empty() ? nullptr : &m_blocks.back();
+    if (!blk_last || !blk_last->data || cat != get_block_type(*blk_last->data))
+    {
+        // Either there is no block, or the last block is empty or of
+        // different type.  Append a new block to store all the new values.
+        size_type block_index = m_blocks.size();
+
+        std::unique_ptr<base_element_block, element_block_deleter> data(
+            mdds_mtv_create_new_block(*it_begin, it_begin, it_end));
+        if (!data)
+            throw general_error("Failed to create new block.");
+
+        m_blocks.emplace_back(m_cur_size, length, data.get());
+        m_hdl_event.element_block_acquired(data.release());
+        m_cur_size += length;
+
+        return get_iterator(block_index);
+    }
+
+    // Append the new values to the last block.
+    size_type block_index = m_blocks.size() - 1;
+
+    mdds_mtv_append_values(*blk_last->data, *it_begin, it_begin, it_end);
+    blk_last->size += length;
+    m_cur_size += length;
+
+    return get_iterator(block_index);
+}
+
 template<typename Traits>
 typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_back_empty()
 {
@@ -950,6 +1129,39 @@ typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::get_blo
     return get_block_position(row, block_index);
 }
 
+template<typename Traits>
+template<typename Blk, typename Func>
+typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits>::find_in_blocks(
+    const char* method_name, size_type start_pos, size_type end_pos, Func find_block) const
+{
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
+
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            method_name, __LINE__, start_pos, block_size(), size());
+
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(method_name, __LINE__, end_pos, block_size(), size());
+
+    for (size_type i = block_index1; i <= block_index2; ++i)
+    {
+        const block& blk = m_blocks[i];
+        if (!blk.data || get_block_type(*blk.data) != Blk::block_type)
+            continue;
+
+        size_type offset = i == block_index1 ? start_pos - blk.position : 0;
+        size_type end = i == block_index2 ? end_pos - blk.position + 1 : blk.size;
+        size_type found = find_block(*blk.data, offset, end - offset);
+        if (found < end - offset)
+            return const_position_type(get_const_iterator(i), offset + found);
+    }
+
+    return const_position_type(cend(), 0);
+}
+
 template<typename Traits>
 template<typename T>
 void multi_type_vector<Traits>::create_new_block_with_new_cell(base_element_block*& data, T&& cell)
@@ -1528,15 +1740,26 @@ void multi_type_vector<Traits>::set_cell_to_top_of_data_block(size_type block_in
     blk.position += 1;
 
     if (blk.data)
-    {
-        block_funcs::overwrite_values(*blk.data, 0, 1);
-        block_funcs::erase(*blk.data, 0);
-    }
+        erase_first_value(*blk.data);
 
     m_blocks.emplace(m_blocks.begin() + block_index, position, 1);
     create_new_block_with_new_cell(m_blocks[block_index].data, cell);
 }
 
+template<typename Traits>
+void multi_type_vector<Traits>::erase_first_value(base_element_block& data)
+{
+    block_funcs::overwrite_values(data, 0, 1);
+    block_funcs::erase(data, 0);
+
+    if constexpr (Traits::front_offset_compaction_ratio > 0.0)
+    {
+        std::size_t front_offset = block_funcs::front_offset(data);
+        if (front_offset && front_offset > Traits::front_offset_compaction_ratio * block_funcs::size(data))
+            block_funcs::compact(data);
+    }
+}
+
 template<typename Traits>
 template<typename T>
 void multi_type_vector<Traits>::set_cell_to_bottom_of_data_block(size_type block_index, const T& cell)
@@ -1860,6 +2083,99 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::transfer
     return ret;
 }
 
+template<typename Traits>
+template<typename Blk, typename Op>
+typename mdds::mtv::detail::reduce_state<Blk, Op>::result_type multi_type_vector<Traits>::reduce(
+    size_type start_pos, size_type end_pos, Op /*op*/) const
+    requires(std::is_arithmetic_v<typename Blk::value_type> || std::is_same_v<Op, reduce_op::count>)
+{
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
+
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::reduce", __LINE__, start_pos, block_size(), size());
+
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::reduce", __LINE__, end_pos, block_size(), size());
+
+    mdds::mtv::detail::reduce_state<Blk, Op> state;
+
+    for (size_type i = block_index1; i <= block_index2; ++i)
+    {
+        const block& blk = m_blocks[i];
+        if (!blk.data || get_block_type(*blk.data) != Blk::block_type)
+            continue;
+
+        size_type offset = i == block_index1 ? start_pos - blk.position : 0;
+        size_type end = i == block_index2 ? end_pos - blk.position + 1 : blk.size;
+        state.add(*blk.data, offset, end - offset);
+    }
+
+    return state.result();
+}
+
+template<typename Traits>
+template<typename Blk>
+typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits>::find_first(
+    size_type start_pos, size_type end_pos, const typename Blk::value_type& value) const
+{
+    return find_in_blocks<Blk>(
+        "multi_type_vector::find_first", start_pos, end_pos,
+        [&value](const base_element_block& data, size_type offset, size_type len) {
+            return mdds::mtv::detail::find_block_value<Blk>(data, offset, len, value);
+        });
+}
+
+template<typename Traits>
+template<typename Blk, typename Pred>
+typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits>::find_if(
+    size_type start_pos, size_type end_pos, Pred pred) const
+{
+    return find_in_blocks<Blk>(
+        "multi_type_vector::find_if", start_pos, end_pos,
+        [&pred](const base_element_block& data, size_type offset, size_type len) {
+            return mdds::mtv::detail::find_block_value_if<Blk>(data, offset, len, pred);
+        });
+}
+
+template<typename Traits>
+template<typename Blk, typename Pred>
+typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::count_if(
+    size_type start_pos, size_type end_pos, Pred pred) const
+{
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
+
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::count_if", __LINE__, start_pos, block_size(), size());
+
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::count_if", __LINE__, end_pos, block_size(), size());
+
+    size_type count = 0;
+
+    for (size_type i = block_index1; i <= block_index2; ++i)
+    {
+        const block& blk = m_blocks[i];
+        if (!blk.data || get_block_type(*blk.data) != Blk::block_type)
+            continue;
+
+        size_type offset = i == block_index1 ? start_pos - blk.position : 0;
+        size_type end = i == block_index2 ? end_pos - blk.position + 1 : blk.size;
+        count += mdds::mtv::detail::count_block_values_if<Blk>(*blk.data, offset, end - offset, pred);
+    }
+
+    return count;
+}
+
 template<typename Traits>
 mtv::element_t multi_type_vector<Traits>::get_type(size_type pos) const
 {
@@ -4090,6 +4406,7 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cell
             {
                 // Erase the upper part of block 2.
                 size_type size_to_erase = end_row - start_row_in_block2 + 1;
+                block_funcs::overwrite_values(*blk2->data, 0, size_to_erase);
                 block_funcs::erase(*blk2->data, 0, size_to_erase);
                 blk2->size -= size_to_erase;
                 blk2->position += size_to_erase;
@@ -4360,7 +4677,7 @@ void multi_type_vector<Traits>::resize_impl(size_type new_size)
         size_type new_block_size = new_end_row - start_row_in_block + 1;
         if (blk->data)
         {
-            block_funcs::overwrite_values(*blk->data, new_end_row + 1, end_row_in_block - new_end_row);
+            block_funcs::overwrite_values(*blk->data, new_block_size, end_row_in_block - new_end_row);
             block_funcs::resize_block(*blk->data, new_block_size);
         }
         blk->size = new_block_size;
@@ -4381,6 +4698,51 @@ void multi_type_vector<Traits>::swap(multi_type_vector& other) noexcept(nothrow_
     m_blocks.swap(other.m_blocks);
 }
 
+template<typename Traits>
+void multi_type_vector<Traits>::apply_permutation(std::span<const size_type> perm)
+{
+    mdds::mtv::detail::check_permutation("multi_type_vector::apply_permutation", perm, m_cur_size);
+
+    std::vector<base_element_block*> src_blocks;
+    std::vector<size_type> src_sizes;
+    src_blocks.reserve(m_blocks.size());
+    src_sizes.reserve(m_blocks.size());
+
+    for (const block& blk : m_blocks)
+    {
+        src_blocks.push_back(blk.data);
+        src_sizes.push_back(blk.size);
+    }
+
+    auto new_blocks = mdds::mtv::detail::gather_permuted_blocks<block_funcs, size_type>(
+        perm, src_blocks, src_sizes, [](element_t cat) { return block_funcs::create_new_block(cat, 0); });
+
+    // The new blocks have taken over the values of the current blocks.
+    for (block& blk : m_blocks)
+    {
+        if (blk.data)
+            block_funcs::resize_block(*blk.data, 0); // prevent double-delete.
+    }
+
+    delete_element_blocks(m_blocks.begin(), m_blocks.end());
+    m_blocks.clear();
+    m_blocks.reserve(new_blocks.size());
+
+    size_type pos = 0;
+    for (const auto& blk : new_blocks)
+    {
+        m_blocks.emplace_back(pos, blk.size, blk.data);
+        if (blk.data)
+            m_hdl_event.element_block_acquired(blk.data);
+
+        pos += blk.size;
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    check_block_integrity();
+#endif
+}
+
 template<typename Traits>
 void multi_type_vector<Traits>::swap(
     size_type start_pos, size_type end_pos, multi_type_vector& other, size_type other_pos)
@@ -4461,6 +4823,73 @@ void multi_type_vector<Traits>::shrink_to_fit()
     }
 }
 
+template<typename Traits>
+memory_usage_stats multi_type_vector<Traits>::memory_usage() const
+{
+    memory_usage_stats stats;
+
+    for (const block& blk : m_blocks)
+    {
+        if (blk.data)
+            stats.element_blocks[get_block_type(*blk.data)] += block_funcs::memory_usage(*blk.data);
+    }
+
+    stats.block_store_bytes = m_blocks.size() * sizeof(block);
+    stats.block_store_slack_bytes = (m_blocks.capacity() - m_blocks.size()) * sizeof(block);
+
+    return stats;
+}
+
+template<typename Traits>
+compaction_stats multi_type_vector<Traits>::compact()
+{
+    if (m_blocks.empty())
+        return compaction_stats();
+
+    return compact_blocks(0, m_blocks.size() - 1);
+}
+
+template<typename Traits>
+compaction_stats multi_type_vector<Traits>::compact(size_type start_pos, size_type end_pos)
+{
+    if (start_pos > end_pos)
+        throw std::out_of_range("multi_type_vector::compact: start position is larger than the end position!");
+
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::compact", __LINE__, start_pos, block_size(), size());
+
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_blocks.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::compact", __LINE__, end_pos, block_size(), size());
+
+    return compact_blocks(block_index1, block_index2);
+}
+
+template<typename Traits>
+compaction_stats multi_type_vector<Traits>::compact_blocks(size_type block_index1, size_type block_index2)
+{
+    compaction_stats stats;
+
+    for (size_type i = block_index1; i <= block_index2; ++i)
+    {
+        base_element_block* data = m_blocks[i].data;
+        if (!data)
+            continue;
+
+        std::size_t bytes = block_funcs::compact(*data);
+        if (bytes)
+        {
+            ++stats.compacted_blocks;
+            stats.reclaimed_bytes += bytes;
+        }
+    }
+
+    return stats;
+}
+
 template<typename Traits>
 bool multi_type_vector<Traits>::operator==(const multi_type_vector& other) const
 {
@@ -0,0 +1,703 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "./types_util.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdds { namespace mtv {
+
+/**
+ * Vector of boolean values packed into 64-bit words.  Unlike
+ * std::vector<bool>, whose range operations process one value at a time,
+ * filling, copying, inserting and erasing ranges of values, as well as
+ * counting the true values, operate on whole words.  This includes
+ * appending the values of another bit_vector, which is how the values move
+ * between element blocks when they get merged or split.
+ *
+ * Like std::vector<bool>, the non-const iterators and the non-const
+ * subscript operator return a proxy object that modifies the stored values
+ * via assignment, and the const ones return the values by value.  The bits
+ * past the last value in the last word are always zero, so that the words
+ * can be processed as a whole.
+ *
+ * @tparam T element type.  It must be bool.
+ * @tparam Allocator allocator type, rebound to allocate the words.
+ */
+template<typename T = bool, typename Allocator = std::allocator<T>>
+class bit_vector
+{
+    static_assert(std::is_same_v<T, bool>, "bit_vector only stores bool values.");
+
+public:
+    using word_type = std::uint64_t;
+
+private:
+    using word_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<word_type>;
+    using words_type = std::vector<word_type, word_allocator>;
+
+    static constexpr std::size_t word_bits = 64;
+
+    template<bool Const>
+    class iterator_base;
+
+    template<typename It>
+    static constexpr bool is_own_iterator_v =
+        std::is_same_v<It, iterator_base<true>> || std::is_same_v<It, iterator_base<false>>;
+
+public:
+    class reference;
+
+    typedef bool value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef bool const_reference;
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /**
+     * Proxy object that references a value by its position.  Assigning a
+     * value to it modifies the referenced value.
+     */
+    class reference
+    {
+        friend class bit_vector;
+
+        bit_vector* m_parent;
+        size_type m_pos;
+
+        reference(bit_vector* parent, size_type pos) noexcept : m_parent(parent), m_pos(pos)
+        {}
+
+    public:
+        reference(const reference&) = default;
+
+        operator bool() const noexcept
+        {
+            return std::as_const(*m_parent)[m_pos];
+        }
+
+        reference& operator=(bool value) noexcept
+        {
+            m_parent->set(m_pos, value);
+            return *this;
+        }
+
+        reference& operator=(const reference& other) noexcept
+        {
+            return *this = bool(other);
+        }
+    };
+
+private:
+    template<bool Const>
+    class iterator_base
+    {
+        friend class bit_vector;
+        friend class iterator_base<!Const>;
+
+        using parent_type = std::conditional_t<Const, const bit_vector, bit_vector>;
+
+        parent_type* m_parent = nullptr;
+        size_type m_pos = 0;
+
+        iterator_base(parent_type* parent, size_type pos) noexcept : m_parent(parent), m_pos(pos)
+        {}
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::conditional_t<Const, bool, typename bit_vector::reference>;
+
+        iterator_base() = default;
+
+        template<bool C = Const>
+        requires C
+        iterator_base(const iterator_base<false>& other) noexcept : m_parent(other.m_parent), m_pos(other.m_pos)
+        {}
+
+        reference operator*() const noexcept
+        {
+            if constexpr (Const)
+                return (*m_parent)[m_pos];
+            else
+                return reference(m_parent, m_pos);
+        }
+
+        reference operator[](difference_type n) const noexcept
+        {
+            return *(*this + n);
+        }
+
+        iterator_base& operator++() noexcept
+        {
+            ++m_pos;
+            return *this;
+        }
+
+        iterator_base operator++(int) noexcept
+        {
+            iterator_base tmp = *this;
+            ++m_pos;
+            return tmp;
+        }
+
+        iterator_base& operator--() noexcept
+        {
+            --m_pos;
+            return *this;
+        }
+
+        iterator_base operator--(int) noexcept
+        {
+            iterator_base tmp = *this;
+            --m_pos;
+            return tmp;
+        }
+
+        iterator_base& operator+=(difference_type n) noexcept
+        {
+            m_pos += n;
+            return *this;
+        }
+
+        iterator_base& operator-=(difference_type n) noexcept
+        {
+            m_pos -= n;
+            return *this;
+        }
+
+        friend iterator_base operator+(iterator_base it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator+(difference_type n, iterator_base it) noexcept
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator-(iterator_base it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return difference_type(left.m_pos) - difference_type(right.m_pos);
+        }
+
+        friend bool operator==(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return left.m_pos == right.m_pos;
+        }
+
+        friend std::strong_ordering operator<=>(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return left.m_pos <=> right.m_pos;
+        }
+    };
+
+public:
+    bit_vector() noexcept(std::is_nothrow_default_constructible_v<words_type>) = default;
+
+    bit_vector(size_type n) : bit_vector(n, false)
+    {}
+
+    bit_vector(size_type n, bool val)
+    {
+        resize(n, val);
+    }
+
+    template<std::input_iterator InputIt>
+    bit_vector(InputIt first, InputIt last)
+    {
+        assign(first, last);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, m_size);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, m_size);
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    reference operator[](size_type pos) noexcept
+    {
+        return reference(this, pos);
+    }
+
+    const_reference operator[](size_type pos) const noexcept
+    {
+        return (m_words[pos / word_bits] >> (pos % word_bits)) & 1u;
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= m_size)
+            throw std::out_of_range("bit_vector::at: position is out of range.");
+
+        return reference(this, pos);
+    }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= m_size)
+            throw std::out_of_range("bit_vector::at: position is out of range.");
+
+        return (*this)[pos];
+    }
+
+    void push_back(bool value)
+    {
+        if (m_size % word_bits == 0)
+            m_words.push_back(0);
+
+        ++m_size;
+        set(m_size - 1, value);
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        push_back(bool(std::forward<Args>(args)...));
+        return reference(this, m_size - 1);
+    }
+
+    void pop_back()
+    {
+        resize(m_size - 1);
+    }
+
+    void swap(bit_vector& other) noexcept
+    {
+        m_words.swap(other.m_words);
+        std::swap(m_size, other.m_size);
+    }
+
+    iterator insert(const_iterator pos, bool value)
+    {
+        open_gap(pos.m_pos, 1);
+        set(pos.m_pos, value);
+        return iterator(this, pos.m_pos);
+    }
+
+    template<std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        // Pack the new values first, as they may come from this instance.
+        bit_vector values = pack(first, last);
+        open_gap(pos.m_pos, values.m_size);
+        copy_bits(m_words.data(), pos.m_pos, values.m_words.data(), 0, values.m_size);
+        return iterator(this, pos.m_pos);
+    }
+
+    /**
+     * Overwrite a range of values starting at the specified position.  The
+     * range must not extend past the end of the vector.
+     *
+     * @param pos position of the first value to overwrite.
+     * @param first iterator pointing to the first of the new values.
+     * @param last iterator pointing to the end position of the new values.
+     */
+    template<std::input_iterator InputIt>
+    void replace(size_type pos, InputIt first, InputIt last)
+    {
+        if constexpr (is_own_iterator_v<InputIt>)
+        {
+            if (first.m_parent != this)
+            {
+                copy_bits(m_words.data(), pos, first.m_parent->m_words.data(), first.m_pos, last.m_pos - first.m_pos);
+                return;
+            }
+        }
+
+        bit_vector values = pack(first, last);
+        copy_bits(m_words.data(), pos, values.m_words.data(), 0, values.m_size);
+    }
+
+    /**
+     * Set a range of values to the same value.  The range must not extend
+     * past the end of the vector.
+     *
+     * @param pos position of the first value to set.
+     * @param len number of values to set.
+     * @param value value to set.
+     */
+    void set(size_type pos, size_type len, bool value) noexcept
+    {
+        word_type bits = value ? ~word_type(0) : 0;
+
+        for (size_type n = 0; n < len; n += word_bits)
+            put_bits(m_words.data(), pos + n, std::min(word_bits, len - n), bits);
+    }
+
+    void resize(size_type count)
+    {
+        resize(count, false);
+    }
+
+    void resize(size_type count, bool value)
+    {
+        size_type cur_size = m_size;
+        m_words.resize(words_for(count), 0);
+        m_size = count;
+
+        if (count > cur_size)
+            set(cur_size, count - cur_size, value);
+        else
+            clear_tail();
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        size_type len = last.m_pos - first.m_pos;
+        copy_bits(m_words.data(), first.m_pos, m_words.data(), last.m_pos, m_size - last.m_pos);
+        resize(m_size - len);
+        return iterator(this, first.m_pos);
+    }
+
+    void clear() noexcept
+    {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    /**
+     * Get the number of values the vector can hold without allocating
+     * more memory.
+     */
+    size_type capacity() const noexcept
+    {
+        return m_words.capacity() * word_bits;
+    }
+
+    void reserve(size_type new_cap)
+    {
+        m_words.reserve(words_for(new_cap));
+    }
+
+    void shrink_to_fit()
+    {
+        m_words.shrink_to_fit();
+    }
+
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        bit_vector values = pack(first, last);
+        swap(values);
+    }
+
+    /**
+     * Count the number of true values.
+     */
+    size_type count() const noexcept
+    {
+        size_type n = 0;
+        for (word_type word : m_words)
+            n += std::popcount(word);
+
+        return n;
+    }
+
+    /**
+     * Count the number of true values in a range.  The range must not
+     * extend past the end of the vector.
+     *
+     * @param pos position of the first value in the range.
+     * @param len length of the range.
+     */
+    size_type count(size_type pos, size_type len) const noexcept
+    {
+        size_type n = 0;
+        for (size_type i = 0; i < len; i += word_bits)
+            n += std::popcount(get_bits(m_words.data(), pos + i, std::min(word_bits, len - i)));
+
+        return n;
+    }
+
+    /**
+     * Find the first occurrence of a value in a range, a word at a time.
+     * The range must not extend past the end of the vector.
+     *
+     * @param value value to search for.
+     * @param pos position of the first value in the range.
+     * @param len length of the range.
+     *
+     * @return offset of the first occurrence from the start of the range, or
+     *         the length of the range when the value is not found.
+     */
+    size_type find(bool value, size_type pos, size_type len) const noexcept
+    {
+        for (size_type i = 0; i < len; i += word_bits)
+        {
+            size_type n = std::min(word_bits, len - i);
+            word_type bits = get_bits(m_words.data(), pos + i, n);
+            if (!value)
+                bits = ~bits & low_mask(n);
+
+            if (bits)
+                return i + std::countr_zero(bits);
+        }
+
+        return len;
+    }
+
+    /**
+     * Invoke a function on the position of each true value, in ascending
+     * order.  Words that only contain false values get skipped as a whole.
+     *
+     * @param func function that takes the position of a true value as its
+     *             only argument.
+     */
+    template<typename Func>
+    void for_each_true(Func func) const
+    {
+        for (size_type i = 0; i < m_words.size(); ++i)
+        {
+            for (word_type word = m_words[i]; word; word &= word - 1)
+                func(i * word_bits + std::countr_zero(word));
+        }
+    }
+
+    /**
+     * Get the words that store the values.  The value at position
+     * <code>pos</code> is stored in bit <code>pos % 64</code> of word
+     * <code>pos / 64</code>, and the bits of the last word that store no
+     * value are zero.
+     *
+     * @return span of the words.
+     */
+    std::span<const word_type> words() const noexcept
+    {
+        return m_words;
+    }
+
+    /**
+     * Get the number of bytes used to store the values.
+     */
+    size_type value_bytes() const noexcept
+    {
+        return m_words.size() * sizeof(word_type);
+    }
+
+    /**
+     * Get the number of bytes allocated for the values but not in use.
+     */
+    size_type slack_bytes() const noexcept
+    {
+        return (m_words.capacity() - m_words.size()) * sizeof(word_type);
+    }
+
+    bool operator==(const bit_vector& other) const noexcept
+    {
+        return m_size == other.m_size && m_words == other.m_words;
+    }
+
+private:
+    static constexpr size_type words_for(size_type n) noexcept
+    {
+        return (n + word_bits - 1) / word_bits;
+    }
+
+    static constexpr word_type low_mask(size_type n) noexcept
+    {
+        return n >= word_bits ? ~word_type(0) : (word_type(1) << n) - 1;
+    }
+
+    /**
+     * Read up to 64 bits starting at the specified bit position.
+     */
+    static word_type get_bits(const word_type* words, size_type pos, size_type n) noexcept
+    {
+        size_type i = pos / word_bits;
+        size_type offset = pos % word_bits;
+
+        word_type bits = words[i] >> offset;
+        if (offset && offset + n > word_bits)
+            bits |= words[i + 1] << (word_bits - offset);
+
+        return bits & low_mask(n);
+    }
+
+    /**
+     * Overwrite up to 64 bits starting at the specified bit position with
+     * the lowest bits of the specified word.
+     */
+    static void put_bits(word_type* words, size_type pos, size_type n, word_type bits) noexcept
+    {
+        size_type i = pos / word_bits;
+        size_type offset = pos % word_bits;
+        bits &= low_mask(n);
+
+        words[i] = (words[i] & ~(low_mask(n) << offset)) | (bits << offset);
+        if (offset + n > word_bits)
+        {
+            size_type spill = offset + n - word_bits;
+            words[i + 1] = (words[i + 1] & ~low_mask(spill)) | (bits >> (word_bits - offset));
+        }
+    }
+
+    /**
+     * Copy a range of bits a word at a time.  The source and destination
+     * ranges may overlap.
+     */
+    static void copy_bits(
+        word_type* dest, size_type dest_pos, const word_type* src, size_type src_pos, size_type len) noexcept
+    {
+        if (dest == src && dest_pos > src_pos)
+        {
+            // Copy backward so that the bits get read before overwritten.
+            for (size_type n = len; n > 0;)
+            {
+                size_type chunk = std::min(word_bits, n);
+                n -= chunk;
+                put_bits(dest, dest_pos + n, chunk, get_bits(src, src_pos + n, chunk));
+            }
+            return;
+        }
+
+        for (size_type n = 0; n < len; n += word_bits)
+        {
+            size_type chunk = std::min(word_bits, len - n);
+            put_bits(dest, dest_pos + n, chunk, get_bits(src, src_pos + n, chunk));
+        }
+    }
+
+    template<typename InputIt>
+    static bit_vector pack(InputIt first, InputIt last)
+    {
+        bit_vector values;
+
+        if constexpr (is_own_iterator_v<InputIt>)
+        {
+            values.resize(last.m_pos - first.m_pos);
+            copy_bits(values.m_words.data(), 0, first.m_parent->m_words.data(), first.m_pos, values.m_size);
+        }
+        else
+        {
+            for (; first != last; ++first)
+                values.push_back(bool(*first));
+        }
+
+        return values;
+    }
+
+    /**
+     * Insert a range of false values at the specified position, shifting the
+     * values that follow.
+     */
+    void open_gap(size_type pos, size_type len)
+    {
+        if (!len)
+            return;
+
+        size_type tail = m_size - pos;
+        m_words.resize(words_for(m_size + len), 0);
+        m_size += len;
+        copy_bits(m_words.data(), pos + len, m_words.data(), pos, tail);
+        set(pos, len, false);
+    }
+
+    /**
+     * Clear the bits of the last word that store no value.
+     */
+    void clear_tail() noexcept
+    {
+        if (size_type n = m_size % word_bits; n)
+            m_words.back() &= low_mask(n);
+    }
+
+    void set(size_type pos, bool value) noexcept
+    {
+        word_type mask = word_type(1) << (pos % word_bits);
+        word_type& word = m_words[pos / word_bits];
+        word = value ? (word | mask) : (word & ~mask);
+    }
+
+    words_type m_words;
+    size_type m_size = 0;
+};
+
+namespace detail {
+
+template<typename Allocator>
+struct is_std_vector_bool_store<bit_vector<bool, Allocator>>
+{
+    using type = std::true_type;
+};
+
+} // namespace detail
+
+}} // namespace mdds::mtv
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -105,6 +105,15 @@ struct element_block_funcs
         f(block, new_size);
     }
 
+    static void clear_block(base_element_block& block)
+    {
+        static const std::unordered_map<element_t, std::function<void(base_element_block&)>> func_map{
+            {Ts::block_type, Ts::clear_block}...};
+
+        auto& f = detail::find_func(func_map, get_block_type(block), __func__);
+        f(block);
+    }
+
     static void print_block(const base_element_block& block)
     {
         static const std::unordered_map<element_t, std::function<void(const base_element_block&)>> func_map{
@@ -219,6 +228,33 @@ struct element_block_funcs
         f(block);
     }
 
+    static element_block_memory_usage memory_usage(const base_element_block& block)
+    {
+        using func_type = std::function<element_block_memory_usage(const base_element_block&)>;
+        static const std::unordered_map<element_t, func_type> func_map{{Ts::block_type, Ts::memory_usage}...};
+
+        auto& f = detail::find_func(func_map, get_block_type(block), __func__);
+        return f(block);
+    }
+
+    static std::size_t front_offset(const base_element_block& block)
+    {
+        using func_type = std::function<std::size_t(const base_element_block&)>;
+        static const std::unordered_map<element_t, func_type> func_map{{Ts::block_type, Ts::front_offset}...};
+
+        auto& f = detail::find_func(func_map, get_block_type(block), __func__);
+        return f(block);
+    }
+
+    static std::size_t compact(base_element_block& block)
+    {
+        using func_type = std::function<std::size_t(base_element_block&)>;
+        static const std::unordered_map<element_t, func_type> func_map{{Ts::block_type, Ts::compact}...};
+
+        auto& f = detail::find_func(func_map, get_block_type(block), __func__);
+        return f(block);
+    }
+
     static std::size_t size(const base_element_block& block)
     {
         using func_type = std::function<std::size_t(const base_element_block&)>;
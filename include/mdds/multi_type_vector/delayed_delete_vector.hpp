@@ -197,6 +197,29 @@ public:
         m_vec.assign(first, last);
     }
 
+    /**
+     * @return number of the elements that have been erased from the front of
+     *         the vector but whose memory has not been reclaimed yet.
+     */
+    size_type front_offset() const noexcept
+    {
+        return m_front_offset;
+    }
+
+    /**
+     * Reclaim the memory occupied by the elements that have been erased from
+     * the front of the vector, by moving the remaining elements to the front
+     * of the buffer.  The capacity of the vector stays the same.
+     *
+     * @return number of the erased elements whose memory has been reclaimed.
+     */
+    size_type compact()
+    {
+        size_type n = m_front_offset;
+        clear_removed();
+        return n;
+    }
+
     T* data()
     {
         return m_vec.data() + m_front_offset;
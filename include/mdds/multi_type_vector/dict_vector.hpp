@@ -0,0 +1,736 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mdds { namespace mtv {
+
+namespace detail {
+
+template<typename T>
+struct dict_value_traits
+{
+    static constexpr bool is_view = false;
+
+    using owned_type = T;
+    using hasher = std::hash<T>;
+    using key_equal = std::equal_to<T>;
+};
+
+template<typename CharT, typename Traits>
+struct dict_value_traits<std::basic_string_view<CharT, Traits>>
+{
+    static constexpr bool is_view = true;
+
+    using view_type = std::basic_string_view<CharT, Traits>;
+    using owned_type = std::basic_string<CharT, Traits>;
+
+    struct hasher
+    {
+        using is_transparent = void;
+
+        std::size_t operator()(view_type v) const noexcept
+        {
+            return std::hash<view_type>{}(v);
+        }
+    };
+
+    using key_equal = std::equal_to<>;
+};
+
+} // namespace detail
+
+/**
+ * Pool of unique values, each of which is identified by a 32-bit id
+ * assigned in the order of insertion.  Values never get removed from the
+ * pool, so that an id stays valid for as long as the pool exists.
+ *
+ * When the value type is a specialization of std::basic_string_view, the
+ * pool stores its own copies of the strings, and the views it hands out
+ * reference those copies.
+ *
+ * @tparam T value type.  It must be equality-comparable and hashable via
+ *           std::hash.
+ */
+template<typename T>
+class dict_pool
+{
+    using value_traits = detail::dict_value_traits<T>;
+    using owned_type = typename value_traits::owned_type;
+    using index_type =
+        std::unordered_map<owned_type, std::uint32_t, typename value_traits::hasher, typename value_traits::key_equal>;
+
+    // For a view type, each slot stores a view of its key in the index.
+    // Otherwise it points to the key.
+    using slot_type = std::conditional_t<value_traits::is_view, T, const T*>;
+
+public:
+    using value_type = T;
+    using id_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    /** Id returned by find() when the value is not in the pool. */
+    static constexpr id_type npos = std::numeric_limits<id_type>::max();
+
+    dict_pool() = default;
+
+    /**
+     * Copy constructor.  The values keep their ids in the new pool.
+     */
+    dict_pool(const dict_pool& other)
+    {
+        m_index.reserve(other.size());
+        m_values.reserve(other.size());
+
+        for (size_type i = 0; i < other.size(); ++i)
+            intern(other[i]);
+    }
+
+    dict_pool& operator=(const dict_pool&) = delete;
+
+    /**
+     * Add a value to the pool unless the pool already contains it.
+     *
+     * @param value value to add.
+     *
+     * @return id of the value.
+     *
+     * @exception std::length_error The pool already contains the maximum
+     *            number of values.
+     */
+    id_type intern(const T& value)
+    {
+        if (auto it = m_index.find(value); it != m_index.end())
+            return it->second;
+
+        if (m_values.size() >= npos)
+            throw std::length_error("dict_pool::intern: the pool is full.");
+
+        id_type id = m_values.size();
+        auto it = m_index.emplace(owned_type(value), id).first;
+
+        if constexpr (value_traits::is_view)
+            m_values.push_back(T(it->first));
+        else
+            m_values.push_back(&it->first);
+
+        return id;
+    }
+
+    /**
+     * Find the id of a value.
+     *
+     * @param value value to find.
+     *
+     * @return id of the value, or npos if the pool does not contain it.
+     */
+    id_type find(const T& value) const
+    {
+        auto it = m_index.find(value);
+        return it == m_index.end() ? npos : it->second;
+    }
+
+    /**
+     * Get the value associated with an id.
+     *
+     * @param id id of the value.  It must be less than the size of the pool.
+     */
+    const T& operator[](id_type id) const
+    {
+        if constexpr (value_traits::is_view)
+            return m_values[id];
+        else
+            return *m_values[id];
+    }
+
+    /**
+     * @return number of the values in the pool.
+     */
+    size_type size() const noexcept
+    {
+        return m_values.size();
+    }
+
+private:
+    index_type m_index;
+    std::vector<slot_type> m_values;
+};
+
+/**
+ * Vector that stores its values dictionary-encoded, i.e. as 32-bit ids of
+ * the values in a pool of unique values.  When used as the store of an
+ * element block, blocks that contain many repetitions of a limited set of
+ * values, such as categories or units, take 4 bytes per value plus the
+ * space taken by one copy of each distinct value.
+ *
+ * When the element type is std::string_view (or another specialization of
+ * std::basic_string_view), the pool owns the strings, and the values read
+ * from the vector are views of the pooled strings.  Such a view remains
+ * valid for as long as any vector that shares the pool exists.
+ *
+ * The pool is shared between copies of a vector, and with the vectors that
+ * get assigned or inserted values from it, which is how the values move
+ * between element blocks when a block gets split, merged or copied.
+ * Comparing and merging vectors that share the same pool only involves the
+ * ids, whereas merging vectors with different pools maps each distinct id of
+ * the source to an id in the destination pool.  A vector never adds a value
+ * to a pool it shares with another vector; it makes its own copy of the pool
+ * first.  This makes it safe to read a shared pool from other threads while
+ * a vector is being modified, as is the case when the element blocks are
+ * shared via copy-on-write.
+ *
+ * Like std::vector<bool>, the non-const iterators and the non-const
+ * subscript operator return a proxy object that modifies the stored values
+ * via assignment.  The values no longer referenced by the vector remain in
+ * the pool.
+ *
+ * @tparam T element type.  It must be equality-comparable and hashable via
+ *           std::hash.
+ * @tparam Allocator allocator type used for the ids.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class dict_vector
+{
+public:
+    using pool_type = dict_pool<T>;
+    using id_type = typename pool_type::id_type;
+
+private:
+    using id_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<id_type>;
+    using ids_type = std::vector<id_type, id_allocator>;
+
+    template<bool Const>
+    class iterator_base;
+
+    template<typename It>
+    static constexpr bool is_own_iterator_v =
+        std::is_same_v<It, iterator_base<true>> || std::is_same_v<It, iterator_base<false>>;
+
+public:
+    class reference;
+
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T& const_reference;
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /**
+     * Proxy object that references a value by its position.  Assigning a
+     * value to it modifies the referenced value.
+     */
+    class reference
+    {
+        friend class dict_vector;
+
+        dict_vector* m_parent;
+        size_type m_pos;
+
+        reference(dict_vector* parent, size_type pos) noexcept : m_parent(parent), m_pos(pos)
+        {}
+
+    public:
+        reference(const reference&) = default;
+
+        operator const T&() const
+        {
+            return std::as_const(*m_parent)[m_pos];
+        }
+
+        reference& operator=(const T& value)
+        {
+            m_parent->set(m_pos, value);
+            return *this;
+        }
+
+        reference& operator=(const reference& other)
+        {
+            T value = other;
+            m_parent->set(m_pos, value);
+            return *this;
+        }
+
+        friend bool operator==(const reference& lhs, const T& rhs)
+        {
+            return static_cast<const T&>(lhs) == rhs;
+        }
+    };
+
+private:
+    template<bool Const>
+    class iterator_base
+    {
+        friend class dict_vector;
+        friend class iterator_base<!Const>;
+
+        using parent_type = std::conditional_t<Const, const dict_vector, dict_vector>;
+
+        parent_type* m_parent = nullptr;
+        size_type m_pos = 0;
+
+        iterator_base(parent_type* parent, size_type pos) noexcept : m_parent(parent), m_pos(pos)
+        {}
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, void>;
+        using reference = std::conditional_t<Const, const T&, typename dict_vector::reference>;
+
+        iterator_base() = default;
+
+        template<bool C = Const>
+        requires C
+        iterator_base(const iterator_base<false>& other) noexcept : m_parent(other.m_parent), m_pos(other.m_pos)
+        {}
+
+        reference operator*() const
+        {
+            if constexpr (Const)
+                return (*m_parent)[m_pos];
+            else
+                return reference(m_parent, m_pos);
+        }
+
+        pointer operator->() const
+        requires Const
+        {
+            return &(*m_parent)[m_pos];
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        iterator_base& operator++() noexcept
+        {
+            ++m_pos;
+            return *this;
+        }
+
+        iterator_base operator++(int) noexcept
+        {
+            iterator_base tmp = *this;
+            ++m_pos;
+            return tmp;
+        }
+
+        iterator_base& operator--() noexcept
+        {
+            --m_pos;
+            return *this;
+        }
+
+        iterator_base operator--(int) noexcept
+        {
+            iterator_base tmp = *this;
+            --m_pos;
+            return tmp;
+        }
+
+        iterator_base& operator+=(difference_type n) noexcept
+        {
+            m_pos += n;
+            return *this;
+        }
+
+        iterator_base& operator-=(difference_type n) noexcept
+        {
+            m_pos -= n;
+            return *this;
+        }
+
+        friend iterator_base operator+(iterator_base it, difference_type n) noexcept
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator+(difference_type n, iterator_base it) noexcept
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator-(iterator_base it, difference_type n) noexcept
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return difference_type(left.m_pos) - difference_type(right.m_pos);
+        }
+
+        friend bool operator==(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return left.m_pos == right.m_pos;
+        }
+
+        friend std::strong_ordering operator<=>(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return left.m_pos <=> right.m_pos;
+        }
+    };
+
+public:
+    dict_vector() noexcept(std::is_nothrow_default_constructible_v<ids_type>) = default;
+
+    dict_vector(size_type n) : dict_vector(n, T())
+    {}
+
+    dict_vector(size_type n, const T& val)
+    {
+        if (n)
+            m_ids.assign(n, intern(val));
+    }
+
+    template<std::input_iterator InputIt>
+    dict_vector(InputIt first, InputIt last)
+    {
+        assign(first, last);
+    }
+
+    /**
+     * Constructor that makes the vector use the specified pool.  Vectors
+     * constructed with the same pool, such as a pool populated in advance
+     * with all the values of a category, compare and merge via their ids.
+     *
+     * @param pool pool to use.
+     */
+    explicit dict_vector(std::shared_ptr<pool_type> pool) noexcept(std::is_nothrow_default_constructible_v<ids_type>)
+        : m_pool(std::move(pool))
+    {}
+
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, size());
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, size());
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    reference operator[](size_type pos)
+    {
+        return reference(this, pos);
+    }
+
+    const_reference operator[](size_type pos) const
+    {
+        return (*m_pool)[m_ids[pos]];
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range("dict_vector::at: position is out of range.");
+
+        return reference(this, pos);
+    }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("dict_vector::at: position is out of range.");
+
+        return (*this)[pos];
+    }
+
+    void push_back(const T& value)
+    {
+        m_ids.push_back(intern(value));
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        push_back(T(std::forward<Args>(args)...));
+        return reference(this, size() - 1);
+    }
+
+    void pop_back()
+    {
+        m_ids.pop_back();
+    }
+
+    void swap(dict_vector& other) noexcept
+    {
+        m_pool.swap(other.m_pool);
+        m_ids.swap(other.m_ids);
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        m_ids.insert(m_ids.begin() + pos.m_pos, intern(value));
+        return iterator(this, pos.m_pos);
+    }
+
+    template<std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        // Encode the new values first, as they may come from this instance.
+        ids_type ids = encode(first, last, m_ids.empty());
+        m_ids.insert(m_ids.begin() + pos.m_pos, ids.begin(), ids.end());
+        return iterator(this, pos.m_pos);
+    }
+
+    void resize(size_type count)
+    {
+        resize(count, T());
+    }
+
+    void resize(size_type count, const T& value)
+    {
+        if (count <= size())
+            m_ids.resize(count);
+        else
+            m_ids.resize(count, intern(value));
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        m_ids.erase(m_ids.begin() + first.m_pos, m_ids.begin() + last.m_pos);
+        return iterator(this, first.m_pos);
+    }
+
+    void clear() noexcept
+    {
+        m_ids.clear();
+    }
+
+    size_type capacity() const noexcept
+    {
+        return m_ids.capacity();
+    }
+
+    void reserve(size_type new_cap)
+    {
+        m_ids.reserve(new_cap);
+    }
+
+    void shrink_to_fit()
+    {
+        m_ids.shrink_to_fit();
+    }
+
+    size_type size() const noexcept
+    {
+        return m_ids.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_ids.empty();
+    }
+
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        ids_type ids = encode(first, last, true);
+        m_ids.swap(ids);
+    }
+
+    /**
+     * Get the ids of the stored values, in order of position.  Two values
+     * stored in vectors that share the same pool are equal if and only if
+     * they have the same id.
+     *
+     * @return span of the ids.
+     */
+    std::span<const id_type> ids() const noexcept
+    {
+        return m_ids;
+    }
+
+    /**
+     * Get the pool that stores the distinct values.
+     *
+     * @return pointer to the pool, or nullptr if no value has ever been
+     *         stored in this vector.
+     */
+    std::shared_ptr<const pool_type> pool() const noexcept
+    {
+        return m_pool;
+    }
+
+    /**
+     * Get the number of bytes used to store the ids.  The memory used by the
+     * pool is not included, as it may be shared with other vectors.
+     */
+    size_type value_bytes() const noexcept
+    {
+        return m_ids.size() * sizeof(id_type);
+    }
+
+    /**
+     * Get the number of bytes allocated for the ids but not in use.
+     */
+    size_type slack_bytes() const noexcept
+    {
+        return (m_ids.capacity() - m_ids.size()) * sizeof(id_type);
+    }
+
+    bool operator==(const dict_vector& other) const
+    {
+        if (m_pool == other.m_pool)
+            return m_ids == other.m_ids;
+
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    /**
+     * Get the id of a value, adding the value to the pool if necessary.
+     */
+    id_type intern(const T& value)
+    {
+        if (!m_pool)
+        {
+            m_pool = std::make_shared<pool_type>();
+            return m_pool->intern(value);
+        }
+
+        if (m_pool.use_count() > 1)
+        {
+            // The pool is shared with another vector.  Only add the value
+            // to a copy of it.
+            if (id_type id = m_pool->find(value); id != pool_type::npos)
+                return id;
+
+            // Keep the shared pool alive until the value, which may reference
+            // it, has been copied.
+            std::shared_ptr<pool_type> shared = m_pool;
+            m_pool = std::make_shared<pool_type>(*shared);
+            return m_pool->intern(value);
+        }
+
+        return m_pool->intern(value);
+    }
+
+    template<typename InputIt>
+    ids_type encode(InputIt first, InputIt last, bool adopt_pool)
+    {
+        if constexpr (is_own_iterator_v<InputIt>)
+        {
+            return import_ids(*first.m_parent, first.m_pos, last.m_pos, adopt_pool);
+        }
+        else
+        {
+            ids_type ids;
+            for (; first != last; ++first)
+                ids.push_back(intern(*first));
+
+            return ids;
+        }
+    }
+
+    /**
+     * Get the ids of a range of values stored in another vector, mapped to
+     * the pool of this vector.
+     *
+     * @param adopt_pool whether or not this vector may switch to the pool of
+     *                   the source vector, which is the case when it holds
+     *                   no values other than the ones being imported.
+     */
+    ids_type import_ids(const dict_vector& src, size_type first, size_type last, bool adopt_pool)
+    {
+        if (first == last)
+            return ids_type();
+
+        if (adopt_pool)
+            m_pool = src.m_pool;
+
+        auto it_src = src.m_ids.begin();
+
+        if (m_pool == src.m_pool)
+            return ids_type(it_src + first, it_src + last);
+
+        // Add each distinct value of the range to this pool only once.
+        std::vector<id_type> mapped(src.m_pool->size(), pool_type::npos);
+        ids_type ids;
+        ids.reserve(last - first);
+
+        for (auto it = it_src + first, it_end = it_src + last; it != it_end; ++it)
+        {
+            id_type& id = mapped[*it];
+            if (id == pool_type::npos)
+                id = intern((*src.m_pool)[*it]);
+
+            ids.push_back(id);
+        }
+
+        return ids;
+    }
+
+    void set(size_type pos, const T& value)
+    {
+        m_ids[pos] = intern(value);
+    }
+
+    std::shared_ptr<pool_type> m_pool;
+    ids_type m_ids;
+};
+
+}} // namespace mdds::mtv
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -10,4 +10,8 @@
 #define MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS 1
 #endif
 
+#ifndef MDDS_MTV_USE_BIT_VECTOR_BOOLEAN_BLOCK
+#define MDDS_MTV_USE_BIT_VECTOR_BOOLEAN_BLOCK 0
+#endif
+
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
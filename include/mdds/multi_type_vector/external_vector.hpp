@@ -0,0 +1,395 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdds { namespace mtv {
+
+/**
+ * Vector that can reference an array of values stored in memory owned by
+ * someone else, such as a memory-mapped file or a buffer shared with another
+ * library, instead of storing its own copy.  When used as the store of an
+ * element block, the block provides read access to the external values
+ * without copying them.
+ *
+ * The values are only read through the const accessors while the instance
+ * references external memory.  The first call to any non-const method,
+ * including the non-const variants of begin(), data() and the subscript
+ * operator, copies the values into a buffer owned by the instance, after
+ * which it behaves like a regular vector.  The only exceptions are erasing
+ * values from either end and resize() with a size not greater than the
+ * current size, which simply narrow the referenced range.
+ *
+ * Copying an instance that references external memory only copies the
+ * reference.  It is therefore the caller's responsibility to keep the
+ * external memory alive and unchanged for as long as any instance, or any
+ * container whose blocks store such instances, references it.
+ *
+ * @tparam T element type.  It cannot be bool, since the values need to be
+ *           accessible via a contiguous array.
+ * @tparam Allocator allocator type used for the owned buffer.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class external_vector
+{
+    static_assert(!std::is_same_v<T, bool>, "bool is not supported as the element type.");
+
+    using store_type = std::vector<T, Allocator>;
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    external_vector() noexcept(std::is_nothrow_default_constructible_v<store_type>)
+    {}
+
+    explicit external_vector(size_type n) : m_store(n)
+    {}
+
+    external_vector(size_type n, const T& val) : m_store(n, val)
+    {}
+
+    template<std::input_iterator InputIt>
+    external_vector(InputIt first, InputIt last) : m_store(first, last)
+    {}
+
+    /**
+     * Constructor that references an external array of values without
+     * copying them.
+     *
+     * @param values span of the external values to reference.
+     */
+    explicit external_vector(std::span<const T> values) noexcept(std::is_nothrow_default_constructible_v<store_type>)
+        : m_external(values.data()), m_external_size(values.size())
+    {}
+
+    external_vector(const external_vector& other) = default;
+    external_vector(external_vector&& other) = default;
+
+    external_vector& operator=(const external_vector& other) = default;
+    external_vector& operator=(external_vector&& other) = default;
+
+    iterator begin()
+    {
+        materialize();
+        return m_store.data();
+    }
+
+    iterator end()
+    {
+        materialize();
+        return m_store.data() + m_store.size();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return cdata();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return cdata() + size();
+    }
+
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    reference operator[](size_type pos)
+    {
+        materialize();
+        return m_store[pos];
+    }
+
+    const_reference operator[](size_type pos) const
+    {
+        return cdata()[pos];
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range("external_vector::at: position is out of range.");
+
+        materialize();
+        return m_store[pos];
+    }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("external_vector::at: position is out of range.");
+
+        return cdata()[pos];
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_external)
+        {
+            // Construct the new element first, as the arguments may refer to
+            // an external element.
+            T tmp(std::forward<Args>(args)...);
+            materialize();
+            return m_store.emplace_back(std::move(tmp));
+        }
+
+        return m_store.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop_back()
+    {
+        resize(size() - 1);
+    }
+
+    void swap(external_vector& other) noexcept
+    {
+        m_store.swap(other.m_store);
+        std::swap(m_external, other.m_external);
+        std::swap(m_external_size, other.m_external_size);
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return insert_one(pos, T(value));
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return insert_one(pos, std::move(value));
+    }
+
+    template<std::input_iterator InputIt>
+    void insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        size_type offset = pos - cdata();
+
+        if (m_external)
+        {
+            // The values to insert may come from the external array.
+            store_type values(first, last);
+            materialize();
+            m_store.insert(m_store.begin() + offset, std::make_move_iterator(values.begin()),
+                           std::make_move_iterator(values.end()));
+            return;
+        }
+
+        m_store.insert(m_store.begin() + offset, first, last);
+    }
+
+    void resize(size_type count)
+    {
+        if (m_external && count <= m_external_size)
+        {
+            m_external_size = count;
+            return;
+        }
+
+        materialize();
+        m_store.resize(count);
+    }
+
+    /**
+     * Erase a value.  Unlike std::vector, this method does not return an
+     * iterator, as the values that follow may still be read-only.
+     *
+     * @param pos position of the value to erase.
+     */
+    void erase(const_iterator pos)
+    {
+        erase(pos, pos + 1);
+    }
+
+    /**
+     * Erase a range of values.  Erasing values from either end of the
+     * referenced range while referencing external memory simply narrows the
+     * range without copying the values.
+     *
+     * @param first position of the first value to erase.
+     * @param last end position of the range of values to erase.
+     */
+    void erase(const_iterator first, const_iterator last)
+    {
+        size_type offset = first - cdata();
+        size_type len = last - first;
+
+        if (m_external && (offset == 0 || offset + len == m_external_size))
+        {
+            if (offset == 0)
+                m_external += len;
+
+            m_external_size -= len;
+            return;
+        }
+
+        materialize();
+        m_store.erase(m_store.begin() + offset, m_store.begin() + offset + len);
+    }
+
+    void clear() noexcept
+    {
+        m_store.clear();
+        m_external = nullptr;
+        m_external_size = 0;
+    }
+
+    /**
+     * Get the capacity of the store.  While referencing external memory, the
+     * capacity equals the number of referenced values.
+     */
+    size_type capacity() const noexcept
+    {
+        return m_external ? m_external_size : m_store.capacity();
+    }
+
+    void shrink_to_fit()
+    {
+        if (!m_external)
+            m_store.shrink_to_fit();
+    }
+
+    void reserve(size_type new_cap)
+    {
+        materialize();
+        m_store.reserve(new_cap);
+    }
+
+    size_type size() const noexcept
+    {
+        return m_external ? m_external_size : m_store.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        if (m_external)
+        {
+            // The values to assign may come from the external array.
+            store_type values(first, last);
+            clear();
+            m_store.swap(values);
+            return;
+        }
+
+        m_store.assign(first, last);
+    }
+
+    T* data()
+    {
+        materialize();
+        return m_store.data();
+    }
+
+    const T* data() const noexcept
+    {
+        return cdata();
+    }
+
+    /**
+     * Check whether or not the instance currently references external
+     * memory.
+     *
+     * @return true if the values are stored in external memory, false if
+     *         they are stored in a buffer owned by the instance.
+     */
+    bool is_external() const noexcept
+    {
+        return m_external != nullptr;
+    }
+
+private:
+    const T* cdata() const noexcept
+    {
+        return m_external ? m_external : m_store.data();
+    }
+
+    iterator insert_one(const_iterator pos, T&& value)
+    {
+        size_type offset = pos - cdata();
+        materialize();
+        m_store.insert(m_store.begin() + offset, std::move(value));
+        return m_store.data() + offset;
+    }
+
+    /**
+     * Copy the referenced external values into the owned buffer, and stop
+     * referencing the external memory.
+     */
+    void materialize()
+    {
+        if (!m_external)
+            return;
+
+        m_store.assign(m_external, m_external + m_external_size);
+        m_external = nullptr;
+        m_external_size = 0;
+    }
+
+    store_type m_store;
+    const T* m_external = nullptr;
+    size_type m_external_size = 0;
+};
+
+template<typename T, typename Allocator>
+bool operator==(const external_vector<T, Allocator>& lhs, const external_vector<T, Allocator>& rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+}} // namespace mdds::mtv
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,239 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "./types.hpp"
+#include "./types_util.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace mdds { namespace mtv { namespace detail {
+
+#if defined(__SSE2__)
+
+inline std::size_t find_values_sse2(const double* p, std::size_t n, double value)
+{
+    __m128d v = _mm_set1_pd(value);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i), v)) |
+                   (_mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p + i + 2), v)) << 2);
+
+        if (mask)
+            return i + std::countr_zero(unsigned(mask));
+    }
+
+    for (; i < n; ++i)
+    {
+        if (p[i] == value)
+            return i;
+    }
+
+    return n;
+}
+
+template<typename T>
+std::size_t find_values_sse2(const T* p, std::size_t n, T value)
+{
+    static_assert(std::is_integral_v<T> && sizeof(T) == 4);
+
+    __m128i v = _mm_set1_epi32(static_cast<int>(value));
+    auto cmp = [v](const T* q) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+        return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, v)));
+    };
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        int mask = cmp(p + i) | (cmp(p + i + 4) << 4);
+        if (mask)
+            return i + std::countr_zero(unsigned(mask));
+    }
+
+    for (; i < n; ++i)
+    {
+        if (p[i] == value)
+            return i;
+    }
+
+    return n;
+}
+
+#endif // __SSE2__
+
+/**
+ * Find the first value equal to the specified value in a contiguous buffer.
+ * Single-byte integral values get searched via memchr, and double and
+ * 32-bit integral values via SSE2 compares when available.
+ *
+ * @return offset of the first matching value, or n when no value matches.
+ */
+template<typename T>
+std::size_t find_values(const T* p, std::size_t n, const T& value)
+{
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 1)
+    {
+        const void* found = std::memchr(p, static_cast<unsigned char>(value), n);
+        return found ? static_cast<const T*>(found) - p : n;
+    }
+#if defined(__SSE2__)
+    else if constexpr (std::is_same_v<T, double> || (std::is_integral_v<T> && sizeof(T) == 4))
+        return find_values_sse2(p, n, value);
+#endif
+    else
+        return std::find(p, p + n, value) - p;
+}
+
+/**
+ * Find the first value equal to the specified value among the values of an
+ * element block within a range.  Boolean values in a store that can search
+ * them a word at a time get searched that way, and a block whose store keeps
+ * a summary of its values gets skipped when the value lies outside their
+ * range.
+ *
+ * @return offset of the first matching value from the start of the range,
+ *         or the length of the range when no value matches.
+ */
+template<typename Blk>
+std::size_t find_block_value(
+    const base_element_block& blk, std::size_t offset, std::size_t len, const typename Blk::value_type& value)
+{
+    using value_type = typename Blk::value_type;
+
+    if constexpr (std::is_same_v<value_type, bool> && has_find_method<typename Blk::store_type>)
+        return Blk::get(blk).store().find(value, offset, len);
+    else
+    {
+        if constexpr (has_summary_method<typename Blk::store_type>)
+        {
+            // Skip the whole block when the value lies outside the range of
+            // its values.  NaN values never compare as outside the range.
+            const auto& store = Blk::get(blk).store();
+            if (offset == 0 && len == store.size())
+            {
+                auto summary = store.summary();
+                if (value < summary.min || summary.max < value)
+                    return len;
+            }
+        }
+
+        auto it = Blk::cbegin(blk);
+        std::advance(it, offset);
+
+        if constexpr (std::contiguous_iterator<decltype(it)>)
+            return find_values(std::to_address(it), len, value);
+        else
+        {
+            for (std::size_t i = 0; i < len; ++i, ++it)
+            {
+                if (*it == value)
+                    return i;
+            }
+
+            return len;
+        }
+    }
+}
+
+/**
+ * Find the first value that satisfies a predicate among the values of an
+ * element block within a range.  For boolean values in a store that can
+ * search them a word at a time, the predicate gets evaluated only once for
+ * each of the two values.
+ *
+ * @return offset of the first matching value from the start of the range,
+ *         or the length of the range when no value matches.
+ */
+template<typename Blk, typename Pred>
+std::size_t find_block_value_if(const base_element_block& blk, std::size_t offset, std::size_t len, Pred& pred)
+{
+    using value_type = typename Blk::value_type;
+
+    if constexpr (std::is_same_v<value_type, bool> && has_find_method<typename Blk::store_type>)
+    {
+        bool on_true = pred(true);
+        bool on_false = pred(false);
+        if (on_true == on_false)
+            return on_true ? 0 : len;
+
+        return Blk::get(blk).store().find(on_true, offset, len);
+    }
+    else
+    {
+        auto it = Blk::cbegin(blk);
+        std::advance(it, offset);
+
+        for (std::size_t i = 0; i < len; ++i, ++it)
+        {
+            if (pred(*it))
+                return i;
+        }
+
+        return len;
+    }
+}
+
+/**
+ * Count the values that satisfy a predicate among the values of an element
+ * block within a range.  For boolean values in a store that can count them
+ * a word at a time, the predicate gets evaluated only once for each of the
+ * two values.
+ */
+template<typename Blk, typename Pred>
+std::size_t count_block_values_if(const base_element_block& blk, std::size_t offset, std::size_t len, Pred& pred)
+{
+    using value_type = typename Blk::value_type;
+
+    if constexpr (std::is_same_v<value_type, bool> && has_count_method<typename Blk::store_type>)
+    {
+        std::size_t n_true = Blk::get(blk).store().count(offset, len);
+        return (pred(true) ? n_true : 0) + (pred(false) ? len - n_true : 0);
+    }
+    else
+    {
+        auto it = Blk::cbegin(blk);
+        std::advance(it, offset);
+
+        if constexpr (std::contiguous_iterator<decltype(it)>)
+        {
+            // The loop without an early exit lets the compiler vectorize it
+            // for simple predicates.
+            const value_type* p = std::to_address(it);
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < len; ++i)
+                n += pred(p[i]) ? 1 : 0;
+
+            return n;
+        }
+        else
+        {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < len; ++i, ++it)
+                n += pred(*it) ? 1 : 0;
+
+            return n;
+        }
+    }
+}
+
+}}} // namespace mdds::mtv::detail
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
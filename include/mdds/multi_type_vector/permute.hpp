@@ -0,0 +1,160 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "../global.hpp"
+#include "./types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace mdds { namespace mtv { namespace detail {
+
+/**
+ * Block of a container rebuilt by a permutation of its elements.
+ */
+template<typename SizeT>
+struct permuted_block
+{
+    element_t type;
+    SizeT size;
+    base_element_block* data; // null for a block of empty elements.
+};
+
+/**
+ * Check that a sequence of positions is a permutation of the positions of
+ * a container of the specified size, i.e. that each position appears
+ * exactly once.
+ *
+ * @param method_name name of the calling method, used in the error
+ *                    messages.
+ */
+template<typename SizeT>
+void check_permutation(const char* method_name, std::span<const SizeT> perm, SizeT size)
+{
+    if (perm.size() != size)
+    {
+        std::ostringstream os;
+        os << method_name << ": the size of the permutation differs from the size of the container (permutation="
+           << perm.size() << "; container=" << size << ")";
+        throw invalid_arg_error(os.str());
+    }
+
+    std::vector<bool> used(size, false);
+
+    for (SizeT pos : perm)
+    {
+        if (pos >= size)
+        {
+            std::ostringstream os;
+            os << method_name << ": position in the permutation is out of bound. (pos=" << pos << "; size=" << size
+               << ")";
+            throw std::out_of_range(os.str());
+        }
+
+        if (used[pos])
+        {
+            std::ostringstream os;
+            os << method_name << ": position " << pos << " appears more than once in the permutation.";
+            throw invalid_arg_error(os.str());
+        }
+
+        used[pos] = true;
+    }
+}
+
+/**
+ * Gather the values of the source blocks in the order of a permutation
+ * into new element blocks, with each run of adjacent values of the same
+ * type going into a single block.  Values at consecutive source positions
+ * within the same source block get appended in one call, so that runs of
+ * rows that keep their relative order get copied in bulk.
+ *
+ * The new blocks only receive copies of the values, which leaves the
+ * ownership of any managed values with the source blocks.  When this
+ * throws, the blocks created so far get deleted without deleting their
+ * values.
+ *
+ * @param perm permutation, where the value at each position of the rebuilt
+ *             container comes from the source position stored at the same
+ *             index.  It must be a valid permutation.
+ * @param src_blocks element blocks of the source container, with null for
+ *                   blocks of empty elements.
+ * @param src_sizes sizes of the blocks of the source container.
+ * @param create_block function that creates a new empty element block of
+ *                     the specified type.
+ *
+ * @return blocks of the rebuilt container, in their stored order.
+ */
+template<typename BlockFuncs, typename SizeT, typename CreateBlockFunc>
+std::vector<permuted_block<SizeT>> gather_permuted_blocks(
+    std::span<const SizeT> perm, std::span<base_element_block* const> src_blocks, std::span<const SizeT> src_sizes,
+    CreateBlockFunc create_block)
+{
+    // Map each source position to the index of its block, and each block to
+    // the position of its first element.
+    std::vector<SizeT> block_indices(perm.size());
+    std::vector<SizeT> src_positions(src_sizes.size());
+
+    for (SizeT i = 0, pos = 0; i < src_sizes.size(); ++i)
+    {
+        src_positions[i] = pos;
+        std::fill_n(block_indices.begin() + pos, src_sizes[i], i);
+        pos += src_sizes[i];
+    }
+
+    std::vector<permuted_block<SizeT>> blocks;
+
+    try
+    {
+        for (SizeT i = 0; i < perm.size();)
+        {
+            SizeT src_pos = perm[i];
+            SizeT block_index = block_indices[src_pos];
+            const base_element_block* src = src_blocks[block_index];
+            element_t type = src ? get_block_type(*src) : element_type_empty;
+
+            SizeT len = 1;
+            while (i + len < perm.size() && perm[i + len] == src_pos + len &&
+                   block_indices[src_pos + len] == block_index)
+                ++len;
+
+            if (blocks.empty() || blocks.back().type != type)
+                blocks.push_back({type, 0, src ? create_block(type) : nullptr});
+
+            permuted_block<SizeT>& dest = blocks.back();
+            if (src)
+                BlockFuncs::append_values_from_block(*dest.data, *src, src_pos - src_positions[block_index], len);
+
+            dest.size += len;
+            i += len;
+        }
+    }
+    catch (...)
+    {
+        for (permuted_block<SizeT>& blk : blocks)
+        {
+            if (!blk.data)
+                continue;
+
+            BlockFuncs::resize_block(*blk.data, 0); // prevent double-delete.
+            BlockFuncs::delete_block(blk.data);
+        }
+
+        throw;
+    }
+
+    return blocks;
+}
+
+}}} // namespace mdds::mtv::detail
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,425 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2025 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "./types.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace mdds { namespace mtv {
+
+/**
+ * Operation types to pass to the reduce() method of multi_type_vector.
+ */
+namespace reduce_op {
+
+/**
+ * Compute the sum of the values.  The result is of the same type as the
+ * value type for floating-point values, and of either <code>int64_t</code>
+ * or <code>uint64_t</code> for integral values depending on their
+ * signedness.
+ */
+struct sum
+{};
+
+/**
+ * Compute the minimum value.  The result is an <code>std::optional</code>
+ * of the value type, which is empty when the range contains no values of
+ * the requested type.  For floating-point values, the result is NaN when
+ * any of the values is NaN, regardless of its position, same as with
+ * sum.
+ */
+struct min
+{};
+
+/**
+ * Compute the maximum value.  The result is an <code>std::optional</code>
+ * of the value type, which is empty when the range contains no values of
+ * the requested type.  For floating-point values, the result is NaN when
+ * any of the values is NaN, regardless of its position, same as with
+ * sum.
+ */
+struct max
+{};
+
+/**
+ * Count the number of values of the requested type.  The result is of type
+ * <code>std::size_t</code>.
+ */
+struct count
+{};
+
+/**
+ * Compute the arithmetic mean of the values.  The result is an
+ * <code>std::optional&lt;double&gt;</code>, which is empty when the range
+ * contains no values of the requested type.
+ */
+struct mean
+{};
+
+} // namespace reduce_op
+
+namespace detail {
+
+template<typename T>
+using reduce_sum_type = std::conditional_t<
+    std::is_floating_point_v<T>, T, std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+/**
+ * Sum the values using four independent accumulators, which breaks the
+ * dependency chain between the additions and lets the compiler vectorize
+ * the loop for integral types.
+ */
+template<typename T>
+reduce_sum_type<T> reduce_sum_values(const T* p, std::size_t n)
+{
+    using acc_type = reduce_sum_type<T>;
+    acc_type acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 += p[i];
+        acc1 += p[i + 1];
+        acc2 += p[i + 2];
+        acc3 += p[i + 3];
+    }
+
+    for (; i < n; ++i)
+        acc0 += p[i];
+
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+template<typename T>
+bool is_nan_value(const T& v)
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return v != v;
+    else
+        return false;
+}
+
+/**
+ * Find the extreme value using four independent accumulators.  Comparisons
+ * involving NaN are always false, which would make the result depend on
+ * whether a NaN value happens to be the first value, so NaN values are
+ * tracked separately and propagated to the result.
+ */
+template<typename T, typename Cmp>
+T reduce_extreme_values(const T* p, std::size_t n, Cmp cmp)
+{
+    T acc0 = p[0], acc1 = p[0], acc2 = p[0], acc3 = p[0];
+    bool nan = false;
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = cmp(p[i], acc0) ? p[i] : acc0;
+        acc1 = cmp(p[i + 1], acc1) ? p[i + 1] : acc1;
+        acc2 = cmp(p[i + 2], acc2) ? p[i + 2] : acc2;
+        acc3 = cmp(p[i + 3], acc3) ? p[i + 3] : acc3;
+
+        if constexpr (std::is_floating_point_v<T>)
+            nan |= is_nan_value(p[i]) | is_nan_value(p[i + 1]) | is_nan_value(p[i + 2]) | is_nan_value(p[i + 3]);
+    }
+
+    for (; i < n; ++i)
+    {
+        acc0 = cmp(p[i], acc0) ? p[i] : acc0;
+        nan |= is_nan_value(p[i]);
+    }
+
+    if (nan)
+        return std::numeric_limits<T>::quiet_NaN();
+
+    acc0 = cmp(acc1, acc0) ? acc1 : acc0;
+    acc2 = cmp(acc3, acc2) ? acc3 : acc2;
+    return cmp(acc2, acc0) ? acc2 : acc0;
+}
+
+#if defined(__SSE2__)
+
+inline double reduce_sum_values(const double* p, std::size_t n)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(p + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(p + i + 2));
+    }
+
+    acc0 = _mm_add_pd(acc0, acc1);
+    double sum = _mm_cvtsd_f64(acc0) + _mm_cvtsd_f64(_mm_unpackhi_pd(acc0, acc0));
+
+    for (; i < n; ++i)
+        sum += p[i];
+
+    return sum;
+}
+
+template<bool IsMin>
+double reduce_extreme_values_sse2(const double* p, std::size_t n)
+{
+    auto op = [](__m128d a, __m128d b) { return IsMin ? _mm_min_pd(a, b) : _mm_max_pd(a, b); };
+
+    // minpd and maxpd return the second operand when either is NaN, so NaN
+    // values get collected in a separate mask and propagated at the end.
+    __m128d acc0 = _mm_set1_pd(p[0]);
+    __m128d acc1 = acc0;
+    __m128d nan = _mm_setzero_pd();
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128d x0 = _mm_loadu_pd(p + i);
+        __m128d x1 = _mm_loadu_pd(p + i + 2);
+        acc0 = op(x0, acc0);
+        acc1 = op(x1, acc1);
+        nan = _mm_or_pd(nan, _mm_or_pd(_mm_cmpunord_pd(x0, x0), _mm_cmpunord_pd(x1, x1)));
+    }
+
+    acc0 = op(acc0, acc1);
+    acc0 = op(acc0, _mm_unpackhi_pd(acc0, acc0));
+
+    for (; i < n; ++i)
+    {
+        __m128d x = _mm_load_sd(p + i);
+        acc0 = op(x, acc0);
+        nan = _mm_or_pd(nan, _mm_cmpunord_sd(x, x));
+    }
+
+    if (_mm_movemask_pd(nan))
+        return std::numeric_limits<double>::quiet_NaN();
+
+    return _mm_cvtsd_f64(acc0);
+}
+
+#endif // __SSE2__
+
+template<typename T>
+T reduce_min_values(const T* p, std::size_t n)
+{
+#if defined(__SSE2__)
+    if constexpr (std::is_same_v<T, double>)
+        return reduce_extreme_values_sse2<true>(p, n);
+#endif
+    return reduce_extreme_values(p, n, [](const T& a, const T& b) { return a < b; });
+}
+
+template<typename T>
+T reduce_max_values(const T* p, std::size_t n)
+{
+#if defined(__SSE2__)
+    if constexpr (std::is_same_v<T, double>)
+        return reduce_extreme_values_sse2<false>(p, n);
+#endif
+    return reduce_extreme_values(p, n, [](const T& a, const T& b) { return b < a; });
+}
+
+/**
+ * Invoke the function on the values of an element block, passing a
+ * pointer to the contiguous buffer when the store of the block allows it,
+ * or on each value otherwise.
+ */
+template<typename Blk, typename FuncContig, typename FuncEach>
+void reduce_visit_block(
+    const base_element_block& blk, std::size_t offset, std::size_t len, FuncContig func_contig, FuncEach func_each)
+{
+    auto it = Blk::cbegin(blk);
+    std::advance(it, offset);
+
+    if constexpr (std::contiguous_iterator<decltype(it)>)
+        func_contig(std::to_address(it), len);
+    else
+    {
+        for (std::size_t i = 0; i < len; ++i, ++it)
+            func_each(*it);
+    }
+}
+
+/**
+ * Check whether the range covers all values of an element block whose
+ * store keeps a cached summary of its values, in which case the summary
+ * can stand in for the values.
+ */
+template<typename Blk>
+    requires has_summary_method<typename Blk::store_type>
+bool is_summarized_block(const base_element_block& blk, std::size_t offset, std::size_t len)
+{
+    return offset == 0 && len == Blk::get(blk).store().size();
+}
+
+template<typename Blk, typename Op>
+class reduce_state;
+
+template<typename Blk>
+class reduce_state<Blk, reduce_op::sum>
+{
+    using value_type = typename Blk::value_type;
+
+public:
+    using result_type = reduce_sum_type<value_type>;
+
+    void add(const base_element_block& blk, std::size_t offset, std::size_t len)
+    {
+        if constexpr (std::is_same_v<value_type, bool> && has_count_method<typename Blk::store_type>)
+        {
+            // Count the true values a word at a time.
+            m_value += Blk::get(blk).store().count(offset, len);
+        }
+        else
+        {
+            if constexpr (has_summary_method<typename Blk::store_type>)
+            {
+                if (is_summarized_block<Blk>(blk, offset, len))
+                {
+                    m_value += Blk::get(blk).store().summary().sum;
+                    return;
+                }
+            }
+
+            reduce_visit_block<Blk>(
+                blk, offset, len, [this](const value_type* p, std::size_t n) { m_value += reduce_sum_values(p, n); },
+                [this](const value_type& v) { m_value += v; });
+        }
+    }
+
+    result_type result() const
+    {
+        return m_value;
+    }
+
+private:
+    result_type m_value = 0;
+};
+
+template<typename Blk>
+class reduce_state<Blk, reduce_op::count>
+{
+public:
+    using result_type = std::size_t;
+
+    void add(const base_element_block& /*blk*/, std::size_t /*offset*/, std::size_t len)
+    {
+        m_value += len;
+    }
+
+    result_type result() const
+    {
+        return m_value;
+    }
+
+private:
+    result_type m_value = 0;
+};
+
+template<typename Blk>
+class reduce_state<Blk, reduce_op::mean>
+{
+    reduce_state<Blk, reduce_op::sum> m_sum;
+    std::size_t m_count = 0;
+
+public:
+    using result_type = std::optional<double>;
+
+    void add(const base_element_block& blk, std::size_t offset, std::size_t len)
+    {
+        m_sum.add(blk, offset, len);
+        m_count += len;
+    }
+
+    result_type result() const
+    {
+        if (!m_count)
+            return std::nullopt;
+
+        return double(m_sum.result()) / m_count;
+    }
+};
+
+template<typename Blk, bool IsMin>
+class reduce_extreme_state
+{
+    using value_type = typename Blk::value_type;
+
+    static bool update(const value_type& v, const value_type& cur)
+    {
+        return IsMin ? v < cur : cur < v;
+    }
+
+    /**
+     * Merge a value into the current result.  A NaN value replaces the
+     * current result, and nothing replaces a NaN result.
+     */
+    void merge(const value_type& v)
+    {
+        if (!m_value || update(v, *m_value) || (is_nan_value(v) && !is_nan_value(*m_value)))
+            m_value = v;
+    }
+
+public:
+    using result_type = std::optional<value_type>;
+
+    void add(const base_element_block& blk, std::size_t offset, std::size_t len)
+    {
+        if (!len)
+            return;
+
+        if constexpr (has_summary_method<typename Blk::store_type>)
+        {
+            if (is_summarized_block<Blk>(blk, offset, len))
+            {
+                auto summary = Blk::get(blk).store().summary();
+                merge(IsMin ? summary.min : summary.max);
+                return;
+            }
+        }
+
+        reduce_visit_block<Blk>(
+            blk, offset, len,
+            [this](const value_type* p, std::size_t n) {
+                merge(IsMin ? reduce_min_values(p, n) : reduce_max_values(p, n));
+            },
+            [this](const value_type& v) { merge(v); });
+    }
+
+    result_type result() const
+    {
+        return m_value;
+    }
+
+private:
+    result_type m_value;
+};
+
+template<typename Blk>
+class reduce_state<Blk, reduce_op::min> : public reduce_extreme_state<Blk, true>
+{};
+
+template<typename Blk>
+class reduce_state<Blk, reduce_op::max> : public reduce_extreme_state<Blk, false>
+{};
+
+} // namespace detail
+
+}} // namespace mdds::mtv
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,601 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdds { namespace mtv {
+
+/**
+ * Vector that stores its values run-length encoded, i.e. as a series of runs
+ * each of which consists of a value and the number of times it repeats.
+ * When used as the store of an element block, blocks that contain long runs
+ * of identical values take only a fraction of the memory they would take
+ * with a store that keeps a copy of each value.
+ *
+ * Accessing a value by its position requires a binary search over the runs,
+ * whereas iterating over the values sequentially does not.  Like
+ * std::vector<bool>, the non-const iterators and the non-const subscript
+ * operator return a proxy object that modifies the stored values via
+ * assignment.  Modifying a single value may split its run into up to three
+ * runs; adjacent runs of the same value always get merged.
+ *
+ * The element type must be equality-comparable.
+ *
+ * @tparam T element type.
+ * @tparam Allocator allocator type used for the runs.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class rle_vector
+{
+public:
+    /**
+     * A run of identical values.
+     */
+    struct run_type
+    {
+        /** value shared by all elements of the run. */
+        T value;
+
+        /** position past the last element of the run. */
+        std::size_t end;
+
+        bool operator==(const run_type&) const = default;
+    };
+
+private:
+    using run_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<run_type>;
+    using runs_type = std::vector<run_type, run_allocator>;
+
+    template<bool Const>
+    class iterator_base;
+
+public:
+    class reference;
+
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T& const_reference;
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /**
+     * Proxy object that references a value by its position.  Assigning a
+     * value to it modifies the referenced value.
+     */
+    class reference
+    {
+        friend class rle_vector;
+
+        rle_vector* m_parent;
+        size_type m_pos;
+
+        reference(rle_vector* parent, size_type pos) noexcept : m_parent(parent), m_pos(pos)
+        {}
+
+    public:
+        reference(const reference&) = default;
+
+        operator const T&() const
+        {
+            return std::as_const(*m_parent)[m_pos];
+        }
+
+        reference& operator=(const T& value)
+        {
+            m_parent->set(m_pos, value);
+            return *this;
+        }
+
+        reference& operator=(const reference& other)
+        {
+            T value = other;
+            m_parent->set(m_pos, value);
+            return *this;
+        }
+
+        friend bool operator==(const reference& lhs, const T& rhs)
+        {
+            return static_cast<const T&>(lhs) == rhs;
+        }
+    };
+
+private:
+    template<bool Const>
+    class iterator_base
+    {
+        friend class rle_vector;
+        friend class iterator_base<!Const>;
+
+        using parent_type = std::conditional_t<Const, const rle_vector, rle_vector>;
+
+        parent_type* m_parent = nullptr;
+        size_type m_pos = 0;
+        size_type m_run = 0; // index of the run containing the current position
+
+        iterator_base(parent_type* parent, size_type pos, size_type run) noexcept
+            : m_parent(parent), m_pos(pos), m_run(run)
+        {}
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, void>;
+        using reference = std::conditional_t<Const, const T&, typename rle_vector::reference>;
+
+        iterator_base() = default;
+
+        template<bool C = Const>
+        requires C
+        iterator_base(const iterator_base<false>& other) noexcept
+            : m_parent(other.m_parent), m_pos(other.m_pos), m_run(other.m_run)
+        {}
+
+        reference operator*() const
+        {
+            if constexpr (Const)
+                return m_parent->m_runs[m_run].value;
+            else
+                return reference(m_parent, m_pos);
+        }
+
+        pointer operator->() const
+        requires Const
+        {
+            return &m_parent->m_runs[m_run].value;
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        iterator_base& operator++()
+        {
+            ++m_pos;
+            if (m_run < m_parent->m_runs.size() && m_pos >= m_parent->m_runs[m_run].end)
+                ++m_run;
+            return *this;
+        }
+
+        iterator_base operator++(int)
+        {
+            iterator_base tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        iterator_base& operator--()
+        {
+            --m_pos;
+            if (m_run > 0 && m_pos < m_parent->m_runs[m_run - 1].end)
+                --m_run;
+            return *this;
+        }
+
+        iterator_base operator--(int)
+        {
+            iterator_base tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        iterator_base& operator+=(difference_type n)
+        {
+            m_pos += n;
+            m_run = m_parent->find_run(m_pos);
+            return *this;
+        }
+
+        iterator_base& operator-=(difference_type n)
+        {
+            return *this += -n;
+        }
+
+        friend iterator_base operator+(iterator_base it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator+(difference_type n, iterator_base it)
+        {
+            return it += n;
+        }
+
+        friend iterator_base operator-(iterator_base it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return difference_type(left.m_pos) - difference_type(right.m_pos);
+        }
+
+        friend bool operator==(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return left.m_pos == right.m_pos;
+        }
+
+        friend std::strong_ordering operator<=>(const iterator_base& left, const iterator_base& right) noexcept
+        {
+            return left.m_pos <=> right.m_pos;
+        }
+    };
+
+public:
+    rle_vector() noexcept(std::is_nothrow_default_constructible_v<runs_type>) = default;
+
+    rle_vector(size_type n) : rle_vector(n, T())
+    {}
+
+    rle_vector(size_type n, const T& val)
+    {
+        if (n)
+            m_runs.push_back(run_type{val, n});
+    }
+
+    template<std::input_iterator InputIt>
+    rle_vector(InputIt first, InputIt last) : m_runs(encode(first, last, 0))
+    {}
+
+    iterator begin() noexcept
+    {
+        return iterator(this, 0, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, size(), m_runs.size());
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, size(), m_runs.size());
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    reference operator[](size_type pos)
+    {
+        return reference(this, pos);
+    }
+
+    const_reference operator[](size_type pos) const
+    {
+        return m_runs[find_run(pos)].value;
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range("rle_vector::at: position is out of range.");
+
+        return reference(this, pos);
+    }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("rle_vector::at: position is out of range.");
+
+        return (*this)[pos];
+    }
+
+    void push_back(const T& value)
+    {
+        if (!m_runs.empty() && m_runs.back().value == value)
+            ++m_runs.back().end;
+        else
+            m_runs.push_back(run_type{value, size() + 1});
+    }
+
+    void push_back(T&& value)
+    {
+        if (!m_runs.empty() && m_runs.back().value == value)
+            ++m_runs.back().end;
+        else
+            m_runs.push_back(run_type{std::move(value), size() + 1});
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        push_back(T(std::forward<Args>(args)...));
+        return reference(this, size() - 1);
+    }
+
+    void pop_back()
+    {
+        if (--m_runs.back().end == (m_runs.size() > 1 ? m_runs[m_runs.size() - 2].end : 0))
+            m_runs.pop_back();
+    }
+
+    void swap(rle_vector& other) noexcept
+    {
+        m_runs.swap(other.m_runs);
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return insert(pos, &value, &value + 1);
+    }
+
+    template<std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        // Encode the new values first, as they may come from this instance.
+        runs_type new_runs = encode(first, last, pos.m_pos);
+        if (new_runs.empty())
+            return iterator(this, pos.m_pos, find_run(pos.m_pos));
+
+        size_type len = new_runs.back().end - pos.m_pos;
+        size_type i = split_at(pos.m_pos);
+
+        for (size_type j = i; j < m_runs.size(); ++j)
+            m_runs[j].end += len;
+
+        m_runs.insert(
+            m_runs.begin() + i, std::make_move_iterator(new_runs.begin()), std::make_move_iterator(new_runs.end()));
+
+        merge_at(i + new_runs.size());
+        merge_at(i);
+        return iterator(this, pos.m_pos, find_run(pos.m_pos));
+    }
+
+    /**
+     * Overwrite a range of values starting at the specified position.  The
+     * range must not extend past the end of the vector.
+     *
+     * @param pos position of the first value to overwrite.
+     * @param first iterator pointing to the first of the new values.
+     * @param last iterator pointing to the end position of the new values.
+     */
+    template<std::input_iterator InputIt>
+    void replace(size_type pos, InputIt first, InputIt last)
+    {
+        runs_type new_runs = encode(first, last, pos);
+        if (new_runs.empty())
+            return;
+
+        size_type i = split_at(pos);
+        size_type j = split_at(new_runs.back().end);
+        m_runs.erase(m_runs.begin() + i, m_runs.begin() + j);
+        m_runs.insert(
+            m_runs.begin() + i, std::make_move_iterator(new_runs.begin()), std::make_move_iterator(new_runs.end()));
+
+        merge_at(i + new_runs.size());
+        merge_at(i);
+    }
+
+    void resize(size_type count)
+    {
+        resize(count, T());
+    }
+
+    void resize(size_type count, const T& value)
+    {
+        size_type cur_size = size();
+        if (count < cur_size)
+        {
+            erase_range(count, cur_size - count);
+            return;
+        }
+
+        if (count == cur_size)
+            return;
+
+        if (!m_runs.empty() && m_runs.back().value == value)
+            m_runs.back().end = count;
+        else
+            m_runs.push_back(run_type{value, count});
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        erase_range(first.m_pos, last.m_pos - first.m_pos);
+        return iterator(this, first.m_pos, find_run(first.m_pos));
+    }
+
+    void clear() noexcept
+    {
+        m_runs.clear();
+    }
+
+    void shrink_to_fit()
+    {
+        m_runs.shrink_to_fit();
+    }
+
+    size_type size() const noexcept
+    {
+        return m_runs.empty() ? 0 : m_runs.back().end;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_runs.empty();
+    }
+
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        m_runs = encode(first, last, 0);
+    }
+
+    /**
+     * Get the runs that make up the stored values, in order of position.
+     * No two adjacent runs share the same value.
+     *
+     * @return span of the runs.
+     */
+    std::span<const run_type> runs() const noexcept
+    {
+        return m_runs;
+    }
+
+    /**
+     * Get the number of bytes used to store the runs.
+     */
+    size_type value_bytes() const noexcept
+    {
+        return m_runs.size() * sizeof(run_type);
+    }
+
+    /**
+     * Get the number of bytes allocated for the runs but not in use.
+     */
+    size_type slack_bytes() const noexcept
+    {
+        return (m_runs.capacity() - m_runs.size()) * sizeof(run_type);
+    }
+
+    bool operator==(const rle_vector& other) const
+    {
+        return m_runs == other.m_runs;
+    }
+
+private:
+    template<typename InputIt>
+    static runs_type encode(InputIt first, InputIt last, size_type start)
+    {
+        runs_type runs;
+        for (size_type pos = start; first != last; ++first)
+        {
+            const T& value = *first;
+            ++pos;
+
+            if (!runs.empty() && runs.back().value == value)
+                runs.back().end = pos;
+            else
+                runs.push_back(run_type{value, pos});
+        }
+
+        return runs;
+    }
+
+    /**
+     * Get the index of the run that contains the specified position, or the
+     * number of runs if the position is at or past the end.
+     */
+    size_type find_run(size_type pos) const
+    {
+        auto it = std::upper_bound(
+            m_runs.begin(), m_runs.end(), pos, [](size_type p, const run_type& run) { return p < run.end; });
+        return it - m_runs.begin();
+    }
+
+    /**
+     * Split the run containing the specified position so that a run starts
+     * at that position, and return the index of that run.
+     */
+    size_type split_at(size_type pos)
+    {
+        size_type i = find_run(pos);
+        if (i == m_runs.size())
+            return i;
+
+        size_type start = i ? m_runs[i - 1].end : 0;
+        if (start == pos)
+            return i;
+
+        run_type head{m_runs[i].value, pos};
+        m_runs.insert(m_runs.begin() + i, std::move(head));
+        return i + 1;
+    }
+
+    /**
+     * Merge the run at the specified index into its preceding run if they
+     * share the same value.
+     */
+    void merge_at(size_type i)
+    {
+        if (i == 0 || i >= m_runs.size())
+            return;
+
+        if (m_runs[i - 1].value == m_runs[i].value)
+        {
+            m_runs[i - 1].end = m_runs[i].end;
+            m_runs.erase(m_runs.begin() + i);
+        }
+    }
+
+    void set(size_type pos, const T& value)
+    {
+        if (m_runs[find_run(pos)].value == value)
+            return;
+
+        T copied = value; // the value may be stored in this instance.
+        size_type i = split_at(pos);
+        split_at(pos + 1);
+        m_runs[i].value = std::move(copied);
+        merge_at(i + 1);
+        merge_at(i);
+    }
+
+    void erase_range(size_type pos, size_type len)
+    {
+        if (!len)
+            return;
+
+        size_type i = split_at(pos);
+        size_type j = split_at(pos + len);
+        m_runs.erase(m_runs.begin() + i, m_runs.begin() + j);
+
+        for (size_type k = i; k < m_runs.size(); ++k)
+            m_runs[k].end -= len;
+
+        merge_at(i);
+    }
+
+    runs_type m_runs;
+};
+
+}} // namespace mdds::mtv
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
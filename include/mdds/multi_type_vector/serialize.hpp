@@ -0,0 +1,527 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "../global.hpp"
+#include "./standard_element_blocks.hpp"
+#include "./types.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdds { namespace mtv { namespace detail {
+
+/**
+ * Magic bytes at the top of the serialized state of a multi_type_vector.
+ */
+inline constexpr char state_magic[8] = {'m', 'd', 'd', 's', '.', 'm', 't', 'v'};
+
+inline constexpr std::uint16_t state_version = 1;
+
+/** Set when the values have been written in big-endian byte order. */
+inline constexpr std::uint16_t state_flag_big_endian = 0x0001;
+
+/**
+ * Alignment of each payload relative to the top of the state, which keeps
+ * the numeric payloads suitably aligned in a memory-mapped buffer.
+ */
+inline constexpr std::size_t state_payload_alignment = 8;
+
+/**
+ * Maximum number of bytes of values to allocate ahead of reading them from
+ * a reader that can't tell how many bytes are left to read.
+ */
+inline constexpr std::size_t state_read_chunk_bytes = 64 * 1024;
+
+struct state_header
+{
+    char magic[8];
+    std::uint16_t version;
+    std::uint16_t flags;
+    std::uint32_t reserved;
+    std::uint64_t size;
+    std::uint64_t block_count;
+};
+
+struct state_block_entry
+{
+    std::int32_t type;
+    std::uint32_t reserved;
+    std::uint64_t size;
+    std::uint64_t payload_size;
+};
+
+static_assert(sizeof(state_header) == 32 && std::is_standard_layout_v<state_header>);
+static_assert(sizeof(state_block_entry) == 24 && std::is_standard_layout_v<state_block_entry>);
+
+inline std::uint16_t native_state_flags()
+{
+    return std::endian::native == std::endian::big ? state_flag_big_endian : 0;
+}
+
+inline std::size_t state_padding_size(std::uint64_t payload_size)
+{
+    return (state_payload_alignment - payload_size % state_payload_alignment) % state_payload_alignment;
+}
+
+/**
+ * Call the function object with the std::type_identity of the standard
+ * element block type associated with the specified element type.
+ *
+ * @exception mdds::mtv::element_block_error the element type is not one of
+ *            the standard element types.
+ */
+template<typename Func>
+decltype(auto) visit_state_block_type(element_t type, Func&& func)
+{
+    switch (type)
+    {
+        case element_type_boolean:
+            return func(std::type_identity<boolean_element_block>{});
+        case element_type_int8:
+            return func(std::type_identity<int8_element_block>{});
+        case element_type_uint8:
+            return func(std::type_identity<uint8_element_block>{});
+        case element_type_int16:
+            return func(std::type_identity<int16_element_block>{});
+        case element_type_uint16:
+            return func(std::type_identity<uint16_element_block>{});
+        case element_type_int32:
+            return func(std::type_identity<int32_element_block>{});
+        case element_type_uint32:
+            return func(std::type_identity<uint32_element_block>{});
+        case element_type_int64:
+            return func(std::type_identity<int64_element_block>{});
+        case element_type_uint64:
+            return func(std::type_identity<uint64_element_block>{});
+        case element_type_float:
+            return func(std::type_identity<float_element_block>{});
+        case element_type_double:
+            return func(std::type_identity<double_element_block>{});
+        case element_type_string:
+            return func(std::type_identity<string_element_block>{});
+    }
+
+    std::ostringstream os;
+    os << "element type " << type << " is not supported by the serialized state.";
+    throw element_block_error(os.str());
+}
+
+template<typename Blk>
+std::uint64_t state_payload_size(const base_element_block& blk)
+{
+    using value_type = typename Blk::value_type;
+    const auto& store = Blk::get(blk).store();
+
+    if constexpr (std::is_same_v<value_type, std::string>)
+    {
+        std::uint64_t n = 0;
+        for (const std::string& s : store)
+            n += sizeof(std::uint64_t) + s.size();
+        return n;
+    }
+    else if constexpr (std::is_same_v<value_type, bool>)
+        return store.size();
+    else
+        return store.size() * sizeof(value_type);
+}
+
+/**
+ * Write the values of an element block.  Numeric values get written as a
+ * contiguous array, boolean values as one byte per value, and each string
+ * as its length followed by its characters.
+ */
+template<typename Blk>
+void write_state_payload(std::ostream& os, const base_element_block& blk)
+{
+    using value_type = typename Blk::value_type;
+    const auto& store = Blk::get(blk).store();
+
+    if constexpr (std::is_same_v<value_type, std::string>)
+    {
+        for (const std::string& s : store)
+        {
+            std::uint64_t n = s.size();
+            os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+            os.write(s.data(), s.size());
+        }
+    }
+    else if constexpr (std::is_same_v<value_type, bool>)
+    {
+        for (bool v : store)
+            os.put(v ? 1 : 0);
+    }
+    else
+        os.write(reinterpret_cast<const char*>(store.data()), store.size() * sizeof(value_type));
+}
+
+[[noreturn]] inline void throw_invalid_state(const char* msg)
+{
+    std::ostringstream os;
+    os << "invalid serialized state: " << msg;
+    throw invalid_arg_error(os.str());
+}
+
+/**
+ * Reads the serialized state from an input stream.
+ */
+class istream_state_reader
+{
+    std::istream& m_is;
+
+public:
+    istream_state_reader(std::istream& is) : m_is(is)
+    {}
+
+    void read(void* p, std::size_t n)
+    {
+        if (!m_is.read(static_cast<char*>(p), n))
+            throw_invalid_state("unexpected end of stream.");
+    }
+};
+
+/**
+ * Reads the serialized state from a memory buffer, such as a memory-mapped
+ * file.  The values get copied straight out of the buffer.
+ */
+class buffer_state_reader
+{
+    std::span<const char> m_buffer;
+    std::size_t m_pos = 0;
+
+public:
+    buffer_state_reader(std::span<const char> buffer) : m_buffer(buffer)
+    {}
+
+    void read(void* p, std::size_t n)
+    {
+        if (n > remaining())
+            throw_invalid_state("unexpected end of buffer.");
+
+        if (n)
+            std::memcpy(p, m_buffer.data() + m_pos, n);
+        m_pos += n;
+    }
+
+    std::size_t remaining() const
+    {
+        return m_buffer.size() - m_pos;
+    }
+};
+
+/**
+ * Readers that can tell the number of the bytes left to read, which lets a
+ * payload size get checked against it before anything gets allocated for
+ * it.
+ */
+template<typename Reader>
+concept has_remaining_method = requires(const Reader& reader) {
+    { reader.remaining() } -> std::same_as<std::size_t>;
+};
+
+/**
+ * Get the number of values to allocate at once ahead of reading them.  With
+ * a reader that can tell the number of the bytes left to read, the payload
+ * size has already been checked against it, so all the values get
+ * allocated at once.  Otherwise, they get allocated in bounded chunks so
+ * that a corrupted size results in an end-of-stream error rather than a
+ * huge allocation.
+ */
+template<typename Reader>
+std::size_t state_read_chunk_count(std::size_t count, std::size_t value_size)
+{
+    if constexpr (has_remaining_method<Reader>)
+        return count;
+    else
+        return std::min(count, std::max<std::size_t>(state_read_chunk_bytes / value_size, 1));
+}
+
+/**
+ * Read the values of an empty element block, growing it to the specified
+ * number of the values along the way.
+ */
+template<typename Blk, typename Reader>
+void read_state_payload(Reader& reader, base_element_block& blk, std::size_t size, std::uint64_t payload_size)
+{
+    using value_type = typename Blk::value_type;
+    auto& store = Blk::get(blk).store();
+
+    if constexpr (std::is_same_v<value_type, std::string>)
+    {
+        std::uint64_t remaining = payload_size;
+        const std::size_t chunk = state_read_chunk_count<Reader>(size, sizeof(std::uint64_t));
+
+        for (std::size_t pos = 0; pos < size; ++pos)
+        {
+            if (pos == store.size())
+                Blk::resize_block(blk, std::min(size, pos + chunk));
+
+            std::uint64_t n = 0;
+            if (remaining < sizeof(n))
+                throw_invalid_state("string payload is too short.");
+            reader.read(&n, sizeof(n));
+            remaining -= sizeof(n);
+
+            if (remaining < n)
+                throw_invalid_state("string payload is too short.");
+            remaining -= n;
+
+            std::string& s = store[pos];
+            const std::size_t str_chunk = state_read_chunk_count<Reader>(n, 1);
+
+            for (std::size_t str_pos = 0; str_pos < n;)
+            {
+                std::size_t len = std::min<std::size_t>(n - str_pos, str_chunk);
+                s.resize(str_pos + len);
+                reader.read(s.data() + str_pos, len);
+                str_pos += len;
+            }
+        }
+
+        if (remaining)
+            throw_invalid_state("string payload is too long.");
+    }
+    else if constexpr (std::is_same_v<value_type, bool>)
+    {
+        if (payload_size != size)
+            throw_invalid_state("boolean payload size does not match the block size.");
+
+        const std::size_t chunk = state_read_chunk_count<Reader>(size, 1);
+        char buf[256];
+        std::size_t pos = 0;
+        while (pos < size)
+        {
+            if (pos == store.size())
+                Blk::resize_block(blk, std::min(size, pos + chunk));
+
+            std::size_t n = std::min(store.size() - pos, sizeof(buf));
+            reader.read(buf, n);
+            for (std::size_t i = 0; i < n; ++i, ++pos)
+                store[pos] = buf[i] != 0;
+        }
+    }
+    else
+    {
+        if (payload_size != size * sizeof(value_type))
+            throw_invalid_state("numeric payload size does not match the block size.");
+
+        const std::size_t chunk = state_read_chunk_count<Reader>(size, sizeof(value_type));
+        for (std::size_t pos = 0; pos < size;)
+        {
+            std::size_t n = std::min(size - pos, chunk);
+            Blk::resize_block(blk, pos + n);
+            reader.read(store.data() + pos, n * sizeof(value_type));
+            pos += n;
+        }
+    }
+}
+
+/**
+ * Write the serialized state of a container.
+ *
+ * @param os output stream to write the state to.
+ * @param size logical size of the container.
+ * @param block_count number of the blocks in the container.
+ * @param get_block function object that takes a block index and returns a
+ *                  pair of the size and the element block of that block.
+ */
+template<typename GetBlock>
+void write_state(std::ostream& os, std::uint64_t size, std::size_t block_count, GetBlock get_block)
+{
+    state_header header{};
+    std::memcpy(header.magic, state_magic, sizeof(header.magic));
+    header.version = state_version;
+    header.flags = native_state_flags();
+    header.size = size;
+    header.block_count = block_count;
+
+    std::vector<state_block_entry> entries(block_count);
+
+    for (std::size_t i = 0; i < block_count; ++i)
+    {
+        auto [blk_size, data] = get_block(i);
+        auto& entry = entries[i];
+        entry.size = blk_size;
+
+        if (!data)
+        {
+            entry.type = element_type_empty;
+            continue;
+        }
+
+        entry.type = get_block_type(*data);
+        entry.payload_size = visit_state_block_type(
+            entry.type, [data](auto blk_type) { return state_payload_size<typename decltype(blk_type)::type>(*data); });
+    }
+
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(state_block_entry));
+
+    const char padding[state_payload_alignment] = {};
+
+    for (std::size_t i = 0; i < block_count; ++i)
+    {
+        const base_element_block* data = get_block(i).second;
+        if (!data)
+            continue;
+
+        visit_state_block_type(entries[i].type, [&os, data](auto blk_type) {
+            write_state_payload<typename decltype(blk_type)::type>(os, *data);
+        });
+
+        os.write(padding, state_padding_size(entries[i].payload_size));
+    }
+}
+
+/**
+ * Check the payload size of a block against the number of its values
+ * before reading them.  The payload size itself gets checked against the
+ * remaining size of the input, if known, before anything is allocated for
+ * the block.
+ */
+template<typename Blk>
+void check_state_payload_size(const state_block_entry& entry)
+{
+    using value_type = typename Blk::value_type;
+
+    if constexpr (std::is_same_v<value_type, std::string>)
+    {
+        if (entry.payload_size / sizeof(std::uint64_t) < entry.size)
+            throw_invalid_state("string payload is too short.");
+    }
+    else if constexpr (std::is_same_v<value_type, bool>)
+    {
+        if (entry.payload_size != entry.size)
+            throw_invalid_state("boolean payload size does not match the block size.");
+    }
+    else
+    {
+        if (entry.payload_size % sizeof(value_type) || entry.payload_size / sizeof(value_type) != entry.size)
+            throw_invalid_state("numeric payload size does not match the block size.");
+    }
+}
+
+struct loaded_state_block
+{
+    std::size_t size;
+    base_element_block* data;
+};
+
+/**
+ * Read the serialized state of a container.  The element blocks get created
+ * via the block functions of the container, and are owned by the caller on
+ * return.  Should an error occur, all element blocks created up to that
+ * point get deleted before the exception propagates.
+ *
+ * @return size and element block of each block, in order.
+ */
+template<typename BlockFuncs, typename Reader>
+std::vector<loaded_state_block> read_state(Reader& reader)
+{
+    state_header header;
+    reader.read(&header, sizeof(header));
+
+    if (std::memcmp(header.magic, state_magic, sizeof(header.magic)))
+        throw_invalid_state("magic bytes not found.");
+
+    if (header.version != state_version)
+        throw_invalid_state("unsupported version.");
+
+    if (header.flags != native_state_flags())
+        throw_invalid_state("byte order differs from that of this platform.");
+
+    // NB: the entries get read one at a time so that a corrupted block count
+    // doesn't result in a huge allocation up front.
+    std::vector<state_block_entry> entries;
+    std::uint64_t total_size = 0;
+
+    for (std::uint64_t i = 0; i < header.block_count; ++i)
+    {
+        state_block_entry entry;
+        reader.read(&entry, sizeof(entry));
+
+        if (!entry.size)
+            throw_invalid_state("empty block found.");
+
+        if (entry.size > header.size - total_size)
+            throw_invalid_state("block sizes exceed the container size.");
+
+        if (!entries.empty() && entries.back().type == entry.type)
+            throw_invalid_state("adjacent blocks of the same type found.");
+
+        if (entry.type == element_type_empty && entry.payload_size)
+            throw_invalid_state("empty block with payload found.");
+
+        total_size += entry.size;
+        entries.push_back(entry);
+    }
+
+    if (total_size != header.size)
+        throw_invalid_state("block sizes don't add up to the container size.");
+
+    std::vector<loaded_state_block> blocks;
+    blocks.reserve(entries.size());
+
+    try
+    {
+        char padding[state_payload_alignment];
+
+        for (const state_block_entry& entry : entries)
+        {
+            if (entry.type == element_type_empty)
+            {
+                blocks.push_back({entry.size, nullptr});
+                continue;
+            }
+
+            visit_state_block_type(entry.type, [&entry](auto blk_type) {
+                check_state_payload_size<typename decltype(blk_type)::type>(entry);
+            });
+
+            if constexpr (has_remaining_method<Reader>)
+            {
+                if (entry.payload_size > reader.remaining())
+                    throw_invalid_state("payload size exceeds the remaining size of the buffer.");
+            }
+
+            base_element_block* data = BlockFuncs::create_new_block(entry.type, 0);
+            blocks.push_back({entry.size, data});
+
+            visit_state_block_type(entry.type, [&reader, &entry, data](auto blk_type) {
+                read_state_payload<typename decltype(blk_type)::type>(reader, *data, entry.size, entry.payload_size);
+            });
+
+            reader.read(padding, state_padding_size(entry.payload_size));
+        }
+    }
+    catch (...)
+    {
+        for (const loaded_state_block& blk : blocks)
+        {
+            if (blk.data)
+                BlockFuncs::delete_block(blk.data);
+        }
+        throw;
+    }
+
+    return blocks;
+}
+
+}}} // namespace mdds::mtv::detail
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
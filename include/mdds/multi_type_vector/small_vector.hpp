@@ -0,0 +1,460 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2025 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace mdds { namespace mtv {
+
+/**
+ * Vector that stores up to N elements inline within the object itself, and
+ * switches to a heap-allocated buffer only when the number of elements
+ * exceeds N.  When used as the store of an element block, blocks holding a
+ * small number of elements require neither a separate allocation for their
+ * elements nor the extra indirection to access them.
+ *
+ * Use small_store to pass this type as the store type template argument of
+ * an element block.
+ *
+ * @tparam T element type.
+ * @tparam N number of elements to store inline.
+ * @tparam Allocator allocator type used for the heap-allocated buffer.
+ */
+template<typename T, std::size_t N, typename Allocator = std::allocator<T>>
+class small_vector
+{
+    static_assert(N > 0, "the inline capacity must be at least one.");
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static constexpr size_type inline_capacity = N;
+
+    small_vector() noexcept : m_data(inline_data())
+    {}
+
+    explicit small_vector(size_type n) : small_vector()
+    {
+        resize(n);
+    }
+
+    small_vector(size_type n, const T& val) : small_vector()
+    {
+        reserve(n);
+        std::uninitialized_fill_n(m_data, n, val);
+        m_size = n;
+    }
+
+    template<std::input_iterator InputIt>
+    small_vector(InputIt first, InputIt last) : small_vector()
+    {
+        insert(end(), first, last);
+    }
+
+    small_vector(const small_vector& other) : small_vector()
+    {
+        reserve(other.m_size);
+        std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
+        m_size = other.m_size;
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : small_vector()
+    {
+        take_from(other);
+    }
+
+    ~small_vector()
+    {
+        clear();
+        release_heap();
+    }
+
+    small_vector& operator=(const small_vector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.m_size);
+            std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
+            m_size = other.m_size;
+        }
+
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other)
+        {
+            clear();
+            release_heap();
+            take_from(other);
+        }
+
+        return *this;
+    }
+
+    iterator begin() noexcept
+    {
+        return m_data;
+    }
+
+    iterator end() noexcept
+    {
+        return m_data + m_size;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return m_data;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    reference operator[](size_type pos)
+    {
+        return m_data[pos];
+    }
+
+    const_reference operator[](size_type pos) const
+    {
+        return m_data[pos];
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= m_size)
+            throw std::out_of_range("small_vector::at: position is out of range.");
+
+        return m_data[pos];
+    }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= m_size)
+            throw std::out_of_range("small_vector::at: position is out of range.");
+
+        return m_data[pos];
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            // Construct the new element first, as the arguments may refer to
+            // an existing element.
+            T tmp(std::forward<Args>(args)...);
+            grow(m_size + 1);
+            ::new (static_cast<void*>(m_data + m_size)) T(std::move(tmp));
+        }
+        else
+            ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+
+        return m_data[m_size++];
+    }
+
+    void pop_back()
+    {
+        std::destroy_at(m_data + --m_size);
+    }
+
+    void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return insert_one(pos, T(value));
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return insert_one(pos, std::move(value));
+    }
+
+    template<std::input_iterator InputIt>
+    void insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        size_type offset = pos - begin();
+        size_type old_size = m_size;
+
+        if constexpr (std::forward_iterator<InputIt>)
+            reserve(m_size + std::distance(first, last));
+
+        for (; first != last; ++first)
+            emplace_back(*first);
+
+        std::rotate(begin() + offset, begin() + old_size, end());
+    }
+
+    void resize(size_type count)
+    {
+        if (count < m_size)
+        {
+            std::destroy(m_data + count, m_data + m_size);
+            m_size = count;
+            return;
+        }
+
+        reserve(count);
+        std::uninitialized_value_construct_n(m_data + m_size, count - m_size);
+        m_size = count;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator it_first = begin() + (first - begin());
+        iterator it_last = begin() + (last - begin());
+
+        iterator new_end = std::move(it_last, end(), it_first);
+        std::destroy(new_end, end());
+        m_size = new_end - begin();
+        return it_first;
+    }
+
+    void clear() noexcept
+    {
+        std::destroy(m_data, m_data + m_size);
+        m_size = 0;
+    }
+
+    size_type capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    void shrink_to_fit()
+    {
+        if (is_inline() || m_size == m_capacity)
+            return;
+
+        reallocate(std::max(m_size, N));
+    }
+
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > m_capacity)
+            reallocate(new_cap);
+    }
+
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        insert(end(), first, last);
+    }
+
+    T* data() noexcept
+    {
+        return m_data;
+    }
+
+    const T* data() const noexcept
+    {
+        return m_data;
+    }
+
+    /**
+     * Check whether or not the elements are currently stored inline.
+     *
+     * @return true if the elements are stored inline, false if they are
+     *         stored in a heap-allocated buffer.
+     */
+    bool is_inline() const noexcept
+    {
+        return m_data == inline_data();
+    }
+
+private:
+    T* inline_data() noexcept
+    {
+        return reinterpret_cast<T*>(m_inline);
+    }
+
+    const T* inline_data() const noexcept
+    {
+        return reinterpret_cast<const T*>(m_inline);
+    }
+
+    iterator insert_one(const_iterator pos, T&& value)
+    {
+        size_type offset = pos - begin();
+        emplace_back(std::move(value));
+        std::rotate(begin() + offset, end() - 1, end());
+        return begin() + offset;
+    }
+
+    void grow(size_type min_cap)
+    {
+        reallocate(std::max(min_cap, m_capacity * 2));
+    }
+
+    /**
+     * Move the elements to a new buffer of the specified capacity, which is
+     * the inline buffer when the capacity equals N.
+     */
+    void reallocate(size_type new_cap)
+    {
+        T* new_data = new_cap == N ? inline_data() : alloc_traits::allocate(m_alloc, new_cap);
+
+        if (new_data == m_data)
+            return;
+
+        try
+        {
+            std::uninitialized_move_n(m_data, m_size, new_data);
+        }
+        catch (...)
+        {
+            if (new_data != inline_data())
+                alloc_traits::deallocate(m_alloc, new_data, new_cap);
+            throw;
+        }
+
+        std::destroy(m_data, m_data + m_size);
+        release_heap();
+        m_data = new_data;
+        m_capacity = new_cap;
+    }
+
+    void release_heap() noexcept
+    {
+        if (!is_inline())
+            alloc_traits::deallocate(m_alloc, m_data, m_capacity);
+
+        m_data = inline_data();
+        m_capacity = N;
+    }
+
+    /**
+     * Take the elements of another instance.  This instance must be empty
+     * and not own a heap-allocated buffer.  The heap-allocated buffer of the
+     * other instance is taken over as is, whereas the inline elements get
+     * moved one by one.
+     */
+    void take_from(small_vector& other)
+    {
+        if (other.is_inline())
+        {
+            std::uninitialized_move_n(other.m_data, other.m_size, m_data);
+            m_size = other.m_size;
+            other.clear();
+            return;
+        }
+
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_data = other.inline_data();
+        other.m_size = 0;
+        other.m_capacity = N;
+    }
+
+    T* m_data;
+    size_type m_size = 0;
+    size_type m_capacity = N;
+    [[no_unique_address]] Allocator m_alloc;
+    alignas(T) unsigned char m_inline[sizeof(T) * N];
+};
+
+template<typename T, std::size_t N, typename Allocator>
+bool operator==(const small_vector<T, N, Allocator>& lhs, const small_vector<T, N, Allocator>& rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+/**
+ * Helper to pass small_vector with a specific inline capacity as the store
+ * type template argument of an element block, e.g.
+ *
+ * @code{.cpp}
+ * using block_type = mdds::mtv::default_element_block<
+ *     mdds::mtv::element_type_double, double, mdds::mtv::small_store<4>::type>;
+ * @endcode
+ *
+ * @tparam N number of elements to store inline.
+ */
+template<std::size_t N>
+struct small_store
+{
+    template<typename T, typename Allocator = std::allocator<T>>
+    using type = small_vector<T, N, Allocator>;
+};
+
+}} // namespace mdds::mtv
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -12,7 +12,27 @@
 #if defined(__SSE2__)
 #include <emmintrin.h>
 #endif
-#if defined(__AVX2__)
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Run-time CPU feature dispatch relies on the target function attribute and
+// the CPU feature detection built-ins of GCC and Clang.
+#if !defined(MDDS_MTV_SOA_CPU_DISPATCH)
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MDDS_MTV_SOA_CPU_DISPATCH 1
+#else
+#define MDDS_MTV_SOA_CPU_DISPATCH 0
+#endif
+#endif
+
+#if MDDS_MTV_SOA_CPU_DISPATCH && !defined(__AVX2__) && !defined(__AVX512F__)
 #include <immintrin.h>
 #endif
 
@@ -591,6 +611,723 @@ struct adjust_block_positions<Blks, lu_factor_t::avx2_x64_lu8>
 
 #endif // __AVX2__
 
+#if defined(__AVX512F__)
+
+template<typename Blks>
+struct adjust_block_positions<Blks, lu_factor_t::avx512_x64>
+{
+    void operator()(Blks& block_store, int64_t start_block_index, int64_t delta) const
+    {
+        static_assert(
+            sizeof(typename decltype(block_store.positions)::value_type) == 8,
+            "This code works only when the position values are 64-bit wide.");
+
+        int64_t n = block_store.positions.size();
+
+        if (start_block_index >= n)
+            return;
+
+        // Ensure that the section length is divisible by 8.
+        int64_t len = n - start_block_index;
+        int64_t rem = len & 7; // % 8
+        len -= rem;
+        len += start_block_index;
+
+        __m512i right = _mm512_set1_epi64(delta);
+
+#if MDDS_USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (int64_t i = start_block_index; i < len; i += 8)
+        {
+            void* dst = &block_store.positions[i];
+            _mm512_storeu_si512(dst, _mm512_add_epi64(_mm512_loadu_si512(dst), right));
+        }
+
+        rem += len;
+        for (int64_t i = len; i < rem; ++i)
+            block_store.positions[i] += delta;
+    }
+};
+
+template<typename Blks>
+struct adjust_block_positions<Blks, lu_factor_t::avx512_x64_lu4>
+{
+    void operator()(Blks& block_store, int64_t start_block_index, int64_t delta) const
+    {
+        static_assert(
+            sizeof(typename decltype(block_store.positions)::value_type) == 8,
+            "This code works only when the position values are 64-bit wide.");
+
+        int64_t n = block_store.positions.size();
+
+        if (start_block_index >= n)
+            return;
+
+        // Ensure that the section length is divisible by 32.
+        int64_t len = n - start_block_index;
+        int64_t rem = len & 31; // % 32
+        len -= rem;
+        len += start_block_index;
+
+        __m512i right = _mm512_set1_epi64(delta);
+
+#if MDDS_USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (int64_t i = start_block_index; i < len; i += 32)
+        {
+            void* dst = &block_store.positions[i];
+            _mm512_storeu_si512(dst, _mm512_add_epi64(_mm512_loadu_si512(dst), right));
+
+            void* dst8 = &block_store.positions[i + 8];
+            _mm512_storeu_si512(dst8, _mm512_add_epi64(_mm512_loadu_si512(dst8), right));
+
+            void* dst16 = &block_store.positions[i + 16];
+            _mm512_storeu_si512(dst16, _mm512_add_epi64(_mm512_loadu_si512(dst16), right));
+
+            void* dst24 = &block_store.positions[i + 24];
+            _mm512_storeu_si512(dst24, _mm512_add_epi64(_mm512_loadu_si512(dst24), right));
+        }
+
+        rem += len;
+        for (int64_t i = len; i < rem; ++i)
+            block_store.positions[i] += delta;
+    }
+};
+
+template<typename Blks>
+struct adjust_block_positions<Blks, lu_factor_t::avx512_x64_lu8>
+{
+    void operator()(Blks& block_store, int64_t start_block_index, int64_t delta) const
+    {
+        static_assert(
+            sizeof(typename decltype(block_store.positions)::value_type) == 8,
+            "This code works only when the position values are 64-bit wide.");
+
+        int64_t n = block_store.positions.size();
+
+        if (start_block_index >= n)
+            return;
+
+        // Ensure that the section length is divisible by 64.
+        int64_t len = n - start_block_index;
+        int64_t rem = len & 63; // % 64
+        len -= rem;
+        len += start_block_index;
+
+        __m512i right = _mm512_set1_epi64(delta);
+
+#if MDDS_USE_OPENMP
+#pragma omp parallel for
+#endif
+        for (int64_t i = start_block_index; i < len; i += 64)
+        {
+            void* dst = &block_store.positions[i];
+            _mm512_storeu_si512(dst, _mm512_add_epi64(_mm512_loadu_si512(dst), right));
+
+            void* dst8 = &block_store.positions[i + 8];
+            _mm512_storeu_si512(dst8, _mm512_add_epi64(_mm512_loadu_si512(dst8), right));
+
+            void* dst16 = &block_store.positions[i + 16];
+            _mm512_storeu_si512(dst16, _mm512_add_epi64(_mm512_loadu_si512(dst16), right));
+
+            void* dst24 = &block_store.positions[i + 24];
+            _mm512_storeu_si512(dst24, _mm512_add_epi64(_mm512_loadu_si512(dst24), right));
+
+            void* dst32 = &block_store.positions[i + 32];
+            _mm512_storeu_si512(dst32, _mm512_add_epi64(_mm512_loadu_si512(dst32), right));
+
+            void* dst40 = &block_store.positions[i + 40];
+            _mm512_storeu_si512(dst40, _mm512_add_epi64(_mm512_loadu_si512(dst40), right));
+
+            void* dst48 = &block_store.positions[i + 48];
+            _mm512_storeu_si512(dst48, _mm512_add_epi64(_mm512_loadu_si512(dst48), right));
+
+            void* dst56 = &block_store.positions[i + 56];
+            _mm512_storeu_si512(dst56, _mm512_add_epi64(_mm512_loadu_si512(dst56), right));
+        }
+
+        rem += len;
+        for (int64_t i = len; i < rem; ++i)
+            block_store.positions[i] += delta;
+    }
+};
+
+#endif // __AVX512F__
+
+/**
+ * Signature of the position adjustment kernels selected at run time.  Each
+ * kernel adds the delta value to all of the n position values starting at
+ * the pointed position.
+ */
+using adjust_positions_kernel_type = void (*)(std::size_t*, std::size_t, int64_t);
+
+/**
+ * Identifiers of the position adjustment kernels that can be selected at run
+ * time.
+ */
+enum class adjust_positions_kernel_t : int
+{
+    scalar = 0,
+    sse2,
+    avx2,
+    avx512
+};
+
+inline void adjust_positions_scalar(std::size_t* p, std::size_t n, int64_t delta)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        p[i] += delta;
+}
+
+#if defined(__SSE2__) && defined(__x86_64__)
+
+inline void adjust_positions_sse2(std::size_t* p, std::size_t n, int64_t delta)
+{
+    static_assert(sizeof(std::size_t) == 8, "This code works only when the position values are 64-bit wide.");
+
+    std::size_t len = n & ~std::size_t(7);
+    __m128i right = _mm_set1_epi64x(delta);
+
+    for (std::size_t i = 0; i < len; i += 8)
+    {
+        __m128i* dst0 = (__m128i*)&p[i];
+        _mm_storeu_si128(dst0, _mm_add_epi64(_mm_loadu_si128(dst0), right));
+
+        __m128i* dst2 = (__m128i*)&p[i + 2];
+        _mm_storeu_si128(dst2, _mm_add_epi64(_mm_loadu_si128(dst2), right));
+
+        __m128i* dst4 = (__m128i*)&p[i + 4];
+        _mm_storeu_si128(dst4, _mm_add_epi64(_mm_loadu_si128(dst4), right));
+
+        __m128i* dst6 = (__m128i*)&p[i + 6];
+        _mm_storeu_si128(dst6, _mm_add_epi64(_mm_loadu_si128(dst6), right));
+    }
+
+    for (std::size_t i = len; i < n; ++i)
+        p[i] += delta;
+}
+
+#endif // __SSE2__ && __x86_64__
+
+#if MDDS_MTV_SOA_CPU_DISPATCH
+
+__attribute__((target("avx2"))) inline void adjust_positions_avx2(std::size_t* p, std::size_t n, int64_t delta)
+{
+    static_assert(sizeof(std::size_t) == 8, "This code works only when the position values are 64-bit wide.");
+
+    std::size_t len = n & ~std::size_t(15);
+    __m256i right = _mm256_set1_epi64x(delta);
+
+    for (std::size_t i = 0; i < len; i += 16)
+    {
+        __m256i* dst = (__m256i*)&p[i];
+        _mm256_storeu_si256(dst, _mm256_add_epi64(_mm256_loadu_si256(dst), right));
+
+        __m256i* dst4 = (__m256i*)&p[i + 4];
+        _mm256_storeu_si256(dst4, _mm256_add_epi64(_mm256_loadu_si256(dst4), right));
+
+        __m256i* dst8 = (__m256i*)&p[i + 8];
+        _mm256_storeu_si256(dst8, _mm256_add_epi64(_mm256_loadu_si256(dst8), right));
+
+        __m256i* dst12 = (__m256i*)&p[i + 12];
+        _mm256_storeu_si256(dst12, _mm256_add_epi64(_mm256_loadu_si256(dst12), right));
+    }
+
+    for (std::size_t i = len; i < n; ++i)
+        p[i] += delta;
+}
+
+__attribute__((target("avx512f"))) inline void adjust_positions_avx512(std::size_t* p, std::size_t n, int64_t delta)
+{
+    static_assert(sizeof(std::size_t) == 8, "This code works only when the position values are 64-bit wide.");
+
+    std::size_t len = n & ~std::size_t(31);
+    __m512i right = _mm512_set1_epi64(delta);
+
+    for (std::size_t i = 0; i < len; i += 32)
+    {
+        void* dst = &p[i];
+        _mm512_storeu_si512(dst, _mm512_add_epi64(_mm512_loadu_si512(dst), right));
+
+        void* dst8 = &p[i + 8];
+        _mm512_storeu_si512(dst8, _mm512_add_epi64(_mm512_loadu_si512(dst8), right));
+
+        void* dst16 = &p[i + 16];
+        _mm512_storeu_si512(dst16, _mm512_add_epi64(_mm512_loadu_si512(dst16), right));
+
+        void* dst24 = &p[i + 24];
+        _mm512_storeu_si512(dst24, _mm512_add_epi64(_mm512_loadu_si512(dst24), right));
+    }
+
+    for (std::size_t i = len; i < n; ++i)
+        p[i] += delta;
+}
+
+#endif // MDDS_MTV_SOA_CPU_DISPATCH
+
+/**
+ * Detect the widest vector kernel supported by the CPU the program is
+ * running on.
+ */
+inline adjust_positions_kernel_t detect_adjust_positions_kernel()
+{
+#if MDDS_MTV_SOA_CPU_DISPATCH
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+        return adjust_positions_kernel_t::avx512;
+
+    if (__builtin_cpu_supports("avx2"))
+        return adjust_positions_kernel_t::avx2;
+#endif
+
+#if defined(__SSE2__) && defined(__x86_64__)
+    return adjust_positions_kernel_t::sse2;
+#else
+    return adjust_positions_kernel_t::scalar;
+#endif
+}
+
+inline adjust_positions_kernel_type get_adjust_positions_kernel(adjust_positions_kernel_t kernel)
+{
+    switch (kernel)
+    {
+#if MDDS_MTV_SOA_CPU_DISPATCH
+        case adjust_positions_kernel_t::avx512:
+            return adjust_positions_avx512;
+        case adjust_positions_kernel_t::avx2:
+            return adjust_positions_avx2;
+#endif
+#if defined(__SSE2__) && defined(__x86_64__)
+        case adjust_positions_kernel_t::sse2:
+            return adjust_positions_sse2;
+#endif
+        default:;
+    }
+
+    return adjust_positions_scalar;
+}
+
+/**
+ * Get the kernel selected for the CPU the program is running on.  The
+ * detection is performed only once on the first call.
+ */
+inline adjust_positions_kernel_t get_selected_adjust_positions_kernel()
+{
+    static const adjust_positions_kernel_t kernel = detect_adjust_positions_kernel();
+    return kernel;
+}
+
+template<typename Blks>
+struct adjust_block_positions<Blks, lu_factor_t::runtime_dispatch>
+{
+    void operator()(Blks& block_store, int64_t start_block_index, int64_t delta) const
+    {
+        static_assert(
+            sizeof(typename decltype(block_store.positions)::value_type) == sizeof(std::size_t),
+            "This code works only when the position values are of the size_t width.");
+
+        static const adjust_positions_kernel_type kernel =
+            get_adjust_positions_kernel(get_selected_adjust_positions_kernel());
+
+        int64_t n = block_store.positions.size();
+
+        if (start_block_index >= n)
+            return;
+
+        kernel(
+            reinterpret_cast<std::size_t*>(block_store.positions.data() + start_block_index), n - start_block_index,
+            delta);
+    }
+};
+
+/**
+ * Keeps track of the block position shifts that have been deferred, i.e. not
+ * yet applied to the position array.
+ *
+ * The pending shifts are stored as a list of segments sorted by the index of
+ * their first block.  Each segment stores the delta to add to the stored
+ * positions of all blocks from its first block up to the first block of the
+ * next segment, or up to the last block for the last segment.  The blocks
+ * preceding the first segment have no pending shift.
+ *
+ * A mutation is expected to be bracketed by begin_edit() and end_edit().  The
+ * former makes the stored positions of the blocks in the edit zone exact, and
+ * shift() then applies the block position shifts that occur during the
+ * mutation only up to the end of that zone while deferring the rest.
+ */
+template<typename SizeT>
+class pending_position_shifts
+{
+    struct segment
+    {
+        SizeT start;
+        int64_t delta;
+    };
+
+    std::vector<segment> m_segments;
+
+    /** Index of the first block past the current edit zone. */
+    SizeT m_zone_end = 0;
+
+    /** Number of blocks at the start of the current edit. */
+    SizeT m_zone_block_count = 0;
+
+    bool m_in_edit = false;
+
+    auto find_segment(SizeT block_index) const
+    {
+        return std::upper_bound(
+            m_segments.begin(), m_segments.end(), block_index,
+            [](SizeT index, const segment& seg) { return index < seg.start; });
+    }
+
+public:
+    bool empty() const noexcept
+    {
+        return m_segments.empty();
+    }
+
+    std::size_t segment_count() const noexcept
+    {
+        return m_segments.size();
+    }
+
+    void clear() noexcept
+    {
+        m_segments.clear();
+    }
+
+    void swap(pending_position_shifts& other) noexcept
+    {
+        m_segments.swap(other.m_segments);
+        std::swap(m_zone_end, other.m_zone_end);
+        std::swap(m_zone_block_count, other.m_zone_block_count);
+        std::swap(m_in_edit, other.m_in_edit);
+    }
+
+    /**
+     * Get the pending delta for a block.
+     *
+     * @param block_index index of the block.
+     *
+     * @return delta to add to the stored position of the block to get its
+     *         logical position.
+     */
+    int64_t delta(SizeT block_index) const
+    {
+        auto it = find_segment(block_index);
+        return it == m_segments.begin() ? 0 : std::prev(it)->delta;
+    }
+
+    /**
+     * Apply all pending shifts to the position array.
+     */
+    template<typename Positions>
+    void apply(Positions& positions)
+    {
+        for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+        {
+            SizeT end = std::next(it) == m_segments.end() ? positions.size() : std::next(it)->start;
+
+            for (SizeT i = it->start; i < end; ++i)
+                positions[i] += it->delta;
+        }
+
+        m_segments.clear();
+    }
+
+    /**
+     * Mark the start of a mutation, and make the stored positions of the
+     * blocks in the edit zone exact.
+     *
+     * @param positions position array.
+     * @param first index of the first block in the edit zone.
+     * @param last index of the block past the last block in the edit zone.
+     */
+    template<typename Positions>
+    void begin_edit(Positions& positions, SizeT first, SizeT last)
+    {
+        SizeT n = positions.size();
+        assert(first <= last && last <= n);
+
+        m_zone_end = last;
+        m_zone_block_count = n;
+        m_in_edit = true;
+
+        if (m_segments.empty())
+            return;
+
+        int64_t delta_before = first ? delta(first - 1) : 0;
+        int64_t delta_last = last < n ? delta(last) : 0;
+
+        for (SizeT i = first; i < last; ++i)
+            positions[i] += delta(i);
+
+        // Replace the segments starting inside the zone with a zero-delta
+        // segment covering the zone and a segment carrying the original delta
+        // past the zone.
+        auto it_first = std::lower_bound(
+            m_segments.begin(), m_segments.end(), first,
+            [](const segment& seg, SizeT index) { return seg.start < index; });
+        auto it_last = find_segment(last);
+        it_first = m_segments.erase(it_first, it_last);
+
+        if (last < n && delta_last != 0)
+            it_first = m_segments.insert(it_first, segment{last, delta_last});
+
+        if (delta_before != 0)
+            m_segments.insert(it_first, segment{first, 0});
+    }
+
+    /**
+     * Shift the positions of the blocks that follow a block whose size has
+     * changed during the current edit.  Only the blocks in the edit zone get
+     * their stored positions updated; the shift for the rest gets deferred.
+     * Outside of an edit, all pending shifts get applied before shifting
+     * the positions of all the blocks that follow.
+     *
+     * @param positions position array.
+     * @param start_block_index index of the first block to shift.
+     * @param delta delta to add to the positions.
+     */
+    template<typename Positions>
+    void shift(Positions& positions, SizeT start_block_index, int64_t delta)
+    {
+        SizeT n = positions.size();
+
+        if (!m_in_edit)
+        {
+            apply(positions);
+            for (SizeT i = start_block_index; i < n; ++i)
+                positions[i] += delta;
+            return;
+        }
+
+        // Current index of the first block past the edit zone.
+        SizeT zone_end = m_zone_end + n - m_zone_block_count;
+        assert(start_block_index <= zone_end || zone_end >= n);
+
+        for (SizeT i = start_block_index; i < std::min(zone_end, n); ++i)
+            positions[i] += delta;
+
+        if (zone_end >= n)
+            return;
+
+        // The segments past the edit zone still use the block indices from
+        // before the edit until end_edit() gets called.
+        auto it = std::lower_bound(
+            m_segments.begin(), m_segments.end(), m_zone_end,
+            [](const segment& seg, SizeT index) { return seg.start < index; });
+
+        if (it == m_segments.end() || it->start != m_zone_end)
+        {
+            int64_t delta_prev = it == m_segments.begin() ? 0 : std::prev(it)->delta;
+            it = m_segments.insert(it, segment{m_zone_end, delta_prev});
+        }
+
+        for (; it != m_segments.end(); ++it)
+            it->delta += delta;
+    }
+
+    /**
+     * Mark the end of a mutation.
+     *
+     * @param block_count number of blocks after the mutation.
+     */
+    void end_edit(SizeT block_count)
+    {
+        m_in_edit = false;
+
+        if (m_segments.empty())
+            return;
+
+        // Re-align the segments past the edit zone with the current block
+        // indices.
+        for (segment& seg : m_segments)
+        {
+            if (seg.start >= m_zone_end)
+                seg.start = seg.start + block_count - m_zone_block_count;
+        }
+
+        // Remove the segments that no longer cover any blocks, as well as the
+        // segments that don't change the delta.
+        auto it_dest = m_segments.begin();
+        int64_t delta_prev = 0;
+
+        for (auto it = m_segments.begin(); it != m_segments.end() && it->start < block_count; ++it)
+        {
+            if (it_dest != m_segments.begin() && std::prev(it_dest)->start == it->start)
+            {
+                // The previous segment has become empty.
+                --it_dest;
+                delta_prev = it_dest == m_segments.begin() ? 0 : std::prev(it_dest)->delta;
+            }
+
+            if (it->delta == delta_prev)
+                continue;
+
+            delta_prev = it->delta;
+            *it_dest++ = *it;
+        }
+
+        m_segments.erase(it_dest, m_segments.end());
+    }
+};
+
+/**
+ * Pool of released element blocks kept for reuse, keyed by element type.
+ * A pooled block is empty but retains the capacity of its store, so that
+ * re-creating a block of the same type neither allocates the block object
+ * nor its store.
+ *
+ * @tparam BlockFuncs block functions used to manipulate the element blocks.
+ * @tparam MaxPerType maximum number of blocks to keep per element type.
+ */
+template<typename BlockFuncs, std::size_t MaxPerType>
+class element_block_pool
+{
+    struct bucket
+    {
+        element_t type;
+        std::vector<base_element_block*> blocks;
+    };
+
+    // The number of element types in use is typically small, so a linear
+    // search is faster than a hash lookup here.
+    std::vector<bucket> m_buckets;
+
+    bucket& get_bucket(element_t type)
+    {
+        for (bucket& b : m_buckets)
+        {
+            if (b.type == type)
+                return b;
+        }
+
+        m_buckets.push_back(bucket{type, {}});
+        m_buckets.back().blocks.reserve(MaxPerType);
+        return m_buckets.back();
+    }
+
+public:
+    element_block_pool() = default;
+    element_block_pool(const element_block_pool&) = delete;
+    element_block_pool& operator=(const element_block_pool&) = delete;
+
+    /**
+     * The pooled blocks belong to the instance only; moving the container
+     * leaves the pool behind.
+     */
+    element_block_pool(element_block_pool&&) noexcept
+    {}
+
+    element_block_pool& operator=(element_block_pool&&) noexcept
+    {
+        return *this;
+    }
+
+    ~element_block_pool()
+    {
+        clear();
+    }
+
+    /**
+     * Take a pooled block of the specified type out of the pool.
+     *
+     * @param type element type of the block to take.
+     *
+     * @return pointer to an empty block of the specified type, or nullptr if
+     *         the pool has no blocks of that type.
+     */
+    base_element_block* acquire(element_t type) noexcept
+    {
+        for (bucket& b : m_buckets)
+        {
+            if (b.type != type)
+                continue;
+
+            if (b.blocks.empty())
+                return nullptr;
+
+            base_element_block* blk = b.blocks.back();
+            b.blocks.pop_back();
+            return blk;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Put a block into the pool after emptying it, or delete it if the pool
+     * for its type is already full.
+     *
+     * @param blk block to release.  The pool takes ownership of it.
+     */
+    void release(base_element_block* blk)
+    {
+        try
+        {
+            std::vector<base_element_block*>& blocks = get_bucket(get_block_type(*blk)).blocks;
+            if (blocks.size() < MaxPerType)
+            {
+                BlockFuncs::clear_block(*blk);
+                blocks.push_back(blk);
+                return;
+            }
+        }
+        catch (...)
+        {
+            // Fall back to deleting the block.
+        }
+
+        BlockFuncs::delete_block(blk);
+    }
+
+    /**
+     * Delete all pooled blocks.
+     */
+    void clear() noexcept
+    {
+        for (bucket& b : m_buckets)
+        {
+            for (base_element_block* blk : b.blocks)
+                BlockFuncs::delete_block(blk);
+        }
+
+        m_buckets.clear();
+    }
+
+    /**
+     * @return total number of blocks currently in the pool.
+     */
+    std::size_t size() const noexcept
+    {
+        std::size_t n = 0;
+        for (const bucket& b : m_buckets)
+            n += b.blocks.size();
+
+        return n;
+    }
+
+    /**
+     * @return memory used by the blocks currently in the pool.
+     */
+    element_block_memory_usage memory_usage() const
+    {
+        element_block_memory_usage usage;
+        for (const bucket& b : m_buckets)
+        {
+            for (const base_element_block* blk : b.blocks)
+                usage += BlockFuncs::memory_usage(*blk);
+        }
+
+        return usage;
+    }
+};
+
 }}}} // namespace mdds::mtv::soa::detail
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,139 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "./main.hpp"
+
+#include <mutex>
+#include <utility>
+
+namespace mdds { namespace mtv { namespace soa {
+
+/**
+ * Wrapper around multi_type_vector that lets a single writer thread modify
+ * the container while any number of reader threads read it, without the
+ * readers having to lock the container or to wait for each other.
+ *
+ * <p>The writer modifies the wrapped container via store() and makes its
+ * changes visible to the readers by calling publish(), which takes a
+ * snapshot of the container and atomically replaces the published one with
+ * it.  The readers call read() to get the latest published snapshot, and
+ * read from it for as long as they need to.  The changes published after a
+ * reader has obtained its snapshot are not visible via that snapshot.
+ * Obtaining a snapshot only involves copying a view, which holds a shared
+ * pointer, under a short-lived lock; reading from it involves no locking at all.</p>
+ *
+ * <p>A published version is freed when the last snapshot referencing it
+ * goes away, which happens in whichever thread drops that last reference.
+ * Likewise, an element block shared between versions is only freed when
+ * the last version referencing it goes away, so that no block ever gets
+ * freed while a reader may still be reading it.</p>
+ *
+ * <p>Enable copy-on-write in the traits in order for publish() to share the
+ * element blocks with the container instead of cloning them, and for the
+ * readers to be able to read the shared blocks safely while the writer
+ * keeps modifying the container.</p>
+ *
+ * @tparam Traits traits type of the wrapped container.
+ */
+template<typename Traits = mdds::mtv::default_traits>
+class concurrent_vector
+{
+public:
+    using store_type = multi_type_vector<Traits>;
+    using const_view = typename store_type::const_view;
+
+    /**
+     * Default constructor.  It wraps an empty container and publishes its
+     * initial state.
+     */
+    concurrent_vector() : concurrent_vector(store_type())
+    {}
+
+    /**
+     * Constructor that takes the initial content of the container, and
+     * publishes it.
+     *
+     * @param store initial content of the container.
+     */
+    explicit concurrent_vector(store_type store) : m_store(std::move(store)), m_published(m_store.snapshot())
+    {}
+
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+    /**
+     * Get the wrapped container for modification.  Only the writer thread
+     * may call this method and access the returned container, and the
+     * modifications made to it are not visible to the readers until the
+     * next call to publish().
+     *
+     * @return reference to the wrapped container.
+     */
+    store_type& store() noexcept
+    {
+        return m_store;
+    }
+
+    /**
+     * Publish the current content of the wrapped container to the readers.
+     * Only the writer thread may call this method.
+     *
+     * @exception mdds::mtv::element_block_error No specialization exists for
+     *                at least one affected value type.
+     */
+    void publish()
+    {
+        const_view published = m_store.snapshot();
+
+        {
+            std::lock_guard lock(m_mtx);
+            std::swap(m_published, published);
+        }
+
+        // The previous version gets released here outside the lock, as
+        // freeing it may take a while.
+    }
+
+    /**
+     * Modify the wrapped container via the specified function, and publish
+     * the result.  Only the writer thread may call this method.  When the
+     * function throws, nothing gets published and the exception propagates
+     * to the caller.
+     *
+     * @param func function that takes a reference to the wrapped container
+     *             as its only argument.
+     */
+    template<typename Func>
+    void modify(Func&& func)
+    {
+        std::forward<Func>(func)(m_store);
+        publish();
+    }
+
+    /**
+     * Get the latest published version of the container.  This method may
+     * be called from any number of threads concurrently, including while
+     * the writer thread modifies or publishes the container.
+     *
+     * @return read-only view of the latest published version.
+     */
+    const_view read() const
+    {
+        std::lock_guard lock(m_mtx);
+        return m_published;
+    }
+
+private:
+    store_type m_store;
+    mutable std::mutex m_mtx;
+    const_view m_published;
+};
+
+}}} // namespace mdds::mtv::soa
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
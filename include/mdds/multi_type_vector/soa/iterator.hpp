@@ -7,8 +7,13 @@
 #pragma once
 
 #include "../iterator_node.hpp"
+#include "../types.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <ostream>
+#include <span>
 
 namespace mdds { namespace mtv { namespace soa { namespace detail {
 
@@ -27,6 +32,10 @@ namespace mdds { namespace mtv { namespace soa { namespace detail {
  *     <li><code>sizes_type</code></li>
  *     <li><code>element_blocks_type</code></li>
  * </ul>
+ *
+ * It also needs to have a static <code>block_position()</code> function that
+ * takes a pointer to the parent container and an iterator into its positions
+ * array, and returns the logical position of the block.
  */
 template<typename Traits>
 class iterator_updater
@@ -118,7 +127,7 @@ protected:
             throw general_error("Current node position should never equal the end position during node update.");
 #endif
 
-        m_cur_node.position = *m_pos.position_iterator;
+        m_cur_node.position = Traits::block_position(m_cur_node.__private_data.parent, m_pos.position_iterator);
         m_cur_node.size = *m_pos.size_iterator;
         m_cur_node.data = *m_pos.element_block_iterator;
 
@@ -369,6 +378,152 @@ std::ostream& operator<<(std::ostream& os, const const_iterator_base<Traits, Non
     return os;
 }
 
+/**
+ * Range of the values of a specific element block type stored within a
+ * range of logical positions, which iterates over the blocks of that type
+ * and yields the values of each block as a span over its contiguous
+ * storage.  The blocks of other types and the empty blocks get skipped by
+ * only inspecting the block store arrays, without building an iterator
+ * node for each block.
+ *
+ * The block store type needs to have the <code>sizes</code> and
+ * <code>element_blocks</code> arrays as well as the
+ * <code>get_position()</code> method that returns the logical position of
+ * a block.
+ *
+ * @tparam BlockStoreT type of the block store of the parent container.
+ * @tparam Blk element block type whose values to iterate over.
+ */
+template<typename BlockStoreT, typename Blk>
+    requires std::contiguous_iterator<decltype(Blk::cbegin(std::declval<const base_element_block&>()))>
+class typed_block_range
+{
+    using size_type = std::size_t;
+
+    /**
+     * Block store and the bounds of the range, shared by the range and its
+     * iterators so that the iterators remain valid after the range object
+     * itself goes away.
+     */
+    struct bounds_type
+    {
+        const BlockStoreT* store = nullptr;
+        size_type block_index_end = 0;
+        size_type start_pos = 0;
+        size_type end_pos = 0;
+    };
+
+public:
+    class iterator
+    {
+        friend class typed_block_range;
+
+        bounds_type m_bounds;
+        size_type m_block_index = 0;
+
+        iterator(const bounds_type& bounds, size_type block_index) : m_bounds(bounds), m_block_index(block_index)
+        {
+            skip();
+        }
+
+        /**
+         * Move forward to the next block of the requested type, or to the
+         * end position.
+         */
+        void skip()
+        {
+            for (; m_block_index < m_bounds.block_index_end; ++m_block_index)
+            {
+                const base_element_block* data = m_bounds.store->element_blocks[m_block_index];
+                if (data && get_block_type(*data) == Blk::block_type)
+                    break;
+            }
+        }
+
+    public:
+        using value_type = std::span<const typename Blk::value_type>;
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() = default;
+
+        /**
+         * Get the values of the current block that are within the range.
+         */
+        value_type operator*() const
+        {
+            const BlockStoreT& store = *m_bounds.store;
+            size_type block_pos = store.get_position(m_block_index);
+            size_type start = std::max(m_bounds.start_pos, block_pos);
+            size_type end = std::min(m_bounds.end_pos + 1, block_pos + store.sizes[m_block_index]);
+
+            const base_element_block& data = *store.element_blocks[m_block_index];
+            return value_type(std::to_address(Blk::cbegin(data)) + (start - block_pos), end - start);
+        }
+
+        /**
+         * Get the logical position of the first value of the current span.
+         */
+        size_type position() const
+        {
+            return std::max(m_bounds.start_pos, m_bounds.store->get_position(m_block_index));
+        }
+
+        iterator& operator++()
+        {
+            ++m_block_index;
+            skip();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        bool operator==(const iterator& other) const noexcept
+        {
+            return m_bounds.store == other.m_bounds.store && m_block_index == other.m_block_index;
+        }
+    };
+
+    typed_block_range() = default;
+
+    /**
+     * Constructor.
+     *
+     * @param store block store of the parent container.
+     * @param block_index1 index of the block that contains the start
+     *                     position.
+     * @param block_index2 index of the block that contains the end position.
+     * @param start_pos start position of the range.
+     * @param end_pos end position of the range, inclusive.
+     */
+    typed_block_range(
+        const BlockStoreT* store, size_type block_index1, size_type block_index2, size_type start_pos,
+        size_type end_pos)
+        : m_bounds{store, block_index2 + 1, start_pos, end_pos}, m_block_index_begin(block_index1)
+    {}
+
+    iterator begin() const
+    {
+        return iterator(m_bounds, m_block_index_begin);
+    }
+
+    iterator end() const
+    {
+        return iterator(m_bounds, m_bounds.block_index_end);
+    }
+
+private:
+    bounds_type m_bounds;
+    size_type m_block_index_begin = 0;
+};
+
 }}}} // namespace mdds::mtv::soa::detail
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
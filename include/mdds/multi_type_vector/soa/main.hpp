@@ -7,6 +7,10 @@
 #pragma once
 
 #include "../../global.hpp"
+#include "../env.hpp"
+#include "../find.hpp"
+#include "../permute.hpp"
+#include "../reduce.hpp"
 #include "../types.hpp"
 #include "../util.hpp"
 #include "./block_util.hpp"
@@ -16,6 +20,10 @@
 #include <iostream>
 #endif
 
+#include <iosfwd>
+#include <memory>
+#include <span>
+
 namespace mdds { namespace mtv { namespace soa {
 
 /**
@@ -91,6 +99,12 @@ private:
         std::vector<size_type> sizes;
         std::vector<base_element_block*> element_blocks;
 
+        /**
+         * Block position shifts not yet applied to the positions array.  This
+         * is always empty unless the position shifts are deferred.
+         */
+        detail::pending_position_shifts<size_type> position_shifts;
+
         static constexpr bool nothrow_default_constructible_v =
             std::is_nothrow_default_constructible_v<std::vector<size_type>> &&
             std::is_nothrow_default_constructible_v<std::vector<base_element_block*>>;
@@ -132,6 +146,28 @@ private:
             element_blocks.push_back(slot.element_block);
         }
 
+        /**
+         * Get the logical position of a block, taking into account its pending
+         * position shift if any.
+         *
+         * @param index index of the block.
+         */
+        size_type get_position(size_type index) const
+        {
+            if (position_shifts.empty())
+                return positions[index];
+
+            return positions[index] + position_shifts.delta(index);
+        }
+
+        /**
+         * Apply all pending position shifts to the positions array.
+         */
+        void apply_position_shifts()
+        {
+            position_shifts.apply(positions);
+        }
+
         void erase(size_type index);
         void erase(size_type index, size_type size);
         void insert(size_type index, size_type size);
@@ -179,6 +215,16 @@ private:
         using element_blocks_iterator_type = typename element_blocks_type::iterator;
 
         using private_data_update = mdds::detail::mtv::private_data_forward_update<multi_type_vector, size_type>;
+
+        static size_type block_position(const parent* p, const positions_iterator_type& it)
+        {
+            const blocks_type& store = p->m_block_store;
+            if (store.position_shifts.empty())
+                return *it;
+
+            typename positions_type::const_iterator cit = it;
+            return store.get_position(cit - store.positions.cbegin());
+        }
     };
 
     struct const_iterator_trait
@@ -193,6 +239,16 @@ private:
         using element_blocks_iterator_type = typename element_blocks_type::const_iterator;
 
         using private_data_update = mdds::detail::mtv::private_data_forward_update<multi_type_vector, size_type>;
+
+        static size_type block_position(const parent* p, const positions_iterator_type& it)
+        {
+            const blocks_type& store = p->m_block_store;
+            if (store.position_shifts.empty())
+                return *it;
+
+            typename positions_type::const_iterator cit = it;
+            return store.get_position(cit - store.positions.cbegin());
+        }
     };
 
     struct reverse_iterator_trait
@@ -207,6 +263,16 @@ private:
         using element_blocks_iterator_type = typename element_blocks_type::reverse_iterator;
 
         using private_data_update = mdds::detail::mtv::private_data_no_update<multi_type_vector, size_type>;
+
+        static size_type block_position(const parent* p, const positions_iterator_type& it)
+        {
+            const blocks_type& store = p->m_block_store;
+            if (store.position_shifts.empty())
+                return *it;
+
+            typename positions_type::const_reverse_iterator cit = it;
+            return store.get_position(store.positions.crend() - cit - 1);
+        }
     };
 
     struct const_reverse_iterator_trait
@@ -221,6 +287,16 @@ private:
         using element_blocks_iterator_type = typename element_blocks_type::const_reverse_iterator;
 
         using private_data_update = mdds::detail::mtv::private_data_no_update<multi_type_vector, size_type>;
+
+        static size_type block_position(const parent* p, const positions_iterator_type& it)
+        {
+            const blocks_type& store = p->m_block_store;
+            if (store.position_shifts.empty())
+                return *it;
+
+            typename positions_type::const_reverse_iterator cit = it;
+            return store.get_position(store.positions.crend() - cit - 1);
+        }
     };
 
     struct element_block_deleter
@@ -259,6 +335,17 @@ public:
     using position_type = std::pair<iterator, size_type>;
     using const_position_type = std::pair<const_iterator, size_type>;
 
+    /**
+     * Range type returned by typed_range(), which yields the values of each
+     * block of the specified element block type as an
+     * <code>std::span</code> of const values.
+     *
+     * @tparam Blk element block type whose values to iterate over.  Its
+     *             store must keep the values in contiguous storage.
+     */
+    template<typename Blk>
+    using typed_range_type = detail::typed_block_range<blocks_type, Blk>;
+
     /**
      * value_type is the type of a block stored in the primary array.  It
      * consists of the following data members:
@@ -457,6 +544,64 @@ public:
      */
     multi_type_vector clone(event_func hdl) const;
 
+#if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+    /**
+     * Save the content of this container to a binary stream.  Only the
+     * standard element types are supported.
+     *
+     * <p>The state consists of a header, followed by a table that stores
+     * the element type, size and payload size of each block, followed by
+     * the payloads of the non-empty blocks in the same order.  Each payload
+     * starts at an 8-byte boundary relative to the top of the state.  The
+     * numeric values are stored as a contiguous array in the native byte
+     * order, the boolean values as one byte per value, and each string as
+     * its length in 8 bytes followed by its characters.</p>
+     *
+     * @param os output stream to write the state to.
+     *
+     * @exception mdds::mtv::element_block_error the container stores an
+     *                element type that is not one of the standard element
+     *                types.
+     */
+    void save_state(std::ostream& os) const;
+
+    /**
+     * Replace the content of this container with the state previously
+     * written by save_state().  The numeric values of each block get read
+     * in bulk as a single array rather than one value at a time.
+     *
+     * <p>Should the state be invalid, this container is left unchanged.</p>
+     *
+     * @param is input stream to load the state from.
+     *
+     * @exception mdds::invalid_arg_error the state is invalid, truncated,
+     *                or has been written on a platform of a different byte
+     *                order.
+     * @exception mdds::mtv::element_block_error the state stores an element
+     *                type that is not supported by this container.
+     */
+    void load_state(std::istream& is);
+
+    /**
+     * Replace the content of this container with the state previously
+     * written by save_state(), stored in a memory buffer such as a
+     * memory-mapped file.  The values of each numeric block get copied out
+     * of the buffer as a single array, and the buffer is no longer
+     * referenced once this call returns.
+     *
+     * <p>Should the state be invalid, this container is left unchanged.</p>
+     *
+     * @param buffer buffer that stores the state.
+     *
+     * @exception mdds::invalid_arg_error the state is invalid, truncated,
+     *                or has been written on a platform of a different byte
+     *                order.
+     * @exception mdds::mtv::element_block_error the state stores an element
+     *                type that is not supported by this container.
+     */
+    void load_state(std::span<const char> buffer);
+#endif
+
     /**
      * Given the logical position of an element, get the iterator of the block
      * where the element is located, and its offset from the first element of
@@ -705,6 +850,38 @@ public:
     template<typename T>
     iterator set(const iterator& pos_hint, size_type pos, const T& it_begin, const T& it_end);
 
+    /**
+     * Set multiple values of identical type to scattered positions in one
+     * call.  The result is the same as calling set() for each pair of
+     * position and value, but the layout of the affected blocks gets rebuilt
+     * in a single pass, without repeatedly splitting and merging blocks or
+     * searching for the block positions.
+     *
+     * <p>The positions must be sorted in strictly ascending order.  The
+     * method will throw an <code>mdds::invalid_arg_error</code> exception if
+     * they are not, or an <code>std::out_of_range</code> exception if any of
+     * the positions is outside the current container range.</p>
+     *
+     * <p>Calling this method will not change the size of the container.</p>
+     *
+     * <p>If an exception is thrown while building the new layout, the
+     * container is left unchanged.  In that case, the values passed to a
+     * managed element block are not taken over by the container, and their
+     * ownership stays with the caller.  The values landing in blocks of the
+     * same type get overwritten in place once the new layout is built.  If
+     * an exception is thrown at that point, the values overwritten before it
+     * remain in the container, as with set().</p>
+     *
+     * @param values span of pairs of position and value, where the position
+     *               is stored in the <code>first</code> member and the value
+     *               in the <code>second</code> member.
+     * @return iterator position pointing to the block where the first value
+     *         is set.  When no value is set because the span is empty, the
+     *         end iterator position is returned.
+     */
+    template<typename T, std::size_t Extent>
+    iterator set_batch(std::span<T, Extent> values);
+
     /**
      * Append a new value to the end of the container.
      *
@@ -753,6 +930,71 @@ public:
     template<typename T, typename... Args>
     iterator emplace_back(Args&&... args);
 
+    /**
+     * Append multiple values of identical type to the end of the container.
+     *
+     * When the last block is of the same type as the new values, the values
+     * get appended directly to the storage of that block, with a single
+     * reallocation at most.  Otherwise a new block is created to store all
+     * the new values.  The values are copied into the destination storage
+     * without any intermediate buffering.
+     *
+     * @param it_begin iterator that points to the beginning of the range of
+     *                 values to append.
+     * @param it_end iterator that points to the end-position of the range of
+     *               values to append.
+     *
+     * @return iterator position pointing to the block where the values are
+     *         appended, which in this case is always the last block of the
+     *         container.  When no value insertion occurs because the value
+     *         set is empty, the end iterator position is returned.
+     */
+    template<typename T>
+    iterator append_range(const T& it_begin, const T& it_end);
+
+    /**
+     * Append multiple values of identical type to the end of the container.
+     * This is equivalent of calling append_range() with the begin and end
+     * iterators of the span.
+     *
+     * @param values span of values to append.
+     *
+     * @return iterator position pointing to the block where the values are
+     *         appended, which in this case is always the last block of the
+     *         container.  When no value insertion occurs because the span is
+     *         empty, the end iterator position is returned.
+     */
+    template<typename T, std::size_t Extent>
+    iterator append(std::span<T, Extent> values);
+
+    /**
+     * Append values stored in externally owned memory to the end of the
+     * container, without copying them.  The values get stored in a new block
+     * of type Blk, whose store references the external memory instead of
+     * storing a copy of the values.  The store type of Blk must therefore be
+     * constructible from a span of its values, as is the case with
+     * mdds::mtv::external_vector.
+     *
+     * The external memory must outlive the container as well as all copies,
+     * clones and snapshots of it, and must not be modified while it is being
+     * referenced.  Any later modification of the block's content copies the
+     * values into a buffer owned by the block first.
+     *
+     * When the last block is already of type Blk, the values are instead
+     * copied and appended to that block, since no two adjacent blocks may be
+     * of the same type.  The values of that block get copied as well if the
+     * block references external memory.
+     *
+     * @param values span of the external values to append.
+     *
+     * @return iterator position pointing to the block where the values are
+     *         appended, which in this case is always the last block of the
+     *         container.  When no value insertion occurs because the span is
+     *         empty, the end iterator position is returned.
+     */
+    template<typename Blk>
+    iterator append_external(std::span<const typename Blk::value_type> values);
+
     /**
      * Insert multiple values of identical type to a specified position.
      * Existing values that occur at or below the specified position will get
@@ -817,6 +1059,191 @@ public:
     template<typename T>
     iterator insert(const iterator& pos_hint, size_type pos, const T& it_begin, const T& it_end);
 
+    /**
+     * Reduce the values of a specific element block type stored in a range
+     * of positions into a single value.  Elements of any other type in the
+     * range, including empty elements, are skipped one whole block at a
+     * time.  The values of each block are processed directly on the
+     * underlying storage of the block, using SIMD instructions where
+     * available.
+     *
+     * Note that the order in which the values get added may differ from the
+     * order in which they are stored, which may cause the result of a
+     * floating-point sum to differ slightly from that of a sequential sum.
+     * The result of the min and max operations is NaN when any of the
+     * floating-point values is NaN, as with the sum operation.
+     *
+     * @tparam Blk element block type to reduce the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param op operation to perform.  It must be one of the types defined
+     *           in the mdds::mtv::reduce_op namespace.
+     *
+     * @return result of the operation.  Refer to the documentation of each
+     *         operation type for its result type.
+     */
+    template<typename Blk, typename Op>
+    typename mdds::mtv::detail::reduce_state<Blk, Op>::result_type reduce(
+        size_type start_pos, size_type end_pos, Op op) const
+        requires(std::is_arithmetic_v<typename Blk::value_type> || std::is_same_v<Op, reduce_op::count>);
+
+    /**
+     * Find the first value equal to the specified value among the values of
+     * a specific element block type stored in a range of positions.  Blocks
+     * of any other type, including empty blocks, are skipped as a whole.
+     * The values of each block are searched directly on the underlying
+     * storage of the block, using memchr for single-byte integral values,
+     * SIMD compares for double and 32-bit integral values where available,
+     * and word-level searches for boolean values stored in bit_vector.
+     *
+     * @tparam Blk element block type to search the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param value value to search for.
+     *
+     * @return position object that references the first matching value, or
+     *         that references the end position when no value matches.
+     */
+    template<typename Blk>
+    const_position_type find_first(
+        size_type start_pos, size_type end_pos, const typename Blk::value_type& value) const;
+
+    /**
+     * Find the first value that satisfies a predicate among the values of a
+     * specific element block type stored in a range of positions.  Blocks of
+     * any other type, including empty blocks, are skipped as a whole.  For
+     * boolean values stored in bit_vector, the predicate gets evaluated
+     * once for each of the two values, and the values get searched a word
+     * at a time.
+     *
+     * @tparam Blk element block type to search the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param pred predicate that takes a value of the block type and returns
+     *             true when the value matches.  The same predicate instance
+     *             gets applied to the values in their stored order.
+     *
+     * @return position object that references the first matching value, or
+     *         that references the end position when no value matches.
+     */
+    template<typename Blk, typename Pred>
+    const_position_type find_if(size_type start_pos, size_type end_pos, Pred pred) const;
+
+    /**
+     * Count the values that satisfy a predicate among the values of a
+     * specific element block type stored in a range of positions.  Blocks of
+     * any other type, including empty blocks, are skipped as a whole.  For
+     * boolean values stored in bit_vector, the predicate gets evaluated
+     * once for each of the two values, and the values get counted a word at
+     * a time.
+     *
+     * @tparam Blk element block type to count the values of.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     * @param pred predicate that takes a value of the block type and returns
+     *             true when the value matches.
+     *
+     * @return number of the matching values.
+     */
+    template<typename Blk, typename Pred>
+    size_type count_if(size_type start_pos, size_type end_pos, Pred pred) const;
+
+    /**
+     * Get a range that iterates over the values of a specific element block
+     * type stored in a range of positions.  Each element of the range is an
+     * <code>std::span</code> over the contiguous values of one block of
+     * that type, trimmed to the specified position range.  Blocks of any
+     * other type, including empty blocks, get skipped without visiting their
+     * values.  The iterators of the returned range provide the position()
+     * method to get the logical position of the first value of the current
+     * span.
+     *
+     * <p>The returned range and its iterators get invalidated by any
+     * modification of the container.</p>
+     *
+     * @tparam Blk element block type whose values to iterate over.  Its
+     *             store must keep the values in contiguous storage.
+     *
+     * @param start_pos starting position of the range.
+     * @param end_pos ending position of the range, inclusive.
+     *
+     * @return range of spans over the values of the blocks of the specified
+     *         type.
+     */
+    template<typename Blk>
+    typed_range_type<Blk> typed_range(size_type start_pos, size_type end_pos) const;
+
+    /**
+     * Get a range that iterates over the values of a specific element block
+     * type stored in the entire container.  Refer to the other overload for
+     * the details.
+     *
+     * @tparam Blk element block type whose values to iterate over.
+     *
+     * @return range of spans over the values of the blocks of the specified
+     *         type.
+     */
+    template<typename Blk>
+    typed_range_type<Blk> typed_range() const;
+
+    /**
+     * Call a function for every block in the container, with the blocks
+     * split into chunks of contiguous blocks that get processed concurrently
+     * under the specified execution policy.  The chunks are formed such that
+     * each of them covers a roughly equal number of elements, and the blocks
+     * within each chunk are visited in their stored order by one worker.
+     *
+     * <p>The function gets called with the element type, the logical
+     * position of the first element, the number of elements, and the
+     * pointer to the element block of each block, in this order.  The block
+     * pointer is null and the element type is mtv::element_type_empty for
+     * an empty block.  The function may be called from multiple threads
+     * concurrently, and must not modify the container.</p>
+     *
+     * <p>Passing an instance of mdds::mtv::default_exec_policy makes all
+     * blocks get visited sequentially by the calling thread.  With any other
+     * policy, an exception thrown by the function is captured, the chunks
+     * not yet started are skipped, and the first captured exception gets
+     * rethrown once all workers are done.</p>
+     *
+     * @param policy execution policy to use, such as
+     *               std::execution::par or
+     *               mdds::mtv::default_exec_policy.
+     * @param func function to call for each block.
+     */
+    template<typename ExecPolicy, typename Func>
+    void parallel_for_each_block(ExecPolicy&& policy, Func func) const;
+
+    /**
+     * Map every block in the container to a value and reduce the mapped
+     * values into a single value, with the blocks split into chunks that get
+     * processed concurrently under the specified execution policy in the
+     * same manner as parallel_for_each_block().
+     *
+     * <p>The map function gets called with the same arguments as the
+     * function passed to parallel_for_each_block(), and must return a value
+     * convertible to T.  The mapped values within each chunk get reduced in
+     * block order first, after which the results of the chunks get reduced,
+     * again in block order, starting with the initial value.  The reduce
+     * function therefore needs to be associative but not commutative, and
+     * the result does not depend on the number of threads used.</p>
+     *
+     * @param policy execution policy to use.
+     * @param init initial value of the reduction.
+     * @param map function that maps each block to a value.
+     * @param reduce function that takes two values and returns the value
+     *               reduced from them.
+     *
+     * @return reduced value, or the initial value when the container is
+     *         empty.
+     */
+    template<typename ExecPolicy, typename T, typename MapFunc, typename ReduceFunc>
+    T parallel_reduce_blocks(ExecPolicy&& policy, T init, MapFunc map, ReduceFunc reduce) const;
+
     /**
      * Get the type of an element at specified position.
      *
@@ -1186,27 +1613,347 @@ public:
     void swap(size_type start_pos, size_type end_pos, multi_type_vector& other, size_type other_pos);
 
     /**
-     * Trim excess capacity from all non-empty blocks.
+     * Move the elements in the same range of positions from each of multiple
+     * source containers to the corresponding destination container, as if
+     * transfer() were called for each pair of containers.  This is meant
+     * for moving a range of rows across many columns at once.  The pairs of
+     * containers get processed concurrently under the specified execution
+     * policy, as they do not share any state with one another.
+     *
+     * <p>All arguments get validated before any container gets modified,
+     * so that invalid arguments for any one pair leave all containers
+     * untouched.  The method throws an <code>std::out_of_range</code>
+     * exception if the range is invalid for any of the source containers,
+     * or if any of the destination containers is not large enough to
+     * accommodate the elements being transferred.  It throws an
+     * mdds::invalid_arg_error exception if the numbers of the source and
+     * destination containers differ, if any of them is null, or if any
+     * container appears more than once among all of them.</p>
+     *
+     * <p>Passing an instance of mdds::mtv::default_exec_policy makes the
+     * pairs get processed sequentially by the calling thread.  With any
+     * other policy, the event handlers of the containers may be called from
+     * multiple threads concurrently.</p>
+     *
+     * @param policy execution policy to use, such as
+     *               std::execution::par or
+     *               mdds::mtv::default_exec_policy.
+     * @param sources source containers from which to move the elements.
+     * @param start_pos starting position of the range in each source
+     *                  container.
+     * @param end_pos ending position of the range in each source
+     *                container, inclusive.
+     * @param dests destination containers to which to move the elements.
+     *              The elements of each source container get moved to the
+     *              destination container at the same index.
+     * @param dest_pos position in each destination container to which the
+     *                 elements are to be moved.
+     */
+    template<typename ExecPolicy>
+    static void transfer(
+        ExecPolicy&& policy, std::span<multi_type_vector* const> sources, size_type start_pos, size_type end_pos,
+        std::span<multi_type_vector* const> dests, size_type dest_pos);
+
+    /**
+     * Swap the elements in the same range of positions between each of
+     * multiple pairs of containers, as if swap() were called for each pair
+     * of containers.  This is meant for swapping a range of rows across many
+     * columns at once.  The pairs of containers get processed concurrently
+     * under the specified execution policy, and all arguments get validated
+     * before any container gets modified, in the same manner as the
+     * multi-container variant of transfer().
+     *
+     * @param policy execution policy to use.
+     * @param containers1 first containers of the pairs.
+     * @param start_pos starting position of the range in each of the first
+     *                  containers.
+     * @param end_pos ending position of the range in each of the first
+     *                containers, inclusive.
+     * @param containers2 second containers of the pairs.  Each of the first
+     *                    containers swaps its elements with the second
+     *                    container at the same index.
+     * @param other_pos starting position of the range in each of the second
+     *                  containers.
+     */
+    template<typename ExecPolicy>
+    static void swap(
+        ExecPolicy&& policy, std::span<multi_type_vector* const> containers1, size_type start_pos,
+        size_type end_pos, std::span<multi_type_vector* const> containers2, size_type other_pos);
+
+    /**
+     * Reorder the elements of the container by a permutation of their
+     * positions.  After the call, the element at each position is the one
+     * that was previously at the position stored at the same index of the
+     * permutation.  This is meant for applying the result of sorting the
+     * rows of a table to each of its columns.
+     *
+     * <p>The block store gets rebuilt in a single pass, by gathering the
+     * values into new blocks in the order of the permutation.  Adjacent
+     * elements of the same type end up in the same block, and runs of
+     * elements that keep their relative order get copied in bulk.  This
+     * avoids the fragmentation of the blocks that results from setting the
+     * elements one at a time.  Managed elements get moved to the new blocks
+     * without being copied.</p>
+     *
+     * <p>The method throws an mdds::invalid_arg_error exception if the size
+     * of the permutation differs from the size of the container, or if any
+     * position appears in it more than once, and an
+     * <code>std::out_of_range</code> exception if any position in it is out
+     * of bound.  The container remains unchanged in either case.</p>
+     *
+     * @param perm permutation of the positions of the container.
+     */
+    void apply_permutation(std::span<const size_type> perm);
+
+    /**
+     * Reorder the elements of multiple containers of the same size by the
+     * same permutation of their positions, as if apply_permutation() were
+     * called for each container.  This is meant for applying the result of
+     * sorting the rows of a table to all of its columns at once.  The
+     * containers get processed concurrently under the specified execution
+     * policy, after the permutation and the containers have been validated.
+     *
+     * <p>In addition to the exceptions thrown by the single-container
+     * variant, the method throws an mdds::invalid_arg_error exception if
+     * any of the containers is null or appears more than once.  No
+     * container gets modified when any of the arguments is invalid.</p>
+     *
+     * @param policy execution policy to use, such as
+     *               std::execution::par or
+     *               mdds::mtv::default_exec_policy.
+     * @param containers containers to reorder.
+     * @param perm permutation of the positions of the containers.
+     */
+    template<typename ExecPolicy>
+    static void apply_permutation(
+        ExecPolicy&& policy, std::span<multi_type_vector* const> containers, std::span<const size_type> perm);
+
+    /**
+     * Trim excess capacity from all non-empty blocks, and delete the element
+     * blocks kept in the pool for reuse when the pooling is enabled.
      */
     void shrink_to_fit();
 
+    /**
+     * Report the amount of memory used by this container, broken down by
+     * the element types of the blocks, and the memory used by the block
+     * store.  The reported slack and front offset amounts indicate how much
+     * memory shrink_to_fit() may reclaim.
+     *
+     * @return memory usage of this container in bytes.
+     */
+    memory_usage_stats memory_usage() const;
+
+    /**
+     * Reclaim the memory occupied by the values that have been erased from
+     * the front of the element block stores but not yet released, such as
+     * the values erased from the front of delayed_delete_vector.  Unlike
+     * shrink_to_fit(), this does not release the excess capacity of the
+     * stores, but makes the reclaimed memory available for new values.
+     *
+     * @return number of the compacted blocks and the amount of the reclaimed
+     *         memory.
+     */
+    compaction_stats compact();
+
+    /**
+     * Same as above, except that it only compacts the blocks that overlap
+     * with the specified range of positions.  Call this repeatedly with
+     * successive ranges to spread the work of compacting a large container
+     * over time.
+     *
+     * @param start_pos position of the first element of the range.
+     * @param end_pos position of the last element of the range, inclusive.
+     *
+     * @return number of the compacted blocks and the amount of the reclaimed
+     *         memory.
+     */
+    compaction_stats compact(size_type start_pos, size_type end_pos);
+
     /**
      * Ensure that this container is the sole owner of its element blocks.  When
-     * copy-on-write is enabled and this container is currently borrowing shared
-     * blocks, this performs the deferred duplication of the blocks so that
-     * subsequent modifications no longer affect any other sharer.
+     * copy-on-write is enabled and any of its blocks are currently shared with
+     * other containers, this performs the deferred duplication of those blocks
+     * so that subsequent modifications no longer affect any other sharer.
      *
      * <p>It is a no-op when the container already owns its blocks, and when
      * copy-on-write is disabled.</p>
      *
-     * @note Mutating methods detach automatically; no need to call this
-     * explicitly ahead of time.  You may need to call this explicitly prior to
+     * @note Mutating methods detach the blocks they modify automatically; no
+     * need to call this explicitly ahead of time.  You may need to call this explicitly prior to
      * calling methods such as release() and release_range() especially when
      * you need to ensure that the memory addresses of the released elements
      * point to non-shared store.
      */
     void detach();
 
+    /**
+     * Scope object that defers the shifting of the block positions for the
+     * duration of a burst of structural edits, such as a series of insert(),
+     * insert_empty() or erase() calls.
+     *
+     * <p>While at least one session is active, each edit only updates the
+     * positions of the blocks around the edited range, and records the shift
+     * for the trailing blocks in a list of pending shifts instead of
+     * renumbering them right away.  Lookups take the pending shifts into
+     * account and therefore stay correct throughout the session.  The pending
+     * shifts get applied all at once when the last active session gets
+     * committed, either explicitly via commit() or on destruction.</p>
+     *
+     * <p>This gives the container the behavior of the
+     * position_shift_t::deferred policy for the lifetime of the session, and
+     * is useful when the container normally uses the immediate policy.</p>
+     *
+     * @note The container must outlive the session.
+     */
+    class edit_session
+    {
+        multi_type_vector* m_parent = nullptr;
+
+    public:
+        explicit edit_session(multi_type_vector& parent);
+        ~edit_session();
+
+        edit_session(const edit_session&) = delete;
+        edit_session& operator=(const edit_session&) = delete;
+
+        /**
+         * End this session.  When this is the last active session of the
+         * container, all the pending shifts of the block positions get
+         * applied.  Calling this more than once has no effect.
+         */
+        void commit();
+
+        /**
+         * @return true if this session has not been committed yet, false
+         *         otherwise.
+         */
+        bool active() const noexcept;
+    };
+
+    /**
+     * Start a new edit session on this container.
+     *
+     * @return edit session object which commits on destruction.
+     */
+    edit_session begin_edit_session();
+
+    /**
+     * Read-only view of an immutable version of a container, as taken by
+     * snapshot().  The view stays valid and keeps its content regardless of
+     * any modification made to the container afterward, or even after the
+     * container gets destroyed.
+     *
+     * <p>A view only provides the const accessors of the container, and
+     * holds the version it references via a shared pointer; copying a view
+     * is therefore a constant-time operation, and all copies reference the
+     * same version.  The version gets freed when the last view referencing
+     * it goes away.</p>
+     *
+     * <p>A view may be read concurrently from multiple threads, and while
+     * the container it has been taken from is being modified, provided
+     * that copy-on-write is enabled.  Each view instance itself must not be
+     * modified, e.g. assigned to, while it is being read.</p>
+     */
+    class const_view
+    {
+        friend class multi_type_vector;
+
+        std::shared_ptr<const multi_type_vector> m_store;
+
+        explicit const_view(std::shared_ptr<const multi_type_vector> store);
+
+    public:
+        const_view(const const_view&) = default;
+        const_view(const_view&&) noexcept = default;
+        const_view& operator=(const const_view&) = default;
+        const_view& operator=(const_view&&) noexcept = default;
+
+        /**
+         * @return reference to the immutable container that this view
+         *         references.
+         */
+        const multi_type_vector& store() const noexcept;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator rend() const;
+
+        const_reverse_iterator crbegin() const;
+        const_reverse_iterator crend() const;
+
+        size_type size() const;
+        size_type block_size() const;
+        bool empty() const;
+
+        template<typename T>
+        void get(size_type pos, T& value) const;
+
+        template<typename T>
+        T get(size_type pos) const;
+
+        mtv::element_t get_type(size_type pos) const;
+        bool is_empty(size_type pos) const;
+
+        const_position_type position(size_type pos) const;
+        const_position_type position(const const_iterator& pos_hint, size_type pos) const;
+
+        template<typename Blk, typename Op>
+        typename mdds::mtv::detail::reduce_state<Blk, Op>::result_type reduce(
+            size_type start_pos, size_type end_pos, Op op) const
+            requires(std::is_arithmetic_v<typename Blk::value_type> || std::is_same_v<Op, reduce_op::count>);
+
+        template<typename Blk>
+        const_position_type find_first(
+            size_type start_pos, size_type end_pos, const typename Blk::value_type& value) const;
+
+        template<typename Blk, typename Pred>
+        const_position_type find_if(size_type start_pos, size_type end_pos, Pred pred) const;
+
+        template<typename Blk, typename Pred>
+        size_type count_if(size_type start_pos, size_type end_pos, Pred pred) const;
+
+        template<typename Blk>
+        typed_range_type<Blk> typed_range(size_type start_pos, size_type end_pos) const;
+
+        template<typename Blk>
+        typed_range_type<Blk> typed_range() const;
+
+        template<typename ExecPolicy, typename Func>
+        void parallel_for_each_block(ExecPolicy&& policy, Func func) const;
+
+        template<typename ExecPolicy, typename T, typename MapFunc, typename ReduceFunc>
+        T parallel_reduce_blocks(ExecPolicy&& policy, T init, MapFunc map, ReduceFunc reduce) const;
+
+        memory_usage_stats memory_usage() const;
+
+        bool operator==(const const_view& other) const;
+        bool operator==(const multi_type_vector& other) const;
+    };
+
+    /**
+     * Take a snapshot of the current content of this container.  The
+     * returned view keeps referencing the content as of this call, and is
+     * not affected by any subsequent modification of this container.
+     *
+     * <p>With copy-on-write enabled, the snapshot shares all element blocks
+     * with this container, which makes this call proportional to the number
+     * of blocks rather than to the number of elements, and only the blocks
+     * that this container modifies afterward get duplicated.  Without
+     * copy-on-write, it performs a full clone() of this container.</p>
+     *
+     * @return read-only view of the current content of this container.
+     *
+     * @exception mdds::mtv::element_block_error No specialization exists for at
+     *                least one affected value type.
+     */
+    const_view snapshot() const;
+
     bool operator==(const multi_type_vector& other) const;
 
     multi_type_vector& operator=(const multi_type_vector& other);
@@ -1238,6 +1985,26 @@ private:
 
     void delete_element_blocks(size_type start, size_type end);
 
+    /**
+     * Create a new empty element block of the specified type.  A pooled block
+     * gets reused when the block pooling is enabled and a block of the same
+     * type is available.  No element block events are fired.
+     *
+     * @param cat element type of the block to create.
+     *
+     * @return pointer to the new block.
+     */
+    base_element_block* create_element_block(element_t cat);
+
+    /**
+     * Free an element block that is no longer used by the container, by
+     * either putting it into the pool or deleting it.  No element block
+     * events are fired.
+     *
+     * @param data pointer to the block to free.  It may be null.
+     */
+    void free_element_block(base_element_block* data);
+
     template<typename T>
     void get_impl(size_type pos, T& value) const;
 
@@ -1327,6 +2094,15 @@ private:
     template<typename T, typename... Args>
     iterator emplace_back_impl(Args&&... args);
 
+    template<typename T>
+    iterator append_range_impl(const T& it_begin, const T& it_end);
+
+    template<typename Blk>
+    iterator append_external_impl(std::span<const typename Blk::value_type> values);
+
+    template<typename T, std::size_t Extent>
+    iterator set_batch_impl(std::span<T, Extent> values, size_type block_index1, size_type block_index2);
+
     template<typename T>
     iterator set_cells_impl(
         size_type row, size_type end_row, size_type block_index1, const T& it_begin, const T& it_end);
@@ -1373,6 +2149,121 @@ private:
      */
     size_type get_block_position(const typename value_type::private_data& pos_data, size_type row) const;
 
+    /**
+     * Search the values of a specific element block type stored in a range
+     * of positions one block at a time, and stop at the first block that
+     * contains a match.
+     *
+     * @param method_name name of the calling method, used in the error
+     *                    message when the range is invalid.
+     * @param find_block function that takes an element block, the offset of
+     *                   the first value to search within the block and the
+     *                   number of the values to search, and returns the
+     *                   offset of the first match from the first value
+     *                   searched, or the number of the values searched when
+     *                   there is no match.
+     */
+    template<typename Blk, typename Func>
+    const_position_type find_in_blocks(
+        const char* method_name, size_type start_pos, size_type end_pos, Func find_block) const;
+
+    /**
+     * Split the blocks into chunks of contiguous blocks that each cover a
+     * roughly equal number of elements, for the parallel block traversal.
+     *
+     * @param max_chunks maximum number of chunks to split the blocks into.
+     *
+     * @return list of the index ranges of the chunks, each represented by a
+     *         pair of the index of its first block and the index past its
+     *         last block.
+     */
+    std::vector<std::pair<size_type, size_type>> get_block_chunks(size_type max_chunks) const;
+
+    /**
+     * Validate the arguments of a range transfer or swap across multiple
+     * pairs of containers, before any of them gets modified.
+     *
+     * @param method_name name of the calling method, used in the error
+     *                    messages.
+     */
+    static void check_container_pairs(
+        const char* method_name, std::span<multi_type_vector* const> sources, size_type start_pos,
+        size_type end_pos, std::span<multi_type_vector* const> dests, size_type dest_pos);
+
+    /**
+     * Call a function for each index of a list of containers or pairs of
+     * containers, either sequentially or concurrently depending on the
+     * execution policy.
+     */
+    template<typename ExecPolicy, typename Func>
+    static void for_each_container(ExecPolicy& policy, std::size_t count, Func func);
+
+    /**
+     * Reorder the elements by a permutation that has already been
+     * validated.
+     */
+    void apply_permutation_impl(std::span<const size_type> perm);
+
+    /**
+     * Whether or not the shifts of the block positions are currently being
+     * deferred.  This is the case when the traits enable it, when an edit
+     * session is active, or when the shifts deferred during an earlier
+     * session are still pending e.g. in a copy made during the session.
+     */
+    bool is_position_shift_deferred() const
+    {
+        if constexpr (Traits::position_shift == position_shift_t::deferred)
+            return true;
+
+        return m_edit_session_depth > 0 || !m_block_store.position_shifts.empty();
+    }
+
+    /**
+     * Shift the logical positions of the blocks starting with the specified
+     * block.  When the position shifts are deferred, only the blocks in the
+     * current edit zone get their positions updated right away.
+     *
+     * @param start_block_index index of the first block to shift.
+     * @param delta value to add to the block positions.
+     */
+    void adjust_block_positions(size_type start_block_index, int64_t delta);
+
+    /**
+     * Apply all deferred position shifts, so that the positions array stores
+     * the exact logical positions of all blocks.
+     */
+    void apply_position_shifts();
+
+#if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+    template<typename Reader>
+    void load_state_impl(Reader& reader);
+#endif
+
+    /**
+     * Scope object that brackets a mutation touching a limited range of
+     * blocks.  It does nothing unless the position shifts are deferred, in
+     * which case it makes the stored positions of the touched blocks and their
+     * immediate neighbors exact for the duration of the mutation.
+     */
+    class position_shift_scope
+    {
+        multi_type_vector* m_parent = nullptr;
+
+    public:
+        /**
+         * @param parent container being mutated.
+         * @param block_index index of the first block touched by the mutation.
+         * @param end_pos logical position of the last element touched by the
+         *                mutation.  Any value beyond the last element refers
+         *                to the last block.
+         */
+        position_shift_scope(multi_type_vector& parent, size_type block_index, size_type end_pos);
+        ~position_shift_scope();
+
+        position_shift_scope(const position_shift_scope&) = delete;
+        position_shift_scope& operator=(const position_shift_scope&) = delete;
+    };
+
     template<typename T>
     void create_new_block_with_new_cell(size_type block_index, T&& cell);
 
@@ -1407,6 +2298,17 @@ private:
     template<typename T>
     void set_cell_to_top_of_data_block(size_type block_index, const T& cell);
 
+    /**
+     * Erase the first value of a non-empty block, and compact its store if
+     * the values erased from its front exceed the threshold set by the
+     * front_offset_compaction_ratio trait.
+     *
+     * @param data element block to erase the first value from.
+     */
+    void erase_first_value(base_element_block& data);
+
+    compaction_stats compact_blocks(size_type block_index1, size_type block_index2);
+
     template<typename T>
     void set_cell_to_bottom_of_data_block(size_type block_index, const T& cell);
 
@@ -1543,32 +2445,62 @@ private:
 
 private:
     /**
-     * Shared holder of borrowed element blocks under copy-on-write (COW).
-     * When a COW instance shares its storage, the block pointers are owned by
-     * one of these holders; the holder frees them exactly once when the last
-     * borrower leaves.
+     * Register this container as an additional owner of all its element
+     * blocks.  Called when the blocks of another container get shared with
+     * this one under copy-on-write (COW).
      */
-    struct shared_element_blocks
-    {
-        std::vector<base_element_block*> blocks;
+    void share_blocks();
 
-        ~shared_element_blocks()
-        {
-            for (base_element_block* p : blocks)
-                block_funcs::delete_block(p);
-        }
-    };
+    /**
+     * Non-tracing core of detach(), called from mutating methods that may
+     * modify any of the blocks.
+     */
+    void detach_impl();
 
     /**
-     * Called by the source store when transitioning from being the sole owner
-     * to one of borrowers.
+     * Replace each shared element block within the specified range with its
+     * own clone, so that the blocks in the range can be modified without
+     * affecting the other sharers.  The blocks outside the range are left
+     * shared.
+     *
+     * @param block_index1 index of the first block in the range.
+     * @param block_index2 index of the last block in the range, inclusive.
      */
-    void share() const;
+    void detach_blocks(size_type block_index1, size_type block_index2);
 
     /**
-     * Non-tracing core of detach(), called from mutating methods.
+     * Detach the blocks that a modification of the specified logical range
+     * may touch, which are the blocks covering the range plus their
+     * immediate neighbors that may get merged with them.
+     *
+     * @param block_index1 index of the block containing the start position.
+     * @param start_pos start position of the range.
+     * @param end_pos end position of the range, inclusive.
      */
-    void detach_impl();
+    void detach_range(size_type block_index1, size_type start_pos, size_type end_pos);
+
+    /**
+     * Detach the blocks that setting a single value at the specified position
+     * may touch.  Overwriting a value of the same type only modifies the
+     * block containing the position.
+     *
+     * @param block_index index of the block containing the position.
+     * @param pos position of the value to set.
+     * @param cat type of the value to set.
+     */
+    void detach_for_set(size_type block_index, size_type pos, element_t cat);
+
+    /**
+     * Detach the last block, which is the only block that may get modified
+     * when appending values to the end.
+     */
+    void detach_last_block();
+
+    /**
+     * Throw shared_block_error if any of the blocks within the specified
+     * range is shared with another container.
+     */
+    void check_blocks_not_shared(size_type block_index1, size_type block_index2, const char* method_name) const;
 
     using adjust_block_positions_func = detail::adjust_block_positions<blocks_type, Traits::loop_unrolling>;
 
@@ -1577,13 +2509,17 @@ private:
     size_type m_cur_size;
 
     /**
-     * Copy-on-write store.  This is null when the parent store doesn't have COW
-     * active & it fully owns the blocks.  When this is non-null the parent
-     * store simply borrows the blocks and this COW store owns the blocks and
-     * there may be multiple borrowers.
+     * Number of edit sessions currently active on this container.
+     */
+    size_type m_edit_session_depth = 0;
+
+    /**
+     * Pool of released element blocks kept for reuse.  This is an empty
+     * placeholder when the block pooling is disabled.
      */
-    [[no_unique_address]] mutable std::conditional_t<
-        Traits::enable_cow, std::shared_ptr<shared_element_blocks>, mtv::detail::empty_cow_store> m_cow_store;
+    [[no_unique_address]] std::conditional_t<
+        (Traits::block_pool_size > 0), detail::element_block_pool<block_funcs, Traits::block_pool_size>,
+        mtv::detail::empty_block_pool> m_block_pool;
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_TRACE
     mutable int m_trace_call_depth = 0;
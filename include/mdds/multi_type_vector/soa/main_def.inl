@@ -7,9 +7,18 @@
 #include "../env.hpp"
 #include "../util.hpp"
 #if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+#include "../serialize.hpp"
 #include "../standard_element_blocks.hpp"
 #endif
 
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
 namespace mdds { namespace mtv { namespace soa {
 
 namespace detail {
@@ -21,6 +30,21 @@ void erase(VecT& arr, SizeT index, SizeT size)
     arr.erase(it, it + size);
 }
 
+/**
+ * Replace each element block in the store with its copy.  The blocks get
+ * copied concurrently under the specified execution policy into a separate
+ * pre-sized store, which gets committed only once every block copy
+ * succeeds.
+ *
+ * Since an exception leaving the function invoked under an execution policy
+ * calls std::terminate, any exception thrown by a block copy gets captured
+ * inside the function, and gets re-thrown after all the blocks copied so
+ * far are freed.  Once one block copy fails, the remaining blocks are
+ * skipped.
+ *
+ * NB: the policy is passed as an lvalue, since some standard library
+ * implementations fail to compile with a policy passed as an rvalue.
+ */
 template<
     typename ExecPolicy, base_element_block* (*BlockOp)(const base_element_block&),
     void (*DeleteOp)(const base_element_block*)>
@@ -28,11 +52,41 @@ struct copy_blocks
 {
     void operator()(std::vector<base_element_block*>& element_blocks) const
     {
-        // No cleanup on exception here; an exception leaving BlockOp under an
-        // execution policy calls std::terminate.
+        std::vector<base_element_block*> owned(element_blocks.size(), nullptr);
+        std::exception_ptr error;
+        std::atomic<bool> failed{false};
+        std::mutex mtx;
+
+        ExecPolicy policy{};
         std::transform(
-            ExecPolicy{}, element_blocks.begin(), element_blocks.end(), element_blocks.begin(),
-            [](base_element_block* data) { return data ? BlockOp(*data) : nullptr; });
+            policy, element_blocks.begin(), element_blocks.end(), owned.begin(),
+            [&](base_element_block* data) -> base_element_block* {
+                if (!data || failed.load(std::memory_order_relaxed))
+                    return nullptr;
+
+                try
+                {
+                    return BlockOp(*data);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (!error)
+                        error = std::current_exception();
+                    failed.store(true, std::memory_order_relaxed);
+                    return nullptr;
+                }
+            });
+
+        if (error)
+        {
+            for (const base_element_block* p : owned)
+                if (p)
+                    DeleteOp(p);
+            std::rethrow_exception(error);
+        }
+
+        element_blocks.swap(owned);
     }
 };
 
@@ -72,7 +126,8 @@ struct mutate_blocks
 {
     void operator()(std::vector<base_element_block*>& element_blocks) const
     {
-        std::for_each(ExecPolicy{}, element_blocks.begin(), element_blocks.end(), [](base_element_block* data) {
+        ExecPolicy policy{};
+        std::for_each(policy, element_blocks.begin(), element_blocks.end(), [](base_element_block* data) {
             if (data)
                 BlockOp(*data);
         });
@@ -119,7 +174,8 @@ struct equal_blocks
 {
     bool operator()(const std::vector<base_element_block*>& lhs, const std::vector<base_element_block*>& rhs) const
     {
-        return std::equal(ExecPolicy{}, lhs.cbegin(), lhs.cend(), rhs.cbegin(), equal_blocks_pred<BlockOp>);
+        ExecPolicy policy{};
+        return std::equal(policy, lhs.cbegin(), lhs.cend(), rhs.cbegin(), equal_blocks_pred<BlockOp>);
     }
 };
 
@@ -132,6 +188,54 @@ struct equal_blocks<mdds::mtv::default_exec_policy, BlockOp>
     }
 };
 
+/**
+ * Get the maximum number of chunks to split the blocks into for a parallel
+ * block traversal.  The blocks get split into more chunks than there are
+ * hardware threads so that the workers can balance the load among
+ * themselves.
+ */
+inline std::size_t get_parallel_chunk_count()
+{
+    return std::max(1u, std::thread::hardware_concurrency()) * 4u;
+}
+
+/**
+ * Call a function for each chunk index under a non-default execution policy.
+ * An exception thrown by the function is captured instead of terminating
+ * the program, the chunks not yet started are skipped, and the first
+ * captured exception gets rethrown once all workers are done.
+ */
+template<typename ExecPolicy, typename Func>
+void for_each_chunk(ExecPolicy& policy, std::size_t chunk_count, Func func)
+{
+    std::vector<std::size_t> indices(chunk_count);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::exception_ptr error;
+    std::mutex mtx;
+    std::atomic<bool> failed{false};
+
+    std::for_each(policy, indices.begin(), indices.end(), [&](std::size_t index) {
+        if (failed.load(std::memory_order_relaxed))
+            return;
+
+        try
+        {
+            func(index);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!error)
+                error = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
 } // namespace detail
 
 template<typename Traits>
@@ -140,7 +244,8 @@ multi_type_vector<Traits>::blocks_type::blocks_type() noexcept(nothrow_default_c
 
 template<typename Traits>
 multi_type_vector<Traits>::blocks_type::blocks_type(mtv::detail::clone_construction_type, const blocks_type& other)
-    : positions(other.positions), sizes(other.sizes), element_blocks(other.element_blocks)
+    : positions(other.positions), sizes(other.sizes), element_blocks(other.element_blocks),
+      position_shifts(other.position_shifts)
 {
     if constexpr (Traits::enable_cow)
     {
@@ -157,7 +262,8 @@ multi_type_vector<Traits>::blocks_type::blocks_type(mtv::detail::clone_construct
 
 template<typename Traits>
 multi_type_vector<Traits>::blocks_type::blocks_type(const blocks_type& other)
-    : positions(other.positions), sizes(other.sizes), element_blocks(other.element_blocks)
+    : positions(other.positions), sizes(other.sizes), element_blocks(other.element_blocks),
+      position_shifts(other.position_shifts)
 {
     if constexpr (Traits::enable_cow)
     {
@@ -175,7 +281,7 @@ multi_type_vector<Traits>::blocks_type::blocks_type(const blocks_type& other)
 template<typename Traits>
 multi_type_vector<Traits>::blocks_type::blocks_type(blocks_type&& other) noexcept(nothrow_move_constructible_v)
     : positions(std::move(other.positions)), sizes(std::move(other.sizes)),
-      element_blocks(std::move(other.element_blocks))
+      element_blocks(std::move(other.element_blocks)), position_shifts(std::move(other.position_shifts))
 {}
 
 template<typename Traits>
@@ -255,6 +361,7 @@ void multi_type_vector<Traits>::blocks_type::swap(blocks_type& other) noexcept(n
     positions.swap(other.positions);
     sizes.swap(other.sizes);
     element_blocks.swap(other.element_blocks);
+    position_shifts.swap(other.position_shifts);
 }
 
 template<typename Traits>
@@ -268,8 +375,22 @@ void multi_type_vector<Traits>::blocks_type::reserve(size_type n)
 template<typename Traits>
 bool multi_type_vector<Traits>::blocks_type::equals(const blocks_type& other) const
 {
-    if (positions != other.positions)
-        return false;
+    if (position_shifts.empty() && other.position_shifts.empty())
+    {
+        if (positions != other.positions)
+            return false;
+    }
+    else
+    {
+        if (positions.size() != other.positions.size())
+            return false;
+
+        for (size_type i = 0; i < positions.size(); ++i)
+        {
+            if (get_position(i) != other.get_position(i))
+                return false;
+        }
+    }
 
     if (sizes != other.sizes)
         return false;
@@ -287,6 +408,7 @@ void multi_type_vector<Traits>::blocks_type::clear()
     positions.clear();
     sizes.clear();
     element_blocks.clear();
+    position_shifts.clear();
 }
 
 template<typename Traits>
@@ -467,8 +589,7 @@ multi_type_vector<Traits>::multi_type_vector(
     {
         // The m_block_store has been shallow-copied above; share the source's
         // blocks and defer the clone to first write.
-        other.share();
-        m_cow_store = other.m_cow_store;
+        share_blocks();
     }
 
     // NB: this must be done sequentially since it involves client-side callback.
@@ -498,8 +619,7 @@ multi_type_vector<Traits>::multi_type_vector(const multi_type_vector& other)
                 throw element_block_error("attempted to copy a noncopyable element block");
 
         // share the source's blocks and defer the copy to first write
-        other.share();
-        m_cow_store = other.m_cow_store;
+        share_blocks();
     }
 
     // NB: this must be done sequentially since it involves client-side callback.
@@ -517,7 +637,7 @@ multi_type_vector<Traits>::multi_type_vector(const multi_type_vector& other)
 template<typename Traits>
 multi_type_vector<Traits>::multi_type_vector(multi_type_vector&& other) noexcept(nothrow_move_constructible_v)
     : m_hdl_event(std::move(other.m_hdl_event)), m_block_store(std::move(other.m_block_store)),
-      m_cur_size(std::move(other.m_cur_size)), m_cow_store(std::move(other.m_cow_store))
+      m_cur_size(std::move(other.m_cur_size))
 {
     MDDS_MTV_TRACE_ARGS(constructor, "other=? (move)");
 
@@ -531,36 +651,20 @@ multi_type_vector<Traits>::~multi_type_vector()
 {
     MDDS_MTV_TRACE(destructor);
 
-    if constexpr (Traits::enable_cow)
-    {
-        if (m_cow_store)
-        {
-            // Borrowing: fire the logical release events but don't delete the
-            // blocks.
-            for (base_element_block* p : m_block_store.element_blocks)
-                if (p)
-                    m_hdl_event.element_block_released(p);
-            return;
-        }
-    }
-
-    // sole owner - delete blocks normally
+    // NB: the shared blocks get freed only by their last owner.
     delete_element_blocks(0, m_block_store.positions.size());
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::share() const
+void multi_type_vector<Traits>::share_blocks()
 {
     if constexpr (Traits::enable_cow)
     {
-        if (m_cow_store)
-            // The parent store already borrows from a shared holder.
-            return;
-
-        // Transfer ownership of the blocks from the parent store to a shared
-        // COW store.
-        m_cow_store = std::make_shared<shared_element_blocks>();
-        m_cow_store->blocks = m_block_store.element_blocks;
+        for (const base_element_block* data : m_block_store.element_blocks)
+        {
+            if (data)
+                mtv::detail::add_block_owner(*data);
+        }
     }
 }
 
@@ -574,49 +678,136 @@ void multi_type_vector<Traits>::detach()
 
 template<typename Traits>
 void multi_type_vector<Traits>::detach_impl()
+{
+    if (!m_block_store.element_blocks.empty())
+        detach_blocks(0, m_block_store.element_blocks.size() - 1);
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::detach_blocks(size_type block_index1, size_type block_index2)
 {
     if constexpr (Traits::enable_cow)
     {
-        if (!m_cow_store)
-            // The parent store is already the sole owner of the blocks.
-            return;
+        assert(block_index1 <= block_index2);
+        assert(block_index2 < m_block_store.element_blocks.size());
 
-        // Clone all blocks into a fresh store, committing only once every clone
-        // succeeds.
-        std::vector<base_element_block*> owned(m_block_store.element_blocks.size(), nullptr);
+        auto it_begin = m_block_store.element_blocks.begin() + block_index1;
+        auto it_end = m_block_store.element_blocks.begin() + block_index2 + 1;
 
-        try
+        auto is_shared = [](const base_element_block* data) {
+            return data && mtv::detail::is_block_shared(*data);
+        };
+
+        auto it_first = std::find_if(it_begin, it_end, is_shared);
+        if (it_first == it_end)
+            // All blocks in the range are already solely owned.
+            return;
+
+        // Clone the shared blocks under the execution policy.  If a clone
+        // throws, the partial clones get freed before the exception
+        // propagates, and the store is left as if nothing was detached.
+        std::vector<base_element_block*> owned(it_first, it_end);
+        for (base_element_block*& data : owned)
         {
-            for (size_type i = 0; i < owned.size(); ++i)
-                if (base_element_block* p = m_block_store.element_blocks[i])
-                    owned[i] = block_funcs::clone_block(*p);
+            if (!is_shared(data))
+                data = nullptr;
         }
-        catch (...)
+
+        detail::copy_blocks<typename Traits::exec_policy, block_funcs::clone_block, block_funcs::delete_block>{}(
+            owned);
+
+        // All shared blocks have been successfully cloned.  Swap them in and
+        // leave the originals to the other owners.  NB: this must be done
+        // sequentially since it involves client-side callback.
+        size_type offset = std::distance(m_block_store.element_blocks.begin(), it_first);
+        for (size_type i = 0; i < owned.size(); ++i)
         {
-            // clone_block has thrown, free the partial clones and rethrow;
-            // the store should still be left as if detach() was not called,
-            // without leaks.
-            for (base_element_block* c : owned)
-                if (c)
-                    block_funcs::delete_block(c);
-            throw;
+            if (!owned[i])
+                continue;
+
+            base_element_block*& data = m_block_store.element_blocks[offset + i];
+            m_hdl_event.element_block_released(data);
+            m_hdl_event.element_block_acquired(owned[i]);
+            free_element_block(data);
+            data = owned[i];
         }
+    }
+    else
+    {
+        (void)block_index1;
+        (void)block_index2;
+    }
+}
 
-        // All blocks have been successfully cloned.  Transfer them to the
-        // parent store.
-        for (size_type i = 0; i < owned.size(); ++i)
+template<typename Traits>
+void multi_type_vector<Traits>::detach_range(size_type block_index1, size_type start_pos, size_type end_pos)
+{
+    if constexpr (Traits::enable_cow)
+    {
+        size_type n_blocks = m_block_store.positions.size();
+        if (block_index1 >= n_blocks)
+            // Let the caller report the invalid position.
+            return;
+
+        size_type block_index2 = get_block_position(std::min(end_pos, m_cur_size - 1), block_index1);
+        if (block_index2 >= n_blocks)
+            block_index2 = n_blocks - 1;
+
+        if (block_index1 > 0)
+            --block_index1;
+
+        if (block_index2 + 1 < n_blocks)
+            ++block_index2;
+
+        detach_blocks(block_index1, block_index2);
+    }
+    else
+    {
+        (void)block_index1;
+        (void)start_pos;
+        (void)end_pos;
+    }
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::detach_for_set(size_type block_index, size_type pos, element_t cat)
+{
+    const base_element_block* data = m_block_store.element_blocks[block_index];
+    if (data && mdds::mtv::get_block_type(*data) == cat)
+        detach_blocks(block_index, block_index);
+    else
+        detach_range(block_index, pos, pos);
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::detach_last_block()
+{
+    if (!m_block_store.element_blocks.empty())
+        detach_blocks(m_block_store.element_blocks.size() - 1, m_block_store.element_blocks.size() - 1);
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::check_blocks_not_shared(
+    size_type block_index1, size_type block_index2, const char* method_name) const
+{
+    if constexpr (Traits::enable_cow)
+    {
+        for (size_type i = block_index1; i <= block_index2 && i < m_block_store.element_blocks.size(); ++i)
         {
-            if (owned[i])
+            const base_element_block* data = m_block_store.element_blocks[i];
+            if (data && mtv::detail::is_block_shared(*data))
             {
-                m_hdl_event.element_block_released(m_block_store.element_blocks[i]);
-                m_hdl_event.element_block_acquired(owned[i]);
-                m_block_store.element_blocks[i] = owned[i];
+                std::ostringstream os;
+                os << method_name << ": requires sole ownership; call detach() first";
+                throw shared_block_error(os.str());
             }
         }
-
-        // Leave the COW borrower state.  The original blocks will be freed once
-        // the last borrower leaves.
-        m_cow_store.reset();
+    }
+    else
+    {
+        (void)block_index1;
+        (void)block_index2;
+        (void)method_name;
     }
 }
 
@@ -636,6 +827,78 @@ auto multi_type_vector<Traits>::clone(event_func hdl) const -> multi_type_vector
     return multi_type_vector(mtv::detail::clone_construction_type{}, *this, std::move(hdl));
 }
 
+#if MDDS_MTV_USE_STANDARD_ELEMENT_BLOCKS
+template<typename Traits>
+void multi_type_vector<Traits>::save_state(std::ostream& os) const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    mtv::detail::write_state(os, m_cur_size, m_block_store.positions.size(), [this](size_type i) {
+        return std::pair<size_type, const base_element_block*>(
+            m_block_store.sizes[i], m_block_store.element_blocks[i]);
+    });
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::load_state(std::istream& is)
+{
+    MDDS_MTV_TRACE(mutator);
+
+    mtv::detail::istream_state_reader reader(is);
+    load_state_impl(reader);
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::load_state(std::span<const char> buffer)
+{
+    MDDS_MTV_TRACE(mutator);
+
+    mtv::detail::buffer_state_reader reader(buffer);
+    load_state_impl(reader);
+}
+
+template<typename Traits>
+template<typename Reader>
+void multi_type_vector<Traits>::load_state_impl(Reader& reader)
+{
+    auto loaded = mtv::detail::read_state<block_funcs>(reader);
+
+    blocks_type store;
+    size_type cur_size = 0;
+
+    try
+    {
+        store.reserve(loaded.size());
+    }
+    catch (...)
+    {
+        for (const auto& blk : loaded)
+            block_funcs::delete_block(blk.data);
+        throw;
+    }
+
+    for (const auto& blk : loaded)
+    {
+        store.push_back(cur_size, blk.size, blk.data);
+        cur_size += blk.size;
+    }
+
+    clear();
+    m_block_store.swap(store);
+    m_cur_size = cur_size;
+
+    for (const base_element_block* data : m_block_store.element_blocks)
+    {
+        if (data)
+            m_hdl_event.element_block_acquired(data);
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    debug_check_full("load_state");
+#endif
+}
+#endif
+
 template<typename Traits>
 void multi_type_vector<Traits>::delete_element_block(size_type block_index)
 {
@@ -645,7 +908,7 @@ void multi_type_vector<Traits>::delete_element_block(size_type block_index)
         return;
 
     m_hdl_event.element_block_released(data);
-    block_funcs::delete_block(data);
+    free_element_block(data);
     m_block_store.element_blocks[block_index] = nullptr;
 }
 
@@ -656,6 +919,37 @@ void multi_type_vector<Traits>::delete_element_blocks(size_type start, size_type
         delete_element_block(i);
 }
 
+template<typename Traits>
+auto multi_type_vector<Traits>::create_element_block(element_t cat) -> base_element_block*
+{
+    if constexpr (Traits::block_pool_size > 0)
+    {
+        if (base_element_block* data = m_block_pool.acquire(cat); data)
+            return data;
+    }
+
+    return block_funcs::create_new_block(cat, 0);
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::free_element_block(base_element_block* data)
+{
+    if (!data)
+        return;
+
+    if constexpr (Traits::enable_cow)
+    {
+        if (!mtv::detail::remove_block_owner(*data))
+            // Other containers still share this block.
+            return;
+    }
+
+    if constexpr (Traits::block_pool_size > 0)
+        m_block_pool.release(data);
+    else
+        block_funcs::delete_block(data);
+}
+
 template<typename Traits>
 template<typename T>
 void multi_type_vector<Traits>::get_impl(size_type pos, T& value) const
@@ -674,7 +968,7 @@ void multi_type_vector<Traits>::get_impl(size_type pos, T& value) const
         return;
     }
 
-    size_type start_row = m_block_store.positions[block_index];
+    size_type start_row = m_block_store.get_position(block_index);
     assert(pos >= start_row);
     size_type offset = pos - start_row;
     mdds_mtv_get_value(*data, offset, value);
@@ -698,7 +992,7 @@ typename multi_type_vector<Traits>::position_type multi_type_vector<Traits>::pos
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::position", __LINE__, pos, block_size(), size());
 
-    size_type start_pos = m_block_store.positions[block_index];
+    size_type start_pos = m_block_store.get_position(block_index);
 
     iterator it = get_iterator(block_index);
     return position_type(it, pos - start_pos);
@@ -724,7 +1018,7 @@ typename multi_type_vector<Traits>::position_type multi_type_vector<Traits>::pos
             "multi_type_vector::position", __LINE__, pos, block_size(), size());
 
     iterator it = get_iterator(block_index);
-    size_type start_pos = m_block_store.positions[block_index];
+    size_type start_pos = m_block_store.get_position(block_index);
     return position_type(it, pos - start_pos);
 }
 
@@ -745,7 +1039,7 @@ typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::position", __LINE__, pos, block_size(), size());
 
-    size_type start_pos = m_block_store.positions[block_index];
+    size_type start_pos = m_block_store.get_position(block_index);
 
     const_iterator it = get_const_iterator(block_index);
     return const_position_type(it, pos - start_pos);
@@ -770,7 +1064,7 @@ typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits
             "multi_type_vector::position", __LINE__, pos, block_size(), size());
 
     const_iterator it = get_const_iterator(block_index);
-    size_type start_pos = m_block_store.positions[block_index];
+    size_type start_pos = m_block_store.get_position(block_index);
     return const_position_type(it, pos - start_pos);
 }
 
@@ -784,21 +1078,24 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::transfer
     if (&dest == this)
         throw invalid_arg_error("You cannot transfer between the same container.");
 
-    // COW: transfer mutates dest's storage too, so both sides must own their blocks.
-    detach_impl();
-    dest.detach_impl();
-
     size_type block_index1 = get_block_position(start_pos);
     if (block_index1 == m_block_store.positions.size())
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::transfer", __LINE__, start_pos, block_size(), size());
 
+    // COW: transfer mutates dest's storage too, so both sides must own the
+    // blocks being modified.
+    detach_range(block_index1, start_pos, end_pos);
+    dest.detach_range(dest.get_block_position(dest_pos), dest_pos, dest_pos + end_pos - start_pos);
+
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block, os_prev_block_dest;
     dump_blocks(os_prev_block);
     dest.dump_blocks(os_prev_block_dest);
 #endif
 
+    apply_position_shifts();
+    dest.apply_position_shifts();
     iterator ret = transfer_impl(start_pos, end_pos, block_index1, dest, dest_pos);
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
@@ -845,21 +1142,24 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::transfer
     if (&dest == this)
         throw invalid_arg_error("You cannot transfer between the same container.");
 
-    // COW: transfer mutates dest's storage too, so both sides must own their blocks.
-    detach_impl();
-    dest.detach_impl();
-
     size_type block_index1 = get_block_position(pos_hint->__private_data, start_pos);
     if (block_index1 == m_block_store.positions.size())
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::transfer", __LINE__, start_pos, block_size(), size());
 
+    // COW: transfer mutates dest's storage too, so both sides must own the
+    // blocks being modified.
+    detach_range(block_index1, start_pos, end_pos);
+    dest.detach_range(dest.get_block_position(dest_pos), dest_pos, dest_pos + end_pos - start_pos);
+
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block, os_prev_block_dest;
     dump_blocks(os_prev_block);
     dest.dump_blocks(os_prev_block_dest);
 #endif
 
+    apply_position_shifts();
+    dest.apply_position_shifts();
     iterator ret = transfer_impl(start_pos, end_pos, block_index1, dest, dest_pos);
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
@@ -901,19 +1201,23 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set(size
 {
     MDDS_MTV_TRACE_ARGS(mutator, "pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
 
-    detach_impl();
-
     size_type block_index = get_block_position(pos);
     if (block_index == m_block_store.positions.size())
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::set", __LINE__, pos, block_size(), size());
 
+    detach_for_set(block_index, pos, mdds_mtv_get_element_type(value));
+
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    iterator ret = set_impl(pos, block_index, value);
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = set_impl(pos, block_index, value);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -944,19 +1248,23 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set(
         mutator_with_pos_hint,
         "pos_hint=" << pos_hint << "; pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
 
-    detach_impl();
-
     size_type block_index = get_block_position(pos_hint->__private_data, pos);
     if (block_index == m_block_store.positions.size())
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::set", __LINE__, pos, block_size(), size());
 
+    detach_for_set(block_index, pos, mdds_mtv_get_element_type(value));
+
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    iterator ret = set_impl(pos, block_index, value);
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = set_impl(pos, block_index, value);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -991,8 +1299,6 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set(
     if (!res.second)
         return make_end();
 
-    detach_impl();
-
     size_type end_pos = res.first;
     size_type block_index1 = get_block_position(pos);
 
@@ -1000,12 +1306,18 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set(
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::set", __LINE__, pos, block_size(), size());
 
+    detach_range(block_index1, pos, end_pos);
+
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    auto ret = set_cells_impl(pos, end_pos, block_index1, it_begin, it_end);
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index1, end_pos);
+        ret = set_cells_impl(pos, end_pos, block_index1, it_begin, it_end);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -1040,17 +1352,20 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set(
     if (!res.second)
         return make_end();
 
-    detach_impl();
-
     size_type end_pos = res.first;
     size_type block_index1 = get_block_position(pos_hint->__private_data, pos);
+    detach_range(block_index1, pos, end_pos);
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    auto ret = set_cells_impl(pos, end_pos, block_index1, it_begin, it_end);
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index1, end_pos);
+        ret = set_cells_impl(pos, end_pos, block_index1, it_begin, it_end);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -1073,19 +1388,46 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set(
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_back(T&& value)
+template<typename T, std::size_t Extent>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_batch(std::span<T, Extent> values)
 {
-    MDDS_MTV_TRACE_ARGS(mutator, "value=? (type=" << mdds_mtv_get_element_type(value) << ")");
+    MDDS_MTV_TRACE_ARGS(mutator, "values=? (length=" << values.size() << ")");
 
-    detach_impl();
+    if (values.empty())
+        return make_end();
+
+    for (std::size_t i = 1; i < values.size(); ++i)
+    {
+        if (values[i - 1].first >= values[i].first)
+        {
+            std::ostringstream os;
+            os << "multi_type_vector::set_batch: positions are not in strictly ascending order (index=" << i
+               << "; previous position=" << values[i - 1].first << "; position=" << values[i].first << ")";
+            throw invalid_arg_error(os.str());
+        }
+    }
+
+    size_type start_pos = values.front().first;
+    size_type end_pos = values.back().first;
+
+    if (end_pos >= m_cur_size)
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::set_batch", __LINE__, end_pos, block_size(), size());
+
+    size_type block_index1 = get_block_position(start_pos);
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    detach_range(block_index1, start_pos, end_pos);
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    auto ret = push_back_impl(std::forward<T>(value));
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index1, end_pos);
+        ret = set_batch_impl(values, block_index1, block_index2);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -1096,7 +1438,8 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_bac
     {
         std::ostringstream os;
         os << e.what() << std::endl;
-        os << "block integrity check failed in push_back" << std::endl;
+        os << "block integrity check failed in set_batch (start_pos=" << start_pos << "; end_pos=" << end_pos << ")"
+           << std::endl;
         os << "previous block state:" << std::endl;
         os << os_prev_block.str();
         std::cerr << os.str() << std::endl;
@@ -1108,36 +1451,82 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_bac
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_back_empty()
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_back(T&& value)
 {
-    MDDS_MTV_TRACE(mutator);
+    MDDS_MTV_TRACE_ARGS(mutator, "value=? (type=" << mdds_mtv_get_element_type(value) << ")");
 
-    detach_impl();
+    detach_last_block();
 
-    size_type block_index = m_block_store.positions.size();
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
 
-    if (!append_empty(1))
+    iterator ret;
     {
-        // Last empty block has been extended.
-        --block_index;
+        position_shift_scope shift_scope(*this, m_block_store.positions.size(), m_cur_size);
+        ret = push_back_impl(std::forward<T>(value));
     }
 
-    // Get the iterator of the last block.
-    return get_iterator(block_index);
-}
-
-template<typename Traits>
-template<typename T, typename... Args>
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in push_back" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+
+    return ret;
+}
+
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::push_back_empty()
+{
+    MDDS_MTV_TRACE(mutator);
+
+    // NB: appending empty cells only modifies the last block when it's empty,
+    // so there is nothing to detach.
+    size_type block_index = m_block_store.positions.size();
+
+    {
+        position_shift_scope shift_scope(*this, m_block_store.positions.size(), m_cur_size);
+        if (!append_empty(1))
+        {
+            // Last empty block has been extended.
+            --block_index;
+        }
+    }
+
+    // Get the iterator of the last block.
+    return get_iterator(block_index);
+}
+
+template<typename Traits>
+template<typename T, typename... Args>
 typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::emplace_back(Args&&... args)
 {
-    detach_impl();
+    detach_last_block();
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    auto ret = emplace_back_impl<T>(std::forward<Args>(args)...);
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, m_block_store.positions.size(), m_cur_size);
+        ret = emplace_back_impl<T>(std::forward<Args>(args)...);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -1159,6 +1548,103 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::emplace_
     return ret;
 }
 
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append_range(
+    const T& it_begin, const T& it_end)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "it_begin=?; it_end=? (length=" << std::distance(it_begin, it_end) << ")");
+
+    if (it_begin == it_end)
+        return make_end();
+
+    detach_last_block();
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, m_block_store.positions.size(), m_cur_size);
+        ret = append_range_impl(it_begin, it_end);
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in append_range" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+
+    return ret;
+}
+
+template<typename Traits>
+template<typename T, std::size_t Extent>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append(std::span<T, Extent> values)
+{
+    return append_range(values.begin(), values.end());
+}
+
+template<typename Traits>
+template<typename Blk>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append_external(
+    std::span<const typename Blk::value_type> values)
+{
+    static_assert(
+        std::is_constructible_v<typename Blk::store_type, std::span<const typename Blk::value_type>>,
+        "the store type of the block must be able to reference external values.");
+
+    MDDS_MTV_TRACE_ARGS(mutator, "values=? (length=" << values.size() << ")");
+
+    if (values.empty())
+        return make_end();
+
+    detach_last_block();
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, m_block_store.positions.size(), m_cur_size);
+        ret = append_external_impl<Blk>(values);
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in append_external" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+
+    return ret;
+}
+
 template<typename Traits>
 template<typename T>
 typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert(
@@ -1167,19 +1653,23 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert(
     MDDS_MTV_TRACE_ARGS(
         mutator, "pos=" << pos << "it_begin=?; it_end=? (length=" << std::distance(it_begin, it_end) << ")");
 
-    detach_impl();
-
     size_type block_index = get_block_position(pos);
     if (block_index == m_block_store.positions.size())
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::insert", __LINE__, pos, block_size(), size());
 
+    detach_range(block_index, pos, pos);
+
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    iterator ret = insert_cells_impl(pos, block_index, it_begin, it_end);
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = insert_cells_impl(pos, block_index, it_begin, it_end);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -1212,19 +1702,23 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert(
         mutator_with_pos_hint, "pos_hint=" << pos_hint << "; pos=" << pos << "; it_begin=?; it_end=? (length="
                                            << std::distance(it_begin, it_end) << ")");
 
-    detach_impl();
-
     size_type block_index = get_block_position(pos_hint->__private_data, pos);
     if (block_index == m_block_store.positions.size())
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::insert", __LINE__, pos, block_size(), size());
 
+    detach_range(block_index, pos, pos);
+
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
-    iterator ret = insert_cells_impl(pos, block_index, it_begin, it_end);
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = insert_cells_impl(pos, block_index, it_begin, it_end);
+    }
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
@@ -1320,2946 +1814,4084 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::emplace_
 }
 
 template<typename Traits>
-mtv::element_t multi_type_vector<Traits>::get_type(size_type pos) const
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append_range_impl(
+    const T& it_begin, const T& it_end)
 {
-    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos);
+    assert(it_begin != it_end);
 
-    size_type block_index = get_block_position(pos);
-    if (block_index == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::get_type", __LINE__, pos, block_size(), size());
+    size_type length = std::distance(it_begin, it_end);
+    element_t cat = mdds_mtv_get_element_type(*it_begin);
+    base_element_block* last_data =
+        m_block_store.element_blocks.empty() ? nullptr : m_block_store.element_blocks.back();
 
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-    if (!blk_data)
-        return mtv::element_type_empty;
+    if (!last_data || cat != get_block_type(*last_data))
+    {
+        // Either there is no block, or the last block is empty or of different
+        // type.  Append a new block to store all the new values.
+        size_type block_index = m_block_store.positions.size();
 
-    return mtv::get_block_type(*blk_data);
-}
+        std::unique_ptr<base_element_block, element_block_deleter> data(
+            mdds_mtv_create_new_block(*it_begin, it_begin, it_end));
+        if (!data)
+            throw general_error("Failed to create new block.");
 
-template<typename Traits>
-bool multi_type_vector<Traits>::is_empty(size_type pos) const
-{
-    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos);
+        m_block_store.push_back(m_cur_size, length, data.get());
+        m_hdl_event.element_block_acquired(data.release());
+        m_cur_size += length;
 
-    size_type block_index = get_block_position(pos);
-    if (block_index == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::is_empty", __LINE__, pos, block_size(), size());
+        return get_iterator(block_index);
+    }
 
-    return m_block_store.element_blocks[block_index] == nullptr;
+    // Append the new values to the last block.
+    size_type block_index = m_block_store.positions.size() - 1;
+
+    mdds_mtv_append_values(*last_data, *it_begin, it_begin, it_end);
+    m_block_store.sizes.back() += length;
+    m_cur_size += length;
+
+    return get_iterator(block_index);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty(
-    size_type start_pos, size_type end_pos)
+template<typename Blk>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::append_external_impl(
+    std::span<const typename Blk::value_type> values)
 {
-    MDDS_MTV_TRACE_ARGS(mutator, "start_pos=" << start_pos << "; end_pos=" << end_pos);
+    assert(!values.empty());
 
-    detach_impl();
+    size_type length = values.size();
+    base_element_block* last_data =
+        m_block_store.element_blocks.empty() ? nullptr : m_block_store.element_blocks.back();
 
-    size_type block_index1 = get_block_position(start_pos);
-    if (block_index1 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::set_empty", __LINE__, start_pos, block_size(), size());
+    if (last_data && get_block_type(*last_data) == Blk::block_type)
+    {
+        // Append the values to the last block, which copies them.
+        size_type block_index = m_block_store.positions.size() - 1;
 
-    return set_empty_impl(start_pos, end_pos, block_index1, true);
-}
+        Blk::append_values(*last_data, values.begin(), values.end());
+        m_block_store.sizes.back() += length;
+        m_cur_size += length;
 
-template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty(
-    const iterator& pos_hint, size_type start_pos, size_type end_pos)
-{
-    MDDS_MTV_TRACE_ARGS(
-        mutator_with_pos_hint, "pos_hint=" << pos_hint << "; start_pos=" << start_pos << "; end_pos=" << end_pos);
+        return get_iterator(block_index);
+    }
 
-    detach_impl();
+    // Append a new block that references the external values.
+    size_type block_index = m_block_store.positions.size();
 
-    size_type block_index1 = get_block_position(pos_hint->__private_data, start_pos);
-    if (block_index1 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::set_empty", __LINE__, start_pos, block_size(), size());
+    std::unique_ptr<base_element_block, element_block_deleter> data(Blk::create_block(0));
+    Blk::get(*data).store() = typename Blk::store_type(values);
 
-    return set_empty_impl(start_pos, end_pos, block_index1, true);
+    m_block_store.push_back(m_cur_size, length, data.get());
+    m_hdl_event.element_block_acquired(data.release());
+    m_cur_size += length;
+
+    return get_iterator(block_index);
 }
 
+
 template<typename Traits>
-void multi_type_vector<Traits>::erase(size_type start_pos, size_type end_pos)
+template<typename T, std::size_t Extent>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_batch_impl(
+    std::span<T, Extent> values, size_type block_index1, size_type block_index2)
 {
-    MDDS_MTV_TRACE_ARGS(mutator, "start_pos=" << start_pos << "; end_pos=" << end_pos);
-
-    if (start_pos > end_pos)
-        throw std::out_of_range("Start row is larger than the end row.");
+    assert(!values.empty());
 
-    detach_impl();
+    const element_t cat = mdds_mtv_get_element_type(values.front().second);
+    const size_type start_pos = values.front().first;
+    const size_type old_block_count = block_index2 - block_index1 + 1;
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+    // Build the new layout of the blocks between block_index1 and
+    // block_index2 (inclusive) into a separate store, merging adjacent blocks
+    // of identical type along the way.  The blocks currently in the store are
+    // not modified until the new layout is complete, so that the container is
+    // left untouched if anything throws.  The blocks of the same type as the
+    // new values get carried over as they are and have their values
+    // overwritten in place, as do the blocks not receiving any new values,
+    // unless they need to be merged.  The values of the other blocks
+    // receiving new values get copied into new blocks.  The total size of
+    // these blocks stays the same, so the positions of the blocks that follow
+    // are not affected.  Each new value adds at most two blocks to the
+    // layout.
+    const size_type max_new_block_count = old_block_count + values.size() * 2;
+    blocks_type new_blocks;
+    new_blocks.reserve(max_new_block_count);
+    std::vector<bool> created; // whether each block in the new layout is newly created.
+    created.reserve(max_new_block_count);
+    std::vector<bool> carried(old_block_count, false); // whether each current block is carried over.
+    size_type last_carried = 0; // index of the last current block carried over.
+    size_type next_pos = m_block_store.positions[block_index1];
+
+    // Get the last block of the new layout to append values of the specified
+    // type to, or append a new block if the last block is of a different
+    // type.  When the last block is a carried-over block of the same type,
+    // it gets replaced with its copy.
+    auto get_tail_block = [&](element_t blk_cat) -> base_element_block& {
+        if (!created.empty())
+        {
+            base_element_block* src = new_blocks.element_blocks.back();
+            if (src && get_block_type(*src) == blk_cat)
+            {
+                if (created.back())
+                    return *src;
+
+                base_element_block* data = create_element_block(blk_cat);
+                if (!data)
+                    throw general_error("Failed to create new block.");
+
+                new_blocks.element_blocks.back() = data;
+                created.back() = true;
+                carried[last_carried] = false;
+                block_funcs::append_values_from_block(*data, *src, 0, new_blocks.sizes.back());
+                return *data;
+            }
+        }
 
-    erase_impl(start_pos, end_pos);
+        new_blocks.push_back(next_pos, 0, nullptr);
+        created.push_back(true);
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    try
-    {
-        check_block_integrity();
-    }
-    catch (const mdds::integrity_error& e)
-    {
-        std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in erase (" << start_pos << "-" << end_pos << ")" << std::endl;
-        os << "block integrity check failed in push_back" << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
-    }
-#endif
-}
+        base_element_block* data = create_element_block(blk_cat);
+        if (!data)
+            throw general_error("Failed to create new block.");
 
-template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_empty(size_type pos, size_type length)
-{
-    MDDS_MTV_TRACE_ARGS(mutator, "pos=" << pos << "; length=" << length);
+        new_blocks.element_blocks.back() = data;
+        return *data;
+    };
 
-    if (!length)
-        // Nothing to insert.
-        return make_end();
+    // Append a run of empty elements to the new layout.
+    auto append_empty = [&](size_type len) {
+        if (!created.empty() && !new_blocks.element_blocks.back())
+            new_blocks.sizes.back() += len;
+        else
+        {
+            new_blocks.push_back(next_pos, 0, nullptr);
+            new_blocks.sizes.back() = len;
+            created.push_back(true);
+        }
 
-    detach_impl();
+        next_pos += len;
+    };
 
-    size_type block_index = get_block_position(pos);
-    if (block_index == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::insert_empty", __LINE__, pos, block_size(), size());
+    // Append copies of the values of a current block to the new layout.
+    auto append_copies = [&](const base_element_block* data, size_type offset, size_type len) {
+        if (!data)
+        {
+            append_empty(len);
+            return;
+        }
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+        base_element_block& dest = get_tail_block(get_block_type(*data));
+        block_funcs::append_values_from_block(dest, *data, offset, len);
+        new_blocks.sizes.back() += len;
+        next_pos += len;
+    };
 
-    iterator ret = insert_empty_impl(pos, block_index, length);
+    auto it = values.begin();
+    blocks_type old_blocks;
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     try
     {
-        check_block_integrity();
-    }
-    catch (const mdds::integrity_error& e)
-    {
-        std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in insert_empty (pos=" << pos << "; length=" << length << ")" << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
-    }
-#endif
+        for (size_type bi = block_index1; bi <= block_index2; ++bi)
+        {
+            base_element_block* data = m_block_store.element_blocks[bi];
+            size_type blk_pos = m_block_store.positions[bi];
+            size_type blk_size = m_block_store.sizes[bi];
+            size_type blk_end = blk_pos + blk_size;
+
+            base_element_block* tail = created.empty() ? nullptr : new_blocks.element_blocks.back();
+            bool mergeable = data && tail && get_block_type(*tail) == get_block_type(*data);
+
+            auto it_blk_end = it;
+            while (it_blk_end != values.end() && it_blk_end->first < blk_end)
+                ++it_blk_end;
+
+            // A block of the same type as the new values gets merged with the
+            // next block when the first value of the next block gets
+            // overwritten.
+            bool same_type = data && get_block_type(*data) == cat;
+            bool merge_next = same_type && bi < block_index2 && it_blk_end != values.end() &&
+                              it_blk_end->first == blk_end;
+
+            if (it == it_blk_end || (same_type && !mergeable && !merge_next))
+            {
+                // This block either doesn't receive any new values or has
+                // them overwritten in place later.  Carry it over unless it
+                // needs to be merged with the last block of the new layout.
+                if (!data || mergeable)
+                    append_copies(data, 0, blk_size);
+                else
+                {
+                    new_blocks.push_back(next_pos, blk_size, data);
+                    created.push_back(false);
+                    last_carried = bi - block_index1;
+                    carried[last_carried] = true;
+                    next_pos += blk_size;
+                }
 
-    return ret;
-}
+                it = it_blk_end;
+                continue;
+            }
 
-template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_empty(
-    const iterator& pos_hint, size_type pos, size_type length)
-{
-    MDDS_MTV_TRACE_ARGS(mutator_with_pos_hint, "pos_hint=" << pos_hint << "; pos=" << pos << "; length=" << length);
+            // Copy the original values between the new values, and append the
+            // new values in between.
+            size_type cur = 0; // offset within the current block
 
-    if (!length)
-        // Nothing to insert.
-        return make_end();
+            for (; it != it_blk_end; ++it)
+            {
+                size_type offset = it->first - blk_pos;
+                if (offset > cur)
+                    append_copies(data, cur, offset - cur);
+
+                mdds_mtv_append_value(get_tail_block(cat), it->second);
+                ++new_blocks.sizes.back();
+                ++next_pos;
+                cur = offset + 1;
+            }
 
-    detach_impl();
+            if (cur < blk_size)
+                append_copies(data, cur, blk_size - cur);
+        }
 
-    size_type block_index = get_block_position(pos_hint->__private_data, pos);
-    if (block_index == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::insert_empty", __LINE__, pos, block_size(), size());
+        assert(it == values.end());
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+        // Keep the current blocks being replaced, to free them once the new
+        // layout is in place, and make room for the new layout in advance,
+        // so that nothing throws once the store starts getting modified.
+        old_blocks.reserve(old_block_count);
+        for (size_type bi = block_index1; bi <= block_index2; ++bi)
+            old_blocks.push_back(
+                m_block_store.positions[bi], m_block_store.sizes[bi], m_block_store.element_blocks[bi]);
 
-    iterator ret = insert_empty_impl(pos, block_index, length);
+        size_type block_count = m_block_store.positions.size();
+        m_block_store.reserve(block_count - old_block_count + new_blocks.positions.size());
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    try
+        // Overwrite the values landing in the carried blocks in place.  Only
+        // an exception thrown here leaves the container modified, with the
+        // values overwritten up to that point, as with set().
+        it = values.begin();
+
+        for (size_type i = 0; i < old_block_count; ++i)
+        {
+            base_element_block* data = old_blocks.element_blocks[i];
+            size_type blk_pos = old_blocks.positions[i];
+            size_type blk_end = blk_pos + old_blocks.sizes[i];
+
+            for (; it != values.end() && it->first < blk_end; ++it)
+            {
+                if (!carried[i])
+                    continue;
+
+                size_type offset = it->first - blk_pos;
+                block_funcs::overwrite_values(*data, offset, 1);
+                mdds_mtv_set_value(*data, offset, it->second);
+            }
+        }
+    }
+    catch (...)
     {
-        check_block_integrity();
+        // Release the blocks created so far.  They only store copies of the
+        // values of the current blocks or the new values, neither of which
+        // are owned by them.
+        for (size_type i = 0; i < created.size(); ++i)
+        {
+            base_element_block* data = new_blocks.element_blocks[i];
+            if (!created[i] || !data)
+                continue;
+
+            block_funcs::resize_block(*data, 0);
+            free_element_block(data);
+        }
+
+        throw;
     }
-    catch (const mdds::integrity_error& e)
+
+    // Replace the blocks with the new layout.
+    m_block_store.erase(block_index1, old_block_count);
+    m_block_store.insert(block_index1, new_blocks);
+
+    for (size_type i = 0; i < created.size(); ++i)
     {
-        std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in insert_empty (pos=" << pos << "; length=" << length << ")" << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
+        if (created[i] && new_blocks.element_blocks[i])
+            m_hdl_event.element_block_acquired(new_blocks.element_blocks[i]);
     }
-#endif
 
-    return ret;
+    // Free the replaced blocks.  The values being overwritten get deleted
+    // along the way, while the rest of their values now belong to the new
+    // blocks.
+    it = values.begin();
+
+    for (size_type i = 0; i < old_block_count; ++i)
+    {
+        base_element_block* data = old_blocks.element_blocks[i];
+        size_type blk_pos = old_blocks.positions[i];
+        size_type blk_end = blk_pos + old_blocks.sizes[i];
+
+        for (; it != values.end() && it->first < blk_end; ++it)
+        {
+            if (data && !carried[i])
+                block_funcs::overwrite_values(*data, it->first - blk_pos, 1);
+        }
+
+        if (!data || carried[i])
+            continue;
+
+        block_funcs::resize_block(*data, 0);
+        m_hdl_event.element_block_released(data);
+        free_element_block(data);
+    }
+
+    // Merge the new layout with the blocks on both sides if possible.
+    size_type block_index_last = block_index1 + new_blocks.positions.size() - 1;
+    merge_with_next_block(block_index_last);
+
+    if (block_index1 > 0)
+    {
+        if (merge_with_next_block(block_index1 - 1))
+            --block_index1;
+    }
+
+    return get_iterator(get_block_position(start_pos, block_index1));
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::clear()
+template<typename Blk, typename Op>
+typename mdds::mtv::detail::reduce_state<Blk, Op>::result_type multi_type_vector<Traits>::reduce(
+    size_type start_pos, size_type end_pos, Op /*op*/) const
+    requires(std::is_arithmetic_v<typename Blk::value_type> || std::is_same_v<Op, reduce_op::count>)
 {
-    MDDS_MTV_TRACE(mutator);
+    MDDS_MTV_TRACE_ARGS(accessor, "start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-    if constexpr (Traits::enable_cow)
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
+
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::reduce", __LINE__, start_pos, block_size(), size());
+
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::reduce", __LINE__, end_pos, block_size(), size());
+
+    mdds::mtv::detail::reduce_state<Blk, Op> state;
+
+    for (size_type i = block_index1; i <= block_index2; ++i)
     {
-        if (m_cow_store)
-        {
-            // Borrowing: fire the logical release events but let the holder free
-            // the shared blocks.
-            for (base_element_block* p : m_block_store.element_blocks)
-                if (p)
-                    m_hdl_event.element_block_released(p);
+        const base_element_block* data = m_block_store.element_blocks[i];
+        if (!data || get_block_type(*data) != Blk::block_type)
+            continue;
 
-            m_block_store.clear();
-            m_cur_size = 0;
-            m_cow_store.reset();
-            return;
-        }
+        size_type start_row = m_block_store.get_position(i);
+        size_type offset = i == block_index1 ? start_pos - start_row : 0;
+        size_type end = i == block_index2 ? end_pos - start_row + 1 : m_block_store.sizes[i];
+        state.add(*data, offset, end - offset);
     }
 
-    delete_element_blocks(0, m_block_store.element_blocks.size());
-    m_block_store.clear();
-    m_cur_size = 0;
+    return state.result();
 }
 
 template<typename Traits>
-template<typename T>
-bool multi_type_vector<Traits>::set_cells_precheck(
-    size_type pos, const T& it_begin, const T& it_end, size_type& end_pos)
+template<typename Blk>
+typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits>::find_first(
+    size_type start_pos, size_type end_pos, const typename Blk::value_type& value) const
 {
-    size_type length = std::distance(it_begin, it_end);
-    if (!length)
-        // empty data array.  nothing to do.
-        return false;
+    MDDS_MTV_TRACE_ARGS(accessor, "start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-    end_pos = pos + length - 1;
-    if (end_pos >= m_cur_size)
-        throw std::out_of_range("Data array is too long.");
+    return find_in_blocks<Blk>(
+        "multi_type_vector::find_first", start_pos, end_pos,
+        [&value](const base_element_block& data, size_type offset, size_type len) {
+            return mdds::mtv::detail::find_block_value<Blk>(data, offset, len, value);
+        });
+}
 
-    return true;
+template<typename Traits>
+template<typename Blk, typename Pred>
+typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits>::find_if(
+    size_type start_pos, size_type end_pos, Pred pred) const
+{
+    MDDS_MTV_TRACE_ARGS(accessor, "start_pos=" << start_pos << "; end_pos=" << end_pos);
+
+    return find_in_blocks<Blk>(
+        "multi_type_vector::find_if", start_pos, end_pos,
+        [&pred](const base_element_block& data, size_type offset, size_type len) {
+            return mdds::mtv::detail::find_block_value_if<Blk>(data, offset, len, pred);
+        });
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_impl(
-    size_type pos, size_type block_index, const T& value)
+template<typename Blk, typename Pred>
+typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::count_if(
+    size_type start_pos, size_type end_pos, Pred pred) const
 {
-    size_type start_row = m_block_store.positions[block_index];
+    MDDS_MTV_TRACE_ARGS(accessor, "start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-    size_type blk_size = m_block_store.sizes[block_index];
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-    assert(blk_size > 0); // block size should never be zero at any time.
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
 
-    assert(pos >= start_row);
-    size_type pos_in_block = pos - start_row;
-    assert(pos_in_block < blk_size);
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::count_if", __LINE__, start_pos, block_size(), size());
 
-    if (!blk_data)
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::count_if", __LINE__, end_pos, block_size(), size());
+
+    size_type count = 0;
+
+    for (size_type i = block_index1; i <= block_index2; ++i)
     {
-        // This is an empty block.
-        return set_cell_to_empty_block(block_index, pos_in_block, value);
+        const base_element_block* data = m_block_store.element_blocks[i];
+        if (!data || get_block_type(*data) != Blk::block_type)
+            continue;
+
+        size_type start_row = m_block_store.get_position(i);
+        size_type offset = i == block_index1 ? start_pos - start_row : 0;
+        size_type end = i == block_index2 ? end_pos - start_row + 1 : m_block_store.sizes[i];
+        count += mdds::mtv::detail::count_block_values_if<Blk>(*data, offset, end - offset, pred);
     }
 
-    element_t cat = mdds_mtv_get_element_type(value);
+    return count;
+}
 
-    assert(blk_data);
-    element_t blk_cat = mdds::mtv::get_block_type(*blk_data);
+template<typename Traits>
+template<typename Blk>
+typename multi_type_vector<Traits>::template typed_range_type<Blk> multi_type_vector<Traits>::typed_range(
+    size_type start_pos, size_type end_pos) const
+{
+    MDDS_MTV_TRACE_ARGS(accessor, "start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-    if (blk_cat == cat)
-    {
-        // This block is of the same type as the cell being inserted.
-        size_type i = pos - start_row;
-        block_funcs::overwrite_values(*blk_data, i, 1);
-        mdds_mtv_set_value(*blk_data, i, value);
-        return get_iterator(block_index);
-    }
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
 
-    assert(blk_cat != cat);
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::typed_range", __LINE__, start_pos, block_size(), size());
 
-    if (pos == start_row)
-    {
-        // t|???|x--|???|b - Insertion point is at the start of the block.
-        if (blk_size == 1)
-        {
-            // t|???|x|???|b
-            return set_cell_to_non_empty_block_of_size_one(block_index, value);
-        }
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::typed_range", __LINE__, end_pos, block_size(), size());
 
-        assert(blk_size > 1);
-        bool blk_prev = is_previous_block_of_type(block_index, cat);
-        if (blk_prev)
+    return typed_range_type<Blk>(&m_block_store, block_index1, block_index2, start_pos, end_pos);
+}
+
+template<typename Traits>
+template<typename Blk>
+typename multi_type_vector<Traits>::template typed_range_type<Blk> multi_type_vector<Traits>::typed_range() const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    if (m_block_store.positions.empty())
+        return typed_range_type<Blk>();
+
+    return typed_range_type<Blk>(&m_block_store, 0, m_block_store.positions.size() - 1, 0, m_cur_size - 1);
+}
+
+template<typename Traits>
+template<typename ExecPolicy, typename Func>
+void multi_type_vector<Traits>::parallel_for_each_block(ExecPolicy&& policy, Func func) const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    auto visit_blocks = [this, &func](size_type first, size_type last) {
+        for (size_type i = first; i < last; ++i)
         {
-            // t|xxx|x--|???|b - Append to the previous block.
-            m_block_store.sizes[block_index] -= 1;
-            m_block_store.positions[block_index] += 1;
-            block_funcs::overwrite_values(*m_block_store.element_blocks[block_index], 0, 1);
-            block_funcs::erase(*m_block_store.element_blocks[block_index], 0);
-            m_block_store.sizes[block_index - 1] += 1;
-            mdds_mtv_append_value(*m_block_store.element_blocks[block_index - 1], value);
-            return get_iterator(block_index - 1);
+            const base_element_block* data = m_block_store.element_blocks[i];
+            mtv::element_t type = data ? get_block_type(*data) : mtv::element_type_empty;
+            func(type, m_block_store.get_position(i), m_block_store.sizes[i], data);
         }
+    };
 
-        // t|---|x--|???|b
-        set_cell_to_top_of_data_block(block_index, value);
-        return get_iterator(block_index);
+    if constexpr (std::is_same_v<std::remove_cvref_t<ExecPolicy>, mdds::mtv::default_exec_policy>)
+    {
+        visit_blocks(0, m_block_store.positions.size());
     }
-
-    if (pos < (start_row + blk_size - 1))
+    else
     {
-        // t|???|-x-|???|b - Insertion point is in the middle of the block.
-        return set_cell_to_middle_of_block(block_index, pos_in_block, value);
+        auto chunks = get_block_chunks(detail::get_parallel_chunk_count());
+        detail::for_each_chunk(policy, chunks.size(), [&chunks, &visit_blocks](std::size_t index) {
+            visit_blocks(chunks[index].first, chunks[index].second);
+        });
     }
+}
 
-    // t|???|--x|???|b - Insertion point is at the end of the block.
-    assert(pos == (start_row + m_block_store.sizes[block_index] - 1));
-    assert(pos > start_row);
-    assert(m_block_store.sizes[block_index] > 1);
+template<typename Traits>
+template<typename ExecPolicy, typename T, typename MapFunc, typename ReduceFunc>
+T multi_type_vector<Traits>::parallel_reduce_blocks(ExecPolicy&& policy, T init, MapFunc map, ReduceFunc reduce) const
+{
+    MDDS_MTV_TRACE(accessor);
 
-    if (block_index == 0)
+    auto map_block = [this, &map](size_type index) -> T {
+        const base_element_block* data = m_block_store.element_blocks[index];
+        mtv::element_t type = data ? get_block_type(*data) : mtv::element_type_empty;
+        return map(type, m_block_store.get_position(index), m_block_store.sizes[index], data);
+    };
+
+    if constexpr (std::is_same_v<std::remove_cvref_t<ExecPolicy>, mdds::mtv::default_exec_policy>)
     {
-        if (m_block_store.positions.size() == 1)
-        {
-            // t|--x|b - This is the only block.
-            set_cell_to_bottom_of_data_block(0, value);
-            iterator itr = make_end();
-            return --itr;
-        }
+        T result = std::move(init);
+        for (size_type i = 0; i < m_block_store.positions.size(); ++i)
+            result = reduce(std::move(result), map_block(i));
 
-        bool blk_next = is_next_block_of_type(block_index, cat);
-        if (!blk_next)
-        {
-            // t|--x|---|b - Next block is of different type.
-            set_cell_to_bottom_of_data_block(0, value);
-            iterator itr = make_begin();
-            return ++itr;
-        }
+        return result;
+    }
+    else
+    {
+        auto chunks = get_block_chunks(detail::get_parallel_chunk_count());
 
-        // t|--x|xxx|b - Next block is of the same type as the new value.
+        // Reduce each chunk into its own slot, then combine the slots in
+        // chunk order so that the result doesn't depend on the scheduling.
+        std::vector<std::optional<T>> partials(chunks.size());
 
-        block_funcs::overwrite_values(*blk_data, blk_size - 1, 1);
-        block_funcs::erase(*blk_data, blk_size - 1);
-        m_block_store.sizes[block_index] -= 1;
-        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], value);
-        m_block_store.sizes[block_index + 1] += 1;
-        m_block_store.positions[block_index + 1] -= 1;
+        detail::for_each_chunk(policy, chunks.size(), [&](std::size_t index) {
+            auto [first, last] = chunks[index];
+            std::optional<T>& partial = partials[index];
+            partial.emplace(map_block(first));
+            for (size_type i = first + 1; i < last; ++i)
+                *partial = reduce(std::move(*partial), map_block(i));
+        });
 
-        return get_iterator(block_index + 1);
+        T result = std::move(init);
+        for (std::optional<T>& partial : partials)
+            result = reduce(std::move(result), std::move(*partial));
+
+        return result;
     }
+}
 
-    assert(block_index > 0);
+template<typename Traits>
+template<typename ExecPolicy>
+void multi_type_vector<Traits>::transfer(
+    ExecPolicy&& policy, std::span<multi_type_vector* const> sources, size_type start_pos, size_type end_pos,
+    std::span<multi_type_vector* const> dests, size_type dest_pos)
+{
+    check_container_pairs("multi_type_vector::transfer", sources, start_pos, end_pos, dests, dest_pos);
 
-    if (block_index == m_block_store.positions.size() - 1)
-    {
-        // t|???|--x|b - This is the last block.
-        set_cell_to_bottom_of_data_block(block_index, value);
-        iterator itr = make_end();
-        return --itr;
-    }
-
-    bool blk_next = is_next_block_of_type(block_index, cat);
-    if (!blk_next)
-    {
-        // t|???|--x|---|b - Next block is of different type than the new
-        // value's.
-        set_cell_to_bottom_of_data_block(block_index, value);
-        return get_iterator(block_index + 1);
-    }
-
-    // t|???|--x|xxx|b - The next block is of the same type as the new value.
-    block_funcs::overwrite_values(*blk_data, blk_size - 1, 1);
-    block_funcs::erase(*blk_data, blk_size - 1);
-    m_block_store.sizes[block_index] -= 1;
-    mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], value);
-    m_block_store.sizes[block_index + 1] += 1;
-    m_block_store.positions[block_index + 1] -= 1;
-
-    return get_iterator(block_index + 1);
+    for_each_container(policy, sources.size(), [&](std::size_t index) {
+        sources[index]->transfer(start_pos, end_pos, *dests[index], dest_pos);
+    });
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release_impl(
-    size_type pos, size_type block_index, T& value)
+template<typename ExecPolicy>
+void multi_type_vector<Traits>::swap(
+    ExecPolicy&& policy, std::span<multi_type_vector* const> containers1, size_type start_pos, size_type end_pos,
+    std::span<multi_type_vector* const> containers2, size_type other_pos)
 {
-    const base_element_block* blk_data = m_block_store.element_blocks[block_index];
-    size_type start_pos = m_block_store.positions[block_index];
+    check_container_pairs("multi_type_vector::swap", containers1, start_pos, end_pos, containers2, other_pos);
 
-    if (!blk_data)
-    {
-        // Empty cell block.  There is no element to release.
-        mdds_mtv_get_empty_value(value);
-        return get_iterator(block_index);
-    }
+    for_each_container(policy, containers1.size(), [&](std::size_t index) {
+        containers1[index]->swap(start_pos, end_pos, *containers2[index], other_pos);
+    });
+}
 
-    assert(pos >= start_pos);
-    assert(blk_data); // data for non-empty blocks should never be nullptr.
-    size_type offset = pos - start_pos;
-    mdds_mtv_get_value(*blk_data, offset, value);
+template<typename Traits>
+void multi_type_vector<Traits>::apply_permutation(std::span<const size_type> perm)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "perm=(size=" << perm.size() << ")");
 
-    // Set the element slot empty without overwriting it.
-    return set_empty_in_single_block(pos, pos, block_index, false);
+    mdds::mtv::detail::check_permutation("multi_type_vector::apply_permutation", perm, m_cur_size);
+    apply_permutation_impl(perm);
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::swap_impl(
-    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index1,
-    size_type block_index2, size_type dblock_index1, size_type dblock_index2)
+template<typename ExecPolicy>
+void multi_type_vector<Traits>::apply_permutation(
+    ExecPolicy&& policy, std::span<multi_type_vector* const> containers, std::span<const size_type> perm)
 {
-    if (block_index1 == block_index2)
+    const char* method_name = "multi_type_vector::apply_permutation";
+
+    for (std::size_t i = 0; i < containers.size(); ++i)
     {
-        // Source range is in a single block.
-        if (dblock_index1 == dblock_index2)
+        if (!containers[i])
         {
-            // Destination range is also in a single block.
-            swap_single_block(other, start_pos, end_pos, other_pos, block_index1, dblock_index1);
+            std::ostringstream os;
+            os << method_name << ": container at index " << i << " is null.";
+            throw invalid_arg_error(os.str());
         }
-        else
+
+        if (containers[i]->size() != perm.size())
         {
-            // Source is single-, and destination is multi-blocks.
-            swap_single_to_multi_blocks(
-                other, start_pos, end_pos, other_pos, block_index1, dblock_index1, dblock_index2);
+            std::ostringstream os;
+            os << method_name << ": the size of the container at index " << i
+               << " differs from the size of the permutation (container=" << containers[i]->size()
+               << "; permutation=" << perm.size() << ")";
+            throw invalid_arg_error(os.str());
         }
     }
-    else if (dblock_index1 == dblock_index2)
-    {
-        // Destination range is over a single block. Switch source and destination.
-        size_type len = end_pos - start_pos + 1;
-        other.swap_single_to_multi_blocks(
-            *this, other_pos, other_pos + len - 1, start_pos, dblock_index1, block_index1, block_index2);
-    }
-    else
+
+    std::vector<const multi_type_vector*> sorted(containers.begin(), containers.end());
+    std::sort(sorted.begin(), sorted.end(), std::less<const multi_type_vector*>());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
     {
-        // Both source and destinations are multi-block.
-        swap_multi_to_multi_blocks(
-            other, start_pos, end_pos, other_pos, block_index1, block_index2, dblock_index1, dblock_index2);
+        std::ostringstream os;
+        os << method_name << ": the same container appears more than once.";
+        throw invalid_arg_error(os.str());
     }
+
+    mdds::mtv::detail::check_permutation(method_name, perm, size_type(perm.size()));
+
+    for_each_container(
+        policy, containers.size(), [&](std::size_t index) { containers[index]->apply_permutation_impl(perm); });
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::swap_single_block(
-    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index,
-    size_type other_block_index)
+mtv::element_t multi_type_vector<Traits>::get_type(size_type pos) const
 {
-    base_element_block* src_data = m_block_store.element_blocks[block_index];
-    base_element_block* dst_data = other.m_block_store.element_blocks[other_block_index];
-    size_type start_pos_in_block = m_block_store.positions[block_index];
-    size_type start_pos_in_other_block = other.m_block_store.positions[other_block_index];
-    element_t cat_src = mtv::element_type_empty;
-    element_t cat_dst = mtv::element_type_empty;
-
-    if (src_data)
-        cat_src = mtv::get_block_type(*src_data);
-    if (dst_data)
-        cat_dst = mtv::get_block_type(*dst_data);
-
-    size_t other_end_pos = other_pos + end_pos - start_pos;
-    size_t len = end_pos - start_pos + 1; // length of elements to swap.
-    size_type src_offset = start_pos - start_pos_in_block;
-    size_type dst_offset = other_pos - start_pos_in_other_block;
-
-    // length of the tail that will not be swapped.
-    size_type src_tail_len = m_block_store.sizes[block_index] - src_offset - len;
-
-    if (cat_src == cat_dst)
-    {
-        // Source and destination blocks are of the same type.
-        if (cat_src == mtv::element_type_empty)
-            // Both are empty blocks. Nothing to swap.
-            return;
+    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos);
 
-        block_funcs::swap_values(*src_data, *dst_data, src_offset, dst_offset, len);
-        return;
-    }
+    size_type block_index = get_block_position(pos);
+    if (block_index == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::get_type", __LINE__, pos, block_size(), size());
 
-    // Source and destination blocks are of different types.
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
+    if (!blk_data)
+        return mtv::element_type_empty;
 
-    if (cat_src == mtv::element_type_empty)
-    {
-        // Source is empty but destination is not. This is equivalent of transfer.
-        other.transfer_single_block(other_pos, other_end_pos, other_block_index, *this, start_pos);
-        // No update of local index vars needed.
-        return;
-    }
+    return mtv::get_block_type(*blk_data);
+}
 
-    if (cat_dst == mtv::element_type_empty)
-    {
-        // Source is not empty but destination is. Use transfer.
-        transfer_single_block(start_pos, end_pos, block_index, other, other_pos);
-        // No update of local index vars needed.
-        return;
-    }
+template<typename Traits>
+bool multi_type_vector<Traits>::is_empty(size_type pos) const
+{
+    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos);
 
-    // Neither the source nor destination blocks are empty, and they are of different types.
-    if (src_offset == 0)
-    {
-        // Source range is at the top of a block.
-        if (src_tail_len == 0)
-        {
-            // the entire source block needs to be replaced.
-            std::unique_ptr<base_element_block, element_block_deleter> src_data_original(src_data);
-            m_hdl_event.element_block_released(src_data);
-            m_block_store.element_blocks[block_index] =
-                other.exchange_elements(*src_data_original, src_offset, other_block_index, dst_offset, len);
-            src_data = m_block_store.element_blocks[block_index];
-            m_hdl_event.element_block_acquired(src_data);
+    size_type block_index = get_block_position(pos);
+    if (block_index == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::is_empty", __LINE__, pos, block_size(), size());
 
-            // Release elements in the source block to prevent double-deletion.
-            block_funcs::resize_block(*src_data_original, 0);
-            merge_with_adjacent_blocks(block_index);
-            return;
-        }
+    return m_block_store.element_blocks[block_index] == nullptr;
+}
 
-        // Get the new elements from the other container.
-        std::unique_ptr<base_element_block, element_block_deleter> new_dst_data(
-            other.exchange_elements(*src_data, src_offset, other_block_index, dst_offset, len));
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty(
+    size_type start_pos, size_type end_pos)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-        // Shrink the current block by erasing the top part.
-        block_funcs::erase(*src_data, 0, len);
-        m_block_store.positions[block_index] += len;
-        m_block_store.sizes[block_index] -= len;
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::set_empty", __LINE__, start_pos, block_size(), size());
 
-        bool blk_prev = is_previous_block_of_type(block_index, cat_dst);
-        if (blk_prev)
-        {
-            // Append the new elements to the previous block.
-            base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
-            block_funcs::append_block(*prev_data, *new_dst_data);
-            block_funcs::resize_block(*new_dst_data, 0); // prevent double-delete.
-            m_block_store.sizes[block_index - 1] += len;
-        }
-        else
-        {
-            // Insert a new block to store the new elements.
-            size_type position = m_block_store.positions[block_index] - len;
-            m_block_store.insert(block_index, position, len, nullptr);
-            m_block_store.element_blocks[block_index] = new_dst_data.release();
-            m_hdl_event.element_block_acquired(m_block_store.element_blocks[block_index]);
-        }
-        return;
-    }
+    detach_range(block_index1, start_pos, end_pos);
 
-    // Get the new elements from the destination instance.
-    std::unique_ptr<base_element_block, element_block_deleter> data_from_dst(
-        other.exchange_elements(*src_data, src_offset, other_block_index, dst_offset, len));
+    return set_empty_impl(start_pos, end_pos, block_index1, true);
+}
 
-    if (src_tail_len == 0)
-    {
-        // Source range is at the bottom of a block.
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty(
+    const iterator& pos_hint, size_type start_pos, size_type end_pos)
+{
+    MDDS_MTV_TRACE_ARGS(
+        mutator_with_pos_hint, "pos_hint=" << pos_hint << "; start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-        // Shrink the current block.
-        block_funcs::resize_block(*src_data, src_offset);
-        m_block_store.sizes[block_index] = src_offset;
+    size_type block_index1 = get_block_position(pos_hint->__private_data, start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::set_empty", __LINE__, start_pos, block_size(), size());
 
-        if (is_next_block_of_type(block_index, cat_dst))
-        {
-            // Merge with the next block.
-            base_element_block* next_data = m_block_store.element_blocks[block_index + 1];
-            block_funcs::prepend_values_from_block(*next_data, *data_from_dst, 0, len);
-            block_funcs::resize_block(*data_from_dst, 0); // prevent double-delete.
-            m_block_store.sizes[block_index + 1] += len;
-            m_block_store.positions[block_index + 1] -= len;
-        }
-        else
-        {
-            m_block_store.insert(block_index + 1, 0, len, nullptr);
-            m_block_store.calc_block_position(block_index + 1);
-            m_block_store.element_blocks[block_index + 1] = data_from_dst.release();
-            m_hdl_event.element_block_acquired(m_block_store.element_blocks[block_index + 1]);
-        }
-        return;
-    }
+    detach_range(block_index1, start_pos, end_pos);
 
-    // Source range is in the middle of a block.
-    assert(src_offset && src_tail_len);
-    block_index = set_new_block_to_middle(block_index, src_offset, len, false);
-    m_block_store.element_blocks[block_index] = data_from_dst.release();
-    m_hdl_event.element_block_acquired(m_block_store.element_blocks[block_index]);
+    return set_empty_impl(start_pos, end_pos, block_index1, true);
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::swap_single_to_multi_blocks(
-    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index,
-    size_type dst_block_index1, size_type dst_block_index2)
+void multi_type_vector<Traits>::erase(size_type start_pos, size_type end_pos)
 {
-    base_element_block* src_data = m_block_store.element_blocks[block_index];
-    size_type start_pos_in_block = m_block_store.positions[block_index];
-    size_type dst_start_pos_in_block1 = other.m_block_store.positions[dst_block_index1];
-    size_type dst_start_pos_in_block2 = other.m_block_store.positions[dst_block_index2];
+    MDDS_MTV_TRACE_ARGS(mutator, "start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-    element_t cat_src = src_data ? mtv::get_block_type(*src_data) : mtv::element_type_empty;
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
 
-    size_type len = end_pos - start_pos + 1;
+    size_type block_index1 = get_block_position(start_pos);
+    detach_range(block_index1, start_pos, end_pos);
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
 
-    if (cat_src == mtv::element_type_empty)
     {
-        // The source block is empty. Use transfer.
-        other.transfer_multi_blocks(
-            other_pos, other_pos + len - 1, dst_block_index1, dst_block_index2, *this, start_pos);
-        return;
+        position_shift_scope shift_scope(*this, block_index1, end_pos);
+        erase_impl(start_pos, end_pos);
     }
 
-    size_type src_offset = start_pos - start_pos_in_block;
-    size_type dst_offset1 = other_pos - dst_start_pos_in_block1;
-    size_type dst_offset2 = other_pos + len - 1 - dst_start_pos_in_block2;
-
-    // length of the tail that will not be swapped.
-    size_type src_tail_len = m_block_store.sizes[block_index] - src_offset - len;
-
-    // Get the new elements from the other instance.
-    blocks_type new_blocks;
-    other.exchange_elements(
-        *src_data, src_offset, dst_block_index1, dst_offset1, dst_block_index2, dst_offset2, len, new_blocks);
-
-    new_blocks.check_integrity();
-
-    if (new_blocks.positions.empty())
-        throw general_error("multi_type_vector::swap_single_to_multi_blocks: failed to exchange elements.");
-
-    if (src_offset == 0)
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
     {
-        // Source range is at the top of a block.
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in erase (" << start_pos << "-" << end_pos << ")" << std::endl;
+        os << "block integrity check failed in push_back" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+}
 
-        size_type src_position = m_block_store.positions[block_index];
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_empty(size_type pos, size_type length)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "pos=" << pos << "; length=" << length);
 
-        if (src_tail_len == 0)
-        {
-            // the whole block needs to be replaced.  Delete the block, but
-            // don't delete the managed elements the block contains since they
-            // have been transferred over to the destination block.
-            block_funcs::resize_block(*src_data, 0);
-            delete_element_block(block_index);
-            m_block_store.erase(block_index);
-        }
-        else
-        {
-            // Shrink the current block by erasing the top part.
-            block_funcs::erase(*src_data, 0, len);
-            m_block_store.sizes[block_index] -= len;
-            m_block_store.positions[block_index] += len;
-        }
+    if (!length)
+        // Nothing to insert.
+        return make_end();
 
-        insert_blocks_at(src_position, block_index, new_blocks);
-        merge_with_next_block(block_index + new_blocks.positions.size() - 1); // last block inserted.
-        if (block_index > 0)
-            merge_with_next_block(block_index - 1); // block before the first block inserted.
+    size_type block_index = get_block_position(pos);
+    if (block_index == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::insert_empty", __LINE__, pos, block_size(), size());
 
-        return;
-    }
+    detach_range(block_index, pos, pos);
 
-    size_type position = 0;
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
 
-    if (src_tail_len == 0)
+    iterator ret;
     {
-        // Source range is at the bottom of a block.
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = insert_empty_impl(pos, block_index, length);
+    }
 
-        // Shrink the current block.
-        block_funcs::resize_block(*src_data, src_offset);
-        m_block_store.sizes[block_index] = src_offset;
-        position = m_block_store.positions[block_index] + m_block_store.sizes[block_index];
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
     }
-    else
+    catch (const mdds::integrity_error& e)
     {
-        // Source range is in the middle of a block.
-        assert(src_offset && src_tail_len);
-
-        // This will create two new slots at block_index+1, the first of which
-        // we will immediately remove.  The new blocks from the other
-        // container will be inserted at the removed slot.
-        set_new_block_to_middle(block_index, src_offset, len, false);
-        delete_element_block(block_index + 1);
-        m_block_store.erase(block_index + 1);
-        position = m_block_store.positions[block_index] + m_block_store.sizes[block_index];
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in insert_empty (pos=" << pos << "; length=" << length << ")" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
     }
+#endif
 
-    insert_blocks_at(position, block_index + 1, new_blocks);
-    merge_with_next_block(block_index + new_blocks.positions.size()); // last block inserted.
-    merge_with_next_block(block_index); // block before the first block inserted.
+    return ret;
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::swap_multi_to_multi_blocks(
-    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index1,
-    size_type block_index2, size_type dblock_index1, size_type dblock_index2)
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_empty(
+    const iterator& pos_hint, size_type pos, size_type length)
 {
-    assert(block_index1 < block_index2);
-    assert(dblock_index1 < dblock_index2);
+    MDDS_MTV_TRACE_ARGS(mutator_with_pos_hint, "pos_hint=" << pos_hint << "; pos=" << pos << "; length=" << length);
 
-    size_type start_pos_in_block1 = m_block_store.positions[block_index1];
-    size_type start_pos_in_block2 = m_block_store.positions[block_index2];
-    size_type start_pos_in_dblock1 = other.m_block_store.positions[dblock_index1];
-    size_type start_pos_in_dblock2 = other.m_block_store.positions[dblock_index2];
+    if (!length)
+        // Nothing to insert.
+        return make_end();
 
-    size_type len = end_pos - start_pos + 1;
-    size_type src_offset1 = start_pos - start_pos_in_block1;
-    size_type src_offset2 = end_pos - start_pos_in_block2;
-    size_type dst_offset1 = other_pos - start_pos_in_dblock1;
-    size_type dst_offset2 = other_pos + len - 1 - start_pos_in_dblock2;
+    size_type block_index = get_block_position(pos_hint->__private_data, pos);
+    if (block_index == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::insert_empty", __LINE__, pos, block_size(), size());
 
-    blocks_to_transfer src_bucket, dst_bucket;
-    prepare_blocks_to_transfer(src_bucket, block_index1, src_offset1, block_index2, src_offset2);
-    other.prepare_blocks_to_transfer(dst_bucket, dblock_index1, dst_offset1, dblock_index2, dst_offset2);
+    detach_range(block_index, pos, pos);
 
-    size_type position = 0;
-    if (src_bucket.insert_index > 0)
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    iterator ret;
     {
-        size_type i = src_bucket.insert_index - 1;
-        position = m_block_store.positions[i] + m_block_store.sizes[i];
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = insert_empty_impl(pos, block_index, length);
     }
-    insert_blocks_at(position, src_bucket.insert_index, dst_bucket.blocks);
-
-    // Merge the boundary blocks in the source.
-    merge_with_next_block(src_bucket.insert_index + dst_bucket.blocks.positions.size() - 1);
-    if (src_bucket.insert_index > 0)
-        merge_with_next_block(src_bucket.insert_index - 1);
 
-    position = 0;
-    if (dst_bucket.insert_index > 0)
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
     {
-        size_type i = dst_bucket.insert_index - 1;
-        position = other.m_block_store.positions[i] + other.m_block_store.sizes[i];
+        check_block_integrity();
     }
-    other.insert_blocks_at(position, dst_bucket.insert_index, src_bucket.blocks);
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in insert_empty (pos=" << pos << "; length=" << length << ")" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
 
-    // Merge the boundary blocks in the destination.
-    other.merge_with_next_block(dst_bucket.insert_index + src_bucket.blocks.positions.size() - 1);
-    if (dst_bucket.insert_index > 0)
-        other.merge_with_next_block(dst_bucket.insert_index - 1);
+    return ret;
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::clear()
+{
+    MDDS_MTV_TRACE(mutator);
+
+    delete_element_blocks(0, m_block_store.element_blocks.size());
+    m_block_store.clear();
+    m_cur_size = 0;
 }
 
 template<typename Traits>
 template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_cells_impl(
-    size_type row, size_type block_index, const T& it_begin, const T& it_end)
+bool multi_type_vector<Traits>::set_cells_precheck(
+    size_type pos, const T& it_begin, const T& it_end, size_type& end_pos)
 {
-    size_type start_row = m_block_store.positions[block_index];
     size_type length = std::distance(it_begin, it_end);
     if (!length)
         // empty data array.  nothing to do.
-        return make_end();
+        return false;
 
-    element_t cat = mdds_mtv_get_element_type(*it_begin);
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-    if (!blk_data)
-    {
-        if (row == start_row)
-        {
-            // Insert into an empty block.  Check the previos block (if exists)
-            // to see if the data can be appended to it if inserting at the top
-            // of the block.
-            bool blk0 = is_previous_block_of_type(block_index, cat);
+    end_pos = pos + length - 1;
+    if (end_pos >= m_cur_size)
+        throw std::out_of_range("Data array is too long.");
 
-            if (blk0)
-            {
-                // Append to the previous block.
-                base_element_block* blk0_data = m_block_store.element_blocks[block_index - 1];
-                mdds_mtv_append_values(*blk0_data, *it_begin, it_begin, it_end);
-                m_block_store.sizes[block_index - 1] += length;
-                m_cur_size += length;
-                adjust_block_positions_func{}(m_block_store, block_index, length);
+    return true;
+}
 
-                return get_iterator(block_index - 1);
-            }
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_impl(
+    size_type pos, size_type block_index, const T& value)
+{
+    size_type start_row = m_block_store.positions[block_index];
 
-            // Just insert a new block before the current block.
-            size_type position = m_block_store.positions[block_index];
-            m_block_store.insert(block_index, position, length, nullptr);
-            m_block_store.element_blocks[block_index] = block_funcs::create_new_block(cat, 0);
-            blk_data = m_block_store.element_blocks[block_index];
-            m_hdl_event.element_block_acquired(blk_data);
-            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
-            m_cur_size += length;
-            adjust_block_positions_func{}(m_block_store, block_index + 1, length);
+    size_type blk_size = m_block_store.sizes[block_index];
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
+    assert(blk_size > 0); // block size should never be zero at any time.
 
-            return get_iterator(block_index);
-        }
+    assert(pos >= start_row);
+    size_type pos_in_block = pos - start_row;
+    assert(pos_in_block < blk_size);
 
-        insert_cells_to_middle(row, block_index, it_begin, it_end);
-        m_cur_size += length;
+    if (!blk_data)
+    {
+        // This is an empty block.
+        return set_cell_to_empty_block(block_index, pos_in_block, value);
+    }
 
-        return get_iterator(block_index + 1);
-    }
+    element_t cat = mdds_mtv_get_element_type(value);
 
     assert(blk_data);
     element_t blk_cat = mdds::mtv::get_block_type(*blk_data);
-    if (cat == blk_cat)
-    {
-        // Simply insert the new data series into existing block.
-        assert(it_begin != it_end);
-        mdds_mtv_insert_values(*blk_data, row - start_row, *it_begin, it_begin, it_end);
-        m_block_store.sizes[block_index] += length;
-        m_cur_size += length;
-        adjust_block_positions_func{}(m_block_store, block_index + 1, length);
 
+    if (blk_cat == cat)
+    {
+        // This block is of the same type as the cell being inserted.
+        size_type i = pos - start_row;
+        block_funcs::overwrite_values(*blk_data, i, 1);
+        mdds_mtv_set_value(*blk_data, i, value);
         return get_iterator(block_index);
     }
 
-    assert(cat != blk_cat);
-    if (row == start_row)
+    assert(blk_cat != cat);
+
+    if (pos == start_row)
     {
-        // Check the previous block to see if we can append the data there.
-        bool blk0 = is_previous_block_of_type(block_index, cat);
-        if (blk0)
+        // t|???|x--|???|b - Insertion point is at the start of the block.
+        if (blk_size == 1)
         {
-            // Append to the previous block.
-            base_element_block* blk0_data = m_block_store.element_blocks[block_index - 1];
-            mdds_mtv_append_values(*blk0_data, *it_begin, it_begin, it_end);
-            m_block_store.sizes[block_index - 1] += length;
-            m_cur_size += length;
-            adjust_block_positions_func{}(m_block_store, block_index, length);
+            // t|???|x|???|b
+            return set_cell_to_non_empty_block_of_size_one(block_index, value);
+        }
 
+        assert(blk_size > 1);
+        bool blk_prev = is_previous_block_of_type(block_index, cat);
+        if (blk_prev)
+        {
+            // t|xxx|x--|???|b - Append to the previous block.
+            m_block_store.sizes[block_index] -= 1;
+            m_block_store.positions[block_index] += 1;
+            erase_first_value(*m_block_store.element_blocks[block_index]);
+            m_block_store.sizes[block_index - 1] += 1;
+            mdds_mtv_append_value(*m_block_store.element_blocks[block_index - 1], value);
             return get_iterator(block_index - 1);
         }
 
-        // Just insert a new block before the current block.
-        m_block_store.insert(block_index, m_block_store.positions[block_index], length, nullptr);
-        m_block_store.element_blocks[block_index] = block_funcs::create_new_block(cat, 0);
-        m_hdl_event.element_block_acquired(blk_data);
-        blk_data = m_block_store.element_blocks[block_index];
-        mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
-        m_block_store.sizes[block_index] = length;
-        m_cur_size += length;
-        adjust_block_positions_func{}(m_block_store, block_index + 1, length);
-
+        // t|---|x--|???|b
+        set_cell_to_top_of_data_block(block_index, value);
         return get_iterator(block_index);
     }
 
-    insert_cells_to_middle(row, block_index, it_begin, it_end);
-    m_cur_size += length;
+    if (pos < (start_row + blk_size - 1))
+    {
+        // t|???|-x-|???|b - Insertion point is in the middle of the block.
+        return set_cell_to_middle_of_block(block_index, pos_in_block, value);
+    }
 
-    return get_iterator(block_index + 1);
-}
+    // t|???|--x|???|b - Insertion point is at the end of the block.
+    assert(pos == (start_row + m_block_store.sizes[block_index] - 1));
+    assert(pos > start_row);
+    assert(m_block_store.sizes[block_index] > 1);
 
-template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty_impl(
-    size_type start_pos, size_type end_pos, size_type block_index1, bool overwrite)
-{
-    if (start_pos > end_pos)
-        throw std::out_of_range("Start row is larger than the end row.");
+    if (block_index == 0)
+    {
+        if (m_block_store.positions.size() == 1)
+        {
+            // t|--x|b - This is the only block.
+            set_cell_to_bottom_of_data_block(0, value);
+            iterator itr = make_end();
+            return --itr;
+        }
 
-    size_type block_index2 = get_block_position(end_pos, block_index1);
-    if (block_index2 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::set_empty_impl", __LINE__, end_pos, block_size(), size());
+        bool blk_next = is_next_block_of_type(block_index, cat);
+        if (!blk_next)
+        {
+            // t|--x|---|b - Next block is of different type.
+            set_cell_to_bottom_of_data_block(0, value);
+            iterator itr = make_begin();
+            return ++itr;
+        }
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+        // t|--x|xxx|b - Next block is of the same type as the new value.
 
-    iterator ret_it;
-    if (block_index1 == block_index2)
-        ret_it = set_empty_in_single_block(start_pos, end_pos, block_index1, overwrite);
-    else
-        ret_it = set_empty_in_multi_blocks(start_pos, end_pos, block_index1, block_index2, overwrite);
+        block_funcs::overwrite_values(*blk_data, blk_size - 1, 1);
+        block_funcs::erase(*blk_data, blk_size - 1);
+        m_block_store.sizes[block_index] -= 1;
+        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], value);
+        m_block_store.sizes[block_index + 1] += 1;
+        m_block_store.positions[block_index + 1] -= 1;
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    try
+        return get_iterator(block_index + 1);
+    }
+
+    assert(block_index > 0);
+
+    if (block_index == m_block_store.positions.size() - 1)
     {
-        check_block_integrity();
+        // t|???|--x|b - This is the last block.
+        set_cell_to_bottom_of_data_block(block_index, value);
+        iterator itr = make_end();
+        return --itr;
     }
-    catch (const mdds::integrity_error& e)
+
+    bool blk_next = is_next_block_of_type(block_index, cat);
+    if (!blk_next)
     {
-        std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in set_empty(start_pos=" << start_pos << "; end_pos=" << end_pos << ")"
-           << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
+        // t|???|--x|---|b - Next block is of different type than the new
+        // value's.
+        set_cell_to_bottom_of_data_block(block_index, value);
+        return get_iterator(block_index + 1);
     }
-#endif
-    return ret_it;
+
+    // t|???|--x|xxx|b - The next block is of the same type as the new value.
+    block_funcs::overwrite_values(*blk_data, blk_size - 1, 1);
+    block_funcs::erase(*blk_data, blk_size - 1);
+    m_block_store.sizes[block_index] -= 1;
+    mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], value);
+    m_block_store.sizes[block_index + 1] += 1;
+    m_block_store.positions[block_index + 1] -= 1;
+
+    return get_iterator(block_index + 1);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty_in_single_block(
-    size_type start_row, size_type end_row, size_type block_index, bool overwrite)
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release_impl(
+    size_type pos, size_type block_index, T& value)
 {
-    // Range is within a single block.
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-    if (!blk_data)
-        // This block is already empty.  Do nothing.
-        return get_iterator(block_index);
-
-    size_type start_row_in_block = m_block_store.positions[block_index];
-    assert(start_row_in_block + m_block_store.sizes[block_index] >= 1);
-    size_type end_row_in_block = start_row_in_block + m_block_store.sizes[block_index] - 1;
-    size_type empty_block_size = end_row - start_row + 1;
+    const base_element_block* blk_data = m_block_store.element_blocks[block_index];
+    size_type start_pos = m_block_store.positions[block_index];
 
-    if (start_row == start_row_in_block)
+    if (!blk_data)
     {
-        // start row coincides with the start of a block.
-
-        if (end_row == end_row_in_block)
-            return set_whole_block_empty(block_index, overwrite);
-
-        // Set the upper part of the block empty.
-        if (overwrite)
-            block_funcs::overwrite_values(*blk_data, 0, empty_block_size);
-
-        block_funcs::erase(*blk_data, 0, empty_block_size);
-        m_block_store.sizes[block_index] -= empty_block_size;
-
-        // Check if the preceding block (if exists) is also empty.
-        bool blk_prev = is_previous_block_of_type(block_index, mtv::element_type_empty);
-        if (blk_prev)
-        {
-            // Extend the previous empty block.
-            m_block_store.sizes[block_index - 1] += empty_block_size;
-            m_block_store.positions[block_index] += empty_block_size;
-            return get_iterator(block_index - 1);
-        }
-
-        // Insert a new empty block before the current one.
-        size_type block_position = m_block_store.positions[block_index];
-        m_block_store.positions[block_index] += empty_block_size;
-        m_block_store.insert(block_index, block_position, empty_block_size, nullptr);
+        // Empty cell block.  There is no element to release.
+        mdds_mtv_get_empty_value(value);
         return get_iterator(block_index);
     }
 
-    if (end_row == end_row_in_block)
-    {
-        // end row equals the end of a block.
-        assert(start_row > start_row_in_block);
-
-        // Set the lower part of the block empty.
-        size_type start_pos = start_row - start_row_in_block;
-        if (overwrite)
-            block_funcs::overwrite_values(*blk_data, start_pos, empty_block_size);
+    assert(pos >= start_pos);
+    assert(blk_data); // data for non-empty blocks should never be nullptr.
+    size_type offset = pos - start_pos;
+    mdds_mtv_get_value(*blk_data, offset, value);
 
-        block_funcs::erase(*blk_data, start_pos, empty_block_size);
-        m_block_store.sizes[block_index] -= empty_block_size;
+    // Set the element slot empty without overwriting it.
+    return set_empty_in_single_block(pos, pos, block_index, false);
+}
 
-        // Check if the following block (if exists) is also empty.
-        bool blk_next = is_next_block_of_type(block_index, mtv::element_type_empty);
-        if (blk_next)
+template<typename Traits>
+void multi_type_vector<Traits>::swap_impl(
+    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index1,
+    size_type block_index2, size_type dblock_index1, size_type dblock_index2)
+{
+    if (block_index1 == block_index2)
+    {
+        // Source range is in a single block.
+        if (dblock_index1 == dblock_index2)
         {
-            // Extend the next empty block to cover the new empty segment.
-            m_block_store.sizes[block_index + 1] += empty_block_size;
-            m_block_store.positions[block_index + 1] = start_row;
+            // Destination range is also in a single block.
+            swap_single_block(other, start_pos, end_pos, other_pos, block_index1, dblock_index1);
         }
         else
         {
-            // Insert a new empty block after the current one.
-            m_block_store.insert(block_index + 1, start_row, empty_block_size, nullptr);
+            // Source is single-, and destination is multi-blocks.
+            swap_single_to_multi_blocks(
+                other, start_pos, end_pos, other_pos, block_index1, dblock_index1, dblock_index2);
         }
-
-        return get_iterator(block_index + 1);
     }
-
-    // Empty the middle part of a block.
-    assert(end_row_in_block - end_row > 0);
-    set_new_block_to_middle(block_index, start_row - start_row_in_block, empty_block_size, overwrite);
-
-    return get_iterator(block_index + 1);
+    else if (dblock_index1 == dblock_index2)
+    {
+        // Destination range is over a single block. Switch source and destination.
+        size_type len = end_pos - start_pos + 1;
+        other.swap_single_to_multi_blocks(
+            *this, other_pos, other_pos + len - 1, start_pos, dblock_index1, block_index1, block_index2);
+    }
+    else
+    {
+        // Both source and destinations are multi-block.
+        swap_multi_to_multi_blocks(
+            other, start_pos, end_pos, other_pos, block_index1, block_index2, dblock_index1, dblock_index2);
+    }
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty_in_multi_blocks(
-    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, bool overwrite)
+void multi_type_vector<Traits>::swap_single_block(
+    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index,
+    size_type other_block_index)
 {
-    assert(block_index1 < block_index2);
-    size_type start_row_in_block1 = m_block_store.positions[block_index1];
-    size_type start_row_in_block2 = m_block_store.positions[block_index2];
+    base_element_block* src_data = m_block_store.element_blocks[block_index];
+    base_element_block* dst_data = other.m_block_store.element_blocks[other_block_index];
+    size_type start_pos_in_block = m_block_store.positions[block_index];
+    size_type start_pos_in_other_block = other.m_block_store.positions[other_block_index];
+    element_t cat_src = mtv::element_type_empty;
+    element_t cat_dst = mtv::element_type_empty;
 
-    {
-        // Empty the lower part of the first block.
-        base_element_block* blk_data = m_block_store.element_blocks[block_index1];
-        if (blk_data)
-        {
-            if (start_row_in_block1 == start_row)
-            {
-                // Empty the whole block.
+    if (src_data)
+        cat_src = mtv::get_block_type(*src_data);
+    if (dst_data)
+        cat_dst = mtv::get_block_type(*dst_data);
 
-                bool prev_empty = is_previous_block_of_type(block_index1, mtv::element_type_empty);
-                if (prev_empty)
-                {
-                    // Previous block is empty.  Move the start row to the
-                    // first row of the previous block, and make the previous
-                    // block 'block 1'.
-                    start_row -= m_block_store.sizes[block_index1 - 1];
-                    --block_index1;
-                }
-                else
-                {
-                    // Make block 1 empty.
-                    if (!overwrite)
-                        block_funcs::resize_block(*blk_data, 0);
+    size_t other_end_pos = other_pos + end_pos - start_pos;
+    size_t len = end_pos - start_pos + 1; // length of elements to swap.
+    size_type src_offset = start_pos - start_pos_in_block;
+    size_type dst_offset = other_pos - start_pos_in_other_block;
 
-                    delete_element_block(block_index1);
-                }
-            }
-            else
-            {
-                // Empty the lower part.
-                size_type new_size = start_row - start_row_in_block1;
-                if (overwrite)
-                    block_funcs::overwrite_values(*blk_data, new_size, m_block_store.sizes[block_index1] - new_size);
+    // length of the tail that will not be swapped.
+    size_type src_tail_len = m_block_store.sizes[block_index] - src_offset - len;
 
-                block_funcs::resize_block(*blk_data, new_size);
-                m_block_store.sizes[block_index1] = new_size;
-            }
-        }
-        else
-        {
-            // First block is already empty.  Adjust the start row of the new
-            // empty range.
-            start_row = start_row_in_block1;
-        }
+    if (cat_src == cat_dst)
+    {
+        // Source and destination blocks are of the same type.
+        if (cat_src == mtv::element_type_empty)
+            // Both are empty blocks. Nothing to swap.
+            return;
+
+        block_funcs::swap_values(*src_data, *dst_data, src_offset, dst_offset, len);
+        return;
     }
 
-    size_type end_block_to_erase = block_index2; // End block position is non-inclusive.
+    // Source and destination blocks are of different types.
 
+    if (cat_src == mtv::element_type_empty)
     {
-        // Empty the upper part of the last block.
-        base_element_block* blk_data = m_block_store.element_blocks[block_index2];
-        size_type last_row_in_block = start_row_in_block2 + m_block_store.sizes[block_index2] - 1;
+        // Source is empty but destination is not. This is equivalent of transfer.
+        other.transfer_single_block(other_pos, other_end_pos, other_block_index, *this, start_pos);
+        // No update of local index vars needed.
+        return;
+    }
 
-        if (blk_data)
+    if (cat_dst == mtv::element_type_empty)
+    {
+        // Source is not empty but destination is. Use transfer.
+        transfer_single_block(start_pos, end_pos, block_index, other, other_pos);
+        // No update of local index vars needed.
+        return;
+    }
+
+    // Neither the source nor destination blocks are empty, and they are of different types.
+    if (src_offset == 0)
+    {
+        // Source range is at the top of a block.
+        if (src_tail_len == 0)
         {
-            if (last_row_in_block == end_row)
-            {
-                // Delete the whole block.
-                ++end_block_to_erase;
+            // the entire source block needs to be replaced.
+            std::unique_ptr<base_element_block, element_block_deleter> src_data_original(src_data);
+            m_hdl_event.element_block_released(src_data);
+            m_block_store.element_blocks[block_index] =
+                other.exchange_elements(*src_data_original, src_offset, other_block_index, dst_offset, len);
+            src_data = m_block_store.element_blocks[block_index];
+            m_hdl_event.element_block_acquired(src_data);
 
-                // Check if the following block (if exists) is also empty.
-                bool next_empty = is_next_block_of_type(block_index2, mtv::element_type_empty);
-                if (next_empty)
-                {
-                    // The following block is also empty.
-                    end_row += m_block_store.sizes[block_index2 + 1];
-                    ++end_block_to_erase;
-                }
-            }
-            else
-            {
-                // Empty the upper part.
-                size_type size_to_erase = end_row - start_row_in_block2 + 1;
-                if (overwrite)
-                    block_funcs::overwrite_values(*blk_data, 0, size_to_erase);
+            // Release elements in the source block to prevent double-deletion.
+            block_funcs::resize_block(*src_data_original, 0);
+            merge_with_adjacent_blocks(block_index);
+            return;
+        }
 
-                block_funcs::erase(*blk_data, 0, size_to_erase);
-                m_block_store.sizes[block_index2] -= size_to_erase;
-                m_block_store.positions[block_index2] = start_row_in_block2 + size_to_erase;
-            }
+        // Get the new elements from the other container.
+        std::unique_ptr<base_element_block, element_block_deleter> new_dst_data(
+            other.exchange_elements(*src_data, src_offset, other_block_index, dst_offset, len));
+
+        // Shrink the current block by erasing the top part.
+        block_funcs::erase(*src_data, 0, len);
+        m_block_store.positions[block_index] += len;
+        m_block_store.sizes[block_index] -= len;
+
+        bool blk_prev = is_previous_block_of_type(block_index, cat_dst);
+        if (blk_prev)
+        {
+            // Append the new elements to the previous block.
+            base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
+            block_funcs::append_block(*prev_data, *new_dst_data);
+            block_funcs::resize_block(*new_dst_data, 0); // prevent double-delete.
+            m_block_store.sizes[block_index - 1] += len;
         }
         else
         {
-            // Last block is empty.  Delete this block and adjust the end row
-            // of the new empty range.
-            ++end_block_to_erase;
-            end_row = last_row_in_block;
+            // Insert a new block to store the new elements.
+            size_type position = m_block_store.positions[block_index] - len;
+            m_block_store.insert(block_index, position, len, nullptr);
+            m_block_store.element_blocks[block_index] = new_dst_data.release();
+            m_hdl_event.element_block_acquired(m_block_store.element_blocks[block_index]);
         }
+        return;
     }
 
-    if (end_block_to_erase - block_index1 > 1)
+    // Get the new elements from the destination instance.
+    std::unique_ptr<base_element_block, element_block_deleter> data_from_dst(
+        other.exchange_elements(*src_data, src_offset, other_block_index, dst_offset, len));
+
+    if (src_tail_len == 0)
     {
-        // Remove all blocks in-between, from block_index1+1 to end_block_to_erase-1.
+        // Source range is at the bottom of a block.
 
-        for (size_type i = block_index1 + 1; i < end_block_to_erase; ++i)
-        {
-            base_element_block* data = m_block_store.element_blocks[i];
-            if (!overwrite && data)
-                block_funcs::resize_block(*data, 0);
+        // Shrink the current block.
+        block_funcs::resize_block(*src_data, src_offset);
+        m_block_store.sizes[block_index] = src_offset;
 
-            delete_element_block(i);
+        if (is_next_block_of_type(block_index, cat_dst))
+        {
+            // Merge with the next block.
+            base_element_block* next_data = m_block_store.element_blocks[block_index + 1];
+            block_funcs::prepend_values_from_block(*next_data, *data_from_dst, 0, len);
+            block_funcs::resize_block(*data_from_dst, 0); // prevent double-delete.
+            m_block_store.sizes[block_index + 1] += len;
+            m_block_store.positions[block_index + 1] -= len;
         }
-
-        size_type n_erase_blocks = end_block_to_erase - block_index1 - 1;
-        m_block_store.erase(block_index1 + 1, n_erase_blocks);
-    }
-
-    base_element_block* blk_data = m_block_store.element_blocks[block_index1];
-    size_type empty_block_size = end_row - start_row + 1;
-    if (blk_data)
-    {
-        // Insert a new empty block after the first block.
-        m_block_store.insert(block_index1 + 1, start_row, empty_block_size, nullptr);
-        return get_iterator(block_index1 + 1);
+        else
+        {
+            m_block_store.insert(block_index + 1, 0, len, nullptr);
+            m_block_store.calc_block_position(block_index + 1);
+            m_block_store.element_blocks[block_index + 1] = data_from_dst.release();
+            m_hdl_event.element_block_acquired(m_block_store.element_blocks[block_index + 1]);
+        }
+        return;
     }
 
-    // Current block is already empty. Just extend its size.
-    m_block_store.sizes[block_index1] = empty_block_size;
-    m_block_store.positions[block_index1] = start_row;
-    return get_iterator(block_index1);
+    // Source range is in the middle of a block.
+    assert(src_offset && src_tail_len);
+    block_index = set_new_block_to_middle(block_index, src_offset, len, false);
+    m_block_store.element_blocks[block_index] = data_from_dst.release();
+    m_hdl_event.element_block_acquired(m_block_store.element_blocks[block_index]);
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::erase_impl(size_type start_row, size_type end_row)
+void multi_type_vector<Traits>::swap_single_to_multi_blocks(
+    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index,
+    size_type dst_block_index1, size_type dst_block_index2)
 {
-    assert(start_row <= end_row);
-
-    // Keep the logic similar to set_empty().
-
-    size_type block_pos1 = get_block_position(start_row);
-    if (block_pos1 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::erase_impl", __LINE__, start_row, block_size(), size());
+    base_element_block* src_data = m_block_store.element_blocks[block_index];
+    size_type start_pos_in_block = m_block_store.positions[block_index];
+    size_type dst_start_pos_in_block1 = other.m_block_store.positions[dst_block_index1];
+    size_type dst_start_pos_in_block2 = other.m_block_store.positions[dst_block_index2];
 
-    size_type block_pos2 = get_block_position(end_row, block_pos1);
-    if (block_pos2 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::erase_impl", __LINE__, start_row, block_size(), size());
+    element_t cat_src = src_data ? mtv::get_block_type(*src_data) : mtv::element_type_empty;
 
-    size_type start_row_in_block1 = m_block_store.positions[block_pos1];
-    size_type start_row_in_block2 = m_block_store.positions[block_pos2];
+    size_type len = end_pos - start_pos + 1;
 
-    if (block_pos1 == block_pos2)
+    if (cat_src == mtv::element_type_empty)
     {
-        erase_in_single_block(start_row, end_row, block_pos1);
+        // The source block is empty. Use transfer.
+        other.transfer_multi_blocks(
+            other_pos, other_pos + len - 1, dst_block_index1, dst_block_index2, *this, start_pos);
         return;
     }
 
-    assert(block_pos1 < block_pos2);
+    size_type src_offset = start_pos - start_pos_in_block;
+    size_type dst_offset1 = other_pos - dst_start_pos_in_block1;
+    size_type dst_offset2 = other_pos + len - 1 - dst_start_pos_in_block2;
 
-    // Initially, we set to erase all blocks between the first and the last.
-    size_type index_erase_begin = block_pos1 + 1;
-    size_type index_erase_end = block_pos2;
+    // length of the tail that will not be swapped.
+    size_type src_tail_len = m_block_store.sizes[block_index] - src_offset - len;
 
-    // First, inspect the first block.
-    if (start_row_in_block1 == start_row)
-    {
-        // Erase the whole block.
-        --index_erase_begin;
-    }
-    else
+    // Get the new elements from the other instance.
+    blocks_type new_blocks;
+    other.exchange_elements(
+        *src_data, src_offset, dst_block_index1, dst_offset1, dst_block_index2, dst_offset2, len, new_blocks);
+
+    new_blocks.check_integrity();
+
+    if (new_blocks.positions.empty())
+        throw general_error("multi_type_vector::swap_single_to_multi_blocks: failed to exchange elements.");
+
+    if (src_offset == 0)
     {
-        // Erase the lower part of the first element block.
-        base_element_block* blk_data = m_block_store.element_blocks[block_pos1];
-        size_type new_size = start_row - start_row_in_block1;
-        if (blk_data)
+        // Source range is at the top of a block.
+
+        size_type src_position = m_block_store.positions[block_index];
+
+        if (src_tail_len == 0)
         {
-            // Shrink the element block.
-            block_funcs::overwrite_values(*blk_data, new_size, m_block_store.sizes[block_pos1] - new_size);
-            block_funcs::resize_block(*blk_data, new_size);
+            // the whole block needs to be replaced.  Delete the block, but
+            // don't delete the managed elements the block contains since they
+            // have been transferred over to the destination block.
+            block_funcs::resize_block(*src_data, 0);
+            delete_element_block(block_index);
+            m_block_store.erase(block_index);
         }
-        m_block_store.sizes[block_pos1] = new_size;
+        else
+        {
+            // Shrink the current block by erasing the top part.
+            block_funcs::erase(*src_data, 0, len);
+            m_block_store.sizes[block_index] -= len;
+            m_block_store.positions[block_index] += len;
+        }
+
+        insert_blocks_at(src_position, block_index, new_blocks);
+        merge_with_next_block(block_index + new_blocks.positions.size() - 1); // last block inserted.
+        if (block_index > 0)
+            merge_with_next_block(block_index - 1); // block before the first block inserted.
+
+        return;
     }
 
-    size_type adjust_block_offset = 0;
+    size_type position = 0;
 
-    // Then inspect the last block.
-    size_type last_row_in_block = start_row_in_block2 + m_block_store.sizes[block_pos2] - 1;
-    if (last_row_in_block == end_row)
+    if (src_tail_len == 0)
     {
-        // Delete the whole block.
-        ++index_erase_end;
+        // Source range is at the bottom of a block.
+
+        // Shrink the current block.
+        block_funcs::resize_block(*src_data, src_offset);
+        m_block_store.sizes[block_index] = src_offset;
+        position = m_block_store.positions[block_index] + m_block_store.sizes[block_index];
     }
     else
     {
-        size_type size_to_erase = end_row - start_row_in_block2 + 1;
-        m_block_store.sizes[block_pos2] -= size_to_erase;
-        m_block_store.positions[block_pos2] = start_row;
-        base_element_block* blk_data = m_block_store.element_blocks[block_pos2];
-        if (blk_data)
-        {
-            // Erase the upper part.
-            block_funcs::overwrite_values(*blk_data, 0, size_to_erase);
-            block_funcs::erase(*blk_data, 0, size_to_erase);
-        }
+        // Source range is in the middle of a block.
+        assert(src_offset && src_tail_len);
 
-        adjust_block_offset = 1; // Exclude this block from later block position adjustment.
+        // This will create two new slots at block_index+1, the first of which
+        // we will immediately remove.  The new blocks from the other
+        // container will be inserted at the removed slot.
+        set_new_block_to_middle(block_index, src_offset, len, false);
+        delete_element_block(block_index + 1);
+        m_block_store.erase(block_index + 1);
+        position = m_block_store.positions[block_index] + m_block_store.sizes[block_index];
     }
 
-    // Get the index of the block that sits before the blocks being erased.
-    block_pos1 = index_erase_begin;
-    if (block_pos1 > 0)
-        --block_pos1;
-
-    // Now, erase all blocks in between.
-    delete_element_blocks(index_erase_begin, index_erase_end);
-    m_block_store.erase(index_erase_begin, index_erase_end - index_erase_begin);
-    int64_t delta = end_row - start_row + 1;
-    m_cur_size -= delta;
-
-    if (m_block_store.positions.empty())
-        return;
-
-    // Adjust the positions of the blocks following the erased.
-    size_type adjust_pos = index_erase_begin;
-    adjust_pos += adjust_block_offset;
-    adjust_block_positions_func{}(m_block_store, adjust_pos, -delta);
-    merge_with_next_block(block_pos1);
+    insert_blocks_at(position, block_index + 1, new_blocks);
+    merge_with_next_block(block_index + new_blocks.positions.size()); // last block inserted.
+    merge_with_next_block(block_index); // block before the first block inserted.
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::erase_in_single_block(size_type start_pos, size_type end_pos, size_type block_index)
+void multi_type_vector<Traits>::swap_multi_to_multi_blocks(
+    multi_type_vector& other, size_type start_pos, size_type end_pos, size_type other_pos, size_type block_index1,
+    size_type block_index2, size_type dblock_index1, size_type dblock_index2)
 {
-    // Range falls within the same block.
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-    int64_t size_to_erase = end_pos - start_pos + 1;
+    assert(block_index1 < block_index2);
+    assert(dblock_index1 < dblock_index2);
 
-    if (blk_data)
-    {
-        // Erase data in the data block.
-        size_type offset = start_pos - m_block_store.positions[block_index];
-        block_funcs::overwrite_values(*blk_data, offset, size_to_erase);
-        block_funcs::erase(*blk_data, offset, size_to_erase);
-    }
+    size_type start_pos_in_block1 = m_block_store.positions[block_index1];
+    size_type start_pos_in_block2 = m_block_store.positions[block_index2];
+    size_type start_pos_in_dblock1 = other.m_block_store.positions[dblock_index1];
+    size_type start_pos_in_dblock2 = other.m_block_store.positions[dblock_index2];
 
-    m_block_store.sizes[block_index] -= size_to_erase;
-    m_cur_size -= size_to_erase;
+    size_type len = end_pos - start_pos + 1;
+    size_type src_offset1 = start_pos - start_pos_in_block1;
+    size_type src_offset2 = end_pos - start_pos_in_block2;
+    size_type dst_offset1 = other_pos - start_pos_in_dblock1;
+    size_type dst_offset2 = other_pos + len - 1 - start_pos_in_dblock2;
 
-    if (m_block_store.sizes[block_index])
+    blocks_to_transfer src_bucket, dst_bucket;
+    prepare_blocks_to_transfer(src_bucket, block_index1, src_offset1, block_index2, src_offset2);
+    other.prepare_blocks_to_transfer(dst_bucket, dblock_index1, dst_offset1, dblock_index2, dst_offset2);
+
+    size_type position = 0;
+    if (src_bucket.insert_index > 0)
     {
-        // Block still contains data.  Bail out.
-        adjust_block_positions_func{}(m_block_store, block_index + 1, -size_to_erase);
-        return;
+        size_type i = src_bucket.insert_index - 1;
+        position = m_block_store.positions[i] + m_block_store.sizes[i];
     }
+    insert_blocks_at(position, src_bucket.insert_index, dst_bucket.blocks);
 
-    // Delete the current block since it has become empty.
-    delete_element_block(block_index);
-    m_block_store.erase(block_index);
+    // Merge the boundary blocks in the source.
+    merge_with_next_block(src_bucket.insert_index + dst_bucket.blocks.positions.size() - 1);
+    if (src_bucket.insert_index > 0)
+        merge_with_next_block(src_bucket.insert_index - 1);
 
-    if (block_index == 0)
+    position = 0;
+    if (dst_bucket.insert_index > 0)
     {
-        // Deleted block was the first block.
-        adjust_block_positions_func{}(m_block_store, block_index, -size_to_erase);
-        return;
+        size_type i = dst_bucket.insert_index - 1;
+        position = other.m_block_store.positions[i] + other.m_block_store.sizes[i];
     }
+    other.insert_blocks_at(position, dst_bucket.insert_index, src_bucket.blocks);
 
-    if (block_index >= m_block_store.positions.size())
-        // Deleted block was the last block.
-        return;
+    // Merge the boundary blocks in the destination.
+    other.merge_with_next_block(dst_bucket.insert_index + src_bucket.blocks.positions.size() - 1);
+    if (dst_bucket.insert_index > 0)
+        other.merge_with_next_block(dst_bucket.insert_index - 1);
+}
 
-    // Check the previous and next blocks to see if they should be merged.
-    base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
-    base_element_block* next_data = m_block_store.element_blocks[block_index];
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_cells_impl(
+    size_type row, size_type block_index, const T& it_begin, const T& it_end)
+{
+    size_type start_row = m_block_store.positions[block_index];
+    size_type length = std::distance(it_begin, it_end);
+    if (!length)
+        // empty data array.  nothing to do.
+        return make_end();
 
-    if (prev_data)
+    element_t cat = mdds_mtv_get_element_type(*it_begin);
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
+    if (!blk_data)
     {
-        // Previous block has data.
-        if (!next_data)
+        if (row == start_row)
         {
-            // Next block is empty.  Nothing to do.
-            adjust_block_positions_func{}(m_block_store, block_index, -size_to_erase);
-            return;
-        }
+            // Insert into an empty block.  Check the previos block (if exists)
+            // to see if the data can be appended to it if inserting at the top
+            // of the block.
+            bool blk0 = is_previous_block_of_type(block_index, cat);
 
-        element_t cat1 = mdds::mtv::get_block_type(*prev_data);
-        element_t cat2 = mdds::mtv::get_block_type(*next_data);
+            if (blk0)
+            {
+                // Append to the previous block.
+                base_element_block* blk0_data = m_block_store.element_blocks[block_index - 1];
+                mdds_mtv_append_values(*blk0_data, *it_begin, it_begin, it_end);
+                m_block_store.sizes[block_index - 1] += length;
+                m_cur_size += length;
+                adjust_block_positions(block_index, length);
 
-        if (cat1 == cat2)
-        {
-            // Merge the two blocks.
-            block_funcs::append_block(*prev_data, *next_data);
-            m_block_store.sizes[block_index - 1] += m_block_store.sizes[block_index];
-            // Resize to 0 to prevent deletion of cells in case of managed cells.
-            block_funcs::resize_block(*next_data, 0);
-            delete_element_block(block_index);
-            m_block_store.erase(block_index);
+                return get_iterator(block_index - 1);
+            }
+
+            // Just insert a new block before the current block.
+            size_type position = m_block_store.positions[block_index];
+            m_block_store.insert(block_index, position, length, nullptr);
+            m_block_store.element_blocks[block_index] = create_element_block(cat);
+            blk_data = m_block_store.element_blocks[block_index];
+            m_hdl_event.element_block_acquired(blk_data);
+            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+            m_cur_size += length;
+            adjust_block_positions(block_index + 1, length);
+
+            return get_iterator(block_index);
         }
 
-        adjust_block_positions_func{}(m_block_store, block_index, -size_to_erase);
+        insert_cells_to_middle(row, block_index, it_begin, it_end);
+        m_cur_size += length;
+
+        return get_iterator(block_index + 1);
     }
-    else
+
+    assert(blk_data);
+    element_t blk_cat = mdds::mtv::get_block_type(*blk_data);
+    if (cat == blk_cat)
     {
-        // Previous block is empty.
-        if (next_data)
-        {
-            // Next block is not empty.  Nothing to do.
-            adjust_block_positions_func{}(m_block_store, block_index, -size_to_erase);
-            return;
-        }
+        // Simply insert the new data series into existing block.
+        assert(it_begin != it_end);
+        mdds_mtv_insert_values(*blk_data, row - start_row, *it_begin, it_begin, it_end);
+        m_block_store.sizes[block_index] += length;
+        m_cur_size += length;
+        adjust_block_positions(block_index + 1, length);
 
-        // Both blocks are empty.  Simply increase the size of the previous
-        // block.
-        m_block_store.sizes[block_index - 1] += m_block_store.sizes[block_index];
-        delete_element_block(block_index);
-        m_block_store.erase(block_index);
-        adjust_block_positions_func{}(m_block_store, block_index, -size_to_erase);
+        return get_iterator(block_index);
     }
-}
-
-template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_empty_impl(
-    size_type pos, size_type block_index, size_type length)
-{
-    assert(pos < m_cur_size);
 
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-
-    if (!blk_data)
-    {
-        // Insertion point is already empty.  Just expand its size and be done
-        // with it.
-        m_block_store.sizes[block_index] += length;
-        m_cur_size += length;
-        adjust_block_positions_func{}(m_block_store, block_index + 1, length);
-        return get_iterator(block_index);
-    }
-
-    size_type start_pos = m_block_store.positions[block_index];
-
-    if (start_pos == pos)
+    assert(cat != blk_cat);
+    if (row == start_row)
     {
-        // Insertion point is at the top of an existing non-empty block.
-        bool blk_prev = is_previous_block_of_type(block_index, mtv::element_type_empty);
-        if (blk_prev)
+        // Check the previous block to see if we can append the data there.
+        bool blk0 = is_previous_block_of_type(block_index, cat);
+        if (blk0)
         {
-            // Previous block is empty.  Expand the size of the previous block.
-            assert(!m_block_store.element_blocks[block_index - 1]);
+            // Append to the previous block.
+            base_element_block* blk0_data = m_block_store.element_blocks[block_index - 1];
+            mdds_mtv_append_values(*blk0_data, *it_begin, it_begin, it_end);
             m_block_store.sizes[block_index - 1] += length;
             m_cur_size += length;
-            adjust_block_positions_func{}(m_block_store, block_index, length);
+            adjust_block_positions(block_index, length);
+
             return get_iterator(block_index - 1);
         }
 
-        // Insert a new empty block.
-        m_block_store.insert(block_index, start_pos, length, nullptr);
+        // Just insert a new block before the current block.
+        m_block_store.insert(block_index, m_block_store.positions[block_index], length, nullptr);
+        m_block_store.element_blocks[block_index] = create_element_block(cat);
+        m_hdl_event.element_block_acquired(blk_data);
+        blk_data = m_block_store.element_blocks[block_index];
+        mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+        m_block_store.sizes[block_index] = length;
         m_cur_size += length;
-        adjust_block_positions_func{}(m_block_store, block_index + 1, length);
-        return get_iterator(block_index);
-    }
-
-    assert(blk_data);
-    assert(pos > start_pos);
-
-    size_type size_blk_prev = pos - start_pos;
-    size_type size_blk_next = m_block_store.sizes[block_index] - size_blk_prev;
-
-    // Insert two new blocks below the current; one for the empty block being
-    // inserted, and the other for the lower part of the current non-empty
-    // block.
-    m_block_store.insert(block_index + 1, 2u);
-
-    m_block_store.sizes[block_index + 1] = length;
-    m_block_store.sizes[block_index + 2] = size_blk_next;
-
-    m_block_store.element_blocks[block_index + 2] =
-        block_funcs::create_new_block(mdds::mtv::get_block_type(*blk_data), 0);
-    base_element_block* next_data = m_block_store.element_blocks[block_index + 2];
-    m_hdl_event.element_block_acquired(next_data);
-
-    // Check if the previous block is the bigger one
-    if (size_blk_prev > size_blk_next)
-    {
-        // Upper (previous) block is larger than the lower (next) block. Copy
-        // the lower values to the next block.
-        block_funcs::assign_values_from_block(*next_data, *blk_data, size_blk_prev, size_blk_next);
-        block_funcs::resize_block(*blk_data, size_blk_prev);
-        m_block_store.sizes[block_index] = size_blk_prev;
-    }
-    else
-    {
-        // Lower (next) block is larger than the upper (previous) block. Copy
-        // the upper values to the "next" block.
-        block_funcs::assign_values_from_block(*next_data, *blk_data, 0, size_blk_prev);
-        m_block_store.sizes[block_index + 2] = size_blk_prev;
+        adjust_block_positions(block_index + 1, length);
 
-        // Remove the copied values and push the rest to the top.
-        block_funcs::erase(*blk_data, 0, size_blk_prev);
-
-        // Set the size of the current block to its new size ( what is after the new block )
-        m_block_store.sizes[block_index] = size_blk_next;
-
-        // And now let's swap the blocks, but save the block position.
-        size_type position = m_block_store.positions[block_index];
-        m_block_store.swap(block_index, block_index + 2);
-        m_block_store.positions[block_index] = position;
+        return get_iterator(block_index);
     }
 
+    insert_cells_to_middle(row, block_index, it_begin, it_end);
     m_cur_size += length;
-    m_block_store.calc_block_position(block_index + 1);
-    m_block_store.calc_block_position(block_index + 2);
-    adjust_block_positions_func{}(m_block_store, block_index + 3, length);
 
     return get_iterator(block_index + 1);
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::insert_blocks_at(size_type position, size_type insert_pos, blocks_type& new_blocks)
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty_impl(
+    size_type start_pos, size_type end_pos, size_type block_index1, bool overwrite)
 {
-    for (size_type i = 0; i < new_blocks.positions.size(); ++i)
-    {
-        new_blocks.positions[i] = position;
-        position += new_blocks.sizes[i];
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
 
-        const base_element_block* data = new_blocks.element_blocks[i];
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::set_empty_impl", __LINE__, end_pos, block_size(), size());
 
-        if (data)
-            m_hdl_event.element_block_acquired(data);
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    iterator ret_it;
+    {
+        position_shift_scope shift_scope(*this, block_index1, end_pos);
+        if (block_index1 == block_index2)
+            ret_it = set_empty_in_single_block(start_pos, end_pos, block_index1, overwrite);
+        else
+            ret_it = set_empty_in_multi_blocks(start_pos, end_pos, block_index1, block_index2, overwrite);
     }
 
-    m_block_store.insert(insert_pos, new_blocks);
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in set_empty(start_pos=" << start_pos << "; end_pos=" << end_pos << ")"
+           << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+    return ret_it;
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::prepare_blocks_to_transfer(
-    blocks_to_transfer& bucket, size_type block_index1, size_type offset1, size_type block_index2, size_type offset2)
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty_in_single_block(
+    size_type start_row, size_type end_row, size_type block_index, bool overwrite)
 {
-    assert(block_index1 < block_index2);
-    assert(offset1 < m_block_store.sizes[block_index1]);
-    assert(offset2 < m_block_store.sizes[block_index2]);
-
-    block_slot_type block_first;
-    block_slot_type block_last;
-    size_type index_begin = block_index1 + 1;
-    size_type index_end = block_index2;
+    // Range is within a single block.
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
+    if (!blk_data)
+        // This block is already empty.  Do nothing.
+        return get_iterator(block_index);
 
-    bucket.insert_index = block_index1 + 1;
+    size_type start_row_in_block = m_block_store.positions[block_index];
+    assert(start_row_in_block + m_block_store.sizes[block_index] >= 1);
+    size_type end_row_in_block = start_row_in_block + m_block_store.sizes[block_index] - 1;
+    size_type empty_block_size = end_row - start_row + 1;
 
-    if (offset1 == 0)
-    {
-        // The whole first block needs to be swapped.
-        --index_begin;
-        --bucket.insert_index;
-    }
-    else
+    if (start_row == start_row_in_block)
     {
-        // Copy the lower part of the block for transfer.
-        size_type blk_size = m_block_store.sizes[block_index1] - offset1;
-        block_first.size = blk_size;
-
-        base_element_block* blk_data1 = m_block_store.element_blocks[block_index1];
-        if (blk_data1)
-        {
-            block_first.element_block = block_funcs::create_new_block(mtv::get_block_type(*blk_data1), 0);
-            block_funcs::assign_values_from_block(*block_first.element_block, *blk_data1, offset1, blk_size);
+        // start row coincides with the start of a block.
 
-            // Shrink the existing block.
-            block_funcs::resize_block(*blk_data1, offset1);
-        }
+        if (end_row == end_row_in_block)
+            return set_whole_block_empty(block_index, overwrite);
 
-        m_block_store.sizes[block_index1] = offset1;
-    }
+        // Set the upper part of the block empty.
+        if (overwrite)
+            block_funcs::overwrite_values(*blk_data, 0, empty_block_size);
 
-    if (offset2 == m_block_store.sizes[block_index2] - 1)
-    {
-        // The entire last block needs to be swapped.
-        ++index_end;
-    }
-    else
-    {
-        // Copy the upper part of the last block for transfer.
-        size_type blk_size = offset2 + 1;
-        block_last.size = blk_size;
-        base_element_block* blk_data2 = m_block_store.element_blocks[block_index2];
+        block_funcs::erase(*blk_data, 0, empty_block_size);
+        m_block_store.sizes[block_index] -= empty_block_size;
 
-        if (blk_data2)
+        // Check if the preceding block (if exists) is also empty.
+        bool blk_prev = is_previous_block_of_type(block_index, mtv::element_type_empty);
+        if (blk_prev)
         {
-            block_last.element_block = block_funcs::create_new_block(mtv::get_block_type(*blk_data2), 0);
-            block_funcs::assign_values_from_block(*block_last.element_block, *blk_data2, 0, blk_size);
-
-            // Shrink the existing block.
-            block_funcs::erase(*blk_data2, 0, blk_size);
+            // Extend the previous empty block.
+            m_block_store.sizes[block_index - 1] += empty_block_size;
+            m_block_store.positions[block_index] += empty_block_size;
+            return get_iterator(block_index - 1);
         }
 
-        m_block_store.positions[block_index2] += blk_size;
-        m_block_store.sizes[block_index2] -= blk_size;
+        // Insert a new empty block before the current one.
+        size_type block_position = m_block_store.positions[block_index];
+        m_block_store.positions[block_index] += empty_block_size;
+        m_block_store.insert(block_index, block_position, empty_block_size, nullptr);
+        return get_iterator(block_index);
     }
 
-    // Copy all blocks into the bucket.
-    if (block_first.size)
-        bucket.blocks.push_back(block_first);
-
-    for (size_type i = index_begin; i < index_end; ++i)
+    if (end_row == end_row_in_block)
     {
-        base_element_block* data = m_block_store.element_blocks[i];
-        if (data)
-            m_hdl_event.element_block_released(data);
+        // end row equals the end of a block.
+        assert(start_row > start_row_in_block);
 
-        bucket.blocks.push_back(m_block_store.positions[i], m_block_store.sizes[i], m_block_store.element_blocks[i]);
+        // Set the lower part of the block empty.
+        size_type start_pos = start_row - start_row_in_block;
+        if (overwrite)
+            block_funcs::overwrite_values(*blk_data, start_pos, empty_block_size);
+
+        block_funcs::erase(*blk_data, start_pos, empty_block_size);
+        m_block_store.sizes[block_index] -= empty_block_size;
+
+        // Check if the following block (if exists) is also empty.
+        bool blk_next = is_next_block_of_type(block_index, mtv::element_type_empty);
+        if (blk_next)
+        {
+            // Extend the next empty block to cover the new empty segment.
+            m_block_store.sizes[block_index + 1] += empty_block_size;
+            m_block_store.positions[block_index + 1] = start_row;
+        }
+        else
+        {
+            // Insert a new empty block after the current one.
+            m_block_store.insert(block_index + 1, start_row, empty_block_size, nullptr);
+        }
+
+        return get_iterator(block_index + 1);
     }
 
-    if (block_last.size)
-        bucket.blocks.push_back(block_last);
+    // Empty the middle part of a block.
+    assert(end_row_in_block - end_row > 0);
+    set_new_block_to_middle(block_index, start_row - start_row_in_block, empty_block_size, overwrite);
 
-    // Remove the slots for these blocks (but don't delete the blocks).
-    m_block_store.erase(index_begin, index_end - index_begin);
+    return get_iterator(block_index + 1);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_whole_block_empty(
-    size_type block_index, bool overwrite)
-{
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-    if (!overwrite)
-        // Resize block to 0 before deleting, to prevent its elements from getting deleted.
-        block_funcs::resize_block(*blk_data, 0);
-
-    delete_element_block(block_index);
-
-    bool blk_prev = is_previous_block_of_type(block_index, mtv::element_type_empty);
-    bool blk_next = is_next_block_of_type(block_index, mtv::element_type_empty);
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_empty_in_multi_blocks(
+    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, bool overwrite)
+{
+    assert(block_index1 < block_index2);
+    size_type start_row_in_block1 = m_block_store.positions[block_index1];
+    size_type start_row_in_block2 = m_block_store.positions[block_index2];
 
-    // Merge with adjacent block(s) if necessary.
-    if (blk_prev)
     {
-        assert(!m_block_store.element_blocks[block_index - 1]);
-
-        if (blk_next)
+        // Empty the lower part of the first block.
+        base_element_block* blk_data = m_block_store.element_blocks[block_index1];
+        if (blk_data)
         {
-            // Both preceding and next blocks are empty.
-            assert(!m_block_store.element_blocks[block_index + 1]);
+            if (start_row_in_block1 == start_row)
+            {
+                // Empty the whole block.
 
-            m_block_store.sizes[block_index - 1] +=
-                m_block_store.sizes[block_index] + m_block_store.sizes[block_index + 1];
+                bool prev_empty = is_previous_block_of_type(block_index1, mtv::element_type_empty);
+                if (prev_empty)
+                {
+                    // Previous block is empty.  Move the start row to the
+                    // first row of the previous block, and make the previous
+                    // block 'block 1'.
+                    start_row -= m_block_store.sizes[block_index1 - 1];
+                    --block_index1;
+                }
+                else
+                {
+                    // Make block 1 empty.
+                    if (!overwrite)
+                        block_funcs::resize_block(*blk_data, 0);
 
-            // No need delete the current and next element blocks since they are both empty.
-            m_block_store.erase(block_index, 2);
+                    delete_element_block(block_index1);
+                }
+            }
+            else
+            {
+                // Empty the lower part.
+                size_type new_size = start_row - start_row_in_block1;
+                if (overwrite)
+                    block_funcs::overwrite_values(*blk_data, new_size, m_block_store.sizes[block_index1] - new_size);
 
-            return get_iterator(block_index - 1);
+                block_funcs::resize_block(*blk_data, new_size);
+                m_block_store.sizes[block_index1] = new_size;
+            }
+        }
+        else
+        {
+            // First block is already empty.  Adjust the start row of the new
+            // empty range.
+            start_row = start_row_in_block1;
         }
+    }
 
-        // Only the preceding block is empty. Merge the current block with the previous.
-        m_block_store.sizes[block_index - 1] += m_block_store.sizes[block_index];
-        m_block_store.erase(block_index);
+    size_type end_block_to_erase = block_index2; // End block position is non-inclusive.
 
-        return get_iterator(block_index - 1);
-    }
-    else if (blk_next)
     {
-        assert(!m_block_store.element_blocks[block_index + 1]);
+        // Empty the upper part of the last block.
+        base_element_block* blk_data = m_block_store.element_blocks[block_index2];
+        size_type last_row_in_block = start_row_in_block2 + m_block_store.sizes[block_index2] - 1;
 
-        // Only the next block is empty. Merge the next block with the current.
-        m_block_store.sizes[block_index] += m_block_store.sizes[block_index + 1];
-        m_block_store.erase(block_index + 1);
+        if (blk_data)
+        {
+            if (last_row_in_block == end_row)
+            {
+                // Delete the whole block.
+                ++end_block_to_erase;
 
-        return get_iterator(block_index);
+                // Check if the following block (if exists) is also empty.
+                bool next_empty = is_next_block_of_type(block_index2, mtv::element_type_empty);
+                if (next_empty)
+                {
+                    // The following block is also empty.
+                    end_row += m_block_store.sizes[block_index2 + 1];
+                    ++end_block_to_erase;
+                }
+            }
+            else
+            {
+                // Empty the upper part.
+                size_type size_to_erase = end_row - start_row_in_block2 + 1;
+                if (overwrite)
+                    block_funcs::overwrite_values(*blk_data, 0, size_to_erase);
+
+                block_funcs::erase(*blk_data, 0, size_to_erase);
+                m_block_store.sizes[block_index2] -= size_to_erase;
+                m_block_store.positions[block_index2] = start_row_in_block2 + size_to_erase;
+            }
+        }
+        else
+        {
+            // Last block is empty.  Delete this block and adjust the end row
+            // of the new empty range.
+            ++end_block_to_erase;
+            end_row = last_row_in_block;
+        }
     }
 
-    return get_iterator(block_index);
-}
+    if (end_block_to_erase - block_index1 > 1)
+    {
+        // Remove all blocks in-between, from block_index1+1 to end_block_to_erase-1.
 
-template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_impl(
-    size_type row, size_type end_row, size_type block_index1, const T& it_begin, const T& it_end)
-{
-    size_type block_index2 = get_block_position(end_row, block_index1);
-    if (block_index2 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::set_cells_impl", __LINE__, end_row, block_size(), size());
+        for (size_type i = block_index1 + 1; i < end_block_to_erase; ++i)
+        {
+            base_element_block* data = m_block_store.element_blocks[i];
+            if (!overwrite && data)
+                block_funcs::resize_block(*data, 0);
 
-    if (block_index1 == block_index2)
+            delete_element_block(i);
+        }
+
+        size_type n_erase_blocks = end_block_to_erase - block_index1 - 1;
+        m_block_store.erase(block_index1 + 1, n_erase_blocks);
+    }
+
+    base_element_block* blk_data = m_block_store.element_blocks[block_index1];
+    size_type empty_block_size = end_row - start_row + 1;
+    if (blk_data)
     {
-        // The whole data array will fit in a single block.
-        return set_cells_to_single_block(row, end_row, block_index1, it_begin, it_end);
+        // Insert a new empty block after the first block.
+        m_block_store.insert(block_index1 + 1, start_row, empty_block_size, nullptr);
+        return get_iterator(block_index1 + 1);
     }
 
-    return set_cells_to_multi_blocks(row, end_row, block_index1, block_index2, it_begin, it_end);
+    // Current block is already empty. Just extend its size.
+    m_block_store.sizes[block_index1] = empty_block_size;
+    m_block_store.positions[block_index1] = start_row;
+    return get_iterator(block_index1);
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_single_block(
-    size_type start_row, size_type end_row, size_type block_index, const T& it_begin, const T& it_end)
+void multi_type_vector<Traits>::erase_impl(size_type start_row, size_type end_row)
 {
-    assert(it_begin != it_end);
-    assert(!m_block_store.positions.empty());
-
-    element_t cat = mdds_mtv_get_element_type(*it_begin);
-    size_type start_row_in_block = m_block_store.positions[block_index];
-    size_type data_length = std::distance(it_begin, it_end);
-    base_element_block* blk_data = m_block_store.element_blocks[block_index];
-
-    if (blk_data && mdds::mtv::get_block_type(*blk_data) == cat)
-    {
-        // t|---|xxx|---|b - Simple overwrite.
-        size_type offset = start_row - start_row_in_block;
-        block_funcs::overwrite_values(*blk_data, offset, data_length);
-        if (!offset && data_length == m_block_store.sizes[block_index])
-            // Overwrite the whole block.  It's faster to use assign_values.
-            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
-        else
-            mdds_mtv_set_values(*blk_data, offset, *it_begin, it_begin, it_end);
+    assert(start_row <= end_row);
 
-        return get_iterator(block_index);
-    }
+    // Keep the logic similar to set_empty().
 
-    size_type end_row_in_block = start_row_in_block + m_block_store.sizes[block_index] - 1;
-    if (start_row == start_row_in_block)
-    {
-        if (end_row == end_row_in_block)
-        {
-            // t|???|xxx|???|b - Replace the entire current block, but first try
-            // to see if the values can be appended to the previous block.
-            if (append_to_prev_block(block_index, cat, end_row - start_row + 1, it_begin, it_end))
-            {
-                delete_element_block(block_index);
-                m_block_store.erase(block_index);
+    size_type block_pos1 = get_block_position(start_row);
+    if (block_pos1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::erase_impl", __LINE__, start_row, block_size(), size());
 
-                // Check if we need to merge it with the next block.
-                --block_index;
-                merge_with_next_block(block_index);
+    size_type block_pos2 = get_block_position(end_row, block_pos1);
+    if (block_pos2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::erase_impl", __LINE__, start_row, block_size(), size());
 
-                return get_iterator(block_index);
-            }
+    size_type start_row_in_block1 = m_block_store.positions[block_pos1];
+    size_type start_row_in_block2 = m_block_store.positions[block_pos2];
 
-            // Replace the whole block.
-            if (blk_data)
-            {
-                m_hdl_event.element_block_released(blk_data);
-                block_funcs::delete_block(blk_data);
-            }
+    if (block_pos1 == block_pos2)
+    {
+        erase_in_single_block(start_row, end_row, block_pos1);
+        return;
+    }
 
-            m_block_store.element_blocks[block_index] = block_funcs::create_new_block(cat, 0);
-            blk_data = m_block_store.element_blocks[block_index];
-            m_hdl_event.element_block_acquired(blk_data);
-            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
-            merge_with_next_block(block_index);
-            return get_iterator(block_index);
-        }
+    assert(block_pos1 < block_pos2);
 
-        // t|???|xxx--|???|b - Replace the upper part of the block. Shrink the
-        // current block first.
-        size_type length = end_row_in_block - end_row;
-        m_block_store.sizes[block_index] = length;
+    // Initially, we set to erase all blocks between the first and the last.
+    size_type index_erase_begin = block_pos1 + 1;
+    size_type index_erase_end = block_pos2;
 
+    // First, inspect the first block.
+    if (start_row_in_block1 == start_row)
+    {
+        // Erase the whole block.
+        --index_erase_begin;
+    }
+    else
+    {
+        // Erase the lower part of the first element block.
+        base_element_block* blk_data = m_block_store.element_blocks[block_pos1];
+        size_type new_size = start_row - start_row_in_block1;
         if (blk_data)
         {
-            // Erase the upper part of the data from the current element block.
-            std::unique_ptr<base_element_block, element_block_deleter> new_data(
-                block_funcs::create_new_block(mdds::mtv::get_block_type(*blk_data), 0));
+            // Shrink the element block.
+            block_funcs::overwrite_values(*blk_data, new_size, m_block_store.sizes[block_pos1] - new_size);
+            block_funcs::resize_block(*blk_data, new_size);
+        }
+        m_block_store.sizes[block_pos1] = new_size;
+    }
 
-            if (!new_data)
-                throw std::logic_error("failed to create a new element block.");
+    size_type adjust_block_offset = 0;
 
-            size_type pos = end_row - start_row_in_block + 1;
-            block_funcs::assign_values_from_block(*new_data, *blk_data, pos, length);
-            block_funcs::overwrite_values(*blk_data, 0, pos);
-
-            block_funcs::resize_block(*blk_data, 0); // to prevent deletion of elements
-            block_funcs::delete_block(blk_data);
-            m_block_store.element_blocks[block_index] = new_data.release();
-
-            // We intentionally don't trigger element block events here.
-        }
-
-        length = end_row - start_row + 1;
-        if (append_to_prev_block(block_index, cat, length, it_begin, it_end))
-        {
-            // The new values have been successfully appended to the previous block.
-            m_block_store.positions[block_index] += length;
-            return get_iterator(block_index - 1);
-        }
-
-        // Insert a new block before the current block, and populate it with
-        // the new data.
-        size_type position = m_block_store.positions[block_index];
-        m_block_store.positions[block_index] += length;
-        m_block_store.insert(block_index, position, length, nullptr);
-        m_block_store.element_blocks[block_index] = block_funcs::create_new_block(cat, 0);
-        blk_data = m_block_store.element_blocks[block_index];
-        m_hdl_event.element_block_acquired(blk_data);
-        m_block_store.sizes[block_index] = length;
-        mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
-
-        return get_iterator(block_index);
+    // Then inspect the last block.
+    size_type last_row_in_block = start_row_in_block2 + m_block_store.sizes[block_pos2] - 1;
+    if (last_row_in_block == end_row)
+    {
+        // Delete the whole block.
+        ++index_erase_end;
     }
-
-    assert(start_row > start_row_in_block);
-    if (end_row == end_row_in_block)
+    else
     {
-        // t|???|--xxx|???|b - Shrink the end of the current block and insert a
-        // new block for the new data series after the current block.
-        size_type new_size = start_row - start_row_in_block;
-        m_block_store.sizes[block_index] = new_size;
-
+        size_type size_to_erase = end_row - start_row_in_block2 + 1;
+        m_block_store.sizes[block_pos2] -= size_to_erase;
+        m_block_store.positions[block_pos2] = start_row;
+        base_element_block* blk_data = m_block_store.element_blocks[block_pos2];
         if (blk_data)
         {
-            block_funcs::overwrite_values(*blk_data, new_size, data_length);
-            block_funcs::resize_block(*blk_data, new_size);
-        }
-
-        new_size = end_row - start_row + 1; // size of the data array being inserted.
-
-        if (block_index < m_block_store.positions.size() - 1)
-        {
-            // t|???|--xxx|???|b - There is a block after the current block..
-            // There is a block (or more) after the current block. Check the next block.
-            bool blk_next = is_next_block_of_type(block_index, cat);
-            if (blk_next)
-            {
-                // t|???|--xxx|xxx|b - Prepend it to the next block.
-                mdds_mtv_prepend_values(*m_block_store.element_blocks[block_index + 1], *it_begin, it_begin, it_end);
-                m_block_store.sizes[block_index + 1] += new_size;
-                m_block_store.positions[block_index + 1] -= new_size;
-                return get_iterator(block_index + 1);
-            }
-
-            // t|???|--xxx|---|b - Next block has a different data type. Do the
-            // normal insertion.
-            m_block_store.insert(block_index + 1, 0, new_size, nullptr);
-            m_block_store.calc_block_position(block_index + 1);
-            m_block_store.element_blocks[block_index + 1] = block_funcs::create_new_block(cat, 0);
-            blk_data = m_block_store.element_blocks[block_index + 1];
-            m_hdl_event.element_block_acquired(blk_data);
-            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
-
-            return get_iterator(block_index + 1);
+            // Erase the upper part.
+            block_funcs::overwrite_values(*blk_data, 0, size_to_erase);
+            block_funcs::erase(*blk_data, 0, size_to_erase);
         }
 
-        // t|???|--xxx|b - Last block.
-        assert(block_index == m_block_store.positions.size() - 1);
-
-        m_block_store.push_back(m_cur_size - new_size, new_size, nullptr);
-        m_block_store.element_blocks.back() = block_funcs::create_new_block(cat, 0);
-        blk_data = m_block_store.element_blocks.back();
-        m_hdl_event.element_block_acquired(blk_data);
-        mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
-
-        return get_iterator(block_index + 1);
+        adjust_block_offset = 1; // Exclude this block from later block position adjustment.
     }
 
-    // t|???|-xx-|???|b - New values will be in the middle of the current block.
-    assert(start_row_in_block < start_row && end_row < end_row_in_block);
+    // Get the index of the block that sits before the blocks being erased.
+    block_pos1 = index_erase_begin;
+    if (block_pos1 > 0)
+        --block_pos1;
 
-    block_index = set_new_block_to_middle(block_index, start_row - start_row_in_block, end_row - start_row + 1, true);
+    // Now, erase all blocks in between.
+    delete_element_blocks(index_erase_begin, index_erase_end);
+    m_block_store.erase(index_erase_begin, index_erase_end - index_erase_begin);
+    int64_t delta = end_row - start_row + 1;
+    m_cur_size -= delta;
 
-    m_block_store.element_blocks[block_index] = block_funcs::create_new_block(cat, 0);
-    blk_data = m_block_store.element_blocks[block_index];
-    m_hdl_event.element_block_acquired(blk_data);
-    mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+    if (m_block_store.positions.empty())
+        return;
 
-    return get_iterator(block_index);
+    // Adjust the positions of the blocks following the erased.
+    size_type adjust_pos = index_erase_begin;
+    adjust_pos += adjust_block_offset;
+    adjust_block_positions(adjust_pos, -delta);
+    merge_with_next_block(block_pos1);
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_multi_blocks(
-    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, const T& it_begin,
-    const T& it_end)
+void multi_type_vector<Traits>::erase_in_single_block(size_type start_pos, size_type end_pos, size_type block_index)
 {
-    assert(block_index1 < block_index2);
-    assert(it_begin != it_end);
-    assert(!m_block_store.positions.empty());
+    // Range falls within the same block.
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
+    int64_t size_to_erase = end_pos - start_pos + 1;
 
-    base_element_block* blk1_data = m_block_store.element_blocks[block_index1];
-    if (blk1_data)
+    if (blk_data)
     {
-        return set_cells_to_multi_blocks_block1_non_empty(
-            start_row, end_row, block_index1, block_index2, it_begin, it_end);
+        // Erase data in the data block.
+        size_type offset = start_pos - m_block_store.positions[block_index];
+        block_funcs::overwrite_values(*blk_data, offset, size_to_erase);
+        block_funcs::erase(*blk_data, offset, size_to_erase);
     }
 
-    // Block 1 is empty.
-    assert(!blk1_data);
+    m_block_store.sizes[block_index] -= size_to_erase;
+    m_cur_size -= size_to_erase;
 
-    return set_cells_to_multi_blocks_block1_non_equal(start_row, end_row, block_index1, block_index2, it_begin, it_end);
-}
+    if (m_block_store.sizes[block_index])
+    {
+        // Block still contains data.  Bail out.
+        adjust_block_positions(block_index + 1, -size_to_erase);
+        return;
+    }
 
-template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_multi_blocks_block1_non_equal(
-    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, const T& it_begin,
-    const T& it_end)
-{
-    element_t cat = mdds_mtv_get_element_type(*it_begin);
-    base_element_block* blk1_data = m_block_store.element_blocks[block_index1];
-    base_element_block* blk2_data = m_block_store.element_blocks[block_index2];
+    // Delete the current block since it has become empty.
+    delete_element_block(block_index);
+    m_block_store.erase(block_index);
 
-    size_type start_row_in_block1 = m_block_store.positions[block_index1];
-    size_type start_row_in_block2 = m_block_store.positions[block_index2];
-    size_type length = std::distance(it_begin, it_end);
-    size_type offset = start_row - start_row_in_block1;
-    size_type end_row_in_block2 = start_row_in_block2 + m_block_store.sizes[block_index2] - 1;
+    if (block_index == 0)
+    {
+        // Deleted block was the first block.
+        adjust_block_positions(block_index, -size_to_erase);
+        return;
+    }
 
-    // Initially set to erase blocks between block 1 and block 2 non-inclusive at either end.
-    size_type index_erase_begin = block_index1 + 1;
-    size_type index_erase_end = block_index2;
+    if (block_index >= m_block_store.positions.size())
+        // Deleted block was the last block.
+        return;
 
-    // Create the new data block first.
-    block_slot_type data_blk(start_row, length);
+    // Check the previous and next blocks to see if they should be merged.
+    base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
+    base_element_block* next_data = m_block_store.element_blocks[block_index];
 
-    bool blk0_copied = false;
-    if (offset == 0)
+    if (prev_data)
     {
-        // Remove block 1.
-        --index_erase_begin;
-
-        // Check the type of the previous block (block 0) if exists.
-        if (block_index1 > 0)
+        // Previous block has data.
+        if (!next_data)
         {
-            base_element_block* blk0_data = m_block_store.element_blocks[block_index1 - 1];
-            if (blk0_data && cat == mdds::mtv::get_block_type(*blk0_data))
-            {
-                // Transfer the whole data from block 0 to data block.
-                data_blk.element_block = blk0_data;
-                m_block_store.element_blocks[block_index1 - 1] = nullptr;
+            // Next block is empty.  Nothing to do.
+            adjust_block_positions(block_index, -size_to_erase);
+            return;
+        }
 
-                data_blk.size += m_block_store.sizes[block_index1 - 1];
-                data_blk.position = m_block_store.positions[block_index1 - 1];
+        element_t cat1 = mdds::mtv::get_block_type(*prev_data);
+        element_t cat2 = mdds::mtv::get_block_type(*next_data);
 
-                --index_erase_begin;
-                blk0_copied = true;
-            }
+        if (cat1 == cat2)
+        {
+            // Merge the two blocks.
+            block_funcs::append_block(*prev_data, *next_data);
+            m_block_store.sizes[block_index - 1] += m_block_store.sizes[block_index];
+            // Resize to 0 to prevent deletion of cells in case of managed cells.
+            block_funcs::resize_block(*next_data, 0);
+            delete_element_block(block_index);
+            m_block_store.erase(block_index);
         }
+
+        adjust_block_positions(block_index, -size_to_erase);
     }
     else
     {
-        // Shrink block 1 by the end.
-        if (blk1_data)
+        // Previous block is empty.
+        if (next_data)
         {
-            size_type n = m_block_store.sizes[block_index1] - offset;
-            block_funcs::overwrite_values(*blk1_data, offset, n);
-            block_funcs::resize_block(*blk1_data, offset);
+            // Next block is not empty.  Nothing to do.
+            adjust_block_positions(block_index, -size_to_erase);
+            return;
         }
-        m_block_store.sizes[block_index1] = offset;
-    }
 
-    if (blk0_copied)
-    {
-        mdds_mtv_append_values(*data_blk.element_block, *it_begin, it_begin, it_end);
+        // Both blocks are empty.  Simply increase the size of the previous
+        // block.
+        m_block_store.sizes[block_index - 1] += m_block_store.sizes[block_index];
+        delete_element_block(block_index);
+        m_block_store.erase(block_index);
+        adjust_block_positions(block_index, -size_to_erase);
     }
-    else
+}
+
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::insert_empty_impl(
+    size_type pos, size_type block_index, size_type length)
+{
+    assert(pos < m_cur_size);
+
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
+
+    if (!blk_data)
     {
-        data_blk.element_block = block_funcs::create_new_block(cat, 0);
-        m_hdl_event.element_block_acquired(data_blk.element_block);
-        mdds_mtv_assign_values(*data_blk.element_block, *it_begin, it_begin, it_end);
+        // Insertion point is already empty.  Just expand its size and be done
+        // with it.
+        m_block_store.sizes[block_index] += length;
+        m_cur_size += length;
+        adjust_block_positions(block_index + 1, length);
+        return get_iterator(block_index);
     }
 
-    if (end_row == end_row_in_block2)
-    {
-        // Remove block 2.
-        ++index_erase_end;
+    size_type start_pos = m_block_store.positions[block_index];
 
-        if (block_index2 + 1 < m_block_store.positions.size())
-        {
-            // There is at least one block after block 2.
-            base_element_block* blk3_data = m_block_store.element_blocks[block_index2 + 1];
-            if (blk3_data && mdds::mtv::get_block_type(*blk3_data) == cat)
-            {
-                // Merge the whole block 3 with the new data. Remove block 3
-                // afterward.  Resize block 3 to zero to prevent invalid free.
-                block_funcs::append_block(*data_blk.element_block, *blk3_data);
-                block_funcs::resize_block(*blk3_data, 0);
-                data_blk.size += m_block_store.sizes[block_index2 + 1];
-                ++index_erase_end;
-            }
+    if (start_pos == pos)
+    {
+        // Insertion point is at the top of an existing non-empty block.
+        bool blk_prev = is_previous_block_of_type(block_index, mtv::element_type_empty);
+        if (blk_prev)
+        {
+            // Previous block is empty.  Expand the size of the previous block.
+            assert(!m_block_store.element_blocks[block_index - 1]);
+            m_block_store.sizes[block_index - 1] += length;
+            m_cur_size += length;
+            adjust_block_positions(block_index, length);
+            return get_iterator(block_index - 1);
         }
+
+        // Insert a new empty block.
+        m_block_store.insert(block_index, start_pos, length, nullptr);
+        m_cur_size += length;
+        adjust_block_positions(block_index + 1, length);
+        return get_iterator(block_index);
     }
-    else
-    {
-        bool erase_upper = true;
 
-        if (blk2_data)
-        {
-            element_t blk_cat2 = mdds::mtv::get_block_type(*blk2_data);
-            if (blk_cat2 == cat)
-            {
-                // Merge the lower part of block 2 with the new data, and erase
-                // block 2.  Resize block 2 to avoid invalid free on the copied
-                // portion of the block.
-                size_type copy_pos = end_row - start_row_in_block2 + 1;
-                size_type size_to_copy = end_row_in_block2 - end_row;
-                block_funcs::append_values_from_block(*data_blk.element_block, *blk2_data, copy_pos, size_to_copy);
-                block_funcs::resize_block(*blk2_data, copy_pos);
-                data_blk.size += size_to_copy;
+    assert(blk_data);
+    assert(pos > start_pos);
 
-                ++index_erase_end;
-                erase_upper = false;
-            }
-        }
+    size_type size_blk_prev = pos - start_pos;
+    size_type size_blk_next = m_block_store.sizes[block_index] - size_blk_prev;
 
-        if (erase_upper)
-        {
-            // Erase the upper part of block 2.
-            size_type size_to_erase = end_row - start_row_in_block2 + 1;
+    // Insert two new blocks below the current; one for the empty block being
+    // inserted, and the other for the lower part of the current non-empty
+    // block.
+    m_block_store.insert(block_index + 1, 2u);
 
-            if (blk2_data)
-            {
-                block_funcs::overwrite_values(*blk2_data, 0, size_to_erase);
-                block_funcs::erase(*blk2_data, 0, size_to_erase);
-            }
+    m_block_store.sizes[block_index + 1] = length;
+    m_block_store.sizes[block_index + 2] = size_blk_next;
 
-            m_block_store.sizes[block_index2] -= size_to_erase;
-            m_block_store.positions[block_index2] += size_to_erase;
-        }
+    m_block_store.element_blocks[block_index + 2] =
+        create_element_block(mdds::mtv::get_block_type(*blk_data));
+    base_element_block* next_data = m_block_store.element_blocks[block_index + 2];
+    m_hdl_event.element_block_acquired(next_data);
+
+    // Check if the previous block is the bigger one
+    if (size_blk_prev > size_blk_next)
+    {
+        // Upper (previous) block is larger than the lower (next) block. Copy
+        // the lower values to the next block.
+        block_funcs::assign_values_from_block(*next_data, *blk_data, size_blk_prev, size_blk_next);
+        block_funcs::resize_block(*blk_data, size_blk_prev);
+        m_block_store.sizes[block_index] = size_blk_prev;
     }
+    else
+    {
+        // Lower (next) block is larger than the upper (previous) block. Copy
+        // the upper values to the "next" block.
+        block_funcs::assign_values_from_block(*next_data, *blk_data, 0, size_blk_prev);
+        m_block_store.sizes[block_index + 2] = size_blk_prev;
 
-    size_type insert_pos = index_erase_begin;
+        // Remove the copied values and push the rest to the top.
+        block_funcs::erase(*blk_data, 0, size_blk_prev);
 
-    // Remove the in-between blocks first.
-    delete_element_blocks(index_erase_begin, index_erase_end);
-    m_block_store.erase(index_erase_begin, index_erase_end - index_erase_begin);
+        // Set the size of the current block to its new size ( what is after the new block )
+        m_block_store.sizes[block_index] = size_blk_next;
 
-    // Insert the new data block.
+        // And now let's swap the blocks, but save the block position.
+        size_type position = m_block_store.positions[block_index];
+        m_block_store.swap(block_index, block_index + 2);
+        m_block_store.positions[block_index] = position;
+    }
 
-    m_block_store.insert(insert_pos, data_blk.position, data_blk.size, data_blk.element_block);
-    return get_iterator(insert_pos);
+    m_cur_size += length;
+    m_block_store.calc_block_position(block_index + 1);
+    m_block_store.calc_block_position(block_index + 2);
+    adjust_block_positions(block_index + 3, length);
+
+    return get_iterator(block_index + 1);
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_multi_blocks_block1_non_empty(
-    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, const T& it_begin,
-    const T& it_end)
+void multi_type_vector<Traits>::insert_blocks_at(size_type position, size_type insert_pos, blocks_type& new_blocks)
 {
-    size_type start_row_in_block1 = m_block_store.positions[block_index1];
-    size_type start_row_in_block2 = m_block_store.positions[block_index2];
+    for (size_type i = 0; i < new_blocks.positions.size(); ++i)
+    {
+        new_blocks.positions[i] = position;
+        position += new_blocks.sizes[i];
 
-    element_t cat = mdds_mtv_get_element_type(*it_begin);
-    base_element_block* blk1_data = m_block_store.element_blocks[block_index1];
-    assert(blk1_data);
-    element_t blk_cat1 = mdds::mtv::get_block_type(*blk1_data);
+        const base_element_block* data = new_blocks.element_blocks[i];
 
-    if (blk_cat1 == cat)
-    {
-        size_type length = std::distance(it_begin, it_end);
-        size_type offset = start_row - start_row_in_block1;
-        size_type end_row_in_block2 = start_row_in_block2 + m_block_store.sizes[block_index2] - 1;
+        if (data)
+            m_hdl_event.element_block_acquired(data);
+    }
 
-        // Initially set to erase blocks between block 1 and block 2 non-inclusive at either end.
-        size_type index_erase_begin = block_index1 + 1;
-        size_type index_erase_end = block_index2;
+    m_block_store.insert(insert_pos, new_blocks);
+}
 
-        // Extend the first block to store the new data set.
+template<typename Traits>
+void multi_type_vector<Traits>::prepare_blocks_to_transfer(
+    blocks_to_transfer& bucket, size_type block_index1, size_type offset1, size_type block_index2, size_type offset2)
+{
+    assert(block_index1 < block_index2);
+    assert(offset1 < m_block_store.sizes[block_index1]);
+    assert(offset2 < m_block_store.sizes[block_index2]);
 
-        // Shrink it first to remove the old values, then append new values.
-        block_funcs::overwrite_values(*blk1_data, offset, m_block_store.sizes[block_index1] - offset);
-        block_funcs::resize_block(*blk1_data, offset);
-        mdds_mtv_append_values(*blk1_data, *it_begin, it_begin, it_end);
-        m_block_store.sizes[block_index1] = offset + length;
+    block_slot_type block_first;
+    block_slot_type block_last;
+    size_type index_begin = block_index1 + 1;
+    size_type index_end = block_index2;
 
-        base_element_block* blk2_data = m_block_store.element_blocks[block_index2];
+    bucket.insert_index = block_index1 + 1;
 
-        if (end_row == end_row_in_block2)
-        {
-            // Data overlaps the entire block 2. Erase it.
-            ++index_erase_end;
-        }
-        else if (blk2_data)
+    if (offset1 == 0)
+    {
+        // The whole first block needs to be swapped.
+        --index_begin;
+        --bucket.insert_index;
+    }
+    else
+    {
+        // Copy the lower part of the block for transfer.
+        size_type blk_size = m_block_store.sizes[block_index1] - offset1;
+        block_first.size = blk_size;
+
+        base_element_block* blk_data1 = m_block_store.element_blocks[block_index1];
+        if (blk_data1)
         {
-            element_t blk_cat2 = mdds::mtv::get_block_type(*blk2_data);
+            block_first.element_block = create_element_block(mtv::get_block_type(*blk_data1));
+            block_funcs::assign_values_from_block(*block_first.element_block, *blk_data1, offset1, blk_size);
 
-            if (blk_cat2 == cat)
-            {
-                // Copy the lower (non-overwritten) part of block 2 to block 1,
-                // and remove the whole block 2. Resize block 2 to zero first to
-                // prevent the transferred / overwritten cells from being
-                // deleted on block deletion.
-                size_type data_length = end_row_in_block2 - end_row;
-                size_type begin_pos = end_row - start_row_in_block2 + 1;
-                block_funcs::append_values_from_block(*blk1_data, *blk2_data, begin_pos, data_length);
-                block_funcs::overwrite_values(*blk2_data, 0, begin_pos);
-                block_funcs::resize_block(*blk2_data, 0);
-                m_block_store.sizes[block_index1] += data_length;
-                ++index_erase_end;
-            }
-            else
-            {
-                // Erase the upper part of block 2.
-                size_type size_to_erase = end_row - start_row_in_block2 + 1;
-                block_funcs::erase(*blk2_data, 0, size_to_erase);
-                m_block_store.sizes[block_index2] -= size_to_erase;
-                m_block_store.positions[block_index2] += size_to_erase;
-            }
+            // Shrink the existing block.
+            block_funcs::resize_block(*blk_data1, offset1);
         }
-        else
+
+        m_block_store.sizes[block_index1] = offset1;
+    }
+
+    if (offset2 == m_block_store.sizes[block_index2] - 1)
+    {
+        // The entire last block needs to be swapped.
+        ++index_end;
+    }
+    else
+    {
+        // Copy the upper part of the last block for transfer.
+        size_type blk_size = offset2 + 1;
+        block_last.size = blk_size;
+        base_element_block* blk_data2 = m_block_store.element_blocks[block_index2];
+
+        if (blk_data2)
         {
-            // Last block is empty.
-            size_type size_to_erase = end_row - start_row_in_block2 + 1;
-            m_block_store.sizes[block_index2] -= size_to_erase;
-            m_block_store.positions[block_index2] += size_to_erase;
+            block_last.element_block = create_element_block(mtv::get_block_type(*blk_data2));
+            block_funcs::assign_values_from_block(*block_last.element_block, *blk_data2, 0, blk_size);
+
+            // Shrink the existing block.
+            block_funcs::erase(*blk_data2, 0, blk_size);
         }
 
-        delete_element_blocks(index_erase_begin, index_erase_end);
-        m_block_store.erase(index_erase_begin, index_erase_end - index_erase_begin);
+        m_block_store.positions[block_index2] += blk_size;
+        m_block_store.sizes[block_index2] -= blk_size;
+    }
 
-        return get_iterator(block_index1);
+    // Copy all blocks into the bucket.
+    if (block_first.size)
+        bucket.blocks.push_back(block_first);
+
+    for (size_type i = index_begin; i < index_end; ++i)
+    {
+        base_element_block* data = m_block_store.element_blocks[i];
+        if (data)
+            m_hdl_event.element_block_released(data);
+
+        bucket.blocks.push_back(m_block_store.positions[i], m_block_store.sizes[i], m_block_store.element_blocks[i]);
     }
 
-    // The first block type is different.
-    assert(blk_cat1 != cat);
+    if (block_last.size)
+        bucket.blocks.push_back(block_last);
 
-    return set_cells_to_multi_blocks_block1_non_equal(start_row, end_row, block_index1, block_index2, it_begin, it_end);
+    // Remove the slots for these blocks (but don't delete the blocks).
+    m_block_store.erase(index_begin, index_end - index_begin);
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cell_to_empty_block(
-    size_type block_index, size_type pos_in_block, const T& cell)
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_whole_block_empty(
+    size_type block_index, bool overwrite)
 {
-    assert(!m_block_store.element_blocks[block_index]); // In this call, the current block is an empty block.
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
+    if (!overwrite)
+        // Resize block to 0 before deleting, to prevent its elements from getting deleted.
+        block_funcs::resize_block(*blk_data, 0);
 
-    if (block_index == 0)
+    delete_element_block(block_index);
+
+    bool blk_prev = is_previous_block_of_type(block_index, mtv::element_type_empty);
+    bool blk_next = is_next_block_of_type(block_index, mtv::element_type_empty);
+
+    // Merge with adjacent block(s) if necessary.
+    if (blk_prev)
     {
-        // Topmost block.
-        if (m_block_store.positions.size() == 1)
+        assert(!m_block_store.element_blocks[block_index - 1]);
+
+        if (blk_next)
         {
-            // this is the only block.
-            assert(m_block_store.sizes[block_index] == m_cur_size);
-            if (m_cur_size == 1)
-            {
-                // This column is allowed to have only one row!
-                assert(pos_in_block == 0);
-                create_new_block_with_new_cell(block_index, cell);
-                return make_begin();
-            }
+            // Both preceding and next blocks are empty.
+            assert(!m_block_store.element_blocks[block_index + 1]);
 
-            // block has multiple rows.
-            if (pos_in_block == 0)
-            {
-                // Insert into the first cell in this block.
-                m_block_store.sizes[block_index] -= 1;
-                assert(m_block_store.sizes[block_index] > 0);
+            m_block_store.sizes[block_index - 1] +=
+                m_block_store.sizes[block_index] + m_block_store.sizes[block_index + 1];
 
-                m_block_store.positions.emplace(m_block_store.positions.begin(), 0);
-                m_block_store.sizes.emplace(m_block_store.sizes.begin(), 1);
-                m_block_store.element_blocks.emplace(m_block_store.element_blocks.begin(), nullptr);
+            // No need delete the current and next element blocks since they are both empty.
+            m_block_store.erase(block_index, 2);
 
-                create_new_block_with_new_cell(0, cell);
+            return get_iterator(block_index - 1);
+        }
 
-                m_block_store.positions[1] = 1;
-                return make_begin();
-            }
+        // Only the preceding block is empty. Merge the current block with the previous.
+        m_block_store.sizes[block_index - 1] += m_block_store.sizes[block_index];
+        m_block_store.erase(block_index);
 
-            if (size_type& blk_size = m_block_store.sizes[block_index]; pos_in_block == blk_size - 1)
-            {
-                // Insert into the last cell in block.
-                blk_size -= 1;
-                assert(blk_size > 0);
+        return get_iterator(block_index - 1);
+    }
+    else if (blk_next)
+    {
+        assert(!m_block_store.element_blocks[block_index + 1]);
 
-                m_block_store.positions.push_back(blk_size);
-                m_block_store.sizes.push_back(1);
-                m_block_store.element_blocks.push_back(nullptr);
+        // Only the next block is empty. Merge the next block with the current.
+        m_block_store.sizes[block_index] += m_block_store.sizes[block_index + 1];
+        m_block_store.erase(block_index + 1);
 
-                create_new_block_with_new_cell(block_index + 1, cell);
-                iterator ret = make_end();
-                return --ret;
-            }
+        return get_iterator(block_index);
+    }
 
-            // Insert into the middle of the block.
-            return set_cell_to_middle_of_block(block_index, pos_in_block, cell);
-        }
+    return get_iterator(block_index);
+}
 
-        // This topmost empty block is followed by a non-empty block.
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_impl(
+    size_type row, size_type end_row, size_type block_index1, const T& it_begin, const T& it_end)
+{
+    size_type block_index2 = get_block_position(end_row, block_index1);
+    if (block_index2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::set_cells_impl", __LINE__, end_row, block_size(), size());
 
-        if (pos_in_block == 0)
-        {
-            // t|x  |???|b
-            assert(block_index < m_block_store.positions.size() - 1);
+    if (block_index1 == block_index2)
+    {
+        // The whole data array will fit in a single block.
+        return set_cells_to_single_block(row, end_row, block_index1, it_begin, it_end);
+    }
 
-            if (m_block_store.sizes[block_index] == 1)
-            {
-                // t|x|???| - Top empty block with only one cell size.
-                element_t cat = mdds_mtv_get_element_type(cell);
-                bool blk_next = is_next_block_of_type(block_index, cat);
-                if (blk_next)
-                {
-                    // t|x|xxx|b - Remove this top empty block of size 1, and
-                    // prepend the cell to the next block.
-                    delete_element_block(block_index);
-                    m_block_store.erase(block_index);
-                    m_block_store.sizes[block_index] += 1;
-                    m_block_store.positions[block_index] -= 1;
-                    mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index], cell);
-                }
-                else
-                {
-                    // t|x|---|b
-                    create_new_block_with_new_cell(block_index, cell);
-                }
-            }
-            else
-            {
-                // Shrink this topmost block by one and set the new value above it as a new block of size 1.
-                assert(block_index == 0);
-                assert(m_block_store.sizes[0] > 1);
-                m_block_store.sizes[0] -= 1;
-                m_block_store.positions[0] = 1;
+    return set_cells_to_multi_blocks(row, end_row, block_index1, block_index2, it_begin, it_end);
+}
 
-                m_block_store.positions.emplace(m_block_store.positions.begin(), 0);
-                m_block_store.sizes.emplace(m_block_store.sizes.begin(), 1);
-                m_block_store.element_blocks.emplace(m_block_store.element_blocks.begin(), nullptr);
-                create_new_block_with_new_cell(0, cell);
-            }
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_single_block(
+    size_type start_row, size_type end_row, size_type block_index, const T& it_begin, const T& it_end)
+{
+    assert(it_begin != it_end);
+    assert(!m_block_store.positions.empty());
 
-            return make_begin();
-        }
+    element_t cat = mdds_mtv_get_element_type(*it_begin);
+    size_type start_row_in_block = m_block_store.positions[block_index];
+    size_type data_length = std::distance(it_begin, it_end);
+    base_element_block* blk_data = m_block_store.element_blocks[block_index];
 
-        if (pos_in_block == m_block_store.sizes[block_index] - 1)
+    if (blk_data && mdds::mtv::get_block_type(*blk_data) == cat)
+    {
+        // t|---|xxx|---|b - Simple overwrite.
+        size_type offset = start_row - start_row_in_block;
+        block_funcs::overwrite_values(*blk_data, offset, data_length);
+        if (!offset && data_length == m_block_store.sizes[block_index])
+            // Overwrite the whole block.  It's faster to use assign_values.
+            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+        else
+            mdds_mtv_set_values(*blk_data, offset, *it_begin, it_begin, it_end);
+
+        return get_iterator(block_index);
+    }
+
+    size_type end_row_in_block = start_row_in_block + m_block_store.sizes[block_index] - 1;
+    if (start_row == start_row_in_block)
+    {
+        if (end_row == end_row_in_block)
         {
-            // Set the cell to the last position of the block, immediately above
-            // a non-empty block.
-            element_t cat = mdds_mtv_get_element_type(cell);
-            bool blk_next = is_next_block_of_type(block_index, cat);
-            if (blk_next)
+            // t|???|xxx|???|b - Replace the entire current block, but first try
+            // to see if the values can be appended to the previous block.
+            if (append_to_prev_block(block_index, cat, end_row - start_row + 1, it_begin, it_end))
             {
-                assert(m_block_store.sizes[block_index] > 1);
+                delete_element_block(block_index);
+                m_block_store.erase(block_index);
 
-                // Shrink this empty block by one, and prepend the cell to the next block.
-                m_block_store.sizes[block_index] -= 1;
-                m_block_store.sizes[block_index + 1] += 1;
-                m_block_store.positions[block_index + 1] -= 1;
-                mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
+                // Check if we need to merge it with the next block.
+                --block_index;
+                merge_with_next_block(block_index);
+
+                return get_iterator(block_index);
             }
-            else
-            {
-                // Shrink the current empty block by one, and create a new block of size 1 to store the new value.
-                m_block_store.sizes[block_index] -= 1;
-                m_block_store.insert(block_index + 1, 1);
-                m_block_store.calc_block_position(block_index + 1);
-                m_block_store.sizes[block_index + 1] = 1;
 
-                create_new_block_with_new_cell(block_index + 1, cell);
+            // Replace the whole block.
+            if (blk_data)
+            {
+                m_hdl_event.element_block_released(blk_data);
+                free_element_block(blk_data);
             }
 
-            return get_iterator(block_index + 1);
+            m_block_store.element_blocks[block_index] = create_element_block(cat);
+            blk_data = m_block_store.element_blocks[block_index];
+            m_hdl_event.element_block_acquired(blk_data);
+            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+            merge_with_next_block(block_index);
+            return get_iterator(block_index);
         }
 
-        // Inserting into the middle of an empty block.
-        return set_cell_to_middle_of_block(block_index, pos_in_block, cell);
-    }
+        // t|???|xxx--|???|b - Replace the upper part of the block. Shrink the
+        // current block first.
+        size_type length = end_row_in_block - end_row;
+        m_block_store.sizes[block_index] = length;
 
-    // This empty block is right below a non-empty block.
-    assert(block_index > 0 && m_block_store.element_blocks[block_index - 1] != nullptr);
+        if (blk_data)
+        {
+            // Erase the upper part of the data from the current element block.
+            std::unique_ptr<base_element_block, element_block_deleter> new_data(
+                create_element_block(mdds::mtv::get_block_type(*blk_data)));
 
-    if (pos_in_block == 0)
-    {
-        // Set the value to the top of the block, right below a non-empty block.
-        element_t blk_cat_prev = mdds::mtv::get_block_type(*m_block_store.element_blocks[block_index - 1]);
-        element_t cat = mdds_mtv_get_element_type(cell);
+            if (!new_data)
+                throw std::logic_error("failed to create a new element block.");
 
-        if (blk_cat_prev == cat)
-        {
-            // Extend the previous block by one to insert this cell.
-            if (m_block_store.sizes[block_index] == 1)
-            {
-                // Check if we need to merge with the following block.
-                if (block_index == m_block_store.positions.size() - 1)
-                {
-                    // Last block.  Delete this block and extend the previous
-                    // block by one.
-                    delete_element_block(block_index);
-                    m_block_store.pop_back();
-                    append_cell_to_block(block_index - 1, cell);
-                }
-                else
-                {
-                    // Block exists below.
-                    bool blk_next = is_next_block_of_type(block_index, blk_cat_prev);
-                    if (blk_next)
-                    {
-                        // Empty block must not be followed by another empty block.
-                        assert(m_block_store.element_blocks[block_index + 1]);
+            size_type pos = end_row - start_row_in_block + 1;
+            block_funcs::assign_values_from_block(*new_data, *blk_data, pos, length);
+            block_funcs::overwrite_values(*blk_data, 0, pos);
 
-                        // We need to merge the previous and next blocks, then
-                        // delete the current and next blocks.  Be sure to
-                        // resize the next block to zero to prevent the
-                        // transferred cells to be deleted.
+            block_funcs::resize_block(*blk_data, 0); // to prevent deletion of elements
+            free_element_block(blk_data);
+            m_block_store.element_blocks[block_index] = new_data.release();
 
-                        // Check if the next block is bigger.
-                        if (m_block_store.sizes[block_index - 1] < m_block_store.sizes[block_index + 1])
-                        {
-                            // Prepend the new item to the next block, then
-                            // prepend the content of the previous block and
-                            // release both previous and current blocks.
-
-                            size_type position = m_block_store.positions[block_index - 1];
-
-                            base_element_block* data = m_block_store.element_blocks[block_index];
-                            base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
-                            base_element_block* next_data = m_block_store.element_blocks[block_index + 1];
-
-                            // Increase the size of block and prepend the new cell
-                            m_block_store.sizes[block_index + 1] += 1;
-                            mdds_mtv_prepend_value(*next_data, cell);
-
-                            // Preprend the content of previous block to the next block.
-                            size_type prev_size = m_block_store.sizes[block_index - 1];
-                            block_funcs::prepend_values_from_block(*next_data, *prev_data, 0, prev_size);
-                            m_block_store.sizes[block_index + 1] += prev_size;
-                            m_block_store.positions[block_index + 1] = position;
-
-                            // Resize the previous block to zero
-                            block_funcs::resize_block(*prev_data, 0);
-                            m_hdl_event.element_block_released(prev_data);
-
-                            // Release both blocks which are no longer used
-                            block_funcs::delete_block(data);
-                            block_funcs::delete_block(prev_data);
-
-                            // Remove the previous and current blocks.
-                            m_block_store.erase(block_index - 1, 2);
-                        }
-                        else
-                        {
-                            // Be sure to resize the next block to zero to prevent the
-                            // transferred cells to be deleted.
-                            m_block_store.sizes[block_index - 1] += 1 + m_block_store.sizes[block_index + 1];
-                            base_element_block* data = m_block_store.element_blocks[block_index];
-                            base_element_block* data_prev = m_block_store.element_blocks[block_index - 1];
-                            base_element_block* data_next = m_block_store.element_blocks[block_index + 1];
-                            mdds_mtv_append_value(*data_prev, cell);
-                            block_funcs::append_block(*data_prev, *data_next);
-                            block_funcs::resize_block(*data_next, 0);
-                            m_hdl_event.element_block_released(data_next);
-                            block_funcs::delete_block(data);
-                            block_funcs::delete_block(data_next);
-                            m_block_store.erase(block_index, 2);
-                        }
-                    }
-                    else
-                    {
-                        // Ignore the next block. Just extend the previous block.
-                        delete_element_block(block_index);
-                        m_block_store.erase(block_index);
-                        append_cell_to_block(block_index - 1, cell);
-                    }
-                }
-            }
-            else
-            {
-                // Extend the previous block to append the cell.
-                assert(m_block_store.sizes[block_index] > 1);
-                m_block_store.sizes[block_index] -= 1;
-                m_block_store.positions[block_index] += 1;
-                append_cell_to_block(block_index - 1, cell);
-            }
+            // We intentionally don't trigger element block events here.
+        }
 
+        length = end_row - start_row + 1;
+        if (append_to_prev_block(block_index, cat, length, it_begin, it_end))
+        {
+            // The new values have been successfully appended to the previous block.
+            m_block_store.positions[block_index] += length;
             return get_iterator(block_index - 1);
         }
-        else
-        {
-            // t|---|x  |???|b - Cell type is different from the previous block's.
-            if (m_block_store.sizes[block_index] == 1)
-            {
-                // t|---|x|???|b
-                if (block_index == m_block_store.positions.size() - 1)
-                {
-                    // t|---|x|b - There is no more block below.  Simply turn this empty block into a non-empty one.
-                    create_new_block_with_new_cell(block_index, cell);
-                }
-                else
-                {
-                    // Check the type of the following non-empty block.
-                    assert(block_index < m_block_store.positions.size() - 1);
-                    bool blk_next = is_next_block_of_type(block_index, cat);
-                    if (blk_next)
-                    {
-                        // t|---|x|xxx|b - Remove this empty block, and prepend the cell to the next block.
-                        m_block_store.sizes[block_index + 1] += 1;
-                        m_block_store.positions[block_index + 1] -= 1;
-                        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
-                        delete_element_block(block_index);
-                        m_block_store.erase(block_index);
-                    }
-                    else
-                    {
-                        // t|---|x|---|b - Simply turn this empty block into a
-                        // non-empty one.
-                        create_new_block_with_new_cell(block_index, cell);
-                    }
-                }
-            }
-            else
-            {
-                // t|---|x  |???|b
 
-                size_type new_block_size = m_block_store.sizes[block_index] - 1;
-                size_type new_block_position = m_block_store.positions[block_index] + 1;
-                m_block_store.sizes[block_index] = 1;
-                create_new_block_with_new_cell(block_index, cell);
-                m_block_store.insert(block_index + 1, new_block_position, new_block_size, nullptr);
-            }
+        // Insert a new block before the current block, and populate it with
+        // the new data.
+        size_type position = m_block_store.positions[block_index];
+        m_block_store.positions[block_index] += length;
+        m_block_store.insert(block_index, position, length, nullptr);
+        m_block_store.element_blocks[block_index] = create_element_block(cat);
+        blk_data = m_block_store.element_blocks[block_index];
+        m_hdl_event.element_block_acquired(blk_data);
+        m_block_store.sizes[block_index] = length;
+        mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
 
-            return get_iterator(block_index);
-        }
+        return get_iterator(block_index);
     }
-    else if (pos_in_block == m_block_store.sizes[block_index] - 1)
+
+    assert(start_row > start_row_in_block);
+    if (end_row == end_row_in_block)
     {
-        // t|???|  x|???|b - New cell is set to the end of the current block.
-        assert(m_block_store.sizes[block_index] > 1);
-        if (block_index == m_block_store.positions.size() - 1)
-        {
-            // t|???|  x|b - The current block is the last block.
-            m_block_store.sizes[block_index] -= 1;
-            m_block_store.push_back(0, 1, nullptr);
-            m_block_store.calc_block_position(block_index + 1);
-            create_new_block_with_new_cell(block_index + 1, cell);
+        // t|???|--xxx|???|b - Shrink the end of the current block and insert a
+        // new block for the new data series after the current block.
+        size_type new_size = start_row - start_row_in_block;
+        m_block_store.sizes[block_index] = new_size;
 
-            iterator it = make_end();
-            return --it;
+        if (blk_data)
+        {
+            block_funcs::overwrite_values(*blk_data, new_size, data_length);
+            block_funcs::resize_block(*blk_data, new_size);
         }
-        else
+
+        new_size = end_row - start_row + 1; // size of the data array being inserted.
+
+        if (block_index < m_block_store.positions.size() - 1)
         {
-            // t|???|  x|???|b - A non-empty block exists below.
-            element_t cat = mdds_mtv_get_element_type(cell);
+            // t|???|--xxx|???|b - There is a block after the current block..
+            // There is a block (or more) after the current block. Check the next block.
             bool blk_next = is_next_block_of_type(block_index, cat);
             if (blk_next)
             {
-                // t|???|  x|xxx|b - Shrink this empty block and extend the next block.
-                m_block_store.sizes[block_index] -= 1;
-                m_block_store.sizes[block_index + 1] += 1;
-                m_block_store.positions[block_index + 1] -= 1;
-                mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
-            }
-            else
-            {
-                // t|???|  x|---|b - Shrink this block by one and insert a new block for the new cell.
-                m_block_store.sizes[block_index] -= 1;
-                m_block_store.insert(block_index + 1, 0, 1, nullptr);
-                m_block_store.calc_block_position(block_index + 1);
-                create_new_block_with_new_cell(block_index + 1, cell);
+                // t|???|--xxx|xxx|b - Prepend it to the next block.
+                mdds_mtv_prepend_values(*m_block_store.element_blocks[block_index + 1], *it_begin, it_begin, it_end);
+                m_block_store.sizes[block_index + 1] += new_size;
+                m_block_store.positions[block_index + 1] -= new_size;
+                return get_iterator(block_index + 1);
             }
 
+            // t|???|--xxx|---|b - Next block has a different data type. Do the
+            // normal insertion.
+            m_block_store.insert(block_index + 1, 0, new_size, nullptr);
+            m_block_store.calc_block_position(block_index + 1);
+            m_block_store.element_blocks[block_index + 1] = create_element_block(cat);
+            blk_data = m_block_store.element_blocks[block_index + 1];
+            m_hdl_event.element_block_acquired(blk_data);
+            mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+
             return get_iterator(block_index + 1);
         }
+
+        // t|???|--xxx|b - Last block.
+        assert(block_index == m_block_store.positions.size() - 1);
+
+        m_block_store.push_back(m_cur_size - new_size, new_size, nullptr);
+        m_block_store.element_blocks.back() = create_element_block(cat);
+        blk_data = m_block_store.element_blocks.back();
+        m_hdl_event.element_block_acquired(blk_data);
+        mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+
+        return get_iterator(block_index + 1);
     }
 
-    // New cell is somewhere in the middle of an empty block.
-    return set_cell_to_middle_of_block(block_index, pos_in_block, cell);
+    // t|???|-xx-|???|b - New values will be in the middle of the current block.
+    assert(start_row_in_block < start_row && end_row < end_row_in_block);
+
+    block_index = set_new_block_to_middle(block_index, start_row - start_row_in_block, end_row - start_row + 1, true);
+
+    m_block_store.element_blocks[block_index] = create_element_block(cat);
+    blk_data = m_block_store.element_blocks[block_index];
+    m_hdl_event.element_block_acquired(blk_data);
+    mdds_mtv_assign_values(*blk_data, *it_begin, it_begin, it_end);
+
+    return get_iterator(block_index);
 }
 
 template<typename Traits>
 template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cell_to_non_empty_block_of_size_one(
-    size_type block_index, const T& cell)
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_multi_blocks(
+    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, const T& it_begin,
+    const T& it_end)
 {
-    assert(m_block_store.sizes[block_index] == 1);
-    assert(m_block_store.element_blocks[block_index]);
-    element_t cat = mdds_mtv_get_element_type(cell);
-    assert(mdds::mtv::get_block_type(*m_block_store.element_blocks[block_index]) != cat);
+    assert(block_index1 < block_index2);
+    assert(it_begin != it_end);
+    assert(!m_block_store.positions.empty());
 
-    if (block_index == 0)
+    base_element_block* blk1_data = m_block_store.element_blocks[block_index1];
+    if (blk1_data)
     {
-        // t|x|???|b - topmost block of size 1.
-        if (block_index == m_block_store.positions.size() - 1)
-        {
-            // t|x|b - This is the only block.
-            create_new_block_with_new_cell(block_index, cell);
-            return make_begin();
-        }
+        return set_cells_to_multi_blocks_block1_non_empty(
+            start_row, end_row, block_index1, block_index2, it_begin, it_end);
+    }
 
-        // There is a block below.
-        bool blk_next = is_next_block_of_type(block_index, cat);
-        if (!blk_next)
-        {
-            // t|x|---|b - Next block is of different type.
-            create_new_block_with_new_cell(block_index, cell);
-            return make_begin();
-        }
+    // Block 1 is empty.
+    assert(!blk1_data);
+
+    return set_cells_to_multi_blocks_block1_non_equal(start_row, end_row, block_index1, block_index2, it_begin, it_end);
+}
+
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_multi_blocks_block1_non_equal(
+    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, const T& it_begin,
+    const T& it_end)
+{
+    element_t cat = mdds_mtv_get_element_type(*it_begin);
+    base_element_block* blk1_data = m_block_store.element_blocks[block_index1];
+    base_element_block* blk2_data = m_block_store.element_blocks[block_index2];
+
+    size_type start_row_in_block1 = m_block_store.positions[block_index1];
+    size_type start_row_in_block2 = m_block_store.positions[block_index2];
+    size_type length = std::distance(it_begin, it_end);
+    size_type offset = start_row - start_row_in_block1;
+    size_type end_row_in_block2 = start_row_in_block2 + m_block_store.sizes[block_index2] - 1;
+
+    // Initially set to erase blocks between block 1 and block 2 non-inclusive at either end.
+    size_type index_erase_begin = block_index1 + 1;
+    size_type index_erase_end = block_index2;
+
+    // Create the new data block first.
+    block_slot_type data_blk(start_row, length);
+
+    bool blk0_copied = false;
+    if (offset == 0)
+    {
+        // Remove block 1.
+        --index_erase_begin;
+
+        // Check the type of the previous block (block 0) if exists.
+        if (block_index1 > 0)
+        {
+            base_element_block* blk0_data = m_block_store.element_blocks[block_index1 - 1];
+            if (blk0_data && cat == mdds::mtv::get_block_type(*blk0_data))
+            {
+                // Transfer the whole data from block 0 to data block.
+                data_blk.element_block = blk0_data;
+                m_block_store.element_blocks[block_index1 - 1] = nullptr;
+
+                data_blk.size += m_block_store.sizes[block_index1 - 1];
+                data_blk.position = m_block_store.positions[block_index1 - 1];
+
+                --index_erase_begin;
+                blk0_copied = true;
+            }
+        }
+    }
+    else
+    {
+        // Shrink block 1 by the end.
+        if (blk1_data)
+        {
+            size_type n = m_block_store.sizes[block_index1] - offset;
+            block_funcs::overwrite_values(*blk1_data, offset, n);
+            block_funcs::resize_block(*blk1_data, offset);
+        }
+        m_block_store.sizes[block_index1] = offset;
+    }
+
+    if (blk0_copied)
+    {
+        mdds_mtv_append_values(*data_blk.element_block, *it_begin, it_begin, it_end);
+    }
+    else
+    {
+        data_blk.element_block = create_element_block(cat);
+        m_hdl_event.element_block_acquired(data_blk.element_block);
+        mdds_mtv_assign_values(*data_blk.element_block, *it_begin, it_begin, it_end);
+    }
+
+    if (end_row == end_row_in_block2)
+    {
+        // Remove block 2.
+        ++index_erase_end;
+
+        if (block_index2 + 1 < m_block_store.positions.size())
+        {
+            // There is at least one block after block 2.
+            base_element_block* blk3_data = m_block_store.element_blocks[block_index2 + 1];
+            if (blk3_data && mdds::mtv::get_block_type(*blk3_data) == cat)
+            {
+                // Merge the whole block 3 with the new data. Remove block 3
+                // afterward.  Resize block 3 to zero to prevent invalid free.
+                block_funcs::append_block(*data_blk.element_block, *blk3_data);
+                block_funcs::resize_block(*blk3_data, 0);
+                data_blk.size += m_block_store.sizes[block_index2 + 1];
+                ++index_erase_end;
+            }
+        }
+    }
+    else
+    {
+        bool erase_upper = true;
+
+        if (blk2_data)
+        {
+            element_t blk_cat2 = mdds::mtv::get_block_type(*blk2_data);
+            if (blk_cat2 == cat)
+            {
+                // Merge the lower part of block 2 with the new data, and erase
+                // block 2.  Resize block 2 to avoid invalid free on the copied
+                // portion of the block.
+                size_type copy_pos = end_row - start_row_in_block2 + 1;
+                size_type size_to_copy = end_row_in_block2 - end_row;
+                block_funcs::append_values_from_block(*data_blk.element_block, *blk2_data, copy_pos, size_to_copy);
+                block_funcs::resize_block(*blk2_data, copy_pos);
+                data_blk.size += size_to_copy;
+
+                ++index_erase_end;
+                erase_upper = false;
+            }
+        }
+
+        if (erase_upper)
+        {
+            // Erase the upper part of block 2.
+            size_type size_to_erase = end_row - start_row_in_block2 + 1;
+
+            if (blk2_data)
+            {
+                block_funcs::overwrite_values(*blk2_data, 0, size_to_erase);
+                block_funcs::erase(*blk2_data, 0, size_to_erase);
+            }
+
+            m_block_store.sizes[block_index2] -= size_to_erase;
+            m_block_store.positions[block_index2] += size_to_erase;
+        }
+    }
+
+    size_type insert_pos = index_erase_begin;
+
+    // Remove the in-between blocks first.
+    delete_element_blocks(index_erase_begin, index_erase_end);
+    m_block_store.erase(index_erase_begin, index_erase_end - index_erase_begin);
+
+    // Insert the new data block.
+
+    m_block_store.insert(insert_pos, data_blk.position, data_blk.size, data_blk.element_block);
+    return get_iterator(insert_pos);
+}
+
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cells_to_multi_blocks_block1_non_empty(
+    size_type start_row, size_type end_row, size_type block_index1, size_type block_index2, const T& it_begin,
+    const T& it_end)
+{
+    size_type start_row_in_block1 = m_block_store.positions[block_index1];
+    size_type start_row_in_block2 = m_block_store.positions[block_index2];
+
+    element_t cat = mdds_mtv_get_element_type(*it_begin);
+    base_element_block* blk1_data = m_block_store.element_blocks[block_index1];
+    assert(blk1_data);
+    element_t blk_cat1 = mdds::mtv::get_block_type(*blk1_data);
+
+    if (blk_cat1 == cat)
+    {
+        size_type length = std::distance(it_begin, it_end);
+        size_type offset = start_row - start_row_in_block1;
+        size_type end_row_in_block2 = start_row_in_block2 + m_block_store.sizes[block_index2] - 1;
+
+        // Initially set to erase blocks between block 1 and block 2 non-inclusive at either end.
+        size_type index_erase_begin = block_index1 + 1;
+        size_type index_erase_end = block_index2;
+
+        // Extend the first block to store the new data set.
+
+        // Shrink it first to remove the old values, then append new values.
+        block_funcs::overwrite_values(*blk1_data, offset, m_block_store.sizes[block_index1] - offset);
+        block_funcs::resize_block(*blk1_data, offset);
+        mdds_mtv_append_values(*blk1_data, *it_begin, it_begin, it_end);
+        m_block_store.sizes[block_index1] = offset + length;
+
+        base_element_block* blk2_data = m_block_store.element_blocks[block_index2];
+
+        if (end_row == end_row_in_block2)
+        {
+            // Data overlaps the entire block 2. Erase it.
+            ++index_erase_end;
+        }
+        else if (blk2_data)
+        {
+            element_t blk_cat2 = mdds::mtv::get_block_type(*blk2_data);
+
+            if (blk_cat2 == cat)
+            {
+                // Copy the lower (non-overwritten) part of block 2 to block 1,
+                // and remove the whole block 2. Resize block 2 to zero first to
+                // prevent the transferred / overwritten cells from being
+                // deleted on block deletion.
+                size_type data_length = end_row_in_block2 - end_row;
+                size_type begin_pos = end_row - start_row_in_block2 + 1;
+                block_funcs::append_values_from_block(*blk1_data, *blk2_data, begin_pos, data_length);
+                block_funcs::overwrite_values(*blk2_data, 0, begin_pos);
+                block_funcs::resize_block(*blk2_data, 0);
+                m_block_store.sizes[block_index1] += data_length;
+                ++index_erase_end;
+            }
+            else
+            {
+                // Erase the upper part of block 2.
+                size_type size_to_erase = end_row - start_row_in_block2 + 1;
+                block_funcs::overwrite_values(*blk2_data, 0, size_to_erase);
+                block_funcs::erase(*blk2_data, 0, size_to_erase);
+                m_block_store.sizes[block_index2] -= size_to_erase;
+                m_block_store.positions[block_index2] += size_to_erase;
+            }
+        }
+        else
+        {
+            // Last block is empty.
+            size_type size_to_erase = end_row - start_row_in_block2 + 1;
+            m_block_store.sizes[block_index2] -= size_to_erase;
+            m_block_store.positions[block_index2] += size_to_erase;
+        }
+
+        delete_element_blocks(index_erase_begin, index_erase_end);
+        m_block_store.erase(index_erase_begin, index_erase_end - index_erase_begin);
+
+        return get_iterator(block_index1);
+    }
+
+    // The first block type is different.
+    assert(blk_cat1 != cat);
+
+    return set_cells_to_multi_blocks_block1_non_equal(start_row, end_row, block_index1, block_index2, it_begin, it_end);
+}
+
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cell_to_empty_block(
+    size_type block_index, size_type pos_in_block, const T& cell)
+{
+    assert(!m_block_store.element_blocks[block_index]); // In this call, the current block is an empty block.
+
+    if (block_index == 0)
+    {
+        // Topmost block.
+        if (m_block_store.positions.size() == 1)
+        {
+            // this is the only block.
+            assert(m_block_store.sizes[block_index] == m_cur_size);
+            if (m_cur_size == 1)
+            {
+                // This column is allowed to have only one row!
+                assert(pos_in_block == 0);
+                create_new_block_with_new_cell(block_index, cell);
+                return make_begin();
+            }
+
+            // block has multiple rows.
+            if (pos_in_block == 0)
+            {
+                // Insert into the first cell in this block.
+                m_block_store.sizes[block_index] -= 1;
+                assert(m_block_store.sizes[block_index] > 0);
+
+                m_block_store.positions.emplace(m_block_store.positions.begin(), 0);
+                m_block_store.sizes.emplace(m_block_store.sizes.begin(), 1);
+                m_block_store.element_blocks.emplace(m_block_store.element_blocks.begin(), nullptr);
+
+                create_new_block_with_new_cell(0, cell);
+
+                m_block_store.positions[1] = 1;
+                return make_begin();
+            }
+
+            if (size_type& blk_size = m_block_store.sizes[block_index]; pos_in_block == blk_size - 1)
+            {
+                // Insert into the last cell in block.
+                blk_size -= 1;
+                assert(blk_size > 0);
+
+                m_block_store.positions.push_back(blk_size);
+                m_block_store.sizes.push_back(1);
+                m_block_store.element_blocks.push_back(nullptr);
+
+                create_new_block_with_new_cell(block_index + 1, cell);
+                iterator ret = make_end();
+                return --ret;
+            }
+
+            // Insert into the middle of the block.
+            return set_cell_to_middle_of_block(block_index, pos_in_block, cell);
+        }
+
+        // This topmost empty block is followed by a non-empty block.
+
+        if (pos_in_block == 0)
+        {
+            // t|x  |???|b
+            assert(block_index < m_block_store.positions.size() - 1);
+
+            if (m_block_store.sizes[block_index] == 1)
+            {
+                // t|x|???| - Top empty block with only one cell size.
+                element_t cat = mdds_mtv_get_element_type(cell);
+                bool blk_next = is_next_block_of_type(block_index, cat);
+                if (blk_next)
+                {
+                    // t|x|xxx|b - Remove this top empty block of size 1, and
+                    // prepend the cell to the next block.
+                    delete_element_block(block_index);
+                    m_block_store.erase(block_index);
+                    m_block_store.sizes[block_index] += 1;
+                    m_block_store.positions[block_index] -= 1;
+                    mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index], cell);
+                }
+                else
+                {
+                    // t|x|---|b
+                    create_new_block_with_new_cell(block_index, cell);
+                }
+            }
+            else
+            {
+                // Shrink this topmost block by one and set the new value above it as a new block of size 1.
+                assert(block_index == 0);
+                assert(m_block_store.sizes[0] > 1);
+                m_block_store.sizes[0] -= 1;
+                m_block_store.positions[0] = 1;
+
+                m_block_store.positions.emplace(m_block_store.positions.begin(), 0);
+                m_block_store.sizes.emplace(m_block_store.sizes.begin(), 1);
+                m_block_store.element_blocks.emplace(m_block_store.element_blocks.begin(), nullptr);
+                create_new_block_with_new_cell(0, cell);
+            }
+
+            return make_begin();
+        }
+
+        if (pos_in_block == m_block_store.sizes[block_index] - 1)
+        {
+            // Set the cell to the last position of the block, immediately above
+            // a non-empty block.
+            element_t cat = mdds_mtv_get_element_type(cell);
+            bool blk_next = is_next_block_of_type(block_index, cat);
+            if (blk_next)
+            {
+                assert(m_block_store.sizes[block_index] > 1);
+
+                // Shrink this empty block by one, and prepend the cell to the next block.
+                m_block_store.sizes[block_index] -= 1;
+                m_block_store.sizes[block_index + 1] += 1;
+                m_block_store.positions[block_index + 1] -= 1;
+                mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
+            }
+            else
+            {
+                // Shrink the current empty block by one, and create a new block of size 1 to store the new value.
+                m_block_store.sizes[block_index] -= 1;
+                m_block_store.insert(block_index + 1, 1);
+                m_block_store.calc_block_position(block_index + 1);
+                m_block_store.sizes[block_index + 1] = 1;
+
+                create_new_block_with_new_cell(block_index + 1, cell);
+            }
+
+            return get_iterator(block_index + 1);
+        }
+
+        // Inserting into the middle of an empty block.
+        return set_cell_to_middle_of_block(block_index, pos_in_block, cell);
+    }
+
+    // This empty block is right below a non-empty block.
+    assert(block_index > 0 && m_block_store.element_blocks[block_index - 1] != nullptr);
+
+    if (pos_in_block == 0)
+    {
+        // Set the value to the top of the block, right below a non-empty block.
+        element_t blk_cat_prev = mdds::mtv::get_block_type(*m_block_store.element_blocks[block_index - 1]);
+        element_t cat = mdds_mtv_get_element_type(cell);
+
+        if (blk_cat_prev == cat)
+        {
+            // Extend the previous block by one to insert this cell.
+            if (m_block_store.sizes[block_index] == 1)
+            {
+                // Check if we need to merge with the following block.
+                if (block_index == m_block_store.positions.size() - 1)
+                {
+                    // Last block.  Delete this block and extend the previous
+                    // block by one.
+                    delete_element_block(block_index);
+                    m_block_store.pop_back();
+                    append_cell_to_block(block_index - 1, cell);
+                }
+                else
+                {
+                    // Block exists below.
+                    bool blk_next = is_next_block_of_type(block_index, blk_cat_prev);
+                    if (blk_next)
+                    {
+                        // Empty block must not be followed by another empty block.
+                        assert(m_block_store.element_blocks[block_index + 1]);
+
+                        // We need to merge the previous and next blocks, then
+                        // delete the current and next blocks.  Be sure to
+                        // resize the next block to zero to prevent the
+                        // transferred cells to be deleted.
+
+                        // Check if the next block is bigger.
+                        if (m_block_store.sizes[block_index - 1] < m_block_store.sizes[block_index + 1])
+                        {
+                            // Prepend the new item to the next block, then
+                            // prepend the content of the previous block and
+                            // release both previous and current blocks.
+
+                            size_type position = m_block_store.positions[block_index - 1];
+
+                            base_element_block* data = m_block_store.element_blocks[block_index];
+                            base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
+                            base_element_block* next_data = m_block_store.element_blocks[block_index + 1];
+
+                            // Increase the size of block and prepend the new cell
+                            m_block_store.sizes[block_index + 1] += 1;
+                            mdds_mtv_prepend_value(*next_data, cell);
+
+                            // Preprend the content of previous block to the next block.
+                            size_type prev_size = m_block_store.sizes[block_index - 1];
+                            block_funcs::prepend_values_from_block(*next_data, *prev_data, 0, prev_size);
+                            m_block_store.sizes[block_index + 1] += prev_size;
+                            m_block_store.positions[block_index + 1] = position;
+
+                            // Resize the previous block to zero
+                            block_funcs::resize_block(*prev_data, 0);
+                            m_hdl_event.element_block_released(prev_data);
+
+                            // Release both blocks which are no longer used
+                            free_element_block(data);
+                            free_element_block(prev_data);
+
+                            // Remove the previous and current blocks.
+                            m_block_store.erase(block_index - 1, 2);
+                        }
+                        else
+                        {
+                            // Be sure to resize the next block to zero to prevent the
+                            // transferred cells to be deleted.
+                            m_block_store.sizes[block_index - 1] += 1 + m_block_store.sizes[block_index + 1];
+                            base_element_block* data = m_block_store.element_blocks[block_index];
+                            base_element_block* data_prev = m_block_store.element_blocks[block_index - 1];
+                            base_element_block* data_next = m_block_store.element_blocks[block_index + 1];
+                            mdds_mtv_append_value(*data_prev, cell);
+                            block_funcs::append_block(*data_prev, *data_next);
+                            block_funcs::resize_block(*data_next, 0);
+                            m_hdl_event.element_block_released(data_next);
+                            free_element_block(data);
+                            free_element_block(data_next);
+                            m_block_store.erase(block_index, 2);
+                        }
+                    }
+                    else
+                    {
+                        // Ignore the next block. Just extend the previous block.
+                        delete_element_block(block_index);
+                        m_block_store.erase(block_index);
+                        append_cell_to_block(block_index - 1, cell);
+                    }
+                }
+            }
+            else
+            {
+                // Extend the previous block to append the cell.
+                assert(m_block_store.sizes[block_index] > 1);
+                m_block_store.sizes[block_index] -= 1;
+                m_block_store.positions[block_index] += 1;
+                append_cell_to_block(block_index - 1, cell);
+            }
+
+            return get_iterator(block_index - 1);
+        }
+        else
+        {
+            // t|---|x  |???|b - Cell type is different from the previous block's.
+            if (m_block_store.sizes[block_index] == 1)
+            {
+                // t|---|x|???|b
+                if (block_index == m_block_store.positions.size() - 1)
+                {
+                    // t|---|x|b - There is no more block below.  Simply turn this empty block into a non-empty one.
+                    create_new_block_with_new_cell(block_index, cell);
+                }
+                else
+                {
+                    // Check the type of the following non-empty block.
+                    assert(block_index < m_block_store.positions.size() - 1);
+                    bool blk_next = is_next_block_of_type(block_index, cat);
+                    if (blk_next)
+                    {
+                        // t|---|x|xxx|b - Remove this empty block, and prepend the cell to the next block.
+                        m_block_store.sizes[block_index + 1] += 1;
+                        m_block_store.positions[block_index + 1] -= 1;
+                        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
+                        delete_element_block(block_index);
+                        m_block_store.erase(block_index);
+                    }
+                    else
+                    {
+                        // t|---|x|---|b - Simply turn this empty block into a
+                        // non-empty one.
+                        create_new_block_with_new_cell(block_index, cell);
+                    }
+                }
+            }
+            else
+            {
+                // t|---|x  |???|b
+
+                size_type new_block_size = m_block_store.sizes[block_index] - 1;
+                size_type new_block_position = m_block_store.positions[block_index] + 1;
+                m_block_store.sizes[block_index] = 1;
+                create_new_block_with_new_cell(block_index, cell);
+                m_block_store.insert(block_index + 1, new_block_position, new_block_size, nullptr);
+            }
+
+            return get_iterator(block_index);
+        }
+    }
+    else if (pos_in_block == m_block_store.sizes[block_index] - 1)
+    {
+        // t|???|  x|???|b - New cell is set to the end of the current block.
+        assert(m_block_store.sizes[block_index] > 1);
+        if (block_index == m_block_store.positions.size() - 1)
+        {
+            // t|???|  x|b - The current block is the last block.
+            m_block_store.sizes[block_index] -= 1;
+            m_block_store.push_back(0, 1, nullptr);
+            m_block_store.calc_block_position(block_index + 1);
+            create_new_block_with_new_cell(block_index + 1, cell);
+
+            iterator it = make_end();
+            return --it;
+        }
+        else
+        {
+            // t|???|  x|???|b - A non-empty block exists below.
+            element_t cat = mdds_mtv_get_element_type(cell);
+            bool blk_next = is_next_block_of_type(block_index, cat);
+            if (blk_next)
+            {
+                // t|???|  x|xxx|b - Shrink this empty block and extend the next block.
+                m_block_store.sizes[block_index] -= 1;
+                m_block_store.sizes[block_index + 1] += 1;
+                m_block_store.positions[block_index + 1] -= 1;
+                mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
+            }
+            else
+            {
+                // t|???|  x|---|b - Shrink this block by one and insert a new block for the new cell.
+                m_block_store.sizes[block_index] -= 1;
+                m_block_store.insert(block_index + 1, 0, 1, nullptr);
+                m_block_store.calc_block_position(block_index + 1);
+                create_new_block_with_new_cell(block_index + 1, cell);
+            }
+
+            return get_iterator(block_index + 1);
+        }
+    }
+
+    // New cell is somewhere in the middle of an empty block.
+    return set_cell_to_middle_of_block(block_index, pos_in_block, cell);
+}
+
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::set_cell_to_non_empty_block_of_size_one(
+    size_type block_index, const T& cell)
+{
+    assert(m_block_store.sizes[block_index] == 1);
+    assert(m_block_store.element_blocks[block_index]);
+    element_t cat = mdds_mtv_get_element_type(cell);
+    assert(mdds::mtv::get_block_type(*m_block_store.element_blocks[block_index]) != cat);
+
+    if (block_index == 0)
+    {
+        // t|x|???|b - topmost block of size 1.
+        if (block_index == m_block_store.positions.size() - 1)
+        {
+            // t|x|b - This is the only block.
+            create_new_block_with_new_cell(block_index, cell);
+            return make_begin();
+        }
+
+        // There is a block below.
+        bool blk_next = is_next_block_of_type(block_index, cat);
+        if (!blk_next)
+        {
+            // t|x|---|b - Next block is of different type.
+            create_new_block_with_new_cell(block_index, cell);
+            return make_begin();
+        }
+
+        // t|x|xxx|b - Delete this block and prepend the cell to the next block.
+        m_block_store.sizes[block_index + 1] += 1;
+        m_block_store.positions[block_index + 1] -= 1;
+        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
+        delete_element_block(block_index);
+        m_block_store.erase(block_index);
+
+        return make_begin();
+    }
+
+    assert(block_index > 0);
+
+    if (block_index == m_block_store.positions.size() - 1)
+    {
+        // t|???|x|b - This is the last block and another block exists above.
+        base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
+        if (!prev_data || mdds::mtv::get_block_type(*prev_data) != cat)
+        {
+            // t|---|x|b - The previous block is of different type.
+            create_new_block_with_new_cell(block_index, cell);
+        }
+        else
+        {
+            // t|xxx|x|b - Append the cell to the previous block and remove the current one.
+            mdds_mtv_append_value(*m_block_store.element_blocks[block_index - 1], cell);
+            m_block_store.sizes[block_index - 1] += 1;
+            delete_element_block(block_index);
+            m_block_store.erase(block_index);
+        }
+
+        iterator itr = make_end();
+        return --itr;
+    }
+
+    // Remove the current block, and check if the cell can be append to the
+    // previous block, or prepended to the following block. Also check if the
+    // blocks above and below need to be combined.
+
+    if (!m_block_store.element_blocks[block_index - 1])
+    {
+        // t|   |x|???|b - Previous block is empty.
+        if (!m_block_store.element_blocks[block_index + 1])
+        {
+            // t|   |x|   |b - Next block is empty too.
+            create_new_block_with_new_cell(block_index, cell);
+            return get_iterator(block_index);
+        }
+
+        // Previous block is empty, but the next block is not.
+        element_t blk_cat_next = mdds::mtv::get_block_type(*m_block_store.element_blocks[block_index + 1]);
+
+        if (blk_cat_next == cat)
+        {
+            // t|   |x|xxx|b - Next block is of the same type as the new value.
+            delete_element_block(block_index);
+            m_block_store.erase(block_index);
+            m_block_store.sizes[block_index] += 1;
+            m_block_store.positions[block_index] -= 1;
+            mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index], cell);
+            return get_iterator(block_index);
+        }
+
+        // t|   |x|---|b
+        assert(blk_cat_next != cat);
+        create_new_block_with_new_cell(block_index, cell);
+        return get_iterator(block_index);
+    }
+
+    if (!m_block_store.element_blocks[block_index + 1])
+    {
+        // t|---|x|   |b - Next block is empty and the previous block is not.
+        base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
+        assert(prev_data);
+        element_t prev_cat = mdds::mtv::get_block_type(*prev_data);
+
+        if (prev_cat == cat)
+        {
+            // t|xxx|x|   |b - Append to the previous block.
+            m_block_store.sizes[block_index - 1] += 1;
+            mdds_mtv_append_value(*prev_data, cell);
+            delete_element_block(block_index);
+            m_block_store.erase(block_index);
+            return get_iterator(block_index - 1);
+        }
+
+        // Just overwrite the current block.
+        create_new_block_with_new_cell(block_index, cell);
+        return get_iterator(block_index);
+    }
+
+    // t|???|x|???|b - Neither previous nor next blocks are empty.
+    base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
+    base_element_block* next_data = m_block_store.element_blocks[block_index + 1];
+    assert(prev_data);
+    assert(next_data);
+    element_t prev_cat = mdds::mtv::get_block_type(*prev_data);
+    element_t next_cat = mdds::mtv::get_block_type(*next_data);
+
+    if (prev_cat == next_cat)
+    {
+        if (prev_cat == cat)
+        {
+            // t|xxx|x|xxx|b - All three blocks are of the same type. Merge all
+            // three blocks.
+            m_block_store.sizes[block_index - 1] += 1 + m_block_store.sizes[block_index + 1];
+            mdds_mtv_append_value(*prev_data, cell);
+            block_funcs::append_block(*prev_data, *next_data);
+            block_funcs::resize_block(*next_data, 0); // to prevent deletion of managed cells on block deletion
+
+            // Delete the current and next blocks.
+            delete_element_block(block_index);
+            delete_element_block(block_index + 1);
+            m_block_store.erase(block_index, 2);
+
+            return get_iterator(block_index - 1);
+        }
+
+        // t|---|x|---|b - Just overwrite the current block.
+        create_new_block_with_new_cell(block_index, cell);
+        return get_iterator(block_index);
+    }
+
+    assert(prev_cat != next_cat);
+
+    if (prev_cat == cat)
+    {
+        // t|xxx|x|---|b - Append to the previous block.
+        m_block_store.sizes[block_index - 1] += 1;
+        mdds_mtv_append_value(*m_block_store.element_blocks[block_index - 1], cell);
+        delete_element_block(block_index);
+        m_block_store.erase(block_index);
+        return get_iterator(block_index - 1);
+    }
+
+    if (next_cat == cat)
+    {
+        // t|---|x|xxx|b - Prepend to the next block.
+        m_block_store.sizes[block_index + 1] += 1;
+        m_block_store.positions[block_index + 1] -= 1;
+        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
+        delete_element_block(block_index);
+        m_block_store.erase(block_index);
+        return get_iterator(block_index);
+    }
+
+    // t|---|x|+++|b - Just overwrite the current block.
+    create_new_block_with_new_cell(block_index, cell);
+    return get_iterator(block_index);
+}
+
+template<typename Traits>
+typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::size() const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    return m_cur_size;
+}
+
+template<typename Traits>
+typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::block_size() const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    return m_block_store.positions.size();
+}
+
+template<typename Traits>
+bool multi_type_vector<Traits>::empty() const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    return m_block_store.positions.empty();
+}
+
+template<typename Traits>
+template<typename T>
+void multi_type_vector<Traits>::get(size_type pos, T& value) const
+{
+    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
+    get_impl(pos, value);
+}
+
+template<typename Traits>
+template<typename T>
+T multi_type_vector<Traits>::get(size_type pos) const
+{
+    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos);
+
+    T cell;
+    get_impl(pos, cell);
+    return cell;
+}
+
+template<typename Traits>
+template<typename T>
+T multi_type_vector<Traits>::release(size_type pos)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "pos=" << pos);
+
+    size_type block_index = get_block_position(pos);
+    if (block_index == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::release", __LINE__, pos, block_size(), size());
+
+    check_blocks_not_shared(block_index, block_index, "multi_type_vector::release");
+    detach_range(block_index, pos, pos);
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    T value;
+    {
+        position_shift_scope shift_scope(*this, block_index, pos);
+        release_impl(pos, block_index, value);
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in release(pos=" << pos << ")" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+
+    return value;
+}
+
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release(size_type pos, T& value)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
+
+    size_type block_index = get_block_position(pos);
+    if (block_index == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::release", __LINE__, pos, block_size(), size());
+
+    check_blocks_not_shared(block_index, block_index, "multi_type_vector::release");
+    detach_range(block_index, pos, pos);
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = release_impl(pos, block_index, value);
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in release(pos=" << pos << ")" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+
+    return ret;
+}
+
+template<typename Traits>
+template<typename T>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release(
+    const iterator& pos_hint, size_type pos, T& value)
+{
+    MDDS_MTV_TRACE_ARGS(
+        mutator_with_pos_hint,
+        "pos_hint=" << pos_hint << "; pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
+
+    size_type block_index = get_block_position(pos_hint->__private_data, pos);
+    if (block_index == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::release", __LINE__, pos, block_size(), size());
+
+    check_blocks_not_shared(block_index, block_index, "multi_type_vector::release");
+    detach_range(block_index, pos, pos);
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    iterator ret;
+    {
+        position_shift_scope shift_scope(*this, block_index, pos);
+        ret = release_impl(pos, block_index, value);
+    }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in release(pos=" << pos << ")" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+
+    return ret;
+}
+
+template<typename Traits>
+void multi_type_vector<Traits>::release()
+{
+    MDDS_MTV_TRACE(mutator);
+
+    check_blocks_not_shared(0, m_block_store.element_blocks.size(), "multi_type_vector::release");
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    std::ostringstream os_prev_block;
+    dump_blocks(os_prev_block);
+#endif
+
+    for (auto* data : m_block_store.element_blocks)
+    {
+        if (!data)
+            continue;
+
+        block_funcs::resize_block(*data, 0);
+        m_hdl_event.element_block_released(data);
+        free_element_block(data);
+    }
+
+    m_block_store.clear();
+    m_cur_size = 0;
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    try
+    {
+        check_block_integrity();
+    }
+    catch (const mdds::integrity_error& e)
+    {
+        std::ostringstream os;
+        os << e.what() << std::endl;
+        os << "block integrity check failed in release()" << std::endl;
+        os << "previous block state:" << std::endl;
+        os << os_prev_block.str();
+        std::cerr << os.str() << std::endl;
+        abort();
+    }
+#endif
+}
 
-        // t|x|xxx|b - Delete this block and prepend the cell to the next block.
-        m_block_store.sizes[block_index + 1] += 1;
-        m_block_store.positions[block_index + 1] -= 1;
-        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
-        delete_element_block(block_index);
-        m_block_store.erase(block_index);
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release_range(
+    size_type start_pos, size_type end_pos)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-        return make_begin();
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::release_range", __LINE__, start_pos, block_size(), size());
+
+    if constexpr (Traits::enable_cow)
+    {
+        size_type block_index2 = get_block_position(end_pos, block_index1);
+        check_blocks_not_shared(block_index1, block_index2, "multi_type_vector::release_range");
+        detach_range(block_index1, start_pos, end_pos);
     }
 
-    assert(block_index > 0);
+    return set_empty_impl(start_pos, end_pos, block_index1, false);
+}
 
-    if (block_index == m_block_store.positions.size() - 1)
-    {
-        // t|???|x|b - This is the last block and another block exists above.
-        base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
-        if (!prev_data || mdds::mtv::get_block_type(*prev_data) != cat)
-        {
-            // t|---|x|b - The previous block is of different type.
-            create_new_block_with_new_cell(block_index, cell);
-        }
-        else
-        {
-            // t|xxx|x|b - Append the cell to the previous block and remove the current one.
-            mdds_mtv_append_value(*m_block_store.element_blocks[block_index - 1], cell);
-            m_block_store.sizes[block_index - 1] += 1;
-            delete_element_block(block_index);
-            m_block_store.erase(block_index);
-        }
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release_range(
+    const iterator& pos_hint, size_type start_pos, size_type end_pos)
+{
+    MDDS_MTV_TRACE_ARGS(
+        mutator_with_pos_hint, "pos_hint=" << pos_hint << "; start_pos=" << start_pos << "; end_pos=" << end_pos);
 
-        iterator itr = make_end();
-        return --itr;
+    size_type block_index1 = get_block_position(pos_hint->__private_data, start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::release_range", __LINE__, start_pos, block_size(), size());
+
+    if constexpr (Traits::enable_cow)
+    {
+        size_type block_index2 = get_block_position(end_pos, block_index1);
+        check_blocks_not_shared(block_index1, block_index2, "multi_type_vector::release_range");
+        detach_range(block_index1, start_pos, end_pos);
     }
 
-    // Remove the current block, and check if the cell can be append to the
-    // previous block, or prepended to the following block. Also check if the
-    // blocks above and below need to be combined.
+    return set_empty_impl(start_pos, end_pos, block_index1, false);
+}
 
-    if (!m_block_store.element_blocks[block_index - 1])
-    {
-        // t|   |x|???|b - Previous block is empty.
-        if (!m_block_store.element_blocks[block_index + 1])
-        {
-            // t|   |x|   |b - Next block is empty too.
-            create_new_block_with_new_cell(block_index, cell);
-            return get_iterator(block_index);
-        }
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::make_begin()
+{
+    return iterator(
+        {m_block_store.positions.begin(), m_block_store.sizes.begin(), m_block_store.element_blocks.begin()},
+        {m_block_store.positions.end(), m_block_store.sizes.end(), m_block_store.element_blocks.end()}, this, 0);
+}
 
-        // Previous block is empty, but the next block is not.
-        element_t blk_cat_next = mdds::mtv::get_block_type(*m_block_store.element_blocks[block_index + 1]);
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::make_end()
+{
+    return iterator(
+        {m_block_store.positions.end(), m_block_store.sizes.end(), m_block_store.element_blocks.end()},
+        {m_block_store.positions.end(), m_block_store.sizes.end(), m_block_store.element_blocks.end()}, this,
+        m_block_store.positions.size());
+}
 
-        if (blk_cat_next == cat)
-        {
-            // t|   |x|xxx|b - Next block is of the same type as the new value.
-            delete_element_block(block_index);
-            m_block_store.erase(block_index);
-            m_block_store.sizes[block_index] += 1;
-            m_block_store.positions[block_index] -= 1;
-            mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index], cell);
-            return get_iterator(block_index);
-        }
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::begin()
+    requires(!Traits::enable_cow)
+{
+    MDDS_MTV_TRACE(accessor);
 
-        // t|   |x|---|b
-        assert(blk_cat_next != cat);
-        create_new_block_with_new_cell(block_index, cell);
-        return get_iterator(block_index);
-    }
+    return make_begin();
+}
 
-    if (!m_block_store.element_blocks[block_index + 1])
-    {
-        // t|---|x|   |b - Next block is empty and the previous block is not.
-        base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
-        assert(prev_data);
-        element_t prev_cat = mdds::mtv::get_block_type(*prev_data);
+template<typename Traits>
+typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::end()
+    requires(!Traits::enable_cow)
+{
+    MDDS_MTV_TRACE(accessor);
 
-        if (prev_cat == cat)
-        {
-            // t|xxx|x|   |b - Append to the previous block.
-            m_block_store.sizes[block_index - 1] += 1;
-            mdds_mtv_append_value(*prev_data, cell);
-            delete_element_block(block_index);
-            m_block_store.erase(block_index);
-            return get_iterator(block_index - 1);
-        }
+    return make_end();
+}
 
-        // Just overwrite the current block.
-        create_new_block_with_new_cell(block_index, cell);
-        return get_iterator(block_index);
-    }
+template<typename Traits>
+typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::begin() const
+{
+    MDDS_MTV_TRACE(accessor);
 
-    // t|???|x|???|b - Neither previous nor next blocks are empty.
-    base_element_block* prev_data = m_block_store.element_blocks[block_index - 1];
-    base_element_block* next_data = m_block_store.element_blocks[block_index + 1];
-    assert(prev_data);
-    assert(next_data);
-    element_t prev_cat = mdds::mtv::get_block_type(*prev_data);
-    element_t next_cat = mdds::mtv::get_block_type(*next_data);
+    return cbegin();
+}
 
-    if (prev_cat == next_cat)
-    {
-        if (prev_cat == cat)
-        {
-            // t|xxx|x|xxx|b - All three blocks are of the same type. Merge all
-            // three blocks.
-            m_block_store.sizes[block_index - 1] += 1 + m_block_store.sizes[block_index + 1];
-            mdds_mtv_append_value(*prev_data, cell);
-            block_funcs::append_block(*prev_data, *next_data);
-            block_funcs::resize_block(*next_data, 0); // to prevent deletion of managed cells on block deletion
+template<typename Traits>
+typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::end() const
+{
+    MDDS_MTV_TRACE(accessor);
 
-            // Delete the current and next blocks.
-            delete_element_block(block_index);
-            delete_element_block(block_index + 1);
-            m_block_store.erase(block_index, 2);
+    return cend();
+}
 
-            return get_iterator(block_index - 1);
-        }
+template<typename Traits>
+typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::cbegin() const
+{
+    MDDS_MTV_TRACE(accessor);
 
-        // t|---|x|---|b - Just overwrite the current block.
-        create_new_block_with_new_cell(block_index, cell);
-        return get_iterator(block_index);
-    }
+    return const_iterator(
+        {m_block_store.positions.cbegin(), m_block_store.sizes.cbegin(), m_block_store.element_blocks.cbegin()},
+        {m_block_store.positions.cend(), m_block_store.sizes.cend(), m_block_store.element_blocks.cend()}, this, 0);
+}
 
-    assert(prev_cat != next_cat);
+template<typename Traits>
+typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::cend() const
+{
+    MDDS_MTV_TRACE(accessor);
 
-    if (prev_cat == cat)
-    {
-        // t|xxx|x|---|b - Append to the previous block.
-        m_block_store.sizes[block_index - 1] += 1;
-        mdds_mtv_append_value(*m_block_store.element_blocks[block_index - 1], cell);
-        delete_element_block(block_index);
-        m_block_store.erase(block_index);
-        return get_iterator(block_index - 1);
-    }
+    return const_iterator(
+        {m_block_store.positions.cend(), m_block_store.sizes.cend(), m_block_store.element_blocks.cend()},
+        {m_block_store.positions.cend(), m_block_store.sizes.cend(), m_block_store.element_blocks.cend()}, this,
+        m_block_store.positions.size());
+}
 
-    if (next_cat == cat)
-    {
-        // t|---|x|xxx|b - Prepend to the next block.
-        m_block_store.sizes[block_index + 1] += 1;
-        m_block_store.positions[block_index + 1] -= 1;
-        mdds_mtv_prepend_value(*m_block_store.element_blocks[block_index + 1], cell);
-        delete_element_block(block_index);
-        m_block_store.erase(block_index);
-        return get_iterator(block_index);
-    }
+template<typename Traits>
+typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::make_rbegin()
+{
+    return reverse_iterator(
+        {m_block_store.positions.rbegin(), m_block_store.sizes.rbegin(), m_block_store.element_blocks.rbegin()},
+        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
+}
 
-    // t|---|x|+++|b - Just overwrite the current block.
-    create_new_block_with_new_cell(block_index, cell);
-    return get_iterator(block_index);
+template<typename Traits>
+typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::make_rend()
+{
+    return reverse_iterator(
+        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()},
+        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::size() const
+typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::rbegin()
+    requires(!Traits::enable_cow)
 {
     MDDS_MTV_TRACE(accessor);
 
-    return m_cur_size;
+    return make_rbegin();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::block_size() const
+typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::rend()
+    requires(!Traits::enable_cow)
 {
     MDDS_MTV_TRACE(accessor);
 
-    return m_block_store.positions.size();
+    return make_rend();
 }
 
 template<typename Traits>
-bool multi_type_vector<Traits>::empty() const
+typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::rbegin() const
 {
     MDDS_MTV_TRACE(accessor);
 
-    return m_block_store.positions.empty();
+    return crbegin();
 }
 
 template<typename Traits>
-template<typename T>
-void multi_type_vector<Traits>::get(size_type pos, T& value) const
+typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::rend() const
 {
-    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
-    get_impl(pos, value);
+    MDDS_MTV_TRACE(accessor);
+
+    return crend();
+}
+
+template<typename Traits>
+typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::crbegin() const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    return const_reverse_iterator(
+        {m_block_store.positions.rbegin(), m_block_store.sizes.rbegin(), m_block_store.element_blocks.rbegin()},
+        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
 }
 
 template<typename Traits>
-template<typename T>
-T multi_type_vector<Traits>::get(size_type pos) const
+typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::crend() const
 {
-    MDDS_MTV_TRACE_ARGS(accessor, "pos=" << pos);
+    MDDS_MTV_TRACE(accessor);
 
-    T cell;
-    get_impl(pos, cell);
-    return cell;
+    return const_reverse_iterator(
+        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()},
+        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
 }
 
 template<typename Traits>
-template<typename T>
-T multi_type_vector<Traits>::release(size_type pos)
+typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::get_block_position(
+    size_type row, size_type start_block_index) const
 {
-    MDDS_MTV_TRACE_ARGS(mutator, "pos=" << pos);
+    if (row >= m_cur_size || start_block_index >= m_block_store.positions.size())
+        return m_block_store.positions.size();
 
-    if constexpr (Traits::enable_cow)
+    if (!m_block_store.position_shifts.empty())
     {
-        if (m_cow_store)
-            throw shared_block_error("multi_type_vector::release: requires sole ownership; call detach() first");
-    }
+        // Some of the stored positions are not up-to-date.  Search on the
+        // logical block positions instead.
+        size_type lo = start_block_index, hi = m_block_store.positions.size();
+        assert(m_block_store.get_position(lo) <= row);
 
-    size_type block_index = get_block_position(pos);
-    if (block_index == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::release", __LINE__, pos, block_size(), size());
+        while (hi - lo > 1)
+        {
+            size_type mid = lo + (hi - lo) / 2;
+            if (m_block_store.get_position(mid) <= row)
+                lo = mid;
+            else
+                hi = mid;
+        }
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+        assert(row < m_block_store.get_position(lo) + m_block_store.sizes[lo]);
+        return lo;
+    }
 
-    T value;
-    release_impl(pos, block_index, value);
+    auto it0 = m_block_store.positions.begin();
+    std::advance(it0, start_block_index);
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    try
-    {
-        check_block_integrity();
-    }
-    catch (const mdds::integrity_error& e)
+    auto it = std::lower_bound(it0, m_block_store.positions.end(), row);
+
+    if (it == m_block_store.positions.end() || *it != row)
     {
-        std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in release(pos=" << pos << ")" << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
+        // Binary search has overshot by one block.  Move back one.
+        assert(it != it0);
+        --it;
     }
-#endif
 
-    return value;
+    size_type pos = std::distance(it0, it) + start_block_index;
+    assert(*it <= row);
+    assert(row < *it + m_block_store.sizes[pos]);
+    return pos;
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release(size_type pos, T& value)
+typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::get_block_position(
+    const typename value_type::private_data& pos_data, size_type row) const
 {
-    MDDS_MTV_TRACE_ARGS(mutator, "pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
+    size_type block_index = 0;
+    if (pos_data.parent == this && pos_data.block_index < m_block_store.positions.size())
+        block_index = pos_data.block_index;
 
-    if constexpr (Traits::enable_cow)
+    size_type start_row = m_block_store.get_position(block_index);
+
+    if (row < start_row)
     {
-        if (m_cow_store)
-            throw shared_block_error("multi_type_vector::release: requires sole ownership; call detach() first");
+        // Position hint is past the insertion position.
+        // Walk back if that seems efficient.
+        if (row > start_row / 2)
+        {
+            for (size_type i = block_index; i > 0;)
+            {
+                --i;
+                start_row = m_block_store.get_position(i);
+                if (row >= start_row)
+                {
+                    // Row is in this block.
+                    return i;
+                }
+                // Specified row is not in this block.
+            }
+            assert(start_row == 0);
+        }
+        // Otherwise reset.
+        block_index = 0;
     }
+    return get_block_position(row, block_index);
+}
 
-    size_type block_index = get_block_position(pos);
-    if (block_index == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::release", __LINE__, pos, block_size(), size());
+template<typename Traits>
+template<typename Blk, typename Func>
+typename multi_type_vector<Traits>::const_position_type multi_type_vector<Traits>::find_in_blocks(
+    const char* method_name, size_type start_pos, size_type end_pos, Func find_block) const
+{
+    if (start_pos > end_pos)
+        throw std::out_of_range("Start row is larger than the end row.");
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            method_name, __LINE__, start_pos, block_size(), size());
 
-    auto ret = release_impl(pos, block_index, value);
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(method_name, __LINE__, end_pos, block_size(), size());
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    try
+    for (size_type i = block_index1; i <= block_index2; ++i)
     {
-        check_block_integrity();
+        const base_element_block* data = m_block_store.element_blocks[i];
+        if (!data || get_block_type(*data) != Blk::block_type)
+            continue;
+
+        size_type start_row = m_block_store.get_position(i);
+        size_type offset = i == block_index1 ? start_pos - start_row : 0;
+        size_type end = i == block_index2 ? end_pos - start_row + 1 : m_block_store.sizes[i];
+        size_type found = find_block(*data, offset, end - offset);
+        if (found < end - offset)
+            return const_position_type(get_const_iterator(i), offset + found);
     }
-    catch (const mdds::integrity_error& e)
+
+    return const_position_type(cend(), 0);
+}
+
+template<typename Traits>
+std::vector<std::pair<typename multi_type_vector<Traits>::size_type, typename multi_type_vector<Traits>::size_type>>
+multi_type_vector<Traits>::get_block_chunks(size_type max_chunks) const
+{
+    std::vector<std::pair<size_type, size_type>> chunks;
+
+    size_type n_blocks = m_block_store.positions.size();
+    if (!n_blocks)
+        return chunks;
+
+    max_chunks = std::clamp<size_type>(max_chunks, 1, n_blocks);
+    chunks.reserve(max_chunks);
+
+    size_type first = 0;
+    for (size_type i = 1; i < max_chunks; ++i)
     {
-        std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in release(pos=" << pos << ")" << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
+        // Each chunk ends before the block that contains the next of the
+        // evenly spaced element positions.  Two positions may fall in the
+        // same block, in which case the chunk gets skipped.
+        size_type row = m_cur_size / max_chunks * i + m_cur_size % max_chunks * i / max_chunks;
+        size_type last = get_block_position(row, first);
+        if (last > first)
+        {
+            chunks.emplace_back(first, last);
+            first = last;
+        }
     }
-#endif
 
-    return ret;
+    chunks.emplace_back(first, n_blocks);
+    return chunks;
 }
 
 template<typename Traits>
-template<typename T>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release(
-    const iterator& pos_hint, size_type pos, T& value)
+void multi_type_vector<Traits>::check_container_pairs(
+    const char* method_name, std::span<multi_type_vector* const> sources, size_type start_pos, size_type end_pos,
+    std::span<multi_type_vector* const> dests, size_type dest_pos)
 {
-    MDDS_MTV_TRACE_ARGS(
-        mutator_with_pos_hint,
-        "pos_hint=" << pos_hint << "; pos=" << pos << "; value=? (type=" << mdds_mtv_get_element_type(value) << ")");
+    if (sources.size() != dests.size())
+    {
+        std::ostringstream os;
+        os << method_name << ": the numbers of the source and destination containers differ (sources="
+           << sources.size() << "; destinations=" << dests.size() << ")";
+        throw invalid_arg_error(os.str());
+    }
 
-    if constexpr (Traits::enable_cow)
+    if (start_pos > end_pos)
     {
-        if (m_cow_store)
-            throw shared_block_error("multi_type_vector::release: requires sole ownership; call detach() first");
+        std::ostringstream os;
+        os << method_name << ": start position is larger than the end position. (start=" << start_pos
+           << ", end=" << end_pos << ")";
+        throw std::out_of_range(os.str());
     }
 
-    size_type block_index = get_block_position(pos_hint->__private_data, pos);
-    if (block_index == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::release", __LINE__, pos, block_size(), size());
+    size_type last_dest_pos = dest_pos + end_pos - start_pos;
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+        if (!sources[i] || !dests[i])
+        {
+            std::ostringstream os;
+            os << method_name << ": container at index " << i << " is null.";
+            throw invalid_arg_error(os.str());
+        }
 
-    auto ret = release_impl(pos, block_index, value);
+        if (end_pos >= sources[i]->size())
+        {
+            std::ostringstream os;
+            os << method_name << ": end position is out of bound for the source container at index " << i
+               << ". (end=" << end_pos << "; size=" << sources[i]->size() << ")";
+            throw std::out_of_range(os.str());
+        }
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    try
-    {
-        check_block_integrity();
+        if (last_dest_pos >= dests[i]->size())
+        {
+            std::ostringstream os;
+            os << method_name << ": destination container at index " << i
+               << " is too small for the elements being moved. (last=" << last_dest_pos
+               << "; size=" << dests[i]->size() << ")";
+            throw std::out_of_range(os.str());
+        }
     }
-    catch (const mdds::integrity_error& e)
+
+    // Each container may only get modified by one pair, which also rules out
+    // a pair of the same container.
+    std::vector<const multi_type_vector*> containers(sources.begin(), sources.end());
+    containers.insert(containers.end(), dests.begin(), dests.end());
+    std::sort(containers.begin(), containers.end(), std::less<const multi_type_vector*>());
+    if (std::adjacent_find(containers.begin(), containers.end()) != containers.end())
     {
         std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in release(pos=" << pos << ")" << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
+        os << method_name << ": the same container appears more than once.";
+        throw invalid_arg_error(os.str());
     }
-#endif
-
-    return ret;
 }
 
 template<typename Traits>
-void multi_type_vector<Traits>::release()
+template<typename ExecPolicy, typename Func>
+void multi_type_vector<Traits>::for_each_container(ExecPolicy& policy, std::size_t count, Func func)
 {
-    MDDS_MTV_TRACE(mutator);
-
-    if constexpr (Traits::enable_cow)
+    if constexpr (std::is_same_v<std::remove_cvref_t<ExecPolicy>, mdds::mtv::default_exec_policy>)
     {
-        if (m_cow_store)
-            throw shared_block_error("multi_type_vector::release: requires sole ownership; call detach() first");
+        for (std::size_t i = 0; i < count; ++i)
+            func(i);
     }
+    else
+        detail::for_each_chunk(policy, count, func);
+}
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    std::ostringstream os_prev_block;
-    dump_blocks(os_prev_block);
-#endif
+template<typename Traits>
+void multi_type_vector<Traits>::apply_permutation_impl(std::span<const size_type> perm)
+{
+    if (!m_cur_size)
+        return;
 
-    for (auto* data : m_block_store.element_blocks)
-    {
-        if (!data)
-            continue;
+    // COW: the values get moved out of the current blocks, so the container
+    // must own all of them.
+    detach_range(0, 0, m_cur_size - 1);
+    apply_position_shifts();
 
-        block_funcs::resize_block(*data, 0);
-        m_hdl_event.element_block_released(data);
-        block_funcs::delete_block(data);
+    auto new_blocks = mdds::mtv::detail::gather_permuted_blocks<block_funcs, size_type>(
+        perm, m_block_store.element_blocks, m_block_store.sizes,
+        [this](element_t cat) { return create_element_block(cat); });
+
+    // The new blocks have taken over the values of the current blocks.
+    for (base_element_block* data : m_block_store.element_blocks)
+    {
+        if (data)
+            block_funcs::resize_block(*data, 0); // prevent double-delete.
     }
 
+    delete_element_blocks(0, m_block_store.element_blocks.size());
     m_block_store.clear();
-    m_cur_size = 0;
+    m_block_store.reserve(new_blocks.size());
 
-#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
-    try
-    {
-        check_block_integrity();
-    }
-    catch (const mdds::integrity_error& e)
+    size_type pos = 0;
+    for (const auto& blk : new_blocks)
     {
-        std::ostringstream os;
-        os << e.what() << std::endl;
-        os << "block integrity check failed in release()" << std::endl;
-        os << "previous block state:" << std::endl;
-        os << os_prev_block.str();
-        std::cerr << os.str() << std::endl;
-        abort();
+        m_block_store.push_back(pos, blk.size, blk.data);
+        if (blk.data)
+            m_hdl_event.element_block_acquired(blk.data);
+
+        pos += blk.size;
     }
+
+#ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
+    check_block_integrity();
 #endif
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release_range(
-    size_type start_pos, size_type end_pos)
+void multi_type_vector<Traits>::adjust_block_positions(size_type start_block_index, int64_t delta)
 {
-    MDDS_MTV_TRACE_ARGS(mutator, "start_pos=" << start_pos << "; end_pos=" << end_pos);
+    if (is_position_shift_deferred())
+        m_block_store.position_shifts.shift(m_block_store.positions, start_block_index, delta);
+    else
+        adjust_block_positions_func{}(m_block_store, start_block_index, delta);
+}
 
-    if constexpr (Traits::enable_cow)
+template<typename Traits>
+void multi_type_vector<Traits>::apply_position_shifts()
+{
+    m_block_store.apply_position_shifts();
+}
+
+template<typename Traits>
+multi_type_vector<Traits>::position_shift_scope::position_shift_scope(
+    multi_type_vector& parent, size_type block_index, size_type end_pos)
+{
+    if (parent.is_position_shift_deferred())
     {
-        if (m_cow_store)
-            throw shared_block_error("multi_type_vector::release_range: requires sole ownership; call detach() first");
+        m_parent = &parent;
+        blocks_type& store = parent.m_block_store;
+        size_type n = store.positions.size();
+
+        size_type last = n ? n - 1 : 0;
+        if (end_pos < parent.m_cur_size)
+            last = parent.get_block_position(end_pos, block_index);
+
+        // Include the immediate neighbors of the touched blocks since the
+        // mutation may merge them with, or split them into, the touched blocks.
+        size_type first = block_index ? block_index - 1 : 0;
+        last = std::min<size_type>(last + 3, n);
+        first = std::min(first, last);
+
+        store.position_shifts.begin_edit(store.positions, first, last);
     }
+}
 
-    size_type block_index1 = get_block_position(start_pos);
-    if (block_index1 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::release_range", __LINE__, start_pos, block_size(), size());
+template<typename Traits>
+multi_type_vector<Traits>::position_shift_scope::~position_shift_scope()
+{
+    if (!m_parent)
+        return;
 
-    return set_empty_impl(start_pos, end_pos, block_index1, false);
+    blocks_type& store = m_parent->m_block_store;
+    size_type n = store.positions.size();
+    store.position_shifts.end_edit(n);
+
+    // Lookups and edits get slower as the number of pending shifts grows.
+    // Apply them all at once when the list grows beyond the square root of
+    // the block count, which keeps the amortized cost of applying them in
+    // check.
+    size_type segment_count = store.position_shifts.segment_count();
+    if (segment_count > 16 && segment_count * segment_count > n)
+        store.apply_position_shifts();
+}
+
+template<typename Traits>
+multi_type_vector<Traits>::edit_session::edit_session(multi_type_vector& parent) : m_parent(&parent)
+{
+    ++m_parent->m_edit_session_depth;
+}
+
+template<typename Traits>
+multi_type_vector<Traits>::edit_session::~edit_session()
+{
+    commit();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::release_range(
-    const iterator& pos_hint, size_type start_pos, size_type end_pos)
+void multi_type_vector<Traits>::edit_session::commit()
 {
-    MDDS_MTV_TRACE_ARGS(
-        mutator_with_pos_hint, "pos_hint=" << pos_hint << "; start_pos=" << start_pos << "; end_pos=" << end_pos);
-
-    if constexpr (Traits::enable_cow)
-    {
-        if (m_cow_store)
-            throw shared_block_error("multi_type_vector::release_range: requires sole ownership; call detach() first");
-    }
+    if (!m_parent)
+        return;
 
-    size_type block_index1 = get_block_position(pos_hint->__private_data, start_pos);
-    if (block_index1 == m_block_store.positions.size())
-        mdds::mtv::detail::throw_block_position_not_found(
-            "multi_type_vector::release_range", __LINE__, start_pos, block_size(), size());
+    assert(m_parent->m_edit_session_depth > 0);
+    if (--m_parent->m_edit_session_depth == 0)
+        m_parent->apply_position_shifts();
 
-    return set_empty_impl(start_pos, end_pos, block_index1, false);
+    m_parent = nullptr;
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::make_begin()
+bool multi_type_vector<Traits>::edit_session::active() const noexcept
 {
-    return iterator(
-        {m_block_store.positions.begin(), m_block_store.sizes.begin(), m_block_store.element_blocks.begin()},
-        {m_block_store.positions.end(), m_block_store.sizes.end(), m_block_store.element_blocks.end()}, this, 0);
+    return m_parent != nullptr;
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::make_end()
+typename multi_type_vector<Traits>::edit_session multi_type_vector<Traits>::begin_edit_session()
 {
-    return iterator(
-        {m_block_store.positions.end(), m_block_store.sizes.end(), m_block_store.element_blocks.end()},
-        {m_block_store.positions.end(), m_block_store.sizes.end(), m_block_store.element_blocks.end()}, this,
-        m_block_store.positions.size());
+    MDDS_MTV_TRACE(mutator);
+
+    return edit_session(*this);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::begin()
-    requires(!Traits::enable_cow)
+multi_type_vector<Traits>::const_view::const_view(std::shared_ptr<const multi_type_vector> store)
+    : m_store(std::move(store))
 {
-    MDDS_MTV_TRACE(accessor);
-
-    return make_begin();
+    assert(m_store);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::end()
-    requires(!Traits::enable_cow)
+auto multi_type_vector<Traits>::const_view::store() const noexcept -> const multi_type_vector&
 {
-    MDDS_MTV_TRACE(accessor);
-
-    return make_end();
+    return *m_store;
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::begin() const
+auto multi_type_vector<Traits>::const_view::begin() const -> const_iterator
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->begin();
+}
 
-    return cbegin();
+template<typename Traits>
+auto multi_type_vector<Traits>::const_view::end() const -> const_iterator
+{
+    return m_store->end();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::end() const
+auto multi_type_vector<Traits>::const_view::cbegin() const -> const_iterator
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->cbegin();
+}
 
-    return cend();
+template<typename Traits>
+auto multi_type_vector<Traits>::const_view::cend() const -> const_iterator
+{
+    return m_store->cend();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::cbegin() const
+auto multi_type_vector<Traits>::const_view::rbegin() const -> const_reverse_iterator
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->rbegin();
+}
 
-    return const_iterator(
-        {m_block_store.positions.cbegin(), m_block_store.sizes.cbegin(), m_block_store.element_blocks.cbegin()},
-        {m_block_store.positions.cend(), m_block_store.sizes.cend(), m_block_store.element_blocks.cend()}, this, 0);
+template<typename Traits>
+auto multi_type_vector<Traits>::const_view::rend() const -> const_reverse_iterator
+{
+    return m_store->rend();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_iterator multi_type_vector<Traits>::cend() const
+auto multi_type_vector<Traits>::const_view::crbegin() const -> const_reverse_iterator
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->crbegin();
+}
 
-    return const_iterator(
-        {m_block_store.positions.cend(), m_block_store.sizes.cend(), m_block_store.element_blocks.cend()},
-        {m_block_store.positions.cend(), m_block_store.sizes.cend(), m_block_store.element_blocks.cend()}, this,
-        m_block_store.positions.size());
+template<typename Traits>
+auto multi_type_vector<Traits>::const_view::crend() const -> const_reverse_iterator
+{
+    return m_store->crend();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::make_rbegin()
+auto multi_type_vector<Traits>::const_view::size() const -> size_type
 {
-    return reverse_iterator(
-        {m_block_store.positions.rbegin(), m_block_store.sizes.rbegin(), m_block_store.element_blocks.rbegin()},
-        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
+    return m_store->size();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::make_rend()
+auto multi_type_vector<Traits>::const_view::block_size() const -> size_type
 {
-    return reverse_iterator(
-        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()},
-        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
+    return m_store->block_size();
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::rbegin()
-    requires(!Traits::enable_cow)
+bool multi_type_vector<Traits>::const_view::empty() const
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->empty();
+}
 
-    return make_rbegin();
+template<typename Traits>
+template<typename T>
+void multi_type_vector<Traits>::const_view::get(size_type pos, T& value) const
+{
+    m_store->get(pos, value);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::reverse_iterator multi_type_vector<Traits>::rend()
-    requires(!Traits::enable_cow)
+template<typename T>
+T multi_type_vector<Traits>::const_view::get(size_type pos) const
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->template get<T>(pos);
+}
 
-    return make_rend();
+template<typename Traits>
+mtv::element_t multi_type_vector<Traits>::const_view::get_type(size_type pos) const
+{
+    return m_store->get_type(pos);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::rbegin() const
+bool multi_type_vector<Traits>::const_view::is_empty(size_type pos) const
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->is_empty(pos);
+}
 
-    return crbegin();
+template<typename Traits>
+auto multi_type_vector<Traits>::const_view::position(size_type pos) const -> const_position_type
+{
+    return m_store->position(pos);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::rend() const
+auto multi_type_vector<Traits>::const_view::position(const const_iterator& pos_hint, size_type pos) const
+    -> const_position_type
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->position(pos_hint, pos);
+}
 
-    return crend();
+template<typename Traits>
+template<typename Blk, typename Op>
+typename mdds::mtv::detail::reduce_state<Blk, Op>::result_type multi_type_vector<Traits>::const_view::reduce(
+    size_type start_pos, size_type end_pos, Op op) const
+    requires(std::is_arithmetic_v<typename Blk::value_type> || std::is_same_v<Op, reduce_op::count>)
+{
+    return m_store->template reduce<Blk>(start_pos, end_pos, op);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::crbegin() const
+template<typename Blk>
+auto multi_type_vector<Traits>::const_view::find_first(
+    size_type start_pos, size_type end_pos, const typename Blk::value_type& value) const -> const_position_type
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->template find_first<Blk>(start_pos, end_pos, value);
+}
 
-    return const_reverse_iterator(
-        {m_block_store.positions.rbegin(), m_block_store.sizes.rbegin(), m_block_store.element_blocks.rbegin()},
-        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
+template<typename Traits>
+template<typename Blk, typename Pred>
+auto multi_type_vector<Traits>::const_view::find_if(size_type start_pos, size_type end_pos, Pred pred) const
+    -> const_position_type
+{
+    return m_store->template find_if<Blk>(start_pos, end_pos, std::move(pred));
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::const_reverse_iterator multi_type_vector<Traits>::crend() const
+template<typename Blk, typename Pred>
+auto multi_type_vector<Traits>::const_view::count_if(size_type start_pos, size_type end_pos, Pred pred) const
+    -> size_type
 {
-    MDDS_MTV_TRACE(accessor);
+    return m_store->template count_if<Blk>(start_pos, end_pos, std::move(pred));
+}
 
-    return const_reverse_iterator(
-        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()},
-        {m_block_store.positions.rend(), m_block_store.sizes.rend(), m_block_store.element_blocks.rend()}, this, 0);
+template<typename Traits>
+template<typename Blk>
+typename multi_type_vector<Traits>::template typed_range_type<Blk> multi_type_vector<Traits>::const_view::typed_range(
+    size_type start_pos, size_type end_pos) const
+{
+    return m_store->template typed_range<Blk>(start_pos, end_pos);
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::get_block_position(
-    size_type row, size_type start_block_index) const
+template<typename Blk>
+typename multi_type_vector<Traits>::template typed_range_type<Blk> multi_type_vector<Traits>::const_view::typed_range()
+    const
 {
-    if (row >= m_cur_size || start_block_index >= m_block_store.positions.size())
-        return m_block_store.positions.size();
+    return m_store->template typed_range<Blk>();
+}
 
-    auto it0 = m_block_store.positions.begin();
-    std::advance(it0, start_block_index);
+template<typename Traits>
+template<typename ExecPolicy, typename Func>
+void multi_type_vector<Traits>::const_view::parallel_for_each_block(ExecPolicy&& policy, Func func) const
+{
+    m_store->parallel_for_each_block(std::forward<ExecPolicy>(policy), std::move(func));
+}
 
-    auto it = std::lower_bound(it0, m_block_store.positions.end(), row);
+template<typename Traits>
+template<typename ExecPolicy, typename T, typename MapFunc, typename ReduceFunc>
+T multi_type_vector<Traits>::const_view::parallel_reduce_blocks(
+    ExecPolicy&& policy, T init, MapFunc map, ReduceFunc reduce) const
+{
+    return m_store->parallel_reduce_blocks(
+        std::forward<ExecPolicy>(policy), std::move(init), std::move(map), std::move(reduce));
+}
 
-    if (it == m_block_store.positions.end() || *it != row)
-    {
-        // Binary search has overshot by one block.  Move back one.
-        assert(it != it0);
-        --it;
-    }
+template<typename Traits>
+memory_usage_stats multi_type_vector<Traits>::const_view::memory_usage() const
+{
+    return m_store->memory_usage();
+}
 
-    size_type pos = std::distance(it0, it) + start_block_index;
-    assert(*it <= row);
-    assert(row < *it + m_block_store.sizes[pos]);
-    return pos;
+template<typename Traits>
+bool multi_type_vector<Traits>::const_view::operator==(const const_view& other) const
+{
+    return m_store == other.m_store || *m_store == *other.m_store;
 }
 
 template<typename Traits>
-typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::get_block_position(
-    const typename value_type::private_data& pos_data, size_type row) const
+bool multi_type_vector<Traits>::const_view::operator==(const multi_type_vector& other) const
 {
-    size_type block_index = 0;
-    if (pos_data.parent == this && pos_data.block_index < m_block_store.positions.size())
-        block_index = pos_data.block_index;
+    return *m_store == other;
+}
 
-    size_type start_row = m_block_store.positions[block_index];
+template<typename Traits>
+auto multi_type_vector<Traits>::snapshot() const -> const_view
+{
+    MDDS_MTV_TRACE(accessor);
 
-    if (row < start_row)
-    {
-        // Position hint is past the insertion position.
-        // Walk back if that seems efficient.
-        if (row > start_row / 2)
-        {
-            for (size_type i = block_index; i > 0;)
-            {
-                --i;
-                start_row = m_block_store.positions[i];
-                if (row >= start_row)
-                {
-                    // Row is in this block.
-                    return i;
-                }
-                // Specified row is not in this block.
-            }
-            assert(start_row == 0);
-        }
-        // Otherwise reset.
-        block_index = 0;
-    }
-    return get_block_position(row, block_index);
+    // Apply the pending position shifts up front, since the snapshot never
+    // gets modified and the lookups on it should not have to account for
+    // them.
+    std::shared_ptr<multi_type_vector> store(new multi_type_vector(mtv::detail::clone_construction_type{}, *this));
+    store->apply_position_shifts();
+    return const_view(std::move(store));
 }
 
 template<typename Traits>
@@ -4270,11 +5902,17 @@ void multi_type_vector<Traits>::create_new_block_with_new_cell(size_type block_i
     if (data)
     {
         m_hdl_event.element_block_released(data);
-        block_funcs::delete_block(data);
+        free_element_block(data);
     }
 
-    // create an empty block
-    data = mdds_mtv_create_new_block(0, cell);
+    // create an empty block, reusing a pooled block if one is available
+    data = nullptr;
+    if constexpr (Traits::block_pool_size > 0)
+        data = m_block_pool.acquire(mdds_mtv_get_element_type(cell));
+
+    if (!data)
+        data = mdds_mtv_create_new_block(0, cell);
+
     if (!data)
         throw general_error("Failed to create new block.");
 
@@ -4292,11 +5930,17 @@ void multi_type_vector<Traits>::create_new_block_with_emplace_back(size_type blo
     if (data)
     {
         m_hdl_event.element_block_released(data);
-        block_funcs::delete_block(data);
+        free_element_block(data);
     }
 
-    // create an empty block
-    data = mdds_mtv_create_new_block(0, t);
+    // create an empty block, reusing a pooled block if one is available
+    data = nullptr;
+    if constexpr (Traits::block_pool_size > 0)
+        data = m_block_pool.acquire(mdds_mtv_get_element_type(t));
+
+    if (!data)
+        data = mdds_mtv_create_new_block(0, t);
+
     if (!data)
         throw general_error("Failed to create new block.");
 
@@ -4351,7 +5995,7 @@ void multi_type_vector<Traits>::insert_cells_to_middle(
     m_block_store.calc_block_position(block_index + 2);
 
     // block for data series.
-    m_block_store.element_blocks[block_index + 1] = block_funcs::create_new_block(cat, 0);
+    m_block_store.element_blocks[block_index + 1] = create_element_block(cat);
     base_element_block* blk2_data = m_block_store.element_blocks[block_index + 1];
     m_hdl_event.element_block_acquired(blk2_data);
     mdds_mtv_assign_values(*blk2_data, *it_begin, it_begin, it_end);
@@ -4361,7 +6005,7 @@ void multi_type_vector<Traits>::insert_cells_to_middle(
         element_t blk_cat = mdds::mtv::get_block_type(*blk_data);
 
         // block to hold data from the lower part of the existing block.
-        m_block_store.element_blocks[block_index + 2] = block_funcs::create_new_block(blk_cat, 0);
+        m_block_store.element_blocks[block_index + 2] = create_element_block(blk_cat);
         base_element_block* blk3_data = m_block_store.element_blocks[block_index + 2];
         m_hdl_event.element_block_acquired(blk3_data);
 
@@ -4371,7 +6015,7 @@ void multi_type_vector<Traits>::insert_cells_to_middle(
         block_funcs::resize_block(*blk_data, m_block_store.sizes[block_index]);
     }
 
-    adjust_block_positions_func{}(m_block_store, block_index + 3, length);
+    adjust_block_positions(block_index + 3, length);
 }
 
 template<typename Traits>
@@ -4398,15 +6042,26 @@ void multi_type_vector<Traits>::set_cell_to_top_of_data_block(size_type block_in
 
     base_element_block* data = m_block_store.element_blocks[block_index];
     if (data)
-    {
-        block_funcs::overwrite_values(*data, 0, 1);
-        block_funcs::erase(*data, 0);
-    }
+        erase_first_value(*data);
 
     m_block_store.insert(block_index, position, 1, nullptr);
     create_new_block_with_new_cell(block_index, cell);
 }
 
+template<typename Traits>
+void multi_type_vector<Traits>::erase_first_value(base_element_block& data)
+{
+    block_funcs::overwrite_values(data, 0, 1);
+    block_funcs::erase(data, 0);
+
+    if constexpr (Traits::front_offset_compaction_ratio > 0.0)
+    {
+        std::size_t front_offset = block_funcs::front_offset(data);
+        if (front_offset && front_offset > Traits::front_offset_compaction_ratio * block_funcs::size(data))
+            block_funcs::compact(data);
+    }
+}
+
 template<typename Traits>
 template<typename T>
 void multi_type_vector<Traits>::set_cell_to_bottom_of_data_block(size_type block_index, const T& cell)
@@ -4551,7 +6206,7 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::transfer
         return get_iterator(block_index1);
     }
 
-    dest.m_block_store.element_blocks[dest_block_index] = block_funcs::create_new_block(cat, 0);
+    dest.m_block_store.element_blocks[dest_block_index] = create_element_block(cat);
     dst_data = dest.m_block_store.element_blocks[dest_block_index];
     assert(dst_data);
     dest.m_hdl_event.element_block_acquired(dst_data);
@@ -4715,7 +6370,7 @@ typename multi_type_vector<Traits>::size_type multi_type_vector<Traits>::set_new
         size_type lower_data_start = offset + new_block_size;
         assert(m_block_store.sizes[block_index + 2] == lower_block_size);
         element_t cat = mtv::get_block_type(*blk_data);
-        m_block_store.element_blocks[block_index + 2] = block_funcs::create_new_block(cat, 0);
+        m_block_store.element_blocks[block_index + 2] = create_element_block(cat);
         m_hdl_event.element_block_acquired(m_block_store.element_blocks[block_index + 2]);
 
         // Try to copy the fewer amount of data to the new non-empty block.
@@ -4870,7 +6525,7 @@ base_element_block* multi_type_vector<Traits>::exchange_elements(
             }
             else
             {
-                dst_blk_data = block_funcs::create_new_block(cat_src, 0);
+                dst_blk_data = create_element_block(cat_src);
                 m_block_store.element_blocks[dst_index] = dst_blk_data;
                 m_hdl_event.element_block_acquired(dst_blk_data);
                 assert(dst_blk_data && dst_blk_data != data.get());
@@ -4887,7 +6542,7 @@ base_element_block* multi_type_vector<Traits>::exchange_elements(
         if (dst_blk_data)
         {
             element_t cat_dst = mtv::get_block_type(*dst_blk_data);
-            data.reset(block_funcs::create_new_block(cat_dst, 0));
+            data.reset(create_element_block(cat_dst));
 
             // We need to keep the tail elements of the current block.
             block_funcs::assign_values_from_block(*data, *dst_blk_data, 0, len);
@@ -4909,7 +6564,7 @@ base_element_block* multi_type_vector<Traits>::exchange_elements(
         {
             // Insert a new block to house the new elements.
             m_block_store.insert(dst_index, position, len, nullptr);
-            dst_blk_data = block_funcs::create_new_block(cat_src, 0);
+            dst_blk_data = create_element_block(cat_src);
             m_block_store.element_blocks[dst_index] = dst_blk_data;
             m_hdl_event.element_block_acquired(dst_blk_data);
             block_funcs::assign_values_from_block(*dst_blk_data, src_data, src_offset, len);
@@ -4925,7 +6580,7 @@ base_element_block* multi_type_vector<Traits>::exchange_elements(
     {
         // Copy the elements of the current block to the block being returned.
         element_t cat_dst = mtv::get_block_type(*dst_blk_data);
-        data.reset(block_funcs::create_new_block(cat_dst, 0));
+        data.reset(create_element_block(cat_dst));
         block_funcs::assign_values_from_block(*data, *dst_blk_data, dst_offset, len);
     }
 
@@ -4952,7 +6607,7 @@ base_element_block* multi_type_vector<Traits>::exchange_elements(
             // Insert a new block to store the new elements.
             size_type position = m_block_store.positions[dst_index] + dst_offset;
             m_block_store.insert(dst_index + 1, position, len, nullptr);
-            m_block_store.element_blocks[dst_index + 1] = block_funcs::create_new_block(cat_src, 0);
+            m_block_store.element_blocks[dst_index + 1] = create_element_block(cat_src);
             dst_blk_data = m_block_store.element_blocks[dst_index + 1];
             assert(dst_blk_data);
             m_hdl_event.element_block_acquired(dst_blk_data);
@@ -4965,7 +6620,7 @@ base_element_block* multi_type_vector<Traits>::exchange_elements(
         assert(dst_end_pos < m_block_store.sizes[dst_index]);
         dst_index = set_new_block_to_middle(dst_index, dst_offset, len, false);
         assert(m_block_store.sizes[dst_index] == len);
-        m_block_store.element_blocks[dst_index] = block_funcs::create_new_block(cat_src, 0);
+        m_block_store.element_blocks[dst_index] = create_element_block(cat_src);
         dst_blk_data = m_block_store.element_blocks[dst_index];
         assert(dst_blk_data);
         m_hdl_event.element_block_acquired(dst_blk_data);
@@ -4991,7 +6646,7 @@ void multi_type_vector<Traits>::exchange_elements(
     if (bucket.insert_index > 0)
         m_block_store.calc_block_position(bucket.insert_index);
 
-    m_block_store.element_blocks[bucket.insert_index] = block_funcs::create_new_block(mtv::get_block_type(src_blk), 0);
+    m_block_store.element_blocks[bucket.insert_index] = create_element_block(mtv::get_block_type(src_blk));
 
     base_element_block* blk_data = m_block_store.element_blocks[bucket.insert_index];
 
@@ -5060,13 +6715,12 @@ void multi_type_vector<Traits>::resize(size_type new_size)
 {
     MDDS_MTV_TRACE_ARGS(mutator, "new_size=" << new_size);
 
-    detach_impl();
-
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
     std::ostringstream os_prev_block;
     dump_blocks(os_prev_block);
 #endif
 
+    apply_position_shifts();
     resize_impl(new_size);
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
@@ -5115,6 +6769,9 @@ void multi_type_vector<Traits>::resize_impl(size_type new_size)
         mdds::mtv::detail::throw_block_position_not_found(
             "multi_type_vector::resize", __LINE__, new_end_row, block_size(), size());
 
+    // Only the new last block gets modified; the blocks below it get removed.
+    detach_blocks(block_index, block_index);
+
     base_element_block* data = m_block_store.element_blocks[block_index];
     size_type start_row_in_block = m_block_store.positions[block_index];
     size_type end_row_in_block = start_row_in_block + m_block_store.sizes[block_index] - 1;
@@ -5125,7 +6782,7 @@ void multi_type_vector<Traits>::resize_impl(size_type new_size)
         size_type new_block_size = new_end_row - start_row_in_block + 1;
         if (data)
         {
-            block_funcs::overwrite_values(*data, new_end_row + 1, end_row_in_block - new_end_row);
+            block_funcs::overwrite_values(*data, new_block_size, end_row_in_block - new_end_row);
             block_funcs::resize_block(*data, new_block_size);
         }
         m_block_store.sizes[block_index] = new_block_size;
@@ -5230,7 +6887,7 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::transfer
         {
             base_element_block* blk_data1 = m_block_store.element_blocks[block_index1];
             element_t cat = mtv::get_block_type(*blk_data1);
-            dest.m_block_store.element_blocks[dest_block_index1] = block_funcs::create_new_block(cat, 0);
+            dest.m_block_store.element_blocks[dest_block_index1] = create_element_block(cat);
             base_element_block* dst_data1 = dest.m_block_store.element_blocks[dest_block_index1];
             assert(dst_data1);
             dest.m_hdl_event.element_block_acquired(dst_data1);
@@ -5308,7 +6965,7 @@ typename multi_type_vector<Traits>::iterator multi_type_vector<Traits>::transfer
             if (blk_data2)
             {
                 element_t cat = mtv::get_block_type(*blk_data2);
-                dest.m_block_store.element_blocks[dest_block_pos] = block_funcs::create_new_block(cat, 0);
+                dest.m_block_store.element_blocks[dest_block_pos] = create_element_block(cat);
                 base_element_block* blk_dst_data = dest.m_block_store.element_blocks[dest_block_pos];
                 dest.m_hdl_event.element_block_acquired(blk_dst_data);
 
@@ -5433,7 +7090,6 @@ void multi_type_vector<Traits>::swap(multi_type_vector& other) noexcept(nothrow_
     std::swap(m_hdl_event, other.m_hdl_event);
     std::swap(m_cur_size, other.m_cur_size);
     m_block_store.swap(other.m_block_store);
-    std::swap(m_cow_store, other.m_cow_store);
 }
 
 template<typename Traits>
@@ -5473,10 +7129,13 @@ void multi_type_vector<Traits>::swap(
     other.dump_blocks(os_prev_block_other);
 #endif
 
-    // COW: a range swap mutates other's storage too, so both sides must own their blocks.
-    detach_impl();
-    other.detach_impl();
+    // COW: a range swap mutates other's storage too, so both sides must own
+    // the blocks being modified.
+    detach_range(block_index1, start_pos, end_pos);
+    other.detach_range(dest_block_index1, other_pos, other_end_pos);
 
+    apply_position_shifts();
+    other.apply_position_shifts();
     swap_impl(other, start_pos, end_pos, other_pos, block_index1, block_index2, dest_block_index1, dest_block_index2);
 
 #ifdef MDDS_MULTI_TYPE_VECTOR_DEBUG
@@ -5518,6 +7177,100 @@ void multi_type_vector<Traits>::shrink_to_fit()
     detach_impl();
 
     detail::mutate_blocks<typename Traits::exec_policy, block_funcs::shrink_to_fit>{}(m_block_store.element_blocks);
+
+    if constexpr (Traits::block_pool_size > 0)
+        m_block_pool.clear();
+}
+
+template<typename Traits>
+memory_usage_stats multi_type_vector<Traits>::memory_usage() const
+{
+    MDDS_MTV_TRACE(accessor);
+
+    memory_usage_stats stats;
+
+    for (const base_element_block* data : m_block_store.element_blocks)
+    {
+        if (data)
+            stats.element_blocks[get_block_type(*data)] += block_funcs::memory_usage(*data);
+    }
+
+    if constexpr (Traits::block_pool_size > 0)
+        stats.pooled_blocks = m_block_pool.memory_usage();
+
+    auto add_array = [&stats](const auto& array) {
+        using elem_type = typename std::decay_t<decltype(array)>::value_type;
+        stats.block_store_bytes += array.size() * sizeof(elem_type);
+        stats.block_store_slack_bytes += (array.capacity() - array.size()) * sizeof(elem_type);
+    };
+
+    add_array(m_block_store.positions);
+    add_array(m_block_store.sizes);
+    add_array(m_block_store.element_blocks);
+
+    return stats;
+}
+
+template<typename Traits>
+compaction_stats multi_type_vector<Traits>::compact()
+{
+    MDDS_MTV_TRACE(mutator);
+
+    if (m_block_store.positions.empty())
+        return compaction_stats();
+
+    return compact_blocks(0, m_block_store.positions.size() - 1);
+}
+
+template<typename Traits>
+compaction_stats multi_type_vector<Traits>::compact(size_type start_pos, size_type end_pos)
+{
+    MDDS_MTV_TRACE_ARGS(mutator, "start_pos=" << start_pos << "; end_pos=" << end_pos);
+
+    if (start_pos > end_pos)
+        throw std::out_of_range("multi_type_vector::compact: start position is larger than the end position!");
+
+    size_type block_index1 = get_block_position(start_pos);
+    if (block_index1 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::compact", __LINE__, start_pos, block_size(), size());
+
+    size_type block_index2 = get_block_position(end_pos, block_index1);
+    if (block_index2 == m_block_store.positions.size())
+        mdds::mtv::detail::throw_block_position_not_found(
+            "multi_type_vector::compact", __LINE__, end_pos, block_size(), size());
+
+    return compact_blocks(block_index1, block_index2);
+}
+
+template<typename Traits>
+compaction_stats multi_type_vector<Traits>::compact_blocks(size_type block_index1, size_type block_index2)
+{
+    compaction_stats stats;
+
+    for (size_type i = block_index1; i <= block_index2; ++i)
+    {
+        base_element_block* data = m_block_store.element_blocks[i];
+        if (!data)
+            continue;
+
+        if constexpr (Traits::enable_cow)
+        {
+            // Shared blocks are left alone, as they may be in use by the other
+            // sharers.  Their copies don't inherit the erased values anyway.
+            if (mtv::detail::is_block_shared(*data))
+                continue;
+        }
+
+        std::size_t bytes = block_funcs::compact(*data);
+        if (bytes)
+        {
+            ++stats.compacted_blocks;
+            stats.reclaimed_bytes += bytes;
+        }
+    }
+
+    return stats;
 }
 
 template<typename Traits>
@@ -5573,7 +7326,7 @@ void multi_type_vector<Traits>::dump_blocks(std::ostream& os) const
     std::ios_base::fmtflags origflags = os.flags();
     for (size_type i = 0, n = m_block_store.positions.size(); i < n; ++i)
     {
-        size_type pos = m_block_store.positions[i];
+        size_type pos = m_block_store.get_position(i);
         size_type size = m_block_store.sizes[i];
         const base_element_block* data = m_block_store.element_blocks[i];
         element_t cat = mtv::element_type_empty;
@@ -5597,7 +7350,7 @@ void multi_type_vector<Traits>::check_block_integrity() const
     if (m_block_store.sizes.size() == 1 && m_block_store.sizes[0] == 0)
         throw mdds::integrity_error("block should never be zero sized!");
 
-    if (m_block_store.positions[0] != 0u)
+    if (m_block_store.get_position(0) != 0u)
     {
         std::ostringstream os;
         os << "position of the first block should be zero!" << std::endl;
@@ -5618,11 +7371,11 @@ void multi_type_vector<Traits>::check_block_integrity() const
         if (this_size == 0)
             throw mdds::integrity_error("block should never be zero sized!");
 
-        if (m_block_store.positions[i] != cur_position)
+        if (m_block_store.get_position(i) != cur_position)
         {
             std::ostringstream os;
             os << "position of the current block is wrong! (expected=" << cur_position
-               << "; actual=" << m_block_store.positions[i] << ")" << std::endl;
+               << "; actual=" << m_block_store.get_position(i) << ")" << std::endl;
 
             dump_blocks(os);
             throw mdds::integrity_error(os.str());
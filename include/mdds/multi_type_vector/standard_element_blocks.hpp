@@ -6,11 +6,16 @@
 
 #pragma once
 
+#include "env.hpp"
 #include "types.hpp"
 #include "util.hpp"
 #include "block_funcs.hpp"
 #include "macro.hpp"
 
+#if MDDS_MTV_USE_BIT_VECTOR_BOOLEAN_BLOCK
+#include "bit_vector.hpp"
+#endif
+
 namespace mdds { namespace mtv {
 
 constexpr element_t element_type_boolean = element_type_reserved_start;
@@ -26,7 +31,11 @@ constexpr element_t element_type_float = element_type_reserved_start + 9;
 constexpr element_t element_type_double = element_type_reserved_start + 10;
 constexpr element_t element_type_string = element_type_reserved_start + 11;
 
+#if MDDS_MTV_USE_BIT_VECTOR_BOOLEAN_BLOCK
+using boolean_element_block = default_element_block<element_type_boolean, bool, bit_vector>;
+#else
 using boolean_element_block = default_element_block<element_type_boolean, bool>;
+#endif
 using int8_element_block = default_element_block<element_type_int8, int8_t>;
 using uint8_element_block = default_element_block<element_type_uint8, uint8_t>;
 using int16_element_block = default_element_block<element_type_int16, int16_t>;
@@ -0,0 +1,407 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "./reduce.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mdds { namespace mtv {
+
+/**
+ * Summary of the numeric values stored in a summary_vector instance.
+ *
+ * @tparam T value type.
+ */
+template<typename T>
+struct value_summary
+{
+    using sum_type = detail::reduce_sum_type<T>;
+
+    /** Number of the values. */
+    std::size_t count = 0;
+
+    /**
+     * Sum of the values, of either <code>int64_t</code> or
+     * <code>uint64_t</code> for integral values depending on their
+     * signedness.
+     */
+    sum_type sum = 0;
+
+    /** Minimum value.  It is unspecified when count is zero. */
+    T min{};
+
+    /** Maximum value.  It is unspecified when count is zero. */
+    T max{};
+};
+
+/**
+ * Vector of numeric values that keeps a cached summary of its values,
+ * namely their count, sum, minimum and maximum.  When used as the store of
+ * an element block, reduce() answers from the summary for each block that
+ * lies entirely within the requested range instead of visiting its values,
+ * and find_first() skips each block whose value range excludes the value
+ * being searched for.
+ *
+ * The summary gets computed on the first call to summary() after the
+ * values have changed.  Any call to a non-const method, including the
+ * non-const variants of begin(), data() and the subscript operator,
+ * invalidates the summary, since the values may get modified through the
+ * returned iterator or reference.  Concurrent calls to summary() on the same
+ * instance are safe, as long as no thread calls a non-const method at the
+ * same time.
+ *
+ * @tparam T element type, which must be an arithmetic type other than bool.
+ * @tparam Allocator allocator type.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class summary_vector
+{
+    static_assert(
+        std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+        "Only arithmetic types other than bool are supported as the element type.");
+
+    using store_type = std::vector<T, Allocator>;
+
+    enum summary_state : unsigned char
+    {
+        summary_invalid = 0,
+        summary_building,
+        summary_valid
+    };
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef value_summary<T> summary_type;
+
+    summary_vector() noexcept(std::is_nothrow_default_constructible_v<store_type>)
+    {}
+
+    summary_vector(size_type n) : m_store(n)
+    {}
+
+    summary_vector(size_type n, const T& val) : m_store(n, val)
+    {}
+
+    template<std::input_iterator InputIt>
+    summary_vector(InputIt first, InputIt last) : m_store(first, last)
+    {}
+
+    summary_vector(const summary_vector& other) : m_store(other.m_store)
+    {
+        copy_summary(other);
+    }
+
+    summary_vector(summary_vector&& other) noexcept : m_store(std::move(other.m_store))
+    {
+        copy_summary(other);
+        other.invalidate();
+    }
+
+    summary_vector& operator=(const summary_vector& other)
+    {
+        summary_vector tmp(other);
+        swap(tmp);
+        return *this;
+    }
+
+    summary_vector& operator=(summary_vector&& other) noexcept
+    {
+        m_store = std::move(other.m_store);
+        copy_summary(other);
+        other.invalidate();
+        return *this;
+    }
+
+    iterator begin()
+    {
+        invalidate();
+        return m_store.data();
+    }
+
+    iterator end()
+    {
+        invalidate();
+        return m_store.data() + m_store.size();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return m_store.data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return m_store.data() + m_store.size();
+    }
+
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    reference operator[](size_type pos)
+    {
+        invalidate();
+        return m_store[pos];
+    }
+
+    const_reference operator[](size_type pos) const
+    {
+        return m_store[pos];
+    }
+
+    reference at(size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range("summary_vector::at: position is out of range.");
+
+        invalidate();
+        return m_store[pos];
+    }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("summary_vector::at: position is out of range.");
+
+        return m_store[pos];
+    }
+
+    void push_back(const T& value)
+    {
+        invalidate();
+        m_store.push_back(value);
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        invalidate();
+        return m_store.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop_back()
+    {
+        invalidate();
+        m_store.pop_back();
+    }
+
+    void swap(summary_vector& other) noexcept
+    {
+        m_store.swap(other.m_store);
+
+        // Swap the summaries only when both are valid, and invalidate both
+        // otherwise.
+        if (is_summary_valid() && other.is_summary_valid())
+            std::swap(m_summary, other.m_summary);
+        else
+        {
+            invalidate();
+            other.invalidate();
+        }
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        size_type offset = pos - m_store.data();
+        invalidate();
+        m_store.insert(m_store.begin() + offset, value);
+        return m_store.data() + offset;
+    }
+
+    template<std::input_iterator InputIt>
+    void insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        size_type offset = pos - m_store.data();
+        invalidate();
+        m_store.insert(m_store.begin() + offset, first, last);
+    }
+
+    void resize(size_type count)
+    {
+        invalidate();
+        m_store.resize(count);
+    }
+
+    void erase(const_iterator pos)
+    {
+        erase(pos, pos + 1);
+    }
+
+    void erase(const_iterator first, const_iterator last)
+    {
+        size_type offset = first - m_store.data();
+        size_type len = last - first;
+        invalidate();
+        m_store.erase(m_store.begin() + offset, m_store.begin() + offset + len);
+    }
+
+    void clear() noexcept
+    {
+        invalidate();
+        m_store.clear();
+    }
+
+    size_type capacity() const noexcept
+    {
+        return m_store.capacity();
+    }
+
+    void shrink_to_fit()
+    {
+        m_store.shrink_to_fit();
+    }
+
+    void reserve(size_type new_cap)
+    {
+        m_store.reserve(new_cap);
+    }
+
+    size_type size() const noexcept
+    {
+        return m_store.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return m_store.empty();
+    }
+
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        invalidate();
+        m_store.assign(first, last);
+    }
+
+    T* data()
+    {
+        invalidate();
+        return m_store.data();
+    }
+
+    const T* data() const noexcept
+    {
+        return m_store.data();
+    }
+
+    /**
+     * Get the summary of the stored values.  It gets computed and cached when
+     * the values have changed since the last call.
+     *
+     * @return summary of the stored values.
+     */
+    summary_type summary() const
+    {
+        if (is_summary_valid())
+            return m_summary;
+
+        summary_type summary = compute_summary();
+
+        // Only one caller gets to cache the summary.  The others that call
+        // this concurrently simply return the summary they have computed.
+        unsigned char expected = summary_invalid;
+        if (m_summary_state.compare_exchange_strong(expected, summary_building, std::memory_order_acquire))
+        {
+            m_summary = summary;
+            m_summary_state.store(summary_valid, std::memory_order_release);
+        }
+
+        return summary;
+    }
+
+    /**
+     * Check whether or not the summary is currently cached.
+     *
+     * @return true if the summary is cached, false if it needs to be
+     *         computed on the next call to summary().
+     */
+    bool is_summary_valid() const noexcept
+    {
+        return m_summary_state.load(std::memory_order_acquire) == summary_valid;
+    }
+
+private:
+    void invalidate() noexcept
+    {
+        m_summary_state.store(summary_invalid, std::memory_order_relaxed);
+    }
+
+    void copy_summary(const summary_vector& other) noexcept
+    {
+        if (other.is_summary_valid())
+        {
+            m_summary = other.m_summary;
+            m_summary_state.store(summary_valid, std::memory_order_release);
+        }
+        else
+            invalidate();
+    }
+
+    summary_type compute_summary() const
+    {
+        summary_type summary;
+        summary.count = m_store.size();
+
+        if (!m_store.empty())
+        {
+            summary.sum = detail::reduce_sum_values(m_store.data(), m_store.size());
+            summary.min = detail::reduce_min_values(m_store.data(), m_store.size());
+            summary.max = detail::reduce_max_values(m_store.data(), m_store.size());
+        }
+
+        return summary;
+    }
+
+    store_type m_store;
+    mutable summary_type m_summary;
+    mutable std::atomic<unsigned char> m_summary_state{summary_invalid};
+};
+
+template<typename T, typename Allocator>
+bool operator==(const summary_vector<T, Allocator>& lhs, const summary_vector<T, Allocator>& rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+}} // namespace mdds::mtv
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -11,10 +11,12 @@
 #include "./delayed_delete_vector.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <concepts>
 #include <memory>
 #include <cstdint>
+#include <map>
 #include <vector>
 #include <sstream>
 #include <type_traits>
@@ -39,6 +41,13 @@ constexpr element_t element_type_user_start = 50;
  *
  * In each enumerator value, the first byte contains the loop-unrolling factor
  * (either 0, 4, 8, 16 or 32), while the second byte stores SIMD flags.
+ *
+ * The <code>sse2_x64*</code>, <code>avx2_x64*</code> and
+ * <code>avx512_x64*</code> values require the corresponding instruction set
+ * to be enabled at compile time.  The <code>runtime_dispatch</code> value
+ * instead detects the available instruction set when the program runs, and
+ * picks the widest vector kernel supported by the CPU.  It falls back to a
+ * scalar loop on platforms where no vector kernel is available.
  */
 enum class lu_factor_t : int
 {
@@ -54,6 +63,27 @@ enum class lu_factor_t : int
     avx2_x64 = 2 << 8,
     avx2_x64_lu4 = 2 << 8 | 4,
     avx2_x64_lu8 = 2 << 8 | 8,
+    avx512_x64 = 4 << 8,
+    avx512_x64_lu4 = 4 << 8 | 4,
+    avx512_x64_lu8 = 4 << 8 | 8,
+    runtime_dispatch = 8 << 8,
+};
+
+/**
+ * Strategy for updating the logical positions of the blocks that follow a
+ * block whose size has changed.
+ *
+ * With <code>immediate</code>, the positions of all following blocks get
+ * updated right away, which takes linear time in the number of the following
+ * blocks.  With <code>deferred</code>, only the positions of the blocks in the
+ * vicinity of the edit get updated, while the shift of the remaining blocks
+ * is recorded in a short list of pending shifts and gets applied later.
+ * Position lookups take the pending shifts into account.
+ */
+enum class position_shift_t : int
+{
+    immediate = 0,
+    deferred = 1,
 };
 
 /**
@@ -116,6 +146,121 @@ struct trace_method_properties_t
     int line_number = -1;
 };
 
+/**
+ * Memory used by one or more element blocks, in bytes.  Only the memory
+ * directly held by the blocks and their stores is counted; any memory the
+ * stored values themselves point to, such as the buffers of string values or
+ * the objects managed by managed element blocks, is not.
+ */
+struct element_block_memory_usage
+{
+    /** Number of the blocks. */
+    std::size_t block_count = 0;
+
+    /**
+     * Size of the block objects themselves, excluding the inline buffer of
+     * the store if any.
+     */
+    std::size_t object_bytes = 0;
+
+    /** Memory occupied by the stored values. */
+    std::size_t value_bytes = 0;
+
+    /**
+     * Memory occupied by the values that have been erased from the front of
+     * the store but not yet reclaimed.  This is non-zero only for stores that
+     * delay the erasure of their leading values, such as
+     * delayed_delete_vector.
+     */
+    std::size_t front_offset_bytes = 0;
+
+    /** Memory reserved by the store for additional values. */
+    std::size_t slack_bytes = 0;
+
+    /**
+     * @return total memory used by the blocks.
+     */
+    std::size_t total() const noexcept
+    {
+        return object_bytes + value_bytes + front_offset_bytes + slack_bytes;
+    }
+
+    element_block_memory_usage& operator+=(const element_block_memory_usage& r) noexcept
+    {
+        block_count += r.block_count;
+        object_bytes += r.object_bytes;
+        value_bytes += r.value_bytes;
+        front_offset_bytes += r.front_offset_bytes;
+        slack_bytes += r.slack_bytes;
+        return *this;
+    }
+};
+
+/**
+ * Memory used by a multi_type_vector instance, in bytes, as returned by its
+ * memory_usage() method.  It does not include the size of the container
+ * object itself.
+ */
+struct memory_usage_stats
+{
+    /**
+     * Memory used by the element blocks, broken down by their element types.
+     * Blocks shared with other containers via copy-on-write are counted in
+     * full.
+     */
+    std::map<element_t, element_block_memory_usage> element_blocks;
+
+    /**
+     * Memory used by the released element blocks kept in the block pool for
+     * reuse.
+     */
+    element_block_memory_usage pooled_blocks;
+
+    /**
+     * Memory occupied by the block store that manages the positions, sizes
+     * and element block pointers of all blocks.
+     */
+    std::size_t block_store_bytes = 0;
+
+    /** Memory reserved by the block store for additional blocks. */
+    std::size_t block_store_slack_bytes = 0;
+
+    /**
+     * @return total memory used by the container.
+     */
+    std::size_t total() const noexcept
+    {
+        std::size_t n = block_store_bytes + block_store_slack_bytes + pooled_blocks.total();
+        for (const auto& [type, usage] : element_blocks)
+            n += usage.total();
+
+        return n;
+    }
+};
+
+/**
+ * Result of the compaction of the element block stores, as returned by the
+ * compact() method of multi_type_vector.
+ */
+struct compaction_stats
+{
+    /** Number of the blocks whose stores have been compacted. */
+    std::size_t compacted_blocks = 0;
+
+    /**
+     * Memory that has been occupied by the values erased from the front of
+     * the stores, and has become available again for new values.
+     */
+    std::size_t reclaimed_bytes = 0;
+
+    compaction_stats& operator+=(const compaction_stats& r) noexcept
+    {
+        compacted_blocks += r.compacted_blocks;
+        reclaimed_bytes += r.reclaimed_bytes;
+        return *this;
+    }
+};
+
 /**
  * Generic exception used for errors specific to element block operations.
  */
@@ -141,6 +286,14 @@ public:
 class base_element_block;
 element_t get_block_type(const base_element_block&) noexcept;
 
+namespace detail {
+
+void add_block_owner(const base_element_block&) noexcept;
+bool is_block_shared(const base_element_block&) noexcept;
+bool remove_block_owner(const base_element_block&) noexcept;
+
+} // namespace detail
+
 /**
  * Non-template common base type necessary for blocks of all types to be
  * stored in a single container.
@@ -148,11 +301,32 @@ element_t get_block_type(const base_element_block&) noexcept;
 class base_element_block
 {
     friend element_t get_block_type(const base_element_block&) noexcept;
+    friend void detail::add_block_owner(const base_element_block&) noexcept;
+    friend bool detail::is_block_shared(const base_element_block&) noexcept;
+    friend bool detail::remove_block_owner(const base_element_block&) noexcept;
 
 protected:
     element_t type;
+
+    /**
+     * Number of the owners of this block in addition to the first one.  It
+     * only becomes non-zero when multiple copy-on-write containers share
+     * this block.  It's not copied along with the block since a copy always
+     * starts with a single owner.
+     */
+    mutable std::atomic<std::uint32_t> extra_owners{0};
+
     base_element_block(element_t _t) noexcept : type(_t)
     {}
+
+    base_element_block(const base_element_block& other) noexcept : type(other.type)
+    {}
+
+    base_element_block& operator=(const base_element_block& other) noexcept
+    {
+        type = other.type;
+        return *this;
+    }
 };
 
 /**
@@ -253,9 +427,11 @@ struct clone_block<BlockT, std::void_t<decltype(clone_value<typename BlockT::val
                 std::is_invocable_r_v<value_type, const CV&, const value_type&>,
                 "a clone_value with an exec_policy must be stateless (const-invocable)");
 
+            // NB: the policy is passed as an lvalue, since some standard library
+            // implementations fail to compile with a policy passed as an rvalue.
             auto dest_blk = std::make_unique<BlockT>(src.store().size());
-            std::transform(
-                typename CV::exec_policy{}, src.store().begin(), src.store().end(), dest_blk->store().begin(), CV{});
+            typename CV::exec_policy policy{};
+            std::transform(policy, src.store().begin(), src.store().end(), dest_blk->store().begin(), CV{});
 
             return dest_blk.release();
         }
@@ -526,6 +702,14 @@ public:
             detail::shrink_to_fit(st);
     }
 
+    static void clear_block(base_element_block& blk)
+    {
+        // Unlike resize_block(), this retains the capacity of the store.
+        store_type& st = get(blk).m_array;
+        Self::overwrite_values(blk, 0, st.size());
+        detail::erase(st, 0, st.size());
+    }
+
 #ifdef MDDS_UNIT_TEST
     static void print_block(const base_element_block& blk)
     {
@@ -543,13 +727,13 @@ public:
     static void erase_value(base_element_block& blk, size_t pos)
     {
         store_type& blk2 = get(blk).m_array;
-        blk2.erase(blk2.begin() + pos);
+        detail::erase(blk2, pos);
     }
 
     static void erase_values(base_element_block& blk, size_t pos, size_t size)
     {
         store_type& blk2 = get(blk).m_array;
-        blk2.erase(blk2.begin() + pos, blk2.begin() + pos + size);
+        detail::erase(blk2, pos, size);
     }
 
     static void append_block(base_element_block& dest, const base_element_block& src)
@@ -616,10 +800,19 @@ public:
     static void set_values(base_element_block& block, size_t pos, const Iter& it_begin, const Iter& it_end)
     {
         store_type& d = get(block).m_array;
-        typename store_type::iterator it_dest = d.begin();
-        std::advance(it_dest, pos);
-        for (Iter it = it_begin; it != it_end; ++it, ++it_dest)
-            *it_dest = *it;
+
+        if constexpr (detail::has_replace_method<store_type, Iter>)
+        {
+            // Let the store overwrite the whole range at once.
+            d.replace(pos, it_begin, it_end);
+        }
+        else
+        {
+            typename store_type::iterator it_dest = d.begin();
+            std::advance(it_dest, pos);
+            for (Iter it = it_begin; it != it_end; ++it, ++it_dest)
+                *it_dest = *it;
+        }
     }
 
     template<typename Iter>
@@ -669,6 +862,64 @@ public:
         detail::shrink_to_fit(blk);
     }
 
+    static element_block_memory_usage memory_usage(const base_element_block& block)
+    {
+        const store_type& blk = get(block).m_array;
+        std::size_t size = blk.size();
+        std::size_t front_offset = detail::get_front_offset(blk);
+        std::size_t capacity = std::max(detail::get_block_capacity(blk), size + front_offset);
+
+        element_block_memory_usage usage;
+        usage.block_count = 1;
+        usage.object_bytes = sizeof(Self);
+
+        if constexpr (detail::has_value_bytes_method<store_type>)
+        {
+            usage.value_bytes = blk.value_bytes();
+            usage.front_offset_bytes = 0;
+            usage.slack_bytes = blk.slack_bytes();
+        }
+        else if constexpr (detail::is_std_vector_bool_store<store_type>::type::value)
+        {
+            // The values are packed into bits.
+            usage.value_bytes = (size + 7) / 8;
+            usage.front_offset_bytes = (size + front_offset + 7) / 8 - usage.value_bytes;
+            usage.slack_bytes = (capacity + 7) / 8 - usage.value_bytes - usage.front_offset_bytes;
+        }
+        else
+        {
+            usage.value_bytes = size * sizeof(value_type);
+            usage.front_offset_bytes = front_offset * sizeof(value_type);
+            usage.slack_bytes = (capacity - size - front_offset) * sizeof(value_type);
+
+            if constexpr (detail::has_inline_buffer<store_type>)
+            {
+                // The inline buffer is part of the block object.  When the
+                // values are stored in a separate buffer, the inline buffer
+                // is left unused.
+                std::size_t inline_bytes = store_type::inline_capacity * sizeof(value_type);
+                usage.object_bytes -= inline_bytes;
+                if (!blk.is_inline())
+                    usage.slack_bytes += inline_bytes;
+            }
+        }
+
+        return usage;
+    }
+
+    static std::size_t front_offset(const base_element_block& block)
+    {
+        const store_type& blk = get(block).m_array;
+        return detail::get_front_offset(blk);
+    }
+
+    static std::size_t compact(base_element_block& block)
+    {
+        std::size_t bytes = memory_usage(block).front_offset_bytes;
+        store_type& blk = get(block).m_array;
+        return detail::compact(blk) ? bytes : 0;
+    }
+
 private:
     static std::pair<const_iterator, const_iterator> get_iterator_pair(
         const store_type& array, size_t begin_pos, size_t len)
@@ -768,6 +1019,48 @@ inline element_t get_block_type(const base_element_block& blk) noexcept
     return blk.type;
 }
 
+namespace detail {
+
+/**
+ * Register an additional owner of a shared element block.
+ */
+inline void add_block_owner(const base_element_block& blk) noexcept
+{
+    blk.extra_owners.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Check whether or not an element block is currently owned by more than one
+ * container.  A block that is not shared can be modified in place by its
+ * sole owner.
+ */
+inline bool is_block_shared(const base_element_block& blk) noexcept
+{
+    return blk.extra_owners.load(std::memory_order_acquire) > 0;
+}
+
+/**
+ * Unregister one owner of an element block.
+ *
+ * @return true if the caller was the last owner of the block and therefore
+ *         is responsible for freeing it, false otherwise.
+ */
+inline bool remove_block_owner(const base_element_block& blk) noexcept
+{
+    if (blk.extra_owners.load(std::memory_order_acquire) == 0)
+        return true;
+
+    if (blk.extra_owners.fetch_sub(1, std::memory_order_acq_rel) > 0)
+        return false;
+
+    // All the other owners have left between the check and the decrement
+    // above, which has wrapped the count around.
+    blk.extra_owners.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace detail
+
 /**
  * Template for default, unmanaged element block for use in
  * multi_type_vector.
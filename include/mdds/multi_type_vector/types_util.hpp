@@ -7,6 +7,7 @@
 #pragma once
 
 #include <concepts>
+#include <utility>
 #include <vector>
 
 namespace mdds { namespace mtv { namespace detail {
@@ -25,6 +26,40 @@ std::size_t get_block_capacity(const T& blk)
         return 0;
 }
 
+template<typename T>
+concept has_front_offset_method = requires(const T& blk) {
+    { blk.front_offset() } -> std::same_as<typename T::size_type>;
+};
+
+template<typename T>
+std::size_t get_front_offset(const T& blk)
+{
+    if constexpr (has_front_offset_method<T>)
+        return blk.front_offset();
+    else
+        return 0;
+}
+
+template<typename T>
+concept has_compact_method = requires(T& blk) {
+    { blk.compact() } -> std::same_as<typename T::size_type>;
+};
+
+template<typename T>
+std::size_t compact(T& blk)
+{
+    if constexpr (has_compact_method<T>)
+        return blk.compact();
+    else
+        return 0;
+}
+
+template<typename T>
+concept has_inline_buffer = requires(const T& blk) {
+    { T::inline_capacity } -> std::convertible_to<std::size_t>;
+    { blk.is_inline() } -> std::same_as<bool>;
+};
+
 template<typename T>
 concept has_reserve_method = requires(T& blk, typename T::size_type size) {
     { blk.reserve(size) } -> std::same_as<void>;
@@ -49,6 +84,84 @@ void shrink_to_fit(T& blk)
         blk.shrink_to_fit();
 }
 
+template<typename T>
+concept has_const_erase_method = requires(T& blk, typename T::const_iterator it) {
+    blk.erase(it);
+    blk.erase(it, it);
+};
+
+/**
+ * Erase a value from a store.  Const iterators are passed when the store
+ * accepts them, so that the store is not asked for mutable access to its
+ * values just to erase some of them.
+ */
+template<typename T>
+void erase(T& blk, std::size_t pos)
+{
+    if constexpr (has_const_erase_method<T>)
+        blk.erase(std::as_const(blk).begin() + pos);
+    else
+        blk.erase(blk.begin() + pos);
+}
+
+/**
+ * Erase a range of values from a store.
+ */
+template<typename T>
+void erase(T& blk, std::size_t pos, std::size_t size)
+{
+    if constexpr (has_const_erase_method<T>)
+    {
+        auto it = std::as_const(blk).begin() + pos;
+        blk.erase(it, it + size);
+    }
+    else
+        blk.erase(blk.begin() + pos, blk.begin() + pos + size);
+}
+
+template<typename T, typename Iter>
+concept has_replace_method = requires(T& blk, typename T::size_type pos, const Iter& it) { blk.replace(pos, it, it); };
+
+/**
+ * Stores that encode their values report the memory used for them on their
+ * own, as it is not proportional to the number of values stored.
+ */
+template<typename T>
+concept has_value_bytes_method = requires(const T& blk) {
+    { blk.value_bytes() } -> std::same_as<typename T::size_type>;
+    { blk.slack_bytes() } -> std::same_as<typename T::size_type>;
+};
+
+/**
+ * Stores of boolean values that can count the true values in a range
+ * without visiting each value.
+ */
+template<typename T>
+concept has_count_method = requires(const T& blk, typename T::size_type pos, typename T::size_type len) {
+    { blk.count(pos, len) } -> std::same_as<typename T::size_type>;
+};
+
+/**
+ * Stores of boolean values that can find the first occurrence of a value in
+ * a range without visiting each value.
+ */
+template<typename T>
+concept has_find_method = requires(const T& blk, bool value, typename T::size_type pos, typename T::size_type len) {
+    { blk.find(value, pos, len) } -> std::same_as<typename T::size_type>;
+};
+
+/**
+ * Stores of numeric values that keep a cached summary of their values, which
+ * lets whole blocks get reduced or skipped without visiting each value.
+ */
+template<typename T>
+concept has_summary_method = requires(const T& blk) {
+    blk.summary().count;
+    blk.summary().sum;
+    blk.summary().min;
+    blk.summary().max;
+};
+
 template<typename T>
 struct is_std_vector_bool_store
 {
@@ -66,6 +66,15 @@ struct default_traits
      */
     static constexpr lu_factor_t loop_unrolling = lu_factor_t::lu16;
 
+    /**
+     * Static value specifying how the positions of the blocks following an
+     * edited block get updated when the edit changes the size of the
+     * container.  Consider using the deferred strategy when the container
+     * tends to consist of a large number of blocks and undergoes frequent
+     * insertions and erasures.  This must be a const expression.
+     */
+    static constexpr position_shift_t position_shift = position_shift_t::immediate;
+
     /**
      * Static value specifying whether or not to enable copy-on-write (COW)
      * semantics for the element block storage.  When enabled, a copied or
@@ -74,6 +83,31 @@ struct default_traits
      */
     static constexpr bool enable_cow = false;
 
+    /**
+     * Static value specifying the maximum number of released element blocks
+     * to keep per element type for reuse.  When non-zero, a block that gets
+     * released by an edit is emptied and kept in a pool owned by the
+     * container instead of being deleted, and later gets reused when a new
+     * block of the same type is needed, along with its storage.  The pooled
+     * blocks keep the capacity of their storage until shrink_to_fit() gets
+     * called, which deletes them.  Zero disables the pooling.  This must be a
+     * const expression.
+     */
+    static constexpr std::size_t block_pool_size = 0;
+
+    /**
+     * Static value specifying when to reclaim the memory occupied by the
+     * values erased from the front of an element block store, for stores
+     * such as delayed_delete_vector that delay such erasures.  When the
+     * number of the erased values exceeds this ratio of the number of the
+     * values remaining in the store, the remaining values get moved to the
+     * front of the store right away.  Zero disables the automatic compaction,
+     * in which case the memory gets reclaimed only when the store gets
+     * resized or when compact() or shrink_to_fit() gets called.  This must be
+     * a const expression.
+     */
+    static constexpr double front_offset_compaction_ratio = 0.0;
+
     /**
      * Execution policy for potentially parallelizable operations.
      */
@@ -98,10 +132,10 @@ struct clone_construction_type
 };
 
 /**
- * Empty placeholder used as the copy-on-write store member when COW is
- * disabled.
+ * Empty placeholder used as the element block pool member when the pooling
+ * of released element blocks is disabled.
  */
-struct empty_cow_store
+struct empty_block_pool
 {
 };
 
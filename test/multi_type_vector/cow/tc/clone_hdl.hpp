@@ -95,10 +95,10 @@ void test_cow_clone_hdl_one()
 
     if constexpr (Cow)
     {
-        // The clone detached: a logical release then re-acquire fired per block
-        // on the clone's own (new) handler.
-        TEST_ASSERT(cloned.event_handler().released == n_blocks);
-        TEST_ASSERT(cloned.event_handler().acquired == 2 * n_blocks);
+        // The clone detached the written block only: a logical release then
+        // re-acquire fired for that block on the clone's own (new) handler.
+        TEST_ASSERT(cloned.event_handler().released == 1);
+        TEST_ASSERT(cloned.event_handler().acquired == n_blocks + 1);
     }
     else
     {
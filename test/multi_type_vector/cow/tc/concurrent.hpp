@@ -0,0 +1,150 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common_types.hpp"
+
+#include <mdds/multi_type_vector/soa/concurrent_vector.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Modifications only become visible to the readers once published.
+ */
+template<typename Traits>
+void test_cow_concurrent_vector_publish()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using cv_type = mdds::mtv::soa::concurrent_vector<Traits>;
+    using mtv_type = typename cv_type::store_type;
+
+    cv_type empty;
+    TEST_ASSERT(empty.read().empty());
+
+    cv_type cv(mtv_type(4, custom_num(1.0)));
+    auto view = cv.read();
+    TEST_ASSERT(view.size() == 4);
+    TEST_ASSERT(same_block_pointers(view.store(), cv.store()));
+
+    cv.store().set(0, custom_num(2.0));
+    cv.store().set(1, new custom_str1{"a"});
+    TEST_ASSERT(cv.read().template get<custom_num>(0).value == 1.0);
+    TEST_ASSERT(cv.read().get_type(1) == block1_id);
+
+    cv.publish();
+    auto view2 = cv.read();
+    TEST_ASSERT(view2.template get<custom_num>(0).value == 2.0);
+    TEST_ASSERT(view2.template get<custom_str1*>(1)->value == "a");
+    TEST_ASSERT(view.template get<custom_num>(0).value == 1.0);
+
+    cv.modify([](mtv_type& db) { db.push_back(custom_num(3.0)); });
+    TEST_ASSERT(cv.read().size() == 5);
+    TEST_ASSERT(view2.size() == 4);
+
+    // Nothing gets published when the modification fails.
+    try
+    {
+        cv.modify([](mtv_type& db) {
+            db.push_back(custom_num(4.0));
+            throw std::runtime_error("failed");
+        });
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::runtime_error&)
+    {
+        // expected
+    }
+
+    TEST_ASSERT(cv.store().size() == 6);
+    TEST_ASSERT(cv.read().size() == 5);
+}
+
+/**
+ * Reader threads keep reading the latest published version while the writer
+ * keeps modifying and publishing the container.  Position 0 stores the
+ * version number, and every other value stores the version in which it has
+ * been set, which must never exceed the version of the view it is read from.
+ */
+template<typename Traits>
+void test_cow_concurrent_vector_threads()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using cv_type = mdds::mtv::soa::concurrent_vector<Traits>;
+    using mtv_type = typename cv_type::store_type;
+
+    constexpr std::size_t n = 500;
+    constexpr int n_versions = 300;
+
+    cv_type cv(mtv_type(n, custom_num(0.0)));
+    std::atomic<bool> done{false};
+    std::atomic<bool> failed{false};
+
+    auto reader = [&cv, &done, &failed] {
+        double last_version = 0.0;
+        while (!done)
+        {
+            auto view = cv.read();
+            double version = view.template get<custom_num>(0).value;
+            if (version < last_version || view.size() != n)
+                failed = true;
+            last_version = version;
+
+            for (const auto& blk : view)
+            {
+                if (blk.type == block1_id)
+                {
+                    for (const auto& v : block1_type::get(*blk.data).store())
+                    {
+                        if (v.value > version)
+                            failed = true;
+                    }
+                }
+                else if (blk.type == block2_id)
+                {
+                    for (const custom_str1* p : block2_type::get(*blk.data).store())
+                    {
+                        if (std::stod(p->value) > version)
+                            failed = true;
+                    }
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+        readers.emplace_back(reader);
+
+    for (int i = 1; i <= n_versions; ++i)
+    {
+        double version = i;
+        std::size_t pos = 1 + (i * 37) % (n - 1);
+
+        cv.modify([version, pos](mtv_type& db) {
+            db.set(0, custom_num(version));
+            if (pos % 2)
+                db.set(pos, new custom_str1{std::to_string(version)});
+            else
+                db.set(pos, custom_num(version));
+        });
+    }
+
+    done = true;
+    for (auto& t : readers)
+        t.join();
+
+    TEST_ASSERT(!failed);
+    TEST_ASSERT(cv.read().template get<custom_num>(0).value == double(n_versions));
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,133 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common_types.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * A snapshot shares all blocks with its source, and keeps its content while
+ * the source gets modified and even after the source goes away.
+ */
+template<typename mtv_type>
+void test_cow_const_view()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    auto src = std::make_unique<mtv_type>(6);
+    src->set(0, custom_num(1.0));
+    src->set(1, custom_num(2.0));
+    src->set(3, new custom_str1{"a"});
+    src->set(4, new custom_str1{"b"});
+
+    typename mtv_type::const_view view = src->snapshot();
+    TEST_ASSERT(view.size() == 6);
+    TEST_ASSERT(view.block_size() == 4);
+    TEST_ASSERT(!view.empty());
+    TEST_ASSERT(view == *src);
+    TEST_ASSERT(same_block_pointers(view.store(), *src));
+
+    // A copy of a view references the same version.
+    auto view2 = view;
+    TEST_ASSERT(&view2.store() == &view.store());
+    TEST_ASSERT(view2 == view);
+
+    src->set(0, custom_num(10.0));
+    src->set(3, new custom_str1{"c"});
+    src->insert_empty(0, 2);
+
+    TEST_ASSERT(view.size() == 6);
+    TEST_ASSERT(view.template get<custom_num>(0).value == 1.0);
+    TEST_ASSERT(view.template get<custom_num>(1).value == 2.0);
+    TEST_ASSERT(view.is_empty(2));
+    TEST_ASSERT(view.get_type(3) == block2_id);
+    TEST_ASSERT(view.template get<custom_str1*>(3)->value == "a");
+    TEST_ASSERT(view.template get<custom_str1*>(4)->value == "b");
+    TEST_ASSERT(view.is_empty(5));
+
+    auto pos = view.position(4);
+    TEST_ASSERT(pos.first->type == block2_id);
+    TEST_ASSERT(pos.second == 1);
+    pos = view.position(pos.first, 5);
+    TEST_ASSERT(pos.first->type == mdds::mtv::element_type_empty);
+
+    TEST_ASSERT(src->template get<custom_num>(2).value == 10.0);
+    TEST_ASSERT(src->template get<custom_str1*>(5)->value == "c");
+    TEST_ASSERT(!(view == *src));
+
+    // The view outlives the source.
+    src.reset();
+    TEST_ASSERT(view.template get<custom_str1*>(3)->value == "a");
+    TEST_ASSERT(view2.template get<custom_str1*>(4)->value == "b");
+
+    std::size_t n_blocks = 0;
+    for (const auto& blk : view)
+    {
+        (void)blk;
+        ++n_blocks;
+    }
+    TEST_ASSERT(n_blocks == 4);
+    TEST_ASSERT(std::distance(view.rbegin(), view.rend()) == 4);
+}
+
+/**
+ * A reader thread iterates over a series of snapshots while the writer keeps
+ * modifying the source.  Each snapshot stores a uniform value which must
+ * stay intact regardless of the writer.
+ */
+template<typename mtv_type>
+void test_cow_const_view_threads()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    constexpr std::size_t n = 1000;
+    constexpr int n_versions = 50;
+
+    mtv_type src(n, custom_num(0.0));
+    std::vector<typename mtv_type::const_view> views;
+    views.reserve(n_versions);
+
+    for (int i = 0; i < n_versions; ++i)
+    {
+        views.push_back(src.snapshot());
+        std::vector<custom_num> values(n, custom_num(double(i + 1)));
+        src.set(0, values.begin(), values.end());
+    }
+
+    std::atomic<bool> failed{false};
+    std::thread reader([&views, &failed] {
+        for (int i = 0; i < n_versions; ++i)
+        {
+            const auto& view = views[i];
+            for (std::size_t pos = 0; pos < view.size(); pos += 7)
+            {
+                if (view.template get<custom_num>(pos).value != double(i))
+                    failed = true;
+            }
+        }
+    });
+
+    // Keep modifying the source and taking more snapshots while the reader
+    // reads the earlier ones.
+    for (int i = 0; i < 200; ++i)
+    {
+        std::size_t pos = (i * 37) % n;
+        src.set(pos, new custom_str1{"x"});
+        src.set(pos, custom_num(-1.0));
+        auto view = src.snapshot();
+        TEST_ASSERT(view.template get<custom_num>(pos).value == -1.0);
+    }
+
+    reader.join();
+    TEST_ASSERT(!failed);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
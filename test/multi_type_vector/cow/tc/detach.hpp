@@ -39,6 +39,79 @@ void test_cow_detach_on_write()
     TEST_ASSERT(copied.begin()->data == p_before);
 }
 
+/**
+ * A write detaches only the blocks it may modify, and the rest of the blocks
+ * stay shared with the other sharer.
+ */
+template<typename mtv_type>
+void test_cow_detach_touched_blocks_only()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    // Build a source with 5 blocks:
+    //   0-2: custom_num, 3-4: empty, 5-7: custom_num, 8: empty, 9-10: custom_num
+    mtv_type src(11);
+    std::vector<custom_num> values = {1.1, 1.2, 1.3};
+    src.set(0, values.begin(), values.end());
+    src.set(5, values.begin(), values.end());
+    src.set(9, values.begin(), values.begin() + 2);
+    TEST_ASSERT(src.block_size() == 5);
+
+    auto block_data = [](const mtv_type& db, std::size_t block_index) {
+        auto it = db.begin();
+        std::advance(it, block_index);
+        return it->data;
+    };
+
+    {
+        // Overwriting a value of the same type detaches its own block only.
+        mtv_type copied(src);
+        copied.template set<custom_num>(6, 9.9);
+        TEST_ASSERT(block_data(copied, 0) == block_data(src, 0));
+        TEST_ASSERT(block_data(copied, 2) != block_data(src, 2));
+        TEST_ASSERT(block_data(copied, 4) == block_data(src, 4));
+        TEST_ASSERT(src.template get<custom_num>(6).value == 1.2);
+        TEST_ASSERT(copied.template get<custom_num>(6).value == 9.9);
+
+        // The handler saw a logical release and re-acquire of that block.
+        TEST_ASSERT(copied.event_handler().released == 1);
+        TEST_ASSERT(copied.event_handler().live() == 3);
+    }
+
+    {
+        // Emptying a cell may merge the block with its neighbors, so the
+        // adjacent blocks get detached too, but the first one stays shared.
+        mtv_type copied(src);
+        copied.set_empty(7, 7);
+        TEST_ASSERT(copied.block_size() == 5);
+        TEST_ASSERT(block_data(copied, 0) == block_data(src, 0));
+        TEST_ASSERT(block_data(copied, 2) != block_data(src, 2));
+        TEST_ASSERT(src.template get<custom_num>(7).value == 1.3);
+        TEST_ASSERT(copied.is_empty(7));
+    }
+
+    {
+        // Appending only touches the last block.
+        mtv_type copied(src);
+        copied.template push_back<custom_num>(1.4);
+        TEST_ASSERT(block_data(copied, 0) == block_data(src, 0));
+        TEST_ASSERT(block_data(copied, 2) == block_data(src, 2));
+        TEST_ASSERT(block_data(copied, 4) != block_data(src, 4));
+        TEST_ASSERT(src.size() == 11);
+        TEST_ASSERT(copied.size() == 12);
+    }
+
+    {
+        // Shrinking only touches the new last block.
+        mtv_type copied(src);
+        copied.resize(6);
+        TEST_ASSERT(block_data(copied, 0) == block_data(src, 0));
+        TEST_ASSERT(block_data(copied, 2) != block_data(src, 2));
+        TEST_ASSERT(src.template get<custom_num>(7).value == 1.3);
+        TEST_ASSERT(copied.size() == 6);
+    }
+}
+
 /**
  * Mutating either sharer leaves the other intact (both-side independence), in
  * both detach directions.
@@ -31,15 +31,18 @@ void test_cow_noncopyable()
         TEST_ASSERT(src == cloned);
         TEST_ASSERT(same_block_pointers(src, cloned)); // shared
 
-        // First write detaches: the managed pointees are deep-cloned and the
-        // two sides become independent.
+        // First write detaches the written block only; the managed blocks
+        // stay shared.
         cloned.template set<custom_num>(0, 9.9);
         TEST_ASSERT(!same_block_pointers(src, cloned));
         TEST_ASSERT(cloned.template get<custom_num>(0).value == 9.9);
         TEST_ASSERT(src.template get<custom_num>(0).value == 1.1);
+        TEST_ASSERT(src.template get<custom_str1*>(1) == cloned.template get<custom_str1*>(1));
+        TEST_ASSERT(src.template get<custom_str2*>(2) == cloned.template get<custom_str2*>(2));
 
-        // The managed blocks were cloned, so the pointees are distinct objects
-        // holding equal values.
+        // Detaching explicitly clones the managed blocks, so the pointees are
+        // distinct objects holding equal values.
+        cloned.detach();
         TEST_ASSERT(src.template get<custom_str1*>(1) != cloned.template get<custom_str1*>(1));
         TEST_ASSERT(src.template get<custom_str1*>(1)->value == cloned.template get<custom_str1*>(1)->value);
         TEST_ASSERT(src.template get<custom_str2*>(2) != cloned.template get<custom_str2*>(2));
@@ -12,12 +12,16 @@
 #include "noncopyable.hpp"
 #include "iterator_gate.hpp"
 #include "clone_hdl.hpp"
+#include "snapshots.hpp"
+#include "const_view.hpp"
+#include "concurrent.hpp"
 
 template<typename cow_mtv_type, typename non_cow_mtv_type>
 void run_all_tests()
 {
     test_cow_share<cow_mtv_type>();
     test_cow_detach_on_write<cow_mtv_type>();
+    test_cow_detach_touched_blocks_only<cow_mtv_type>();
     test_cow_both_side<cow_mtv_type>();
     test_cow_release_requires_sole_ownership<cow_mtv_type>();
     test_cow_release_pos_hint_requires_sole_ownership<cow_mtv_type>();
@@ -25,6 +29,11 @@ void run_all_tests()
     test_cow_noncopyable<cow_mtv_type>();
     test_cow_iterator_gate<cow_mtv_type, non_cow_mtv_type>();
     test_cow_clone_hdl();
+    test_cow_snapshots_random<cow_mtv_type, non_cow_mtv_type>();
+    test_cow_const_view<cow_mtv_type>();
+    test_cow_const_view_threads<cow_mtv_type>();
+    test_cow_concurrent_vector_publish<cow_traits>();
+    test_cow_concurrent_vector_threads<cow_traits>();
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
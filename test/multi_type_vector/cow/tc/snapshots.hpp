@@ -0,0 +1,232 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common_types.hpp"
+
+#include <algorithm>
+#include <list>
+#include <numeric>
+#include <random>
+#include <utility>
+
+/**
+ * Check that a COW container and a non-COW container store the same content,
+ * block by block.  The managed values are compared by their pointees.
+ */
+template<typename cow_mtv_type, typename non_cow_mtv_type>
+void assert_same_content(const cow_mtv_type& cow, const non_cow_mtv_type& ref)
+{
+    TEST_ASSERT(cow.size() == ref.size());
+    TEST_ASSERT(cow.block_size() == ref.block_size());
+
+    auto it = cow.begin();
+    auto it_ref = ref.begin();
+    for (; it != cow.end(); ++it, ++it_ref)
+    {
+        TEST_ASSERT(it->type == it_ref->type);
+        TEST_ASSERT(it->size == it_ref->size);
+
+        switch (it->type)
+        {
+            case block1_id:
+                TEST_ASSERT(block1_type::get(*it->data).store() == block1_type::get(*it_ref->data).store());
+                break;
+            case block2_id:
+            {
+                const auto& store = block2_type::get(*it->data).store();
+                const auto& store_ref = block2_type::get(*it_ref->data).store();
+                TEST_ASSERT(std::equal(
+                    store.begin(), store.end(), store_ref.begin(), store_ref.end(),
+                    [](const custom_str1* p1, const custom_str1* p2) { return p1->value == p2->value; }));
+                break;
+            }
+            default:
+                TEST_ASSERT(it->type == mdds::mtv::element_type_empty);
+        }
+    }
+}
+
+/**
+ * Number of the non-empty blocks, which should match the number of the live
+ * blocks as seen by the event handler.
+ */
+template<typename mtv_type>
+int count_non_empty_blocks(const mtv_type& db)
+{
+    int n = 0;
+    for (const auto& blk : db)
+    {
+        if (blk.data)
+            ++n;
+    }
+    return n;
+}
+
+/**
+ * Mutate two COW containers that keep sharing their blocks with many
+ * snapshots, and mutate two non-COW containers in lockstep as a reference.
+ * Every snapshot must keep its content regardless of the mutations made
+ * afterward, and the mutated containers must match the references.
+ *
+ * This needs to be run under the check-memcheck target to verify that each
+ * shared block gets freed exactly once.
+ */
+template<typename cow_mtv_type, typename non_cow_mtv_type>
+void test_cow_snapshots_random()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    std::mt19937 gen(11);
+    auto rand_below = [&gen](std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(gen); };
+
+    cow_mtv_type db1(100), db2(100);
+    non_cow_mtv_type ref1(100), ref2(100);
+
+    // NB: std::list avoids relocating the snapshots, which would copy them
+    // since the move constructor of the containers is not noexcept.
+    std::list<std::pair<cow_mtv_type, non_cow_mtv_type>> snapshots;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        bool second = rand_below(2);
+        cow_mtv_type& db = second ? db2 : db1;
+        non_cow_mtv_type& ref = second ? ref2 : ref1;
+        cow_mtv_type& db_other = second ? db1 : db2;
+        non_cow_mtv_type& ref_other = second ? ref1 : ref2;
+
+        std::size_t n = ref.size();
+        std::size_t pos = rand_below(n);
+        std::size_t len = std::min<std::size_t>(rand_below(4) + 1, n - pos);
+
+        switch (rand_below(13))
+        {
+            case 0:
+            {
+                custom_num v(double(rand_below(3)));
+                db.set(pos, v);
+                ref.set(pos, v);
+                break;
+            }
+            case 1:
+            {
+                std::string v(1, char('a' + rand_below(3)));
+                db.set(pos, new custom_str1{v});
+                ref.set(pos, new custom_str1{v});
+                break;
+            }
+            case 2:
+            {
+                std::vector<custom_num> values(len, custom_num(double(rand_below(3))));
+                db.set(pos, values.begin(), values.end());
+                ref.set(pos, values.begin(), values.end());
+                break;
+            }
+            case 3:
+                db.set_empty(pos, pos + len - 1);
+                ref.set_empty(pos, pos + len - 1);
+                break;
+            case 4:
+            {
+                std::vector<custom_num> values(len, custom_num(double(rand_below(3))));
+                db.insert(pos, values.begin(), values.end());
+                ref.insert(pos, values.begin(), values.end());
+                break;
+            }
+            case 5:
+                if (n > 50)
+                {
+                    db.erase(pos, pos + len - 1);
+                    ref.erase(pos, pos + len - 1);
+                }
+                break;
+            case 6:
+                db.insert_empty(pos, len);
+                ref.insert_empty(pos, len);
+                break;
+            case 7:
+            {
+                custom_num v(double(rand_below(3)));
+                db.push_back(v);
+                ref.push_back(v);
+                break;
+            }
+            case 8:
+            {
+                std::vector<std::pair<std::size_t, custom_num>> values;
+                for (std::size_t j = pos; j < n; j += rand_below(8) + 1)
+                    values.emplace_back(j, custom_num(double(rand_below(3))));
+                db.set_batch(std::span{values});
+                ref.set_batch(std::span{values});
+                break;
+            }
+            case 9:
+                if (n > 50)
+                {
+                    db.resize(n - len);
+                    ref.resize(n - len);
+                }
+                else
+                {
+                    db.resize(n + len);
+                    ref.resize(n + len);
+                }
+                break;
+            case 10:
+            {
+                std::size_t dest_pos = rand_below(ref_other.size() - len + 1);
+                db.transfer(pos, pos + len - 1, db_other, dest_pos);
+                ref.transfer(pos, pos + len - 1, ref_other, dest_pos);
+                break;
+            }
+            case 11:
+            {
+                std::size_t other_pos = rand_below(ref_other.size() - len + 1);
+                db.swap(pos, pos + len - 1, db_other, other_pos);
+                ref.swap(pos, pos + len - 1, ref_other, other_pos);
+                break;
+            }
+            case 12:
+            {
+                std::vector<std::size_t> perm(n);
+                std::iota(perm.begin(), perm.end(), 0);
+                // Shuffle a section of the positions, leaving the blocks
+                // outside of it where they are.
+                std::size_t shuffle_end = std::min(n, pos + len * 10);
+                std::shuffle(perm.begin() + pos, perm.begin() + shuffle_end, gen);
+                db.apply_permutation(perm);
+                ref.apply_permutation(perm);
+                break;
+            }
+        }
+
+        TEST_ASSERT(db.event_handler().live() == count_non_empty_blocks(db));
+        TEST_ASSERT(db_other.event_handler().live() == count_non_empty_blocks(db_other));
+
+        if (i % 10 == 0)
+            snapshots.emplace_back(db.clone(), ref.clone());
+
+        if (i % 25 == 0 && !snapshots.empty())
+            // Let one of the snapshots go so that some shared blocks get
+            // freed by their other owners.
+            snapshots.erase(std::next(snapshots.begin(), rand_below(snapshots.size())));
+
+        if (i % 100 == 0)
+        {
+            assert_same_content(db1, ref1);
+            assert_same_content(db2, ref2);
+        }
+    }
+
+    assert_same_content(db1, ref1);
+    assert_same_content(db2, ref2);
+
+    for (const auto& [snapshot, snapshot_ref] : snapshots)
+        assert_same_content(snapshot, snapshot_ref);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
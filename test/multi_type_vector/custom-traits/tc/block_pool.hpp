@@ -0,0 +1,175 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2025 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// SoA-only extension: the pooling of released element blocks only applies to
+// the soa variant.
+
+#include <random>
+#include <string>
+
+/**
+ * Event handler that keeps track of the number of live blocks as well as the
+ * last blocks acquired and released.
+ */
+struct event_block_tracker
+{
+    std::size_t live_count = 0;
+    const mdds::mtv::base_element_block* last_acquired = nullptr;
+    const mdds::mtv::base_element_block* last_released = nullptr;
+
+    void element_block_acquired(const mdds::mtv::base_element_block* block)
+    {
+        ++live_count;
+        last_acquired = block;
+    }
+
+    void element_block_released(const mdds::mtv::base_element_block* block)
+    {
+        --live_count;
+        last_released = block;
+    }
+};
+
+struct trait_block_pool : public mdds::mtv::standard_element_blocks_traits
+{
+    using event_func = event_block_tracker;
+
+    constexpr static std::size_t block_pool_size = 4;
+};
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_block_pool_reuse()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mtv_tmpl<trait_block_pool>;
+
+    mtv_type db(10, 1.0);
+    TEST_ASSERT(db.event_handler().live_count == 1);
+
+    // Split the numeric block with an int32 block in the middle.
+    db.set(5, int32_t(1));
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(db.event_handler().live_count == 3);
+    const mdds::mtv::base_element_block* int_block = db.event_handler().last_acquired;
+
+    // Overwrite the int32 value to merge the blocks back into one.  The int32
+    // block goes into the pool.
+    db.set(5, 2.0);
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(db.event_handler().live_count == 1);
+
+    // Split the block again.  The pooled int32 block should get reused.
+    db.set(5, int32_t(3));
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(db.event_handler().live_count == 3);
+    TEST_ASSERT(db.event_handler().last_acquired == int_block);
+    TEST_ASSERT(db.template get<int32_t>(5) == 3);
+    TEST_ASSERT(db.template get<double>(4) == 1.0);
+    TEST_ASSERT(db.template get<double>(6) == 1.0);
+
+    // A reused string block must not carry over any previous values.
+    db.set(2, std::string("A"));
+    const mdds::mtv::base_element_block* str_block = db.event_handler().last_acquired;
+    db.set(2, 4.0);
+    db.set(8, std::string("B"));
+    TEST_ASSERT(db.event_handler().last_acquired == str_block);
+    TEST_ASSERT(db.block_size() == 5);
+    TEST_ASSERT(db.template get<std::string>(8) == "B");
+    TEST_ASSERT(db.template get<double>(2) == 4.0);
+
+    db.clear();
+    TEST_ASSERT(db.event_handler().live_count == 0);
+
+    // The released blocks stay in the pool until shrink_to_fit() gets called.
+    TEST_ASSERT(db.memory_usage().pooled_blocks.block_count > 0);
+    db.shrink_to_fit();
+    TEST_ASSERT(db.memory_usage().pooled_blocks.block_count == 0);
+}
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_block_pool_random()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using ref_type = mtv_tmpl<trait_lu<lu_factor_t::none>>;
+    using mtv_type = mtv_tmpl<trait_block_pool>;
+
+    std::mt19937 gen(7);
+    auto rand_below = [&gen](std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(gen); };
+
+    ref_type ref(100);
+    mtv_type db(100);
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::size_t n = ref.size();
+        std::size_t pos = rand_below(n);
+        std::size_t len = std::min<std::size_t>(rand_below(4) + 1, n - pos);
+
+        switch (rand_below(6))
+        {
+            case 0:
+            {
+                int32_t v = int32_t(rand_below(3));
+                ref.set(pos, v);
+                db.set(pos, v);
+                break;
+            }
+            case 1:
+            {
+                std::string v(1, char('a' + rand_below(3)));
+                ref.set(pos, v);
+                db.set(pos, v);
+                break;
+            }
+            case 2:
+            {
+                std::vector<double> values(len, double(rand_below(3)));
+                ref.set(pos, values.begin(), values.end());
+                db.set(pos, values.begin(), values.end());
+                break;
+            }
+            case 3:
+                ref.set_empty(pos, pos + len - 1);
+                db.set_empty(pos, pos + len - 1);
+                break;
+            case 4:
+            {
+                std::vector<std::string> values(len, std::string(1, char('a' + rand_below(3))));
+                ref.insert(pos, values.begin(), values.end());
+                db.insert(pos, values.begin(), values.end());
+                break;
+            }
+            case 5:
+                if (n > 50)
+                {
+                    ref.erase(pos, pos + len - 1);
+                    db.erase(pos, pos + len - 1);
+                }
+                break;
+        }
+
+        // Every non-empty block is accounted for by the event handler,
+        // regardless of whether it comes from the pool.
+        std::size_t non_empty_count = 0;
+        for (const auto& blk : db)
+        {
+            if (blk.type != mdds::mtv::element_type_empty)
+                ++non_empty_count;
+        }
+        TEST_ASSERT(db.event_handler().live_count == non_empty_count);
+
+        if (i % 50 == 0)
+            mtv_test_check_same_content(ref, db);
+    }
+
+    mtv_test_check_same_content(ref, db);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,104 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2025 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+struct trait_front_offset_compaction : public mdds::mtv::standard_element_blocks_traits
+{
+    using event_func = mdds::mtv::empty_event_func;
+
+    constexpr static double front_offset_compaction_ratio = 1.0;
+};
+
+/**
+ * Get the number of the values erased from the front of the store of the
+ * double block at the specified position.
+ */
+template<typename mtv_type>
+std::size_t get_double_front_offset(const mtv_type& db, std::size_t pos)
+{
+    auto it = db.position(pos).first;
+    TEST_ASSERT(it->type == mdds::mtv::element_type_double);
+    return mdds::mtv::double_element_block::front_offset(*it->data);
+}
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_front_offset_compaction()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mdds::mtv::element_type_double;
+
+    {
+        // Without automatic compaction, the values popped off the top of a
+        // block stay in its store until it gets compacted explicitly.
+        using mtv_type = mtv_tmpl<trait_lu<lu_factor_t::none>>;
+
+        mtv_type db(20, 1.5);
+        for (std::size_t i = 0; i < 8; ++i)
+            db.set(i, int32_t(i));
+
+        TEST_ASSERT(db.block_size() == 2);
+        TEST_ASSERT(get_double_front_offset(db, 8) == 8);
+        TEST_ASSERT(db.memory_usage().element_blocks.at(element_type_double).front_offset_bytes == 8 * sizeof(double));
+
+        // The range only covers the int32 block.
+        auto stats = db.compact(0, 7);
+        TEST_ASSERT(stats.compacted_blocks == 0);
+        TEST_ASSERT(stats.reclaimed_bytes == 0);
+        TEST_ASSERT(get_double_front_offset(db, 8) == 8);
+
+        stats = db.compact(5, 10);
+        TEST_ASSERT(stats.compacted_blocks == 1);
+        TEST_ASSERT(stats.reclaimed_bytes == 8 * sizeof(double));
+        TEST_ASSERT(get_double_front_offset(db, 8) == 0);
+        TEST_ASSERT(db.memory_usage().element_blocks.at(element_type_double).front_offset_bytes == 0);
+
+        for (std::size_t i = 8; i < 10; ++i)
+            db.set(i, int32_t(i));
+
+        stats = db.compact();
+        TEST_ASSERT(stats.compacted_blocks == 1);
+        TEST_ASSERT(stats.reclaimed_bytes == 2 * sizeof(double));
+
+        // Compaction doesn't change the content.
+        for (std::size_t i = 0; i < 10; ++i)
+            TEST_ASSERT(db.template get<int32_t>(i) == int32_t(i));
+        for (std::size_t i = 10; i < 20; ++i)
+            TEST_ASSERT(db.template get<double>(i) == 1.5);
+
+        try
+        {
+            db.compact(5, 20);
+            TEST_ASSERT(!"exception should have been thrown");
+        }
+        catch (const std::out_of_range&)
+        {
+            // expected
+        }
+    }
+
+    {
+        // With automatic compaction, the number of the erased values never
+        // exceeds the number of the remaining values.
+        using mtv_type = mtv_tmpl<trait_front_offset_compaction>;
+
+        mtv_type db(40, 1.5);
+        for (std::size_t i = 0; i < 30; ++i)
+        {
+            db.set(i, int32_t(i));
+            std::size_t remaining = 40 - i - 1;
+            TEST_ASSERT(get_double_front_offset(db, i + 1) <= remaining);
+        }
+
+        for (std::size_t i = 0; i < 30; ++i)
+            TEST_ASSERT(db.template get<int32_t>(i) == int32_t(i));
+        for (std::size_t i = 30; i < 40; ++i)
+            TEST_ASSERT(db.template get<double>(i) == 1.5);
+    }
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,318 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2025 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// SoA-only extension: the deferred position shift policy only applies to the
+// soa variant.
+
+#include <random>
+
+using mdds::mtv::position_shift_t;
+
+struct trait_deferred_shift : public mdds::mtv::standard_element_blocks_traits
+{
+    using event_func = mdds::mtv::empty_event_func;
+
+    constexpr static position_shift_t position_shift = position_shift_t::deferred;
+};
+
+template<typename mtv_type1, typename mtv_type2>
+void mtv_test_check_same_content(const mtv_type1& db1, const mtv_type2& db2)
+{
+    TEST_ASSERT(db1.size() == db2.size());
+    TEST_ASSERT(db1.block_size() == db2.block_size());
+
+    auto it1 = db1.cbegin();
+    auto it2 = db2.cbegin();
+    std::size_t pos = 0;
+
+    for (; it1 != db1.cend(); ++it1, ++it2)
+    {
+        TEST_ASSERT(it2 != db2.cend());
+        TEST_ASSERT(it1->type == it2->type);
+        TEST_ASSERT(it1->size == it2->size);
+        TEST_ASSERT(it1->position == pos);
+        TEST_ASSERT(it2->position == pos);
+        pos += it1->size;
+    }
+
+    TEST_ASSERT(it2 == db2.cend());
+
+    // Walk backward to check the positions reported by the reverse iterators.
+    auto rit = db2.crbegin();
+    for (; rit != db2.crend(); ++rit)
+    {
+        pos -= rit->size;
+        TEST_ASSERT(rit->position == pos);
+    }
+
+    for (std::size_t i = 0; i < db1.size(); ++i)
+    {
+        auto type = db1.get_type(i);
+        TEST_ASSERT(type == db2.get_type(i));
+
+        switch (type)
+        {
+            case mdds::mtv::element_type_int32:
+                TEST_ASSERT(db1.template get<int32_t>(i) == db2.template get<int32_t>(i));
+                break;
+            case mdds::mtv::element_type_double:
+                TEST_ASSERT(db1.template get<double>(i) == db2.template get<double>(i));
+                break;
+            case mdds::mtv::element_type_string:
+                TEST_ASSERT(db1.template get<std::string>(i) == db2.template get<std::string>(i));
+                break;
+            default:;
+        }
+
+        auto pos1 = db1.position(i);
+        auto pos2 = db2.position(i);
+        TEST_ASSERT(pos1.second == pos2.second);
+        TEST_ASSERT(pos1.first->position == pos2.first->position);
+    }
+}
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_deferred_position_shift()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using ref_type = mtv_tmpl<trait_lu<lu_factor_t::none>>;
+    using mtv_type = mtv_tmpl<trait_deferred_shift>;
+
+    std::mt19937 gen(42);
+    auto rand_below = [&gen](std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(gen); };
+
+    ref_type ref(200);
+    mtv_type db(200);
+
+    // Sibling containers to transfer the elements to and from.
+    ref_type ref_other(50, 1.5);
+    mtv_type db_other(50, 1.5);
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        if (ref.empty())
+        {
+            ref.push_back_empty();
+            db.push_back_empty();
+        }
+
+        std::size_t n = ref.size();
+        std::size_t pos = rand_below(n);
+        std::size_t len = std::min<std::size_t>(rand_below(5) + 1, n - pos);
+
+        switch (rand_below(11))
+        {
+            case 0:
+            {
+                int32_t v = int32_t(rand_below(3));
+                ref.set(pos, v);
+                db.set(pos, v);
+                break;
+            }
+            case 1:
+            {
+                std::vector<double> values(len, double(rand_below(3)));
+                ref.set(pos, values.begin(), values.end());
+                db.set(pos, values.begin(), values.end());
+                break;
+            }
+            case 2:
+            {
+                std::vector<int32_t> values(len, int32_t(rand_below(3)));
+                ref.insert(pos, values.begin(), values.end());
+                db.insert(pos, values.begin(), values.end());
+                break;
+            }
+            case 3:
+                ref.insert_empty(pos, len);
+                db.insert_empty(pos, len);
+                break;
+            case 4:
+                ref.set_empty(pos, pos + len - 1);
+                db.set_empty(pos, pos + len - 1);
+                break;
+            case 5:
+                if (n > 20)
+                {
+                    ref.erase(pos, pos + len - 1);
+                    db.erase(pos, pos + len - 1);
+                }
+                break;
+            case 6:
+            {
+                double v = double(rand_below(3));
+                ref.push_back(v);
+                db.push_back(v);
+                break;
+            }
+            case 7:
+            {
+                // Use a position hint.
+                auto it = db.position(pos).first;
+                ref.set(pos, 7.0);
+                db.set(it, pos, 7.0);
+                break;
+            }
+            case 8:
+            {
+                std::size_t dest_pos = rand_below(ref_other.size() - len + 1);
+                ref.swap(pos, pos + len - 1, ref_other, dest_pos);
+                db.swap(pos, pos + len - 1, db_other, dest_pos);
+                break;
+            }
+            case 9:
+            {
+                std::size_t dest_pos = rand_below(ref_other.size() - len + 1);
+                ref.transfer(pos, pos + len - 1, ref_other, dest_pos);
+                db.transfer(pos, pos + len - 1, db_other, dest_pos);
+                break;
+            }
+            case 10:
+                if (rand_below(10) == 0)
+                {
+                    ref.resize(n + len);
+                    db.resize(n + len);
+                }
+                break;
+        }
+
+        if (i % 50 == 0)
+        {
+            mtv_test_check_same_content(ref, db);
+            mtv_test_check_same_content(ref_other, db_other);
+        }
+    }
+
+    mtv_test_check_same_content(ref, db);
+    mtv_test_check_same_content(ref_other, db_other);
+
+    // Copies must carry the pending shifts over.
+    mtv_type db_copy(db);
+    TEST_ASSERT(db_copy == db);
+    mtv_test_check_same_content(ref, db_copy);
+}
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_edit_session()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using ref_type = mtv_tmpl<trait_lu<lu_factor_t::none>>;
+    using mtv_type = mtv_tmpl<trait_lu<lu_factor_t::lu4>>;
+
+    {
+        // Basic session life cycle.
+        mtv_type db(10);
+        auto session = db.begin_edit_session();
+        TEST_ASSERT(session.active());
+        db.insert_empty(0, 5);
+        db.set(0, 1.0);
+        TEST_ASSERT(db.size() == 15);
+        TEST_ASSERT(db.template get<double>(0) == 1.0);
+        session.commit();
+        TEST_ASSERT(!session.active());
+        session.commit(); // no effect
+        TEST_ASSERT(db.size() == 15);
+    }
+
+    std::mt19937 gen(123);
+    auto rand_below = [&gen](std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(gen); };
+
+    ref_type ref(100);
+    mtv_type db(100);
+
+    auto run_edit = [&]() {
+        if (ref.empty())
+        {
+            ref.push_back_empty();
+            db.push_back_empty();
+        }
+
+        std::size_t n = ref.size();
+        std::size_t pos = rand_below(n);
+        std::size_t len = std::min<std::size_t>(rand_below(5) + 1, n - pos);
+
+        switch (rand_below(5))
+        {
+            case 0:
+            {
+                std::vector<int32_t> values(len, int32_t(rand_below(3)));
+                ref.insert(pos, values.begin(), values.end());
+                db.insert(pos, values.begin(), values.end());
+                break;
+            }
+            case 1:
+                ref.insert_empty(pos, len);
+                db.insert_empty(pos, len);
+                break;
+            case 2:
+                if (n > 20)
+                {
+                    ref.erase(pos, pos + len - 1);
+                    db.erase(pos, pos + len - 1);
+                }
+                break;
+            case 3:
+            {
+                double v = double(rand_below(3));
+                ref.set(pos, v);
+                db.set(pos, v);
+                break;
+            }
+            case 4:
+            {
+                std::string v(1, char('a' + rand_below(3)));
+                ref.set(pos, v);
+                db.set(pos, v);
+                break;
+            }
+        }
+    };
+
+    for (int burst = 0; burst < 40; ++burst)
+    {
+        typename mtv_type::edit_session session(db);
+
+        for (int i = 0; i < 50; ++i)
+        {
+            run_edit();
+
+            if (i % 10 == 0)
+                // Lookups must stay correct while the shifts are pending.
+                mtv_test_check_same_content(ref, db);
+        }
+
+        if (burst % 4 == 0)
+        {
+            // Nested session.  Committing it must leave the outer session
+            // intact.
+            auto inner = db.begin_edit_session();
+            for (int i = 0; i < 20; ++i)
+                run_edit();
+            inner.commit();
+            mtv_test_check_same_content(ref, db);
+        }
+
+        if (burst % 5 == 0)
+        {
+            // A copy made during a session carries the pending shifts, and
+            // must remain editable after the session ends.
+            mtv_type db_copy(db);
+            session.commit();
+            mtv_test_check_same_content(ref, db_copy);
+            db_copy.insert_empty(0, 3);
+            db_copy.erase(0, 2);
+            mtv_test_check_same_content(ref, db_copy);
+        }
+    }
+
+    mtv_test_check_same_content(ref, db);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "loop_unrolling.hpp"
+#include "compaction.hpp"
 
 template<template<typename> class mtv_tmpl>
 void run_all_tests()
@@ -35,6 +36,8 @@ void run_all_tests()
         using mtv_type = mtv_tmpl<trait_lu<lu_factor_t::lu32>>;
         mtv_test_loop_unrolling<mtv_type>();
     }
+
+    mtv_test_front_offset_compaction<mtv_tmpl>();
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -6,13 +6,52 @@
 
 #pragma once
 
-// SoA-only extension: the SSE2/AVX2 loop-unrolling factors are exercised only
-// against the soa variant (the aos driver does not run these). This is a
-// deliberate, documented exclusion - not a parity gap - and is gated on the
-// build architecture exactly as before.
+// SoA-only extension: the SSE2/AVX2/AVX-512 loop-unrolling factors are
+// exercised only against the soa variant (the aos driver does not run these).
+// This is a deliberate, documented exclusion - not a parity gap - and is gated
+// on the build architecture exactly as before.
 
 #include "loop_unrolling.hpp"
 
+#include <mdds/multi_type_vector/soa/block_util.hpp>
+
+inline void mtv_test_adjust_positions_kernels()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mdds::mtv::soa::detail::adjust_positions_kernel_t;
+    using mdds::mtv::soa::detail::detect_adjust_positions_kernel;
+    using mdds::mtv::soa::detail::get_adjust_positions_kernel;
+
+    // Run every kernel supported by this CPU against varying lengths to cover
+    // both the vectorized sections and the trailing scalar remainders.
+    auto selected = detect_adjust_positions_kernel();
+
+    for (int k = 0; k <= int(selected); ++k)
+    {
+        auto kernel = get_adjust_positions_kernel(adjust_positions_kernel_t(k));
+
+        for (std::size_t n = 0; n < 100; ++n)
+        {
+            for (int64_t delta : {int64_t(3), int64_t(-2)})
+            {
+                std::vector<std::size_t> values(n + 2);
+                for (std::size_t i = 0; i < values.size(); ++i)
+                    values[i] = i * 2 + 10;
+
+                kernel(values.data() + 1, n, delta);
+
+                // The values outside the range must not be touched.
+                TEST_ASSERT(values.front() == 10);
+                TEST_ASSERT(values.back() == (n + 1) * 2 + 10);
+
+                for (std::size_t i = 1; i <= n; ++i)
+                    TEST_ASSERT(values[i] == i * 2 + 10 + delta);
+            }
+        }
+    }
+}
+
 template<template<typename> class mtv_tmpl>
 void run_simd_tests()
 {
@@ -44,6 +83,25 @@ void run_simd_tests()
     cout << "  * __AVX2__ not defined" << endl;
 #endif
 #endif
+
+#if SIZEOF_VOID_P == 8 && defined(__AVX512F__)
+    mtv_test_loop_unrolling<mtv_tmpl<trait_lu<lu_factor_t::avx512_x64>>>();
+    mtv_test_loop_unrolling<mtv_tmpl<trait_lu<lu_factor_t::avx512_x64_lu4>>>();
+    mtv_test_loop_unrolling<mtv_tmpl<trait_lu<lu_factor_t::avx512_x64_lu8>>>();
+#else
+    cout << "AVX-512 loop-unrolling tests disabled for the following reasons:" << endl;
+#if SIZEOF_VOID_P != 8
+    cout << "  * not a 64-bit build" << endl;
+#endif
+#ifndef __AVX512F__
+    cout << "  * __AVX512F__ not defined" << endl;
+#endif
+#endif
+
+#if SIZEOF_VOID_P == 8
+    mtv_test_adjust_positions_kernels();
+#endif
+    mtv_test_loop_unrolling<mtv_tmpl<trait_lu<lu_factor_t::runtime_dispatch>>>();
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -11,6 +11,8 @@
 
 #include "run.hpp"
 #include "simd.hpp"
+#include "position_shift.hpp"
+#include "block_pool.hpp"
 
 template<typename Traits>
 using mtv_tmpl = mdds::mtv::soa::multi_type_vector<Traits>;
@@ -21,6 +23,11 @@ int main()
     {
         run_all_tests<mtv_tmpl>();
         run_simd_tests<mtv_tmpl>(); // SoA-only SIMD loop-unrolling extension
+        mtv_test_deferred_position_shift<mtv_tmpl>(); // SoA-only deferred position shift
+        mtv_test_edit_session<mtv_tmpl>();
+        mtv_test_loop_unrolling<mtv_tmpl<trait_deferred_shift>>();
+        mtv_test_block_pool_reuse<mtv_tmpl>(); // SoA-only element block pooling
+        mtv_test_block_pool_random<mtv_tmpl>();
     }
     catch (const std::exception& e)
     {
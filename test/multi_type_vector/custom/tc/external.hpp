@@ -0,0 +1,134 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// SoA-only extension: appending blocks that reference external memory only
+// applies to the soa variant.
+
+#include <mdds/multi_type_vector/collection.hpp>
+#include <mdds/multi_type_vector/external_vector.hpp>
+
+#include <iterator>
+#include <span>
+#include <vector>
+
+constexpr mdds::mtv::element_t element_type_ext_double_block = mdds::mtv::element_type_user_start + 10;
+constexpr mdds::mtv::element_t element_type_ext_int32_block = mdds::mtv::element_type_user_start + 11;
+
+using ext_double_block =
+    mdds::mtv::default_element_block<element_type_ext_double_block, double, mdds::mtv::external_vector>;
+using ext_int32_block =
+    mdds::mtv::default_element_block<element_type_ext_int32_block, std::int32_t, mdds::mtv::external_vector>;
+
+struct external_traits : public mdds::mtv::default_traits
+{
+    using block_funcs = mdds::mtv::element_block_funcs<
+        mdds::mtv::double_element_block, mdds::mtv::string_element_block, ext_double_block, ext_int32_block>;
+};
+
+template<typename Blk>
+bool references(const mdds::mtv::base_element_block& blk, const typename Blk::value_type* values)
+{
+    return Blk::get(blk).store().is_external() && Blk::cbegin(blk) == values;
+}
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_append_external()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mtv_tmpl<external_traits>;
+
+    const double doubles[] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    const std::int32_t ints[] = {10, 20, 30, 40};
+
+    mtv_type db;
+    TEST_ASSERT(db.template append_external<ext_double_block>(std::span<const double>{}) == db.end());
+    TEST_ASSERT(db.empty());
+
+    auto it = db.template append_external<ext_double_block>(doubles);
+    TEST_ASSERT(it->type == element_type_ext_double_block);
+    TEST_ASSERT(it->size == 6);
+    db.push_back(std::string("sep"));
+    it = db.template append_external<ext_int32_block>(ints);
+    TEST_ASSERT(it->position == 7);
+    TEST_ASSERT(db.size() == 11);
+    TEST_ASSERT(db.block_size() == 3);
+
+    // The blocks reference the external arrays.
+    TEST_ASSERT(references<ext_double_block>(*db.begin()->data, doubles));
+    TEST_ASSERT(references<ext_int32_block>(*db.rbegin()->data, ints));
+
+    // Read the values through positions and iterators.
+    TEST_ASSERT(mtv_type::template get<ext_double_block>(db.position(2)) == 3.0);
+    TEST_ASSERT(mtv_type::template get<ext_int32_block>(db.position(10)) == 40);
+    TEST_ASSERT(db.get_type(8) == element_type_ext_int32_block);
+    TEST_ASSERT(db.template get<std::string>(6) == "sep");
+
+    double sum = 0.0;
+    for (const auto& blk : db)
+    {
+        if (blk.type != element_type_ext_double_block)
+            continue;
+
+        for (auto it_val = ext_double_block::cbegin(*blk.data); it_val != ext_double_block::cend(*blk.data); ++it_val)
+            sum += *it_val;
+    }
+    TEST_ASSERT(sum == 21.0);
+
+    // Copies and snapshots keep referencing the external arrays.
+    mtv_type db2 = db;
+    TEST_ASSERT(db2 == db);
+    TEST_ASSERT(references<ext_double_block>(*db2.begin()->data, doubles));
+
+    auto view = db.snapshot();
+    TEST_ASSERT(references<ext_int32_block>(*view.rbegin()->data, ints));
+
+    // Iterate through them via a collection.
+    std::vector<const mtv_type*> vectors = {&db, &db2};
+    mdds::mtv::collection<mtv_type> cols(vectors.begin(), vectors.end());
+    auto it_col = cols.begin();
+    TEST_ASSERT(it_col->type == element_type_ext_double_block);
+    TEST_ASSERT(it_col->template get<ext_double_block>() == 1.0);
+    ++it_col;
+    TEST_ASSERT(it_col->index == 1);
+    TEST_ASSERT(it_col->template get<ext_double_block>() == 1.0);
+
+    // Overwrite a value in the middle of the double block.  The smaller upper
+    // part gets copied while the lower part keeps referencing the external
+    // array.
+    db.set(1, 2.5);
+    TEST_ASSERT(db.block_size() == 5);
+    TEST_ASSERT(!ext_double_block::get(*db.begin()->data).store().is_external());
+    TEST_ASSERT(db.begin()->size == 1);
+    TEST_ASSERT(references<ext_double_block>(*std::next(db.begin(), 2)->data, doubles + 2));
+    TEST_ASSERT(mtv_type::template get<ext_double_block>(db.position(0)) == 1.0);
+    TEST_ASSERT(db.template get<double>(1) == 2.5);
+    TEST_ASSERT(mtv_type::template get<ext_double_block>(db.position(2)) == 3.0);
+    TEST_ASSERT(mtv_type::template get<ext_double_block>(db.position(5)) == 6.0);
+    TEST_ASSERT(doubles[1] == 2.0);
+
+    // The copy and the snapshot are unaffected.
+    TEST_ASSERT(mtv_type::template get<ext_double_block>(db2.position(1)) == 2.0);
+    TEST_ASSERT(view.block_size() == 3);
+    TEST_ASSERT(references<ext_double_block>(*db2.begin()->data, doubles));
+
+    // Appending to a block of the same type copies the values.
+    it = db.template append_external<ext_int32_block>(ints);
+    TEST_ASSERT(db.block_size() == 5);
+    TEST_ASSERT(db.size() == 15);
+    TEST_ASSERT(it->size == 8);
+    TEST_ASSERT(!ext_int32_block::get(*it->data).store().is_external());
+    TEST_ASSERT(mtv_type::template get<ext_int32_block>(db.position(14)) == 40);
+    TEST_ASSERT(ints[3] == 40);
+
+    db.clear();
+    TEST_ASSERT(db.empty());
+    TEST_ASSERT(mtv_type::template get<ext_int32_block>(db2.position(9)) == 30);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
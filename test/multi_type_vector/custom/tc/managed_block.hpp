@@ -133,6 +133,37 @@ void mtv_test_managed_block()
         db.clear();
     }
 
+    {
+        // Shrink a managed block that doesn't start at the top.  Only the
+        // cells past the new end should get deleted.
+        mtv_type db(5);
+        db.set(0, 1.1);
+        db.set(1, 1.2);
+        db.set(2, new muser_cell(1.0));
+        db.set(3, new muser_cell(2.0));
+        db.set(4, new muser_cell(3.0));
+        db.resize(4);
+        TEST_ASSERT(db.block_size() == 2);
+        TEST_ASSERT(db.template get<muser_cell*>(2)->value == 1.0);
+        TEST_ASSERT(db.template get<muser_cell*>(3)->value == 2.0);
+    }
+
+    {
+        // Overwrite the upper part of a managed block with values of the same
+        // type as the first block.  The overwritten cell should get deleted.
+        mtv_type db(6);
+        db.set(0, 1.1);
+        db.set(1, 1.2);
+        db.set(2, 1.3);
+        db.set(4, new muser_cell(1.0));
+        db.set(5, new muser_cell(2.0));
+        std::vector<double> values = {2.1, 2.2, 2.3};
+        db.set(2, values.begin(), values.end());
+        TEST_ASSERT(db.block_size() == 2);
+        TEST_ASSERT(db.template get<double>(4) == 2.3);
+        TEST_ASSERT(db.template get<muser_cell*>(5)->value == 2.0);
+    }
+
     {
         // Overwrite with a cell of different type.
         mtv_type db(3);
@@ -639,4 +670,55 @@ void mtv_test_managed_block()
     }
 }
 
+/**
+ * This test is to be run with valgrind, to ensure that applying a
+ * permutation moves the managed cells without leaking or double-deleting
+ * them.
+ */
+template<typename mtv_type>
+void mtv_test_managed_block_permutation()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    // Blocks: [0-1] muser_cell, [2] double, [3-4] muser_cell, [5] empty
+    mtv_type db(6);
+    std::vector<muser_cell*> cells = {
+        new muser_cell(1.0), new muser_cell(2.0), new muser_cell(3.0), new muser_cell(4.0)};
+    db.set(0, cells[0]);
+    db.set(1, cells[1]);
+    db.set(2, 1.5);
+    db.set(3, cells[2]);
+    db.set(4, cells[3]);
+    TEST_ASSERT(db.block_size() == 4);
+
+    std::vector<typename mtv_type::size_type> perm = {3, 0, 4, 1, 5, 2};
+    db.apply_permutation(perm);
+
+    // The managed cells get moved, not copied, and the cells that end up
+    // adjacent to each other share the same block.
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(db.template get<muser_cell*>(0) == cells[2]);
+    TEST_ASSERT(db.template get<muser_cell*>(1) == cells[0]);
+    TEST_ASSERT(db.template get<muser_cell*>(2) == cells[3]);
+    TEST_ASSERT(db.template get<muser_cell*>(3) == cells[1]);
+    TEST_ASSERT(db.is_empty(4));
+    TEST_ASSERT(db.template get<double>(5) == 1.5);
+
+    // An invalid permutation leaves the cells with the container.
+    perm[1] = 3;
+
+    try
+    {
+        db.apply_permutation(perm);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    TEST_ASSERT(db.template get<muser_cell*>(0) == cells[2]);
+    TEST_ASSERT(db.template get<muser_cell*>(3) == cells[1]);
+}
+
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -9,6 +9,7 @@
 #include "common_types.hpp"
 
 #include <cstdint>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -193,4 +194,37 @@ void mtv_test_misc_construction_with_array()
     }
 }
 
+template<typename mtv_fruit_type>
+void mtv_test_misc_save_state_user_block()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    mtv_fruit_type db(3);
+    db.set(0, 1.5);
+    db.set(1, apple);
+
+    // User-defined element blocks are not supported.
+    std::ostringstream os;
+    try
+    {
+        db.save_state(os);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::mtv::element_block_error&)
+    {
+        // expected
+    }
+
+    // Standard element blocks in a container with custom block functions
+    // are.
+    db.set_empty(1, 1);
+    os.str(std::string());
+    db.save_state(os);
+
+    mtv_fruit_type db2(2, orange);
+    std::istringstream is(os.str());
+    db2.load_state(is);
+    TEST_ASSERT(db2 == db);
+}
+
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
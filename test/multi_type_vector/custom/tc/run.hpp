@@ -27,9 +27,11 @@ void run_all_tests()
     mtv_test_misc_custom_block_func3<mtv3_type>();
     mtv_test_misc_release<mtv_type>();
     mtv_test_misc_construction_with_array<mtv_type>();
+    mtv_test_misc_save_state_user_block<mtv_fruit_type>();
     mtv_test_basic<mtv_type>();
     mtv_test_basic_equality<mtv_type>();
     mtv_test_managed_block<mtv_type>();
+    mtv_test_managed_block_permutation<mtv_type>();
     mtv_test_transfer<mtv_type>();
     mtv_test_swap<mtv3_type>();
     mtv_test_swap_2<mtv3_type>();
@@ -0,0 +1,196 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// SoA-only: set_batch() of the soa variant leaves the container unchanged
+// when it throws while rebuilding the blocks, while the aos variant only sets
+// the values one by one.
+
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Value whose copy throws once the countdown set by the test reaches zero,
+ * to make set_batch() fail at an arbitrary point.
+ */
+struct throwing_cell
+{
+    inline static int copy_countdown = 0; // disabled when 0.
+
+    int value = 0;
+
+    throwing_cell() = default;
+
+    throwing_cell(int _value) : value(_value)
+    {}
+
+    throwing_cell(const throwing_cell& r) : value(r.value)
+    {
+        if (copy_countdown > 0 && --copy_countdown == 0)
+            throw std::runtime_error("copy failed");
+    }
+
+    throwing_cell& operator=(const throwing_cell& r) = default;
+
+    bool operator==(const throwing_cell& r) const
+    {
+        return value == r.value;
+    }
+};
+
+constexpr mdds::mtv::element_t element_type_throwing_block = mdds::mtv::element_type_user_start + 12;
+
+using throwing_cell_block = mdds::mtv::default_element_block<element_type_throwing_block, throwing_cell>;
+
+MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(throwing_cell, element_type_throwing_block, throwing_cell(), throwing_cell_block)
+
+struct throwing_traits : public mdds::mtv::default_traits
+{
+    using block_funcs =
+        mdds::mtv::element_block_funcs<mdds::mtv::double_element_block, muser_cell_block, throwing_cell_block>;
+};
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_set_batch_exception()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mtv_tmpl<throwing_traits>;
+    using size_type = typename mtv_type::size_type;
+
+    // Blocks of 5 elements each, cycling through throwing cells, doubles,
+    // managed cells and empty elements.
+    auto build = []() {
+        mtv_type db(60);
+        for (size_type i = 0; i < db.size(); ++i)
+        {
+            switch (i / 5 % 4)
+            {
+                case 0:
+                    db.set(i, throwing_cell(int(i)));
+                    break;
+                case 1:
+                    db.set(i, double(i));
+                    break;
+                case 2:
+                    db.set(i, new muser_cell(double(i)));
+                    break;
+                default:;
+            }
+        }
+
+        return db;
+    };
+
+    // Managed blocks compare their pointers, so compare their values instead.
+    auto check_equal = [](const mtv_type& db1, const mtv_type& db2) {
+        TEST_ASSERT(db1.size() == db2.size());
+        TEST_ASSERT(db1.block_size() == db2.block_size());
+
+        for (size_type i = 0; i < db1.size(); ++i)
+        {
+            TEST_ASSERT(db1.get_type(i) == db2.get_type(i));
+
+            switch (db1.get_type(i))
+            {
+                case element_type_throwing_block:
+                    TEST_ASSERT(db1.template get<throwing_cell>(i) == db2.template get<throwing_cell>(i));
+                    break;
+                case mdds::mtv::element_type_double:
+                    TEST_ASSERT(db1.template get<double>(i) == db2.template get<double>(i));
+                    break;
+                case element_type_muser_block:
+                    TEST_ASSERT(db1.template get<muser_cell*>(i)->value == db2.template get<muser_cell*>(i)->value);
+                    break;
+                default:;
+            }
+        }
+    };
+
+    // Values spanning all types of blocks, including some blocks not
+    // receiving any values.  The value at 19 merges the new block with the
+    // block that follows, and the value at 45 with the block that precedes
+    // it.  The values at 1 and 2 get overwritten in place, which involves no
+    // copy construction.
+    std::vector<std::pair<size_type, throwing_cell>> values = {
+        {1, 101},  {2, 102},  {6, 106},  {9, 109},  {12, 112}, {17, 117},
+        {19, 119}, {35, 135}, {37, 137}, {45, 145}, {52, 152}};
+
+    mtv_type expected = build();
+    for (const auto& [pos, v] : values)
+        expected.set(pos, v);
+
+    TEST_ASSERT(expected.block_size() > 8);
+
+    // Make each copy fail in turn until set_batch() runs to completion.
+    bool succeeded = false;
+
+    for (int countdown = 1; !succeeded; ++countdown)
+    {
+        mtv_type db = build();
+        const mtv_type original = build();
+
+        throwing_cell::copy_countdown = countdown;
+
+        try
+        {
+            db.set_batch(std::span{values});
+            succeeded = true;
+        }
+        catch (const std::runtime_error&)
+        {
+            // The container must be left unchanged.
+            throwing_cell::copy_countdown = 0;
+            check_equal(db, original);
+
+            // It must still be usable.
+            db.set_batch(std::span{values});
+        }
+
+        throwing_cell::copy_countdown = 0;
+        check_equal(db, expected);
+    }
+}
+
+template<template<typename> class mtv_tmpl>
+void mtv_test_set_batch_managed()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mtv_tmpl<throwing_traits>;
+    using size_type = typename mtv_type::size_type;
+
+    // Blocks: [0-9] managed, [10-14] double, [15-19] managed
+    mtv_type db(20);
+    for (size_type i = 0; i < db.size(); ++i)
+    {
+        if (i / 5 == 2)
+            db.set(i, double(i));
+        else
+            db.set(i, new muser_cell(double(i)));
+    }
+
+    // The values landing in the managed block of the same type replace the
+    // values in place, which get deleted.  The value at 14 gets merged with
+    // the managed block that follows it.
+    const mdds::mtv::base_element_block* data = db.begin()->data;
+    std::vector<std::pair<size_type, muser_cell*>> values = {
+        {3, new muser_cell(103.0)}, {7, new muser_cell(107.0)}, {14, new muser_cell(114.0)}};
+    db.set_batch(std::span{values});
+
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(db.begin()->data == data);
+    TEST_ASSERT(db.template get<muser_cell*>(3)->value == 103.0);
+    TEST_ASSERT(db.template get<muser_cell*>(7)->value == 107.0);
+    TEST_ASSERT(db.template get<double>(13) == 13.0);
+    TEST_ASSERT(db.template get<muser_cell*>(14)->value == 114.0);
+    TEST_ASSERT(db.template get<muser_cell*>(19)->value == 19.0);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -10,6 +10,8 @@
 #include <mdds/multi_type_vector/soa/main.hpp>
 
 #include "run.hpp"
+#include "external.hpp"
+#include "set_batch.hpp"
 
 template<typename Traits>
 using mtv_tmpl = mdds::mtv::soa::multi_type_vector<Traits>;
@@ -19,6 +21,9 @@ int main()
     try
     {
         run_all_tests<mtv_tmpl>();
+        mtv_test_append_external<mtv_tmpl>(); // SoA-only blocks referencing external memory
+        mtv_test_set_batch_exception<mtv_tmpl>();
+        mtv_test_set_batch_managed<mtv_tmpl>();
     }
     catch (const std::exception& e)
     {
@@ -0,0 +1,187 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.hpp"
+
+#include <numeric>
+
+template<typename mtv_type>
+void mtv_test_find()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mdds::mtv::boolean_element_block;
+    using mdds::mtv::double_element_block;
+    using mdds::mtv::int32_element_block;
+    using mdds::mtv::int8_element_block;
+    using mdds::mtv::string_element_block;
+
+    // Blocks: [0-9] empty, [10-109] double, [110-114] int32, [115-119] empty,
+    // [120-126] double, [127-129] string, [130-139] int8, [140-149] bool
+    mtv_type db(150);
+    std::vector<double> values1(100);
+    std::iota(values1.begin(), values1.end(), 1.0); // 1.0 - 100.0
+    db.set(10, values1.begin(), values1.end());
+
+    std::vector<int32_t> ints = {-5, 7, 3, 12, 7};
+    db.set(110, ints.begin(), ints.end());
+
+    std::vector<double> values2 = {-3.5, 0.5, 1000.0, 2.0, 2.0, 2.0, 2.0};
+    db.set(120, values2.begin(), values2.end());
+
+    db.set(127, std::string("A"));
+    db.set(128, std::string("B"));
+    db.set(129, std::string("A"));
+
+    std::vector<int8_t> bytes = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    db.set(130, bytes.begin(), bytes.end());
+
+    std::vector<bool> flags = {false, false, false, true, false, true, false, false, false, false};
+    db.set(140, flags.begin(), flags.end());
+
+    auto pos_of = [](const typename mtv_type::const_position_type& pos) {
+        return mtv_type::logical_position(pos);
+    };
+
+    {
+        // Whole range.
+        const mtv_type& cdb = db;
+        auto pos = cdb.template find_first<double_element_block>(0, 149, 2.0);
+        TEST_ASSERT(pos_of(pos) == 11);
+        TEST_ASSERT(pos.first->type == mdds::mtv::element_type_double);
+        TEST_ASSERT(pos.first->position == 10);
+        TEST_ASSERT(pos.second == 1);
+
+        TEST_ASSERT(pos_of(cdb.template find_first<double_element_block>(0, 149, 1000.0)) == 122);
+        TEST_ASSERT(pos_of(cdb.template find_first<int32_element_block>(0, 149, 7)) == 111);
+        TEST_ASSERT(pos_of(cdb.template find_first<int8_element_block>(0, 149, 6)) == 136);
+        TEST_ASSERT(pos_of(cdb.template find_first<string_element_block>(0, 149, "B")) == 128);
+        TEST_ASSERT(pos_of(cdb.template find_first<boolean_element_block>(0, 149, true)) == 143);
+        TEST_ASSERT(pos_of(cdb.template find_first<boolean_element_block>(0, 149, false)) == 140);
+    }
+
+    {
+        // Partial ranges, starting and ending in the middle of blocks.
+        TEST_ASSERT(pos_of(db.template find_first<double_element_block>(15, 129, 2.0)) == 123);
+        TEST_ASSERT(pos_of(db.template find_first<int32_element_block>(112, 149, 7)) == 114);
+        TEST_ASSERT(pos_of(db.template find_first<string_element_block>(128, 149, "A")) == 129);
+        TEST_ASSERT(pos_of(db.template find_first<boolean_element_block>(144, 149, true)) == 145);
+        TEST_ASSERT(db.template find_first<int8_element_block>(131, 139, 0).first == db.cend());
+    }
+
+    {
+        // Values not found return the end position.
+        auto pos = db.template find_first<double_element_block>(0, 149, 101.0);
+        TEST_ASSERT(pos.first == db.cend());
+        TEST_ASSERT(pos.second == 0);
+
+        TEST_ASSERT(db.template find_first<double_element_block>(20, 29, 3.0).first == db.cend());
+        TEST_ASSERT(db.template find_first<int32_element_block>(0, 109, -5).first == db.cend());
+        TEST_ASSERT(db.template find_first<boolean_element_block>(146, 149, true).first == db.cend());
+    }
+
+    {
+        // Find with predicates.
+        auto pos = db.template find_if<double_element_block>(0, 149, [](double v) { return v < 0.0; });
+        TEST_ASSERT(pos_of(pos) == 120);
+
+        pos = db.template find_if<int32_element_block>(0, 149, [](int32_t v) { return v > 10; });
+        TEST_ASSERT(pos_of(pos) == 113);
+
+        pos = db.template find_if<string_element_block>(0, 149, [](const std::string& v) { return v != "A"; });
+        TEST_ASSERT(pos_of(pos) == 128);
+
+        pos = db.template find_if<boolean_element_block>(141, 149, [](bool v) { return v; });
+        TEST_ASSERT(pos_of(pos) == 143);
+
+        pos = db.template find_if<boolean_element_block>(141, 149, [](bool) { return true; });
+        TEST_ASSERT(pos_of(pos) == 141);
+
+        pos = db.template find_if<boolean_element_block>(0, 149, [](bool) { return false; });
+        TEST_ASSERT(pos.first == db.cend());
+
+        // The same predicate instance gets applied to the values in order.
+        std::vector<double> visited;
+        pos = db.template find_if<double_element_block>(105, 121, [&visited](double v) {
+            visited.push_back(v);
+            return v < 0.0;
+        });
+        TEST_ASSERT(pos_of(pos) == 120);
+        TEST_ASSERT(visited == std::vector<double>({96.0, 97.0, 98.0, 99.0, 100.0, -3.5}));
+    }
+
+    {
+        // Count with predicates.
+        TEST_ASSERT(db.template count_if<double_element_block>(0, 149, [](double v) { return v == 2.0; }) == 5);
+        TEST_ASSERT(db.template count_if<double_element_block>(11, 123, [](double v) { return v == 2.0; }) == 2);
+        TEST_ASSERT(db.template count_if<double_element_block>(0, 149, [](double) { return true; }) == 107);
+        TEST_ASSERT(db.template count_if<int32_element_block>(0, 149, [](int32_t v) { return v == 7; }) == 2);
+        TEST_ASSERT(db.template count_if<int8_element_block>(0, 149, [](int8_t v) { return v % 2 == 0; }) == 5);
+        TEST_ASSERT(
+            db.template count_if<string_element_block>(0, 149, [](const std::string& v) { return v == "A"; }) == 2);
+        TEST_ASSERT(db.template count_if<boolean_element_block>(0, 149, [](bool v) { return v; }) == 2);
+        TEST_ASSERT(db.template count_if<boolean_element_block>(0, 149, [](bool v) { return !v; }) == 8);
+        TEST_ASSERT(db.template count_if<boolean_element_block>(144, 149, [](bool) { return true; }) == 6);
+        TEST_ASSERT(db.template count_if<double_element_block>(110, 119, [](double) { return true; }) == 0);
+    }
+
+    {
+        // Search buffers of various lengths, to cover both the vectorized
+        // loops and their tails.
+        for (std::size_t len = 1; len <= 40; ++len)
+        {
+            mtv_type db2(len + 2);
+            std::vector<double> dv(len, 1.0);
+            std::vector<int32_t> iv(len, 1);
+            db2.set(1, dv.begin(), dv.end());
+
+            TEST_ASSERT(db2.template find_first<double_element_block>(0, len + 1, 2.0).first == db2.cend());
+
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                db2.set(1 + i, 2.0);
+                TEST_ASSERT(pos_of(db2.template find_first<double_element_block>(0, len + 1, 2.0)) == 1 + i);
+                TEST_ASSERT(pos_of(db2.template find_first<double_element_block>(1 + i, 1 + i, 2.0)) == 1 + i);
+                db2.set(1 + i, 1.0);
+            }
+
+            db2.set(1, iv.begin(), iv.end());
+            TEST_ASSERT(db2.template find_first<int32_element_block>(0, len + 1, 2).first == db2.cend());
+
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                db2.set(1 + i, int32_t(2));
+                TEST_ASSERT(pos_of(db2.template find_first<int32_element_block>(0, len + 1, 2)) == 1 + i);
+                db2.set(1 + i, int32_t(1));
+            }
+        }
+    }
+
+    // Invalid ranges.
+    try
+    {
+        db.template find_first<double_element_block>(10, 5, 1.0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    try
+    {
+        db.template count_if<double_element_block>(10, 150, [](double) { return true; });
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -442,6 +442,83 @@ void mtv_test_misc_push_back()
     TEST_ASSERT(it->type == mdds::mtv::element_type_double);
 }
 
+template<typename mtv_type>
+void mtv_test_misc_append_range()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    mtv_type db;
+
+    // Appending an empty range should be a no-op.
+    std::vector<double> values;
+    auto it = db.append_range(values.begin(), values.end());
+    TEST_ASSERT(it == db.end());
+    TEST_ASSERT(db.size() == 0);
+    TEST_ASSERT(db.block_size() == 0);
+
+    // Append to an empty container.
+    values = {1.1, 1.2, 1.3};
+    it = db.append_range(values.begin(), values.end());
+    TEST_ASSERT(db.size() == 3);
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(it == db.begin());
+    TEST_ASSERT(it->size == 3);
+    TEST_ASSERT(it->type == mdds::mtv::element_type_double);
+
+    // Values of the same type should get appended to the last block.
+    values = {2.1, 2.2};
+    it = db.append(std::span<const double>(values));
+    TEST_ASSERT(db.size() == 5);
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(it->size == 5);
+    TEST_ASSERT(it->position == 0);
+    TEST_ASSERT(it->__private_data.block_index == 0);
+
+    // Values of a different type should create a new block.
+    std::vector<std::string> strs = {"A", "B"};
+    it = db.append_range(strs.begin(), strs.end());
+    TEST_ASSERT(db.size() == 7);
+    TEST_ASSERT(db.block_size() == 2);
+    TEST_ASSERT(it->size == 2);
+    TEST_ASSERT(it->position == 5);
+    TEST_ASSERT(it->type == mdds::mtv::element_type_string);
+    TEST_ASSERT(it->__private_data.block_index == 1);
+    ++it;
+    TEST_ASSERT(it == db.end());
+
+    // Values appended after an empty block should not go into the empty block.
+    db.push_back_empty();
+    std::vector<int32_t> ints = {5, 6, 7};
+    it = db.append(std::span<int32_t>(ints));
+    TEST_ASSERT(db.size() == 11);
+    TEST_ASSERT(db.block_size() == 4);
+    TEST_ASSERT(it->size == 3);
+    TEST_ASSERT(it->position == 8);
+    TEST_ASSERT(it->type == mdds::mtv::element_type_int32);
+
+    TEST_ASSERT(db.template get<double>(0) == 1.1);
+    TEST_ASSERT(db.template get<double>(2) == 1.3);
+    TEST_ASSERT(db.template get<double>(3) == 2.1);
+    TEST_ASSERT(db.template get<double>(4) == 2.2);
+    TEST_ASSERT(db.template get<std::string>(5) == "A");
+    TEST_ASSERT(db.template get<std::string>(6) == "B");
+    TEST_ASSERT(db.is_empty(7));
+    TEST_ASSERT(db.template get<int32_t>(8) == 5);
+    TEST_ASSERT(db.template get<int32_t>(10) == 7);
+
+    // The result must be identical to the one built with push_back().
+    mtv_type db2;
+    for (double v : {1.1, 1.2, 1.3, 2.1, 2.2})
+        db2.push_back(v);
+    for (const std::string& v : strs)
+        db2.push_back(v);
+    db2.push_back_empty();
+    for (int32_t v : ints)
+        db2.push_back(v);
+
+    TEST_ASSERT(db == db2);
+}
+
 template<typename mtv_type>
 void mtv_test_misc_capacity()
 {
@@ -463,6 +540,63 @@ void mtv_test_misc_capacity()
     TEST_ASSERT(cap == 3);
 }
 
+template<typename mtv_type>
+void mtv_test_misc_memory_usage()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mdds::mtv::double_element_block;
+    using mdds::mtv::element_type_double;
+    using mdds::mtv::element_type_int32;
+
+    mtv_type db(20, 1.1);
+    db.set(15, int32_t(7));
+
+    auto stats = db.memory_usage();
+    TEST_ASSERT(stats.element_blocks.size() == 2);
+
+    const auto& dbl = stats.element_blocks.at(element_type_double);
+    TEST_ASSERT(dbl.block_count == 2);
+    TEST_ASSERT(dbl.object_bytes == 2 * sizeof(double_element_block));
+    TEST_ASSERT(dbl.value_bytes == 19 * sizeof(double));
+
+    const auto& i32 = stats.element_blocks.at(element_type_int32);
+    TEST_ASSERT(i32.block_count == 1);
+    TEST_ASSERT(i32.value_bytes == sizeof(int32_t));
+
+    TEST_ASSERT(stats.block_store_bytes > 0);
+    TEST_ASSERT(stats.pooled_blocks.block_count == 0);
+
+    std::size_t total = stats.block_store_bytes + stats.block_store_slack_bytes + dbl.total() + i32.total();
+    TEST_ASSERT(stats.total() == total);
+
+    // Values removed from the front of a block leave a front offset behind
+    // until the block gets shrunk.
+    db.set_empty(0, 0);
+    auto it = db.begin();
+    ++it;
+    TEST_ASSERT(it->type == element_type_double);
+    std::size_t front_offset = double_element_block::get(*it->data).store().front_offset();
+    std::size_t slack = double_element_block::capacity(*it->data) - front_offset - it->size;
+
+    stats = db.memory_usage();
+    const auto& dbl2 = stats.element_blocks.at(element_type_double);
+    TEST_ASSERT(dbl2.value_bytes == 18 * sizeof(double));
+    TEST_ASSERT(dbl2.front_offset_bytes == front_offset * sizeof(double));
+    TEST_ASSERT(dbl2.slack_bytes >= slack * sizeof(double));
+    TEST_ASSERT(dbl2.front_offset_bytes + dbl2.slack_bytes > 0);
+
+    db.shrink_to_fit();
+    stats = db.memory_usage();
+    TEST_ASSERT(stats.element_blocks.at(element_type_double).front_offset_bytes == 0);
+    TEST_ASSERT(stats.element_blocks.at(element_type_double).slack_bytes == 0);
+
+    // Empty blocks hold no element blocks.
+    db.set_empty(0, db.size() - 1);
+    stats = db.memory_usage();
+    TEST_ASSERT(stats.element_blocks.empty());
+}
+
 template<typename mtv_type>
 void mtv_test_misc_position_type_end_position()
 {
@@ -0,0 +1,246 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <variant>
+
+namespace test_permutation {
+
+using cell_value = std::variant<std::monostate, double, int32_t, std::string, bool>;
+
+template<typename mtv_type>
+cell_value get_cell(const mtv_type& db, std::size_t pos)
+{
+    switch (db.get_type(pos))
+    {
+        case mdds::mtv::element_type_double:
+            return db.template get<double>(pos);
+        case mdds::mtv::element_type_int32:
+            return db.template get<int32_t>(pos);
+        case mdds::mtv::element_type_string:
+            return db.template get<std::string>(pos);
+        case mdds::mtv::element_type_boolean:
+            return db.template get<bool>(pos);
+        default:;
+    }
+
+    return std::monostate{};
+}
+
+template<typename mtv_type>
+std::vector<cell_value> get_cells(const mtv_type& db)
+{
+    std::vector<cell_value> cells;
+    for (std::size_t i = 0; i < db.size(); ++i)
+        cells.push_back(get_cell(db, i));
+
+    return cells;
+}
+
+/**
+ * Check that no two adjacent blocks are of the same type, i.e. that all
+ * runs of the same type have been coalesced.
+ */
+template<typename mtv_type>
+bool is_coalesced(const mtv_type& db)
+{
+    mdds::mtv::element_t prev_type = mdds::mtv::element_type_empty;
+
+    for (auto it = db.begin(); it != db.end(); ++it)
+    {
+        if (it != db.begin() && it->type == prev_type)
+            return false;
+
+        prev_type = it->type;
+    }
+
+    return true;
+}
+
+} // namespace test_permutation
+
+template<typename mtv_type>
+void mtv_test_apply_permutation()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using namespace test_permutation;
+    using perm_type = std::vector<typename mtv_type::size_type>;
+
+    // Blocks: [0-9] empty, [10-19] double, [20-24] int32, [25-29] empty,
+    // [30-34] string, [35-39] bool
+    mtv_type db(40);
+    for (int i = 0; i < 10; ++i)
+        db.set(10 + i, double(i));
+
+    for (int i = 0; i < 5; ++i)
+    {
+        db.set(20 + i, int32_t(i * 10));
+        db.set(30 + i, std::to_string(i));
+        db.set(35 + i, i % 2 == 0);
+    }
+
+    TEST_ASSERT(db.block_size() == 6);
+    const std::vector<cell_value> original = get_cells(db);
+
+    auto check_permuted = [&original](const mtv_type& permuted, const perm_type& perm) {
+        std::vector<cell_value> cells = get_cells(permuted);
+        TEST_ASSERT(cells.size() == perm.size());
+        for (std::size_t i = 0; i < perm.size(); ++i)
+            TEST_ASSERT(cells[i] == original[perm[i]]);
+
+        TEST_ASSERT(is_coalesced(permuted));
+    };
+
+    {
+        // Identity permutation keeps the blocks as they are.
+        mtv_type db2 = db;
+        perm_type perm(40);
+        std::iota(perm.begin(), perm.end(), 0);
+        db2.apply_permutation(perm);
+        TEST_ASSERT(db2 == db);
+        TEST_ASSERT(db2.block_size() == 6);
+    }
+
+    {
+        // Reversal.
+        mtv_type db2 = db;
+        perm_type perm(40);
+        std::iota(perm.rbegin(), perm.rend(), 0);
+        db2.apply_permutation(perm);
+        check_permuted(db2, perm);
+        TEST_ASSERT(db2.block_size() == 6);
+
+        // Reversing it again restores the original.
+        db2.apply_permutation(perm);
+        TEST_ASSERT(db2 == db);
+    }
+
+    {
+        // Sorting by type groups the values of the same type into a single
+        // block each.
+        mtv_type db2 = db;
+        perm_type perm(40);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::stable_sort(perm.begin(), perm.end(), [&db](std::size_t a, std::size_t b) {
+            return db.get_type(a) < db.get_type(b);
+        });
+
+        db2.apply_permutation(perm);
+        check_permuted(db2, perm);
+        TEST_ASSERT(db2.block_size() == 5);
+
+        auto it = db2.begin();
+        TEST_ASSERT(it->type == mdds::mtv::element_type_empty);
+        TEST_ASSERT(it->size == 15);
+    }
+
+    {
+        // Interleave the blocks, which fragments the container as much as
+        // possible.
+        mtv_type db2 = db;
+        perm_type perm(40);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::stable_sort(perm.begin(), perm.end(), [](std::size_t a, std::size_t b) { return a % 5 < b % 5; });
+        db2.apply_permutation(perm);
+        check_permuted(db2, perm);
+    }
+
+    {
+        // Rotation, where the runs of consecutive positions get copied in
+        // bulk.
+        mtv_type db2 = db;
+        perm_type perm(40);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::rotate(perm.begin(), perm.begin() + 17, perm.end());
+        db2.apply_permutation(perm);
+        check_permuted(db2, perm);
+        TEST_ASSERT(db2.block_size() == 7);
+    }
+
+    {
+        // Random permutations.
+        for (unsigned seed = 1; seed <= 20; ++seed)
+        {
+            mtv_type db2 = db;
+            perm_type perm(40);
+            std::iota(perm.begin(), perm.end(), 0);
+
+            // Simple linear congruential shuffle, for the sake of
+            // reproducibility across platforms.
+            unsigned state = seed;
+            for (std::size_t i = perm.size() - 1; i > 0; --i)
+            {
+                state = state * 1103515245u + 12345u;
+                std::swap(perm[i], perm[(state >> 16) % (i + 1)]);
+            }
+
+            db2.apply_permutation(perm);
+            check_permuted(db2, perm);
+            TEST_ASSERT(db2.size() == 40);
+        }
+    }
+
+    {
+        // Empty container.
+        mtv_type db2;
+        db2.apply_permutation(perm_type{});
+        TEST_ASSERT(db2.empty());
+
+        // Single element.
+        db2.push_back(1.5);
+        db2.apply_permutation(perm_type{0});
+        TEST_ASSERT(db2.template get<double>(0) == 1.5);
+    }
+
+    // Invalid permutations leave the container unchanged.
+    mtv_type db2 = db;
+
+    try
+    {
+        db2.apply_permutation(perm_type(39, 0));
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    perm_type perm(40);
+    std::iota(perm.begin(), perm.end(), 0);
+    perm[7] = 40;
+
+    try
+    {
+        db2.apply_permutation(perm);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    perm[7] = 8;
+
+    try
+    {
+        db2.apply_permutation(perm);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    TEST_ASSERT(db2 == db);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,157 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2025 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.hpp"
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+template<typename mtv_type>
+void mtv_test_reduce()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    namespace rop = mdds::mtv::reduce_op;
+    using mdds::mtv::double_element_block;
+    using mdds::mtv::int32_element_block;
+
+    // Blocks: [0-9] empty, [10-109] double, [110-114] int32, [115-119] empty,
+    // [120-126] double, [127-129] string
+    mtv_type db(130);
+    std::vector<double> values1(100);
+    std::iota(values1.begin(), values1.end(), 1.0); // 1.0 - 100.0
+    db.set(10, values1.begin(), values1.end());
+
+    std::vector<int32_t> ints = {-5, 7, 3, 12, -9};
+    db.set(110, ints.begin(), ints.end());
+
+    std::vector<double> values2 = {-3.5, 0.5, 1000.0, 2.0, 2.0, 2.0, 2.0};
+    db.set(120, values2.begin(), values2.end());
+
+    db.set(127, std::string("A"));
+    db.set(128, std::string("B"));
+    db.set(129, std::string("C"));
+
+    // Whole range.
+    double sum_all = 5050.0 - 3.5 + 0.5 + 1000.0 + 8.0;
+    TEST_ASSERT(db.template reduce<double_element_block>(0, 129, rop::sum{}) == sum_all);
+    TEST_ASSERT(db.template reduce<double_element_block>(0, 129, rop::count{}) == 107);
+    TEST_ASSERT(*db.template reduce<double_element_block>(0, 129, rop::min{}) == -3.5);
+    TEST_ASSERT(*db.template reduce<double_element_block>(0, 129, rop::max{}) == 1000.0);
+    TEST_ASSERT(std::abs(*db.template reduce<double_element_block>(0, 129, rop::mean{}) - sum_all / 107) < 1e-9);
+
+    // Partial ranges starting and ending in the middle of blocks.
+    TEST_ASSERT(db.template reduce<double_element_block>(15, 24, rop::sum{}) == 105.0); // 6 + 7 + ... + 15
+    TEST_ASSERT(db.template reduce<double_element_block>(15, 24, rop::count{}) == 10);
+    TEST_ASSERT(*db.template reduce<double_element_block>(15, 24, rop::min{}) == 6.0);
+    TEST_ASSERT(*db.template reduce<double_element_block>(15, 24, rop::max{}) == 15.0);
+    TEST_ASSERT(db.template reduce<double_element_block>(108, 121, rop::sum{}) == 99.0 + 100.0 - 3.5 + 0.5);
+    TEST_ASSERT(db.template reduce<double_element_block>(108, 121, rop::count{}) == 4);
+
+    // Integer values get summed into a 64-bit integer.
+    auto int_sum = db.template reduce<int32_element_block>(0, 129, rop::sum{});
+    static_assert(std::is_same_v<decltype(int_sum), int64_t>);
+    TEST_ASSERT(int_sum == 8);
+    TEST_ASSERT(*db.template reduce<int32_element_block>(0, 129, rop::min{}) == -9);
+    TEST_ASSERT(*db.template reduce<int32_element_block>(0, 129, rop::max{}) == 12);
+    TEST_ASSERT(*db.template reduce<int32_element_block>(111, 112, rop::max{}) == 7);
+    TEST_ASSERT(*db.template reduce<int32_element_block>(110, 114, rop::mean{}) == 8.0 / 5);
+
+    // No values of the requested type in range.
+    TEST_ASSERT(db.template reduce<double_element_block>(0, 9, rop::sum{}) == 0.0);
+    TEST_ASSERT(db.template reduce<double_element_block>(0, 9, rop::count{}) == 0);
+    TEST_ASSERT(!db.template reduce<double_element_block>(110, 119, rop::min{}));
+    TEST_ASSERT(!db.template reduce<double_element_block>(110, 119, rop::max{}));
+    TEST_ASSERT(!db.template reduce<double_element_block>(127, 129, rop::mean{}));
+
+    // Count works with non-arithmetic value types too.
+    TEST_ASSERT(db.template reduce<mdds::mtv::string_element_block>(0, 129, rop::count{}) == 3);
+
+    // Check against a straight sequential loop over lengths that exercise the
+    // vectorized kernels and their trailing remainders.
+    for (std::size_t len = 1; len <= 30; ++len)
+    {
+        double expected_sum = 0.0, expected_min = values1[0], expected_max = values1[0];
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            expected_sum += values1[i];
+            expected_min = std::min(expected_min, values1[i]);
+            expected_max = std::max(expected_max, values1[i]);
+        }
+
+        TEST_ASSERT(db.template reduce<double_element_block>(10, 10 + len - 1, rop::sum{}) == expected_sum);
+        TEST_ASSERT(*db.template reduce<double_element_block>(10, 10 + len - 1, rop::min{}) == expected_min);
+        TEST_ASSERT(*db.template reduce<double_element_block>(10, 10 + len - 1, rop::max{}) == expected_max);
+    }
+
+    // A NaN value makes min and max NaN regardless of its position, both
+    // within a block and across blocks.
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    for (std::size_t nan_pos = 0; nan_pos < 30; ++nan_pos)
+    {
+        std::vector<double> values(30);
+        std::iota(values.begin(), values.end(), 1.0);
+        values[nan_pos] = nan;
+
+        // Blocks: [0-29] double, [30] int32, [31-32] double
+        mtv_type db2(33);
+        db2.set(0, values.begin(), values.end());
+        db2.set(30, int32_t(1));
+        db2.set(31, -100.0);
+        db2.set(32, 100.0);
+
+        TEST_ASSERT(std::isnan(*db2.template reduce<double_element_block>(0, 29, rop::min{})));
+        TEST_ASSERT(std::isnan(*db2.template reduce<double_element_block>(0, 29, rop::max{})));
+        TEST_ASSERT(std::isnan(*db2.template reduce<double_element_block>(0, 32, rop::min{})));
+        TEST_ASSERT(std::isnan(*db2.template reduce<double_element_block>(0, 32, rop::max{})));
+
+        // Ranges that exclude the NaN value are not affected.
+        if (nan_pos > 0)
+        {
+            TEST_ASSERT(*db2.template reduce<double_element_block>(0, nan_pos - 1, rop::min{}) == 1.0);
+            TEST_ASSERT(*db2.template reduce<double_element_block>(0, nan_pos - 1, rop::max{}) == double(nan_pos));
+        }
+    }
+
+    {
+        // NaN in a later block than the extreme value.
+        mtv_type db2(4);
+        db2.set(0, -1.0);
+        db2.set(1, int32_t(0));
+        db2.set(2, nan);
+        db2.set(3, 5.0);
+        TEST_ASSERT(std::isnan(*db2.template reduce<double_element_block>(0, 3, rop::min{})));
+        TEST_ASSERT(std::isnan(*db2.template reduce<double_element_block>(0, 3, rop::max{})));
+        TEST_ASSERT(*db2.template reduce<double_element_block>(0, 1, rop::min{}) == -1.0);
+    }
+
+    // Invalid ranges.
+    try
+    {
+        db.template reduce<double_element_block>(10, 5, rop::sum{});
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    try
+    {
+        db.template reduce<double_element_block>(10, 130, rop::sum{});
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
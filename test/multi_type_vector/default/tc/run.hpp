@@ -10,6 +10,7 @@
 #include "construction.hpp"
 #include "empty_cells.hpp"
 #include "erase.hpp"
+#include "find.hpp"
 #include "hints.hpp"
 #include "insert.hpp"
 #include "iterators.hpp"
@@ -17,8 +18,11 @@
 #include "iterators_set.hpp"
 #include "iterators_set_empty.hpp"
 #include "misc.hpp"
+#include "permutation.hpp"
 #include "position.hpp"
+#include "reduce.hpp"
 #include "set.hpp"
+#include "state.hpp"
 #include "swap_range.hpp"
 #include "transfer.hpp"
 
@@ -37,12 +41,15 @@ void run_all_tests()
     mtv_test_misc_value_type<mtv_type>();
     mtv_test_misc_block_identifier<mtv_type>();
     mtv_test_misc_push_back<mtv_type>();
+    mtv_test_misc_append_range<mtv_type>();
     mtv_test_misc_capacity<mtv_type>();
+    mtv_test_misc_memory_usage<mtv_type>();
     mtv_test_misc_position_type_end_position<mtv_type>();
     mtv_test_misc_block_pos_adjustments<mtv_type>();
     mtv_test_erase<mtv_type>();
     mtv_test_insert_empty<mtv_type>();
     mtv_test_set_cells<mtv_type>();
+    mtv_test_set_batch<mtv_type>();
     mtv_test_insert_cells<mtv_type>();
     mtv_test_iterators<mtv_type>();
     mtv_test_iterators_element_block<mtv_type>();
@@ -61,8 +68,12 @@ void run_all_tests()
     mtv_test_position<mtv_type>();
     mtv_test_position_next<mtv_type>();
     mtv_test_position_advance<mtv_type>();
+    mtv_test_reduce<mtv_type>();
+    mtv_test_find<mtv_type>();
     mtv_test_swap_range<mtv_type>();
     mtv_test_transfer<mtv_type>();
+    mtv_test_apply_permutation<mtv_type>();
+    mtv_test_save_load_state<mtv_type>();
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
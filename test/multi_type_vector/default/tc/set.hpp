@@ -8,6 +8,10 @@
 
 #include "common.hpp"
 
+#include <random>
+#include <span>
+#include <utility>
+
 template<typename mtv_type>
 void mtv_test_set_cells()
 {
@@ -633,4 +637,165 @@ void mtv_test_set_cells()
     }
 }
 
+template<typename mtv_type>
+void mtv_test_set_batch()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using size_type = typename mtv_type::size_type;
+
+    {
+        // Blocks: [0-4] empty, [5-9] double, [10-14] string, [15-19] int32
+        mtv_type db(20);
+        for (size_type i = 5; i < 10; ++i)
+            db.set(i, double(i));
+        for (size_type i = 10; i < 15; ++i)
+            db.set(i, std::string(1, char('a' + i - 10)));
+        for (size_type i = 15; i < 20; ++i)
+            db.set(i, int32_t(i));
+
+        TEST_ASSERT(db.block_size() == 4);
+
+        std::vector<std::pair<size_type, double>> values = {
+            {1, 1.5}, {2, 2.5}, {4, 4.5}, {7, -7.0}, {10, 10.5}, {12, 12.5}, {19, 19.5}};
+
+        auto it = db.set_batch(std::span{values});
+        TEST_ASSERT(it != db.end());
+        TEST_ASSERT(it->position == 1);
+        TEST_ASSERT(it->type == mdds::mtv::element_type_double);
+
+        // Blocks: [0] empty, [1-2] double, [3] empty, [4-10] double,
+        // [11] string, [12] double, [13-14] string, [15-18] int32, [19] double
+        TEST_ASSERT(db.size() == 20);
+        TEST_ASSERT(db.block_size() == 9);
+        TEST_ASSERT(db.is_empty(0));
+        TEST_ASSERT(db.template get<double>(1) == 1.5);
+        TEST_ASSERT(db.template get<double>(2) == 2.5);
+        TEST_ASSERT(db.is_empty(3));
+        TEST_ASSERT(db.template get<double>(4) == 4.5);
+        TEST_ASSERT(db.template get<double>(5) == 5.0);
+        TEST_ASSERT(db.template get<double>(7) == -7.0);
+        TEST_ASSERT(db.template get<double>(10) == 10.5);
+        TEST_ASSERT(db.template get<std::string>(11) == "b");
+        TEST_ASSERT(db.template get<double>(12) == 12.5);
+        TEST_ASSERT(db.template get<std::string>(13) == "d");
+        TEST_ASSERT(db.template get<std::string>(14) == "e");
+        TEST_ASSERT(db.template get<int32_t>(18) == 18);
+        TEST_ASSERT(db.template get<double>(19) == 19.5);
+
+        // Fill the remaining gaps to merge everything into one block.
+        std::vector<std::pair<size_type, double>> values2 = {{0, 0.0}, {3, 3.0}, {11, 11.0}, {13, 13.0},
+                                                             {14, 14.0}, {15, 15.0}, {16, 16.0}, {17, 17.0},
+                                                             {18, 18.0}};
+        db.set_batch(std::span{values2});
+        TEST_ASSERT(db.block_size() == 1);
+        TEST_ASSERT(db.template get<double>(0) == 0.0);
+        TEST_ASSERT(db.template get<double>(19) == 19.5);
+
+        // Values landing in a block of the same type get overwritten in
+        // place, without replacing the block.
+        const mdds::mtv::base_element_block* data = db.begin()->data;
+        std::vector<std::pair<size_type, double>> values3 = {{2, -2.0}, {9, -9.0}, {17, -17.0}};
+        db.set_batch(std::span{values3});
+        TEST_ASSERT(db.block_size() == 1);
+        TEST_ASSERT(db.begin()->data == data);
+        TEST_ASSERT(db.template get<double>(2) == -2.0);
+        TEST_ASSERT(db.template get<double>(9) == -9.0);
+        TEST_ASSERT(db.template get<double>(17) == -17.0);
+
+        // Empty span.
+        values2.clear();
+        TEST_ASSERT(db.set_batch(std::span{values2}) == db.end());
+    }
+
+    {
+        // Invalid input.
+        mtv_type db(10);
+        std::vector<std::pair<size_type, double>> values = {{1, 1.0}, {3, 3.0}, {2, 2.0}};
+
+        try
+        {
+            db.set_batch(std::span{values});
+            TEST_ASSERT(!"exception should have been thrown");
+        }
+        catch (const mdds::invalid_arg_error&)
+        {
+            // expected
+        }
+
+        values = {{1, 1.0}, {1, 2.0}};
+
+        try
+        {
+            db.set_batch(std::span{values});
+            TEST_ASSERT(!"exception should have been thrown");
+        }
+        catch (const mdds::invalid_arg_error&)
+        {
+            // expected
+        }
+
+        values = {{1, 1.0}, {10, 2.0}};
+
+        try
+        {
+            db.set_batch(std::span{values});
+            TEST_ASSERT(!"exception should have been thrown");
+        }
+        catch (const std::out_of_range&)
+        {
+            // expected
+        }
+
+        // The container must be left untouched.
+        TEST_ASSERT(db.block_size() == 1);
+        TEST_ASSERT(db.is_empty(1));
+    }
+
+    {
+        // Compare against setting the values one by one.
+        std::mt19937 gen(123);
+        auto rand_below = [&gen](size_type n) { return std::uniform_int_distribution<size_type>(0, n - 1)(gen); };
+
+        for (int round = 0; round < 200; ++round)
+        {
+            mtv_type db(60);
+            for (size_type i = 0; i < db.size(); ++i)
+            {
+                switch (rand_below(4))
+                {
+                    case 0:
+                        db.set(i, double(rand_below(3)));
+                        break;
+                    case 1:
+                        db.set(i, std::string(1, char('a' + rand_below(3))));
+                        break;
+                    case 2:
+                        db.set(i, int32_t(rand_below(3)));
+                        break;
+                    default:;
+                }
+            }
+
+            mtv_type ref(db);
+
+            std::vector<std::pair<size_type, std::string>> values;
+            for (size_type pos = 0; pos < db.size(); ++pos)
+            {
+                if (rand_below(3) == 0)
+                    values.emplace_back(pos, std::string(1, char('a' + rand_below(3))));
+            }
+
+            for (const auto& [pos, v] : values)
+                ref.set(pos, v);
+
+            const auto& cvalues = values;
+            db.set_batch(std::span{cvalues});
+
+            TEST_ASSERT(db.block_size() == ref.block_size());
+            TEST_ASSERT(db == ref);
+        }
+    }
+}
+
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,181 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+template<typename mtv_type>
+void mtv_test_save_load_state()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    mtv_type db(30);
+    db.set(0, true);
+    db.set(1, false);
+    db.set(2, int8_t(-8));
+    db.set(3, uint8_t(8));
+    db.set(4, int16_t(-16));
+    db.set(5, uint16_t(16));
+    db.set(6, int32_t(-32));
+    db.set(7, uint32_t(32));
+    db.set(8, int64_t(-64));
+    db.set(9, uint64_t(64));
+    db.set(10, 1.5f);
+    std::vector<double> values = {1.1, 1.2, 1.3, 1.4, 1.5};
+    db.set(12, values.begin(), values.end());
+    db.set(17, std::string("foo"));
+    db.set(18, std::string());
+    db.set(19, std::string(100, 'x'));
+    db.push_back(true);
+
+    // Pop a few values off the top of the double block so that its store
+    // has a front offset.
+    db.set(12, int32_t(12));
+    db.set(13, int32_t(13));
+
+    std::ostringstream os;
+    db.save_state(os);
+    std::string state = os.str();
+    TEST_ASSERT(state.size() % 8 == 0);
+
+    {
+        // Load into a container that already has content.
+        mtv_type db2(5, std::string("old"));
+        std::istringstream is(state);
+        db2.load_state(is);
+        TEST_ASSERT(db2 == db);
+        TEST_ASSERT(db2.block_size() == db.block_size());
+        TEST_ASSERT(db2.template get<double>(14) == 1.3);
+        TEST_ASSERT(db2.template get<std::string>(19) == std::string(100, 'x'));
+        TEST_ASSERT(db2.template get<bool>(30));
+    }
+
+    {
+        // Load from a memory buffer, whose numeric payloads are aligned.
+        std::vector<std::uint64_t> aligned((state.size() + 7) / 8);
+        std::memcpy(aligned.data(), state.data(), state.size());
+        std::span<const char> buffer{reinterpret_cast<const char*>(aligned.data()), state.size()};
+
+        mtv_type db2;
+        db2.load_state(buffer);
+        TEST_ASSERT(db2 == db);
+
+        // The values of the double block are stored as an array aligned
+        // to 8 bytes.
+        const double expected[] = {1.3, 1.4, 1.5};
+        std::string_view needle{reinterpret_cast<const char*>(expected), sizeof(expected)};
+        std::size_t offset = std::string_view{state}.find(needle);
+        TEST_ASSERT(offset != std::string_view::npos);
+        TEST_ASSERT(offset % 8 == 0);
+    }
+
+    {
+        // Empty container.
+        mtv_type empty_db;
+        std::ostringstream empty_os;
+        empty_db.save_state(empty_os);
+        TEST_ASSERT(empty_os.str().size() == 32);
+
+        mtv_type db2(3, 1.0);
+        std::istringstream is(empty_os.str());
+        db2.load_state(is);
+        TEST_ASSERT(db2.empty());
+        TEST_ASSERT(db2.block_size() == 0);
+    }
+
+    {
+        // Invalid states leave the container unchanged.
+        mtv_type db2(2, int32_t(7));
+
+        auto test_invalid = [&db2](std::string_view bad) {
+            try
+            {
+                db2.load_state(std::span<const char>{bad.data(), bad.size()});
+                TEST_ASSERT(!"exception should have been thrown");
+            }
+            catch (const mdds::invalid_arg_error&)
+            {
+                // expected
+            }
+
+            TEST_ASSERT(db2.size() == 2);
+            TEST_ASSERT(db2.template get<int32_t>(1) == 7);
+
+            try
+            {
+                std::istringstream is{std::string{bad}};
+                db2.load_state(is);
+                TEST_ASSERT(!"exception should have been thrown");
+            }
+            catch (const mdds::invalid_arg_error&)
+            {
+                // expected
+            }
+
+            TEST_ASSERT(db2.size() == 2);
+            TEST_ASSERT(db2.template get<int32_t>(1) == 7);
+        };
+
+        // Truncated at various points.
+        for (std::size_t len : {std::size_t(0), std::size_t(10), std::size_t(40), state.size() / 2, state.size() - 1})
+            test_invalid(std::string_view{state}.substr(0, len));
+
+        // Bad magic bytes.
+        std::string bad = state;
+        bad[0] = 'x';
+        test_invalid(bad);
+
+        // Bad container size.
+        bad = state;
+        bad[16] ^= 0x01;
+        test_invalid(bad);
+
+        // The container size, the block size and the payload size all
+        // inflated consistently, so that only the size of the input tells
+        // that the payload is missing.
+        auto set_u64 = [](std::string& s, std::size_t offset, std::uint64_t v) {
+            std::memcpy(s.data() + offset, &v, sizeof(v));
+        };
+
+        constexpr std::uint64_t huge = std::uint64_t(1) << 40;
+        constexpr std::size_t header_size = 32;
+        constexpr std::size_t entry_size_offset = header_size + 8;
+        constexpr std::size_t entry_payload_offset = header_size + 16;
+
+        mtv_type single(5, 1.5);
+        std::ostringstream single_os;
+        single.save_state(single_os);
+        bad = single_os.str();
+        set_u64(bad, 16, huge);
+        set_u64(bad, entry_size_offset, huge);
+        set_u64(bad, entry_payload_offset, huge * sizeof(double));
+        test_invalid(bad);
+
+        single = mtv_type(5, std::string("abc"));
+        single_os.str(std::string{});
+        single.save_state(single_os);
+        bad = single_os.str();
+        set_u64(bad, 16, huge);
+        set_u64(bad, entry_size_offset, huge);
+        set_u64(bad, entry_payload_offset, huge * sizeof(std::uint64_t));
+        test_invalid(bad);
+
+        // Length of the first string inflated along with the payload size.
+        bad = single_os.str();
+        set_u64(bad, entry_payload_offset, huge * 2);
+        set_u64(bad, header_size + 24, huge);
+        test_invalid(bad);
+    }
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -0,0 +1,173 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common.hpp"
+
+#include <numeric>
+#include <span>
+
+template<typename mtv_type, typename Blk>
+concept has_typed_range = requires(const mtv_type& db) { db.template typed_range<Blk>(); };
+
+template<typename mtv_type>
+void mtv_test_typed_range()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mdds::mtv::double_element_block;
+    using mdds::mtv::int32_element_block;
+    using range_type = typename mtv_type::template typed_range_type<double_element_block>;
+
+    static_assert(std::ranges::forward_range<range_type>);
+    static_assert(std::is_same_v<std::ranges::range_value_t<range_type>, std::span<const double>>);
+
+    // The values of std::vector<bool> are not stored contiguously.
+    static_assert(has_typed_range<mtv_type, double_element_block>);
+    static_assert(!has_typed_range<mtv_type, mdds::mtv::boolean_element_block>);
+
+    // Blocks: [0-9] empty, [10-109] double, [110-114] int32, [115-119] empty,
+    // [120-126] double, [127-129] string
+    mtv_type db(130);
+    std::vector<double> values1(100);
+    std::iota(values1.begin(), values1.end(), 1.0); // 1.0 - 100.0
+    db.set(10, values1.begin(), values1.end());
+
+    std::vector<int32_t> ints = {-5, 7, 3, 12, -9};
+    db.set(110, ints.begin(), ints.end());
+
+    std::vector<double> values2 = {-3.5, 0.5, 1000.0, 2.0, 2.0, 2.0, 2.0};
+    db.set(120, values2.begin(), values2.end());
+
+    db.set(127, std::string("A"));
+    db.set(128, std::string("B"));
+    db.set(129, std::string("C"));
+
+    {
+        // Whole container.
+        std::vector<std::size_t> positions;
+        std::vector<double> values;
+        auto range = db.template typed_range<double_element_block>();
+        for (auto it = range.begin(); it != range.end(); ++it)
+        {
+            positions.push_back(it.position());
+            std::span<const double> span = *it;
+            values.insert(values.end(), span.begin(), span.end());
+        }
+
+        TEST_ASSERT(positions == std::vector<std::size_t>({10, 120}));
+
+        std::vector<double> expected = values1;
+        expected.insert(expected.end(), values2.begin(), values2.end());
+        TEST_ASSERT(values == expected);
+    }
+
+    {
+        // The spans point directly to the block storage.
+        auto range = db.template typed_range<double_element_block>(0, 129);
+        auto it = db.begin();
+        std::advance(it, 1);
+        TEST_ASSERT((*range.begin()).data() == &double_element_block::at(*it->data, 0));
+    }
+
+    {
+        // Partial range starting and ending in the middle of blocks.
+        std::vector<std::span<const double>> spans;
+        for (auto span : db.template typed_range<double_element_block>(105, 121))
+            spans.push_back(span);
+
+        TEST_ASSERT(spans.size() == 2);
+        TEST_ASSERT(spans[0].size() == 5);
+        TEST_ASSERT(spans[0].front() == 96.0);
+        TEST_ASSERT(spans[0].back() == 100.0);
+        TEST_ASSERT(spans[1].size() == 2);
+        TEST_ASSERT(spans[1].front() == -3.5);
+        TEST_ASSERT(spans[1].back() == 0.5);
+
+        auto range = db.template typed_range<double_element_block>(105, 121);
+        auto it = range.begin();
+        TEST_ASSERT(it.position() == 105);
+        ++it;
+        TEST_ASSERT(it.position() == 120);
+        ++it;
+        TEST_ASSERT(it == range.end());
+    }
+
+    {
+        // Range within a single block.
+        auto range = db.template typed_range<double_element_block>(20, 29);
+        TEST_ASSERT(std::ranges::distance(range) == 1);
+        std::span<const double> span = *range.begin();
+        TEST_ASSERT(span.size() == 10);
+        TEST_ASSERT(std::accumulate(span.begin(), span.end(), 0.0) == 155.0); // 11 + 12 + ... + 20
+    }
+
+    {
+        // Int32 values, and ranges without any values of the type.
+        auto range = db.template typed_range<int32_element_block>(0, 129);
+        TEST_ASSERT(std::ranges::distance(range) == 1);
+        std::span<const int32_t> span = *range.begin();
+        TEST_ASSERT(std::vector<int32_t>(span.begin(), span.end()) == ints);
+
+        TEST_ASSERT(std::ranges::empty(db.template typed_range<int32_element_block>(0, 109)));
+        TEST_ASSERT(std::ranges::empty(db.template typed_range<double_element_block>(110, 119)));
+        TEST_ASSERT(std::ranges::empty(db.template typed_range<double_element_block>(127, 129)));
+    }
+
+    // Invalid ranges.
+    try
+    {
+        db.template typed_range<double_element_block>(20, 10);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    try
+    {
+        db.template typed_range<double_element_block>(0, 130);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    mtv_type empty_db;
+    TEST_ASSERT(std::ranges::empty(empty_db.template typed_range<double_element_block>()));
+
+    {
+        // Pending position shifts get applied to the reported positions.
+        auto session = db.begin_edit_session();
+        db.insert_empty(0, 5);
+
+        std::vector<std::size_t> positions;
+        auto range = db.template typed_range<double_element_block>(100, 134);
+        for (auto it = range.begin(); it != range.end(); ++it)
+            positions.push_back(it.position());
+
+        TEST_ASSERT(positions == std::vector<std::size_t>({100, 125}));
+        TEST_ASSERT((*range.begin()).front() == 86.0);
+        session.commit();
+
+        db.erase(0, 4);
+    }
+
+    {
+        // The range works on a snapshot as well.
+        auto view = db.snapshot();
+        double sum = 0.0;
+        for (auto span : view.template typed_range<double_element_block>())
+            sum = std::accumulate(span.begin(), span.end(), sum);
+
+        TEST_ASSERT(sum == 5050.0 - 3.5 + 0.5 + 1000.0 + 8.0);
+    }
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
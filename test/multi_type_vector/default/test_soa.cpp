@@ -10,6 +10,7 @@
 #include <mdds/multi_type_vector/soa/main.hpp>
 
 #include "run.hpp"
+#include "typed_range.hpp"
 
 int main()
 {
@@ -18,6 +19,7 @@ int main()
     try
     {
         run_all_tests<mtv_type>();
+        mtv_test_typed_range<mtv_type>(); // SoA-only typed block range
     }
     catch (const std::exception& e)
     {
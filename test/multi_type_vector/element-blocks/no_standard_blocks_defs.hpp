@@ -13,8 +13,13 @@
 #include <mdds/multi_type_vector/block_funcs.hpp>
 #include <mdds/multi_type_vector/util.hpp>
 #include <mdds/multi_type_vector/macro.hpp>
+#include <mdds/multi_type_vector/small_vector.hpp>
+#include <mdds/multi_type_vector/rle_vector.hpp>
+#include <mdds/multi_type_vector/dict_vector.hpp>
+#include <mdds/multi_type_vector/summary_vector.hpp>
 
 #include <deque>
+#include <string_view>
 #include <vector>
 #include <type_traits>
 
@@ -25,14 +30,26 @@ namespace mdds { namespace mtv {
 constexpr element_t element_type_boolean = element_type_user_start;
 constexpr element_t element_type_int32 = element_type_user_start + 1;
 constexpr element_t element_type_uint32 = element_type_user_start + 2;
+constexpr element_t element_type_double = element_type_user_start + 3;
+constexpr element_t element_type_int16 = element_type_user_start + 4;
+constexpr element_t element_type_string = element_type_user_start + 5;
+constexpr element_t element_type_int64 = element_type_user_start + 6;
 
 using boolean_element_block = default_element_block<element_type_boolean, bool, std::deque>;
 using int32_element_block = default_element_block<element_type_int32, std::int32_t, std::vector>;
 using uint32_element_block = default_element_block<element_type_uint32, std::uint32_t, delayed_delete_vector>;
+using double_element_block = default_element_block<element_type_double, double, small_store<2>::type>;
+using int16_element_block = default_element_block<element_type_int16, std::int16_t, rle_vector>;
+using string_element_block = default_element_block<element_type_string, std::string_view, dict_vector>;
+using int64_element_block = default_element_block<element_type_int64, std::int64_t, summary_vector>;
 
 MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(bool, element_type_boolean, false, boolean_element_block)
 MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(std::int32_t, element_type_int32, 0, int32_element_block)
 MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(std::uint32_t, element_type_uint32, 0, uint32_element_block)
+MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(double, element_type_double, 0.0, double_element_block)
+MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(std::int16_t, element_type_int16, 0, int16_element_block)
+MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(std::string_view, element_type_string, std::string_view(), string_element_block)
+MDDS_MTV_DEFINE_ELEMENT_CALLBACKS(std::int64_t, element_type_int64, 0, int64_element_block)
 
 struct standard_element_blocks_traits;
 static_assert(
@@ -45,11 +62,18 @@ static_assert(std::is_same_v<mdds::mtv::boolean_element_block::store_type, std::
 static_assert(std::is_same_v<mdds::mtv::int32_element_block::store_type, std::vector<std::int32_t>>);
 static_assert(
     std::is_same_v<mdds::mtv::uint32_element_block::store_type, mdds::mtv::delayed_delete_vector<std::uint32_t>>);
+static_assert(std::is_same_v<mdds::mtv::double_element_block::store_type, mdds::mtv::small_vector<double, 2>>);
+static_assert(std::is_same_v<mdds::mtv::int16_element_block::store_type, mdds::mtv::rle_vector<std::int16_t>>);
+static_assert(
+    std::is_same_v<mdds::mtv::string_element_block::store_type, mdds::mtv::dict_vector<std::string_view>>);
+static_assert(std::is_same_v<mdds::mtv::int64_element_block::store_type, mdds::mtv::summary_vector<std::int64_t>>);
 
 struct my_traits : mdds::mtv::default_traits
 {
     using block_funcs = mdds::mtv::element_block_funcs<
-        mdds::mtv::boolean_element_block, mdds::mtv::int32_element_block, mdds::mtv::uint32_element_block>;
+        mdds::mtv::boolean_element_block, mdds::mtv::int32_element_block, mdds::mtv::uint32_element_block,
+        mdds::mtv::double_element_block, mdds::mtv::int16_element_block, mdds::mtv::string_element_block,
+        mdds::mtv::int64_element_block>;
 };
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
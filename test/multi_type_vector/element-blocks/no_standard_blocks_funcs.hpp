@@ -7,6 +7,11 @@
 #pragma once
 
 #include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 // `mtv_tmpl` is the storage-variant alias template (aos or soa); the element
 // block definitions and `my_traits` come from no_standard_blocks_defs.hpp,
@@ -31,6 +36,275 @@ void mtv_test_no_standard_blocks_basic()
     TEST_ASSERT(db.template get<bool>(1) == false);
     TEST_ASSERT(db.template get<std::int32_t>(2) == 123);
     TEST_ASSERT(db.template get<std::uint32_t>(3) == 456u);
+
+    // The double block stores up to 2 values inline.  Grow it past that and
+    // split it in the middle.
+    db.push_back(1.0);
+    db.push_back(2.0);
+    TEST_ASSERT(db.block_size() == 4);
+    TEST_ASSERT(mdds::mtv::double_element_block::get(*db.crbegin()->data).store().is_inline());
+
+    db.push_back(3.0);
+    db.push_back(4.0);
+    db.push_back(5.0);
+    TEST_ASSERT(db.size() == 9);
+    TEST_ASSERT(db.block_size() == 4);
+    TEST_ASSERT(!mdds::mtv::double_element_block::get(*db.crbegin()->data).store().is_inline());
+
+    db.template set<std::int32_t>(6, -1);
+    TEST_ASSERT(db.block_size() == 6);
+    TEST_ASSERT(db.template get<double>(4) == 1.0);
+    TEST_ASSERT(db.template get<double>(5) == 2.0);
+    TEST_ASSERT(db.template get<std::int32_t>(6) == -1);
+    TEST_ASSERT(db.template get<double>(7) == 4.0);
+    TEST_ASSERT(db.template get<double>(8) == 5.0);
+
+    // Merge them back.
+    db.set(6, 3.0);
+    TEST_ASSERT(db.block_size() == 4);
+
+    for (std::size_t i = 4; i < 9; ++i)
+        TEST_ASSERT(db.template get<double>(i) == double(i - 3));
+
+    db.erase(5, 7);
+    TEST_ASSERT(db.size() == 6);
+    TEST_ASSERT(db.template get<double>(4) == 1.0);
+    TEST_ASSERT(db.template get<double>(5) == 5.0);
+
+    db.insert_empty(5, 2);
+    TEST_ASSERT(db.block_size() == 6);
+
+    auto db2 = db;
+    TEST_ASSERT(db2 == db);
+}
+
+template<template<typename...> class mtv_tmpl>
+void mtv_test_no_standard_blocks_rle()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using this_mtv_type = mtv_tmpl<my_traits>;
+
+    this_mtv_type db(1000, std::int16_t(5));
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(db.get_type(0) == mdds::mtv::element_type_int16);
+
+    const auto& store = mdds::mtv::int16_element_block::get(*db.begin()->data).store();
+    TEST_ASSERT(store.runs().size() == 1);
+
+    db.set(500, std::int16_t(7));
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(store.runs().size() == 3);
+    TEST_ASSERT(db.template get<std::int16_t>(499) == 5);
+    TEST_ASSERT(db.template get<std::int16_t>(500) == 7);
+    TEST_ASSERT(db.template get<std::int16_t>(501) == 5);
+
+    std::vector<std::int16_t> values(100, 7);
+    db.set(400, values.begin(), values.end());
+    TEST_ASSERT(store.runs().size() == 3);
+    TEST_ASSERT(store.runs()[1].end == 501);
+
+    // The memory used by the values is proportional to the number of runs.
+    auto stats = db.memory_usage();
+    TEST_ASSERT(stats.element_blocks.at(mdds::mtv::element_type_int16).value_bytes < 1000 * sizeof(std::int16_t));
+
+    // Split the block in the middle of a run.
+    db.set(450, 1.5);
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(db.template get<std::int16_t>(449) == 7);
+    TEST_ASSERT(db.template get<double>(450) == 1.5);
+    TEST_ASSERT(db.template get<std::int16_t>(451) == 7);
+    TEST_ASSERT(db.template get<std::int16_t>(999) == 5);
+
+    // Merge the blocks back.
+    db.set(450, std::int16_t(7));
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(mdds::mtv::int16_element_block::get(*db.begin()->data).store().runs().size() == 3);
+
+    std::size_t n = 0;
+    for (auto it = mdds::mtv::int16_element_block::cbegin(*db.begin()->data);
+         it != mdds::mtv::int16_element_block::cend(*db.begin()->data); ++it)
+    {
+        if (*it == 7)
+            ++n;
+    }
+    TEST_ASSERT(n == 101);
+
+    auto db2 = db;
+    TEST_ASSERT(db2 == db);
+}
+
+template<template<typename...> class mtv_tmpl>
+void mtv_test_no_standard_blocks_dict()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using this_mtv_type = mtv_tmpl<my_traits>;
+    using blk_type = mdds::mtv::string_element_block;
+
+    auto get_store = [](const this_mtv_type& db, std::size_t pos) -> const blk_type::store_type& {
+        auto it = db.position(pos).first;
+        return blk_type::get(*it->data).store();
+    };
+
+    this_mtv_type db(10, 1.0);
+
+    {
+        // The container stores its own copies of the strings.
+        std::string s = "metre";
+        db.set(0, std::string_view(s));
+        s = "second";
+        db.set(1, std::string_view(s));
+    }
+
+    std::vector<std::string_view> units = {"metre", "metre", "second", "metre"};
+    db.set(2, units.begin(), units.end());
+    TEST_ASSERT(db.block_size() == 2);
+    TEST_ASSERT(db.get_type(0) == mdds::mtv::element_type_string);
+    TEST_ASSERT(db.template get<std::string_view>(0) == "metre");
+    TEST_ASSERT(db.template get<std::string_view>(1) == "second");
+    TEST_ASSERT(db.template get<std::string_view>(5) == "metre");
+
+    // Each distinct value is stored only once.
+    const auto& store = get_store(db, 0);
+    TEST_ASSERT(store.pool()->size() == 2);
+    TEST_ASSERT(store.ids()[0] == store.ids()[2]);
+    TEST_ASSERT(db.memory_usage().element_blocks.at(mdds::mtv::element_type_string).value_bytes == 6 * 4);
+
+    // Build another string block with its own pool, and merge the two blocks
+    // by erasing the values in between.
+    db.set(8, std::string_view("kelvin"));
+    db.set(9, std::string_view("second"));
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(get_store(db, 8).pool() != get_store(db, 0).pool());
+
+    db.erase(6, 7);
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(db.size() == 8);
+    std::vector<std::string_view> expected = {"metre",  "second", "metre",  "metre",
+                                              "second", "metre",  "kelvin", "second"};
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        TEST_ASSERT(db.template get<std::string_view>(i) == expected[i]);
+
+    TEST_ASSERT(get_store(db, 0).pool()->size() == 3);
+
+    // Split the block.  Both parts share the same pool.
+    db.set(3, 2.0);
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(get_store(db, 0).pool() == get_store(db, 4).pool());
+    TEST_ASSERT(db.template get<std::string_view>(4) == "second");
+
+    // Copies share the pool too, and compare via the ids.
+    auto db2 = db;
+    TEST_ASSERT(db2 == db);
+    TEST_ASSERT(get_store(db2, 0).pool() == get_store(db, 0).pool());
+
+    // Adding a new value to a shared pool makes a copy of it first.
+    db2.set(0, std::string_view("ampere"));
+    TEST_ASSERT(get_store(db2, 0).pool() != get_store(db, 0).pool());
+    TEST_ASSERT(get_store(db, 0).pool()->size() == 3);
+    TEST_ASSERT(db2 != db);
+    TEST_ASSERT(db.template get<std::string_view>(0) == "metre");
+
+    // Merge the parts back.
+    db.set(3, std::string_view("metre"));
+    TEST_ASSERT(db.block_size() == 1);
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        TEST_ASSERT(db.template get<std::string_view>(i) == expected[i]);
+
+    db2.set(0, std::string_view("metre"));
+    db2.set(3, std::string_view("metre"));
+    TEST_ASSERT(db2 == db);
+}
+
+template<template<typename...> class mtv_tmpl>
+void mtv_test_no_standard_blocks_summary()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    namespace rop = mdds::mtv::reduce_op;
+    using this_mtv_type = mtv_tmpl<my_traits>;
+    using blk_type = mdds::mtv::int64_element_block;
+
+    auto get_store = [](const this_mtv_type& db, std::size_t pos) -> const blk_type::store_type& {
+        auto it = db.position(pos).first;
+        return blk_type::get(*it->data).store();
+    };
+
+    // Blocks: [0-99] int64, [100-109] double, [110-159] int64
+    this_mtv_type db(160, std::int64_t(0));
+    std::vector<std::int64_t> values1(100);
+    std::iota(values1.begin(), values1.end(), 1); // 1 - 100
+    db.set(0, values1.begin(), values1.end());
+    std::vector<double> doubles(10, 0.5);
+    db.set(100, doubles.begin(), doubles.end());
+
+    std::vector<std::int64_t> values2(50, 7);
+    values2[25] = -3;
+    db.set(110, values2.begin(), values2.end());
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(!get_store(db, 0).is_summary_valid());
+
+    // Reducing whole blocks caches their summaries.
+    TEST_ASSERT(db.template reduce<blk_type>(0, 159, rop::sum{}) == 5050 + 7 * 49 - 3);
+    TEST_ASSERT(get_store(db, 0).is_summary_valid());
+    TEST_ASSERT(get_store(db, 110).is_summary_valid());
+    TEST_ASSERT(db.template reduce<blk_type>(0, 159, rop::min{}) == -3);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 159, rop::max{}) == 100);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 159, rop::count{}) == 150);
+    TEST_ASSERT(*db.template reduce<blk_type>(0, 109, rop::mean{}) == 50.5);
+
+    // Partial blocks get reduced from their values.
+    TEST_ASSERT(db.template reduce<blk_type>(10, 134, rop::sum{}) == 5050 - 55 + 7 * 25);
+    TEST_ASSERT(db.template reduce<blk_type>(5, 135, rop::min{}) == -3);
+    TEST_ASSERT(db.template reduce<blk_type>(5, 134, rop::min{}) == 6);
+    TEST_ASSERT(db.template reduce<blk_type>(5, 49, rop::max{}) == 50);
+
+    // Blocks whose values are all outside the searched value get skipped.
+    TEST_ASSERT(this_mtv_type::logical_position(db.template find_first<blk_type>(0, 159, 7)) == 6);
+    TEST_ASSERT(this_mtv_type::logical_position(db.template find_first<blk_type>(0, 159, -3)) == 135);
+    TEST_ASSERT(db.template find_first<blk_type>(0, 159, 101).first == db.cend());
+    TEST_ASSERT(db.template find_first<blk_type>(0, 159, -4).first == db.cend());
+
+    // Modifying the values invalidates the summary of the block.
+    db.set(50, std::int64_t(1000));
+    TEST_ASSERT(!get_store(db, 0).is_summary_valid());
+    TEST_ASSERT(get_store(db, 110).is_summary_valid());
+    TEST_ASSERT(db.template reduce<blk_type>(0, 99, rop::max{}) == 1000);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 159, rop::sum{}) == 5050 - 51 + 1000 + 7 * 49 - 3);
+    TEST_ASSERT(this_mtv_type::logical_position(db.template find_first<blk_type>(0, 159, 1000)) == 50);
+
+    // So does modifying them through the mutable block iterator.
+    {
+        auto it = db.begin();
+        auto& store = blk_type::get(*it->data).store();
+        TEST_ASSERT(std::as_const(store).summary().max == 1000);
+        store[0] = -1000;
+        TEST_ASSERT(!store.is_summary_valid());
+    }
+
+    TEST_ASSERT(db.template reduce<blk_type>(0, 99, rop::min{}) == -1000);
+    TEST_ASSERT(this_mtv_type::logical_position(db.template find_first<blk_type>(0, 159, -1000)) == 0);
+
+    // Merging blocks.
+    std::vector<std::int64_t> values3(10, 2000);
+    db.set(100, values3.begin(), values3.end());
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 159, rop::max{}) == 2000);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 159, rop::min{}) == -1000);
+    TEST_ASSERT(get_store(db, 0).summary().count == 160);
+
+    // Copies keep the values and the summaries.
+    auto db2 = db;
+    TEST_ASSERT(db2 == db);
+    TEST_ASSERT(get_store(db2, 0).is_summary_valid());
+    TEST_ASSERT(db2.template reduce<blk_type>(0, 159, rop::sum{}) == db.template reduce<blk_type>(0, 159, rop::sum{}));
+
+    // Erasing values.
+    db.erase(0, 99);
+    TEST_ASSERT(db.size() == 60);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 59, rop::min{}) == -3);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 59, rop::sum{}) == 20000 + 7 * 49 - 3);
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
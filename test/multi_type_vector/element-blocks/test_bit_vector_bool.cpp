@@ -0,0 +1,115 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#include "test_global.hpp" // This must be the first header to be included.
+
+// Store the values of the standard boolean element block in bit_vector.
+#define MDDS_MTV_USE_BIT_VECTOR_BOOLEAN_BLOCK 1
+
+#include <mdds/multi_type_vector/aos/main.hpp>
+#include <mdds/multi_type_vector/soa/main.hpp>
+
+#include <sstream>
+#include <vector>
+
+static_assert(
+    std::is_same_v<mdds::mtv::boolean_element_block::store_type, mdds::mtv::bit_vector<bool>>,
+    "The standard boolean element block should store its values in bit_vector.");
+
+template<template<typename...> class mtv_tmpl>
+void mtv_test_bit_vector_boolean_block()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mtv_tmpl<mdds::mtv::standard_element_blocks_traits>;
+    using blk_type = mdds::mtv::boolean_element_block;
+
+    mtv_type db(1000, false);
+
+    std::vector<bool> flags(300);
+    for (std::size_t i = 0; i < flags.size(); ++i)
+        flags[i] = i % 3 == 0;
+
+    db.set(100, flags.begin(), flags.end());
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(db.template get<bool>(99) == false);
+    TEST_ASSERT(db.template get<bool>(100) == true);
+    TEST_ASSERT(db.template get<bool>(103) == true);
+    TEST_ASSERT(db.template get<bool>(104) == false);
+
+    // The true values get counted a word at a time.
+    TEST_ASSERT(db.template reduce<blk_type>(0, 999, mdds::mtv::reduce_op::sum{}) == 100u);
+    TEST_ASSERT(db.template reduce<blk_type>(101, 399, mdds::mtv::reduce_op::sum{}) == 99u);
+
+    auto stats = db.memory_usage();
+    TEST_ASSERT(stats.element_blocks.at(mdds::mtv::element_type_boolean).value_bytes == 16 * sizeof(std::uint64_t));
+
+    // Split the block, and merge it back.
+    db.set(500, 1.5);
+    TEST_ASSERT(db.block_size() == 3);
+    TEST_ASSERT(db.template get<bool>(397) == true);
+    TEST_ASSERT(db.template get<bool>(501) == false);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 999, mdds::mtv::reduce_op::sum{}) == 100u);
+
+    db.set(500, true);
+    TEST_ASSERT(db.block_size() == 1);
+    TEST_ASSERT(db.template reduce<blk_type>(0, 999, mdds::mtv::reduce_op::sum{}) == 101u);
+
+    // Searched and counted a word at a time.
+    TEST_ASSERT(mtv_type::logical_position(db.template find_first<blk_type>(0, 999, true)) == 100);
+    TEST_ASSERT(mtv_type::logical_position(db.template find_first<blk_type>(101, 999, true)) == 103);
+    TEST_ASSERT(mtv_type::logical_position(db.template find_if<blk_type>(500, 999, [](bool v) { return !v; })) == 501);
+    TEST_ASSERT(db.template find_first<blk_type>(401, 499, true).first == db.cend());
+    TEST_ASSERT(db.template count_if<blk_type>(0, 999, [](bool v) { return !v; }) == 899u);
+
+    const auto& store = blk_type::get(*db.begin()->data).store();
+    std::size_t n = 0;
+    store.for_each_true([&n](std::size_t) { ++n; });
+    TEST_ASSERT(n == 101);
+
+    db.insert_empty(50, 20);
+    db.erase(0, 9);
+    TEST_ASSERT(db.size() == 1010);
+    TEST_ASSERT(db.template get<bool>(100 + 20 - 10) == true);
+
+    // Save and load the state.
+    std::ostringstream os;
+    db.save_state(os);
+    mtv_type db2;
+    std::istringstream is(os.str());
+    db2.load_state(is);
+    TEST_ASSERT(db2 == db);
+
+    auto db3 = db;
+    TEST_ASSERT(db3 == db);
+    db3.set(1009, true);
+    TEST_ASSERT(db3 != db);
+}
+
+template<typename... Ts>
+using mtv_aos = mdds::mtv::aos::multi_type_vector<Ts...>;
+
+template<typename... Ts>
+using mtv_soa = mdds::mtv::soa::multi_type_vector<Ts...>;
+
+int main()
+{
+    try
+    {
+        mtv_test_bit_vector_boolean_block<mtv_aos>();
+        mtv_test_bit_vector_boolean_block<mtv_soa>();
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Test failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Test finished successfully!" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
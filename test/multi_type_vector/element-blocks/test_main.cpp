@@ -13,6 +13,12 @@ int main()
         mtv_test_element_blocks_buildability();
         mtv_test_element_blocks_std_vector();
         mtv_test_element_blocks_std_deque();
+        mtv_test_element_blocks_small_vector();
+        mtv_test_element_blocks_external_vector();
+        mtv_test_element_blocks_rle_vector();
+        mtv_test_element_blocks_dict_vector();
+        mtv_test_element_blocks_bit_vector();
+        mtv_test_element_blocks_summary_vector();
         mtv_test_element_blocks_std_vector_bool();
         mtv_test_element_blocks_std_deque_bool();
         mtv_test_element_blocks_delayed_delete_vector_bool();
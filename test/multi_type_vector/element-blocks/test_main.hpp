@@ -14,6 +14,12 @@
 void mtv_test_element_blocks_buildability();
 void mtv_test_element_blocks_std_vector();
 void mtv_test_element_blocks_std_deque();
+void mtv_test_element_blocks_small_vector();
+void mtv_test_element_blocks_external_vector();
+void mtv_test_element_blocks_rle_vector();
+void mtv_test_element_blocks_dict_vector();
+void mtv_test_element_blocks_bit_vector();
+void mtv_test_element_blocks_summary_vector();
 void mtv_test_element_blocks_std_vector_bool();
 void mtv_test_element_blocks_std_deque_bool();
 void mtv_test_element_blocks_delayed_delete_vector_bool();
@@ -20,6 +20,9 @@ using mtv_aos = mdds::mtv::aos::multi_type_vector<Ts...>;
 void test_mtv_basic()
 {
     mtv_test_no_standard_blocks_basic<mtv_aos>();
+    mtv_test_no_standard_blocks_rle<mtv_aos>();
+    mtv_test_no_standard_blocks_dict<mtv_aos>();
+    mtv_test_no_standard_blocks_summary<mtv_aos>();
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
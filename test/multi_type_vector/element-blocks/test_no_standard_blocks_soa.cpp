@@ -20,6 +20,9 @@ using mtv_soa = mdds::mtv::soa::multi_type_vector<Ts...>;
 void test_mtv_basic()
 {
     mtv_test_no_standard_blocks_basic<mtv_soa>();
+    mtv_test_no_standard_blocks_rle<mtv_soa>();
+    mtv_test_no_standard_blocks_dict<mtv_soa>();
+    mtv_test_no_standard_blocks_summary<mtv_soa>();
 }
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -8,10 +8,20 @@
 
 #include <mdds/multi_type_vector/types.hpp>
 #include <mdds/multi_type_vector/block_funcs.hpp>
+#include <mdds/multi_type_vector/small_vector.hpp>
+#include <mdds/multi_type_vector/external_vector.hpp>
+#include <mdds/multi_type_vector/rle_vector.hpp>
+#include <mdds/multi_type_vector/dict_vector.hpp>
+#include <mdds/multi_type_vector/bit_vector.hpp>
+#include <mdds/multi_type_vector/summary_vector.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <deque>
+#include <span>
+#include <string>
 #include <type_traits>
+#include <utility>
 
 void mtv_test_element_blocks_std_vector()
 {
@@ -67,4 +77,812 @@ void mtv_test_element_blocks_std_deque()
     this_block::delete_block(blk);
 }
 
+void mtv_test_element_blocks_small_vector()
+{
+    stack_printer __stack_printer__(__func__);
+
+    using store_type = mdds::mtv::small_vector<std::string, 3>;
+
+    // An integer must not silently convert to a store.
+    static_assert(!std::is_convertible_v<store_type::size_type, store_type>);
+
+    store_type store;
+    TEST_ASSERT(store.empty());
+    TEST_ASSERT(store.is_inline());
+    TEST_ASSERT(store.capacity() == 3u);
+
+    store.push_back("a");
+    store.push_back("b");
+    store.push_back("c");
+    TEST_ASSERT(store.is_inline());
+
+    // Exceed the inline capacity.
+    store.push_back("d");
+    TEST_ASSERT(!store.is_inline());
+    TEST_ASSERT(store.size() == 4u);
+
+    // Insert in the middle and at the front.
+    store.insert(store.begin() + 2, std::string("X"));
+    std::vector<std::string> values = {"1", "2"};
+    store.insert(store.begin(), values.begin(), values.end());
+    std::vector<std::string> expected = {"1", "2", "a", "b", "X", "c", "d"};
+    TEST_ASSERT(std::equal(store.begin(), store.end(), expected.begin(), expected.end()));
+
+    // Copies and moves.
+    store_type copied = store;
+    TEST_ASSERT(copied == store);
+    store_type moved = std::move(copied);
+    TEST_ASSERT(moved == store);
+
+    // Erase and shrink back into the inline buffer.
+    store.erase(store.begin(), store.begin() + 5);
+    TEST_ASSERT(store.size() == 2u);
+    TEST_ASSERT(store[0] == "c");
+    TEST_ASSERT(store.at(1) == "d");
+    store.shrink_to_fit();
+    TEST_ASSERT(store.is_inline());
+    TEST_ASSERT(store[0] == "c");
+    TEST_ASSERT(store[1] == "d");
+
+    // Swap an inline instance with a heap-allocated one.
+    store.swap(moved);
+    TEST_ASSERT(store.size() == 7u);
+    TEST_ASSERT(!store.is_inline());
+    TEST_ASSERT(moved.size() == 2u);
+    TEST_ASSERT(moved.is_inline());
+    TEST_ASSERT(moved[1] == "d");
+
+    store.resize(1);
+    TEST_ASSERT(store.size() == 1u);
+    TEST_ASSERT(store[0] == "1");
+
+    try
+    {
+        [[maybe_unused]] auto v = store.at(1);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    // Use it as the store of an element block.
+    constexpr mdds::mtv::element_t element_type_int8 = mdds::mtv::element_type_user_start + 21;
+    using this_block =
+        mdds::mtv::default_element_block<element_type_int8, std::int8_t, mdds::mtv::small_store<4>::type>;
+
+    static_assert(this_block::block_type == element_type_int8);
+    static_assert(std::is_same_v<this_block::store_type, mdds::mtv::small_vector<std::int8_t, 4>>);
+
+    auto* blk = this_block::create_block(2);
+
+    TEST_ASSERT(mdds::mtv::get_block_type(*blk) == this_block::block_type);
+    TEST_ASSERT(this_block::size(*blk) == 2u);
+    TEST_ASSERT(this_block::capacity(*blk) == 4u);
+    TEST_ASSERT(this_block::get(*blk).store().is_inline());
+
+    // The inline buffer counts as part of the block object.
+    auto usage = this_block::memory_usage(*blk);
+    TEST_ASSERT(usage.value_bytes == 2u);
+    TEST_ASSERT(usage.slack_bytes == 2u);
+    TEST_ASSERT(usage.total() == sizeof(this_block));
+
+    this_block::reserve(*blk, 100u);
+    TEST_ASSERT(this_block::capacity(*blk) >= 100u);
+
+    usage = this_block::memory_usage(*blk);
+    TEST_ASSERT(usage.total() == sizeof(this_block) + this_block::capacity(*blk));
+
+    this_block::shrink_to_fit(*blk);
+    TEST_ASSERT(this_block::capacity(*blk) == 4u);
+    TEST_ASSERT(this_block::get(*blk).store().is_inline());
+
+    this_block::delete_block(blk);
+}
+
+void mtv_test_element_blocks_external_vector()
+{
+    stack_printer __stack_printer__(__func__);
+
+    using store_type = mdds::mtv::external_vector<std::string>;
+
+    // An integer must not silently convert to a store.
+    static_assert(!std::is_convertible_v<store_type::size_type, store_type>);
+
+    const std::vector<std::string> src = {"a", "b", "c", "d", "e"};
+
+    const store_type store(std::span<const std::string>{src});
+    TEST_ASSERT(store.is_external());
+    TEST_ASSERT(store.size() == 5u);
+    TEST_ASSERT(store.data() == src.data());
+    TEST_ASSERT(&store[2] == &src[2]);
+    TEST_ASSERT(store.at(4) == "e");
+    TEST_ASSERT(std::equal(store.begin(), store.end(), src.begin(), src.end()));
+    TEST_ASSERT(*store.rbegin() == "e");
+
+    try
+    {
+        [[maybe_unused]] auto v = store.at(5);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    // Copying only copies the reference.
+    store_type copied = store;
+    TEST_ASSERT(copied.is_external());
+    TEST_ASSERT(std::as_const(copied).data() == src.data());
+    TEST_ASSERT(copied == store);
+
+    // Shrinking narrows the referenced range without copying.
+    copied.resize(3);
+    TEST_ASSERT(copied.is_external());
+    TEST_ASSERT(copied.size() == 3u);
+    TEST_ASSERT(copied.capacity() == 3u);
+    copied.shrink_to_fit();
+    TEST_ASSERT(copied.is_external());
+
+    // Any other modification copies the values first.
+    copied.push_back(copied[0]);
+    TEST_ASSERT(!copied.is_external());
+    std::vector<std::string> expected = {"a", "b", "c", "a"};
+    TEST_ASSERT(std::equal(copied.begin(), copied.end(), expected.begin(), expected.end()));
+    TEST_ASSERT(src[0] == "a");
+    TEST_ASSERT(src.size() == 5u);
+
+    // Insert values from the external array into another external instance.
+    store_type inserted(std::span<const std::string>{src});
+    inserted.insert(std::as_const(inserted).begin() + 1, store.begin() + 3, store.end());
+    expected = {"a", "d", "e", "b", "c", "d", "e"};
+    TEST_ASSERT(std::equal(inserted.begin(), inserted.end(), expected.begin(), expected.end()));
+
+    // Erasing values from either end narrows the referenced range as well.
+    store_type erased(std::span<const std::string>{src});
+    erased.erase(std::as_const(erased).begin());
+    erased.erase(std::as_const(erased).end() - 1);
+    TEST_ASSERT(erased.is_external());
+    TEST_ASSERT(std::as_const(erased).data() == src.data() + 1);
+    expected = {"b", "c", "d"};
+    TEST_ASSERT(std::equal(erased.begin(), erased.end(), expected.begin(), expected.end()));
+
+    erased = store_type(std::span<const std::string>{src});
+    erased.erase(std::as_const(erased).begin() + 1, std::as_const(erased).begin() + 4);
+    TEST_ASSERT(!erased.is_external());
+    expected = {"a", "e"};
+    TEST_ASSERT(std::equal(erased.begin(), erased.end(), expected.begin(), expected.end()));
+
+    store_type assigned(std::span<const std::string>{src});
+    assigned.assign(store.begin() + 2, store.end());
+    TEST_ASSERT(!assigned.is_external());
+    expected = {"c", "d", "e"};
+    TEST_ASSERT(std::equal(assigned.begin(), assigned.end(), expected.begin(), expected.end()));
+
+    assigned.swap(copied);
+    TEST_ASSERT(assigned.size() == 4u);
+    TEST_ASSERT(copied.size() == 3u);
+
+    // Use it as the store of an element block.
+    constexpr mdds::mtv::element_t element_type_int16 = mdds::mtv::element_type_user_start + 22;
+    using this_block = mdds::mtv::default_element_block<element_type_int16, std::int16_t, mdds::mtv::external_vector>;
+
+    static_assert(this_block::block_type == element_type_int16);
+    static_assert(std::is_same_v<this_block::store_type, mdds::mtv::external_vector<std::int16_t>>);
+
+    const std::int16_t values[] = {1, 2, 3, 4};
+    auto* blk = this_block::create_block(0);
+    this_block::get(*blk).store() = this_block::store_type(std::span<const std::int16_t>{values});
+
+    const auto& cblk = *blk;
+    TEST_ASSERT(this_block::size(cblk) == 4u);
+    TEST_ASSERT(this_block::at(cblk, 3) == 4);
+    TEST_ASSERT(this_block::get_value(cblk, 1) == 2);
+    TEST_ASSERT(this_block::cbegin(cblk) == values);
+
+    auto* blk2 = this_block::copy_block(cblk);
+    TEST_ASSERT(this_block::get(*blk2).store().is_external());
+    TEST_ASSERT(this_block::cbegin(*blk2) == values);
+
+    this_block::set_value(*blk2, 0, 10);
+    TEST_ASSERT(!this_block::get(*blk2).store().is_external());
+    TEST_ASSERT(this_block::get_value(*blk2, 0) == 10);
+    TEST_ASSERT(values[0] == 1);
+
+    this_block::delete_block(blk2);
+    this_block::delete_block(blk);
+}
+
+void mtv_test_element_blocks_rle_vector()
+{
+    stack_printer __stack_printer__(__func__);
+
+    using store_type = mdds::mtv::rle_vector<std::string>;
+
+    auto check_values = [](const store_type& store, const std::vector<std::string>& expected) {
+        TEST_ASSERT(store.size() == expected.size());
+        TEST_ASSERT(std::equal(store.begin(), store.end(), expected.begin(), expected.end()));
+        TEST_ASSERT(std::equal(store.rbegin(), store.rend(), expected.rbegin(), expected.rend()));
+
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            TEST_ASSERT(store[i] == expected[i]);
+
+        // No two adjacent runs may share the same value.
+        auto runs = store.runs();
+        for (std::size_t i = 1; i < runs.size(); ++i)
+            TEST_ASSERT(runs[i - 1].value != runs[i].value);
+    };
+
+    std::vector<std::string> values = {"a", "a", "a", "b", "b", "a", "a", "a"};
+    store_type store(values.begin(), values.end());
+    TEST_ASSERT(store.runs().size() == 3u);
+    TEST_ASSERT(store.runs()[1].value == "b");
+    TEST_ASSERT(store.runs()[1].end == 5u);
+    check_values(store, values);
+
+    // Overwriting the middle run with the surrounding value merges all runs
+    // into one.
+    store[3] = "a";
+    store[4] = "a";
+    TEST_ASSERT(store.runs().size() == 1u);
+    check_values(store, std::vector<std::string>(8, "a"));
+
+    // Setting a value in the middle of a run splits it into three.
+    store[2] = "x";
+    TEST_ASSERT(store.runs().size() == 3u);
+    check_values(store, {"a", "a", "x", "a", "a", "a", "a", "a"});
+
+    // Assign via an iterator, and from another element.
+    auto it = store.begin() + 6;
+    *it = "y";
+    store[7] = store[2];
+    check_values(store, {"a", "a", "x", "a", "a", "a", "y", "x"});
+
+    store.replace(1, values.begin() + 2, values.begin() + 6);
+    check_values(store, {"a", "a", "b", "b", "a", "a", "y", "x"});
+
+    values = {"b", "b", "c"};
+    store.insert(store.begin() + 3, values.begin(), values.end());
+    check_values(store, {"a", "a", "b", "b", "b", "c", "b", "a", "a", "y", "x"});
+
+    store.insert(store.end(), std::string("x"));
+    store.push_back("x");
+    store.emplace_back(3, 'z');
+    check_values(store, {"a", "a", "b", "b", "b", "c", "b", "a", "a", "y", "x", "x", "x", "zzz"});
+
+    // Erasing a run merges its neighbors.
+    store.erase(store.begin() + 5);
+    check_values(store, {"a", "a", "b", "b", "b", "b", "a", "a", "y", "x", "x", "x", "zzz"});
+    TEST_ASSERT(store.runs().size() == 6u);
+
+    store.erase(store.begin() + 1, store.begin() + 7);
+    check_values(store, {"a", "a", "y", "x", "x", "x", "zzz"});
+
+    store.pop_back();
+    store.resize(9, "x");
+    check_values(store, {"a", "a", "y", "x", "x", "x", "x", "x", "x"});
+    TEST_ASSERT(store.runs().size() == 3u);
+    store.resize(2);
+    check_values(store, {"a", "a"});
+
+    // Insert the values of the store into itself.
+    store.insert(store.begin() + 1, std::as_const(store).begin(), std::as_const(store).end());
+    check_values(store, {"a", "a", "a", "a"});
+
+    store_type copied = store;
+    TEST_ASSERT(copied == store);
+    copied[0] = "b";
+    TEST_ASSERT(copied != store);
+    copied.swap(store);
+    TEST_ASSERT(store.at(0) == "b");
+
+    try
+    {
+        [[maybe_unused]] auto v = std::as_const(store).at(4);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    store.assign(values.begin(), values.end());
+    check_values(store, values);
+    store.clear();
+    TEST_ASSERT(store.empty());
+    TEST_ASSERT(store.begin() == store.end());
+
+    // Use it as the store of an element block.
+    constexpr mdds::mtv::element_t element_type_int32 = mdds::mtv::element_type_user_start + 23;
+    using this_block = mdds::mtv::default_element_block<element_type_int32, std::int32_t, mdds::mtv::rle_vector>;
+
+    static_assert(std::is_same_v<this_block::store_type, mdds::mtv::rle_vector<std::int32_t>>);
+
+    auto* blk = this_block::create_block(1000);
+    TEST_ASSERT(this_block::size(*blk) == 1000u);
+    TEST_ASSERT(this_block::get(*blk).store().runs().size() == 1u);
+
+    std::vector<std::int32_t> ints(100, 7);
+    this_block::set_values(*blk, 200, ints.begin(), ints.end());
+    this_block::set_value(*blk, 250, 8);
+    TEST_ASSERT(this_block::get(*blk).store().runs().size() == 5u);
+    TEST_ASSERT(this_block::get_value(*blk, 249) == 7);
+    TEST_ASSERT(this_block::get_value(*blk, 250) == 8);
+    TEST_ASSERT(this_block::at(std::as_const(*blk), 300) == 0);
+
+    auto usage = this_block::memory_usage(*blk);
+    TEST_ASSERT(usage.value_bytes == 5u * sizeof(this_block::store_type::run_type));
+    TEST_ASSERT(usage.value_bytes < 1000u * sizeof(std::int32_t));
+
+    auto* blk2 = this_block::create_block(0);
+    this_block::assign_values_from_block(*blk2, *blk, 190, 20);
+    TEST_ASSERT(this_block::size(*blk2) == 20u);
+    TEST_ASSERT(this_block::get(*blk2).store().runs().size() == 2u);
+
+    this_block::swap_values(*blk, *blk2, 0, 0, 20);
+    TEST_ASSERT(this_block::get_value(*blk, 9) == 0);
+    TEST_ASSERT(this_block::get_value(*blk, 10) == 7);
+    TEST_ASSERT(this_block::get_value(*blk2, 10) == 0);
+
+    this_block::erase_values(*blk, 0, 200);
+    TEST_ASSERT(this_block::size(*blk) == 800u);
+    TEST_ASSERT(this_block::get_value(*blk, 0) == 7);
+
+    this_block::delete_block(blk2);
+    this_block::delete_block(blk);
+}
+
+void mtv_test_element_blocks_dict_vector()
+{
+    stack_printer __stack_printer__(__func__);
+
+    {
+        using store_type = mdds::mtv::dict_vector<std::string>;
+
+        std::vector<std::string> values = {"kg", "m", "kg", "s", "m", "kg"};
+        store_type store(values.begin(), values.end());
+        TEST_ASSERT(std::equal(store.begin(), store.end(), values.begin(), values.end()));
+        TEST_ASSERT(store.pool()->size() == 3u);
+        TEST_ASSERT(store.ids()[0] == store.ids()[2]);
+        TEST_ASSERT(store.ids()[0] != store.ids()[1]);
+        TEST_ASSERT(store.value_bytes() == 6u * sizeof(store_type::id_type));
+
+        // Assign through the proxy objects.
+        store[1] = "s";
+        *(store.begin() + 2) = store[3];
+        store.emplace_back(2, 'A');
+        values = {"kg", "s", "s", "s", "m", "kg", "AA"};
+        TEST_ASSERT(std::equal(store.rbegin(), store.rend(), values.rbegin(), values.rend()));
+        TEST_ASSERT(store.pool()->size() == 4u);
+
+        // Insert the values of the store into itself.
+        store.insert(store.begin() + 1, std::as_const(store).begin(), std::as_const(store).begin() + 2);
+        store.erase(store.end() - 2, store.end());
+        store.pop_back();
+        values = {"kg", "kg", "s", "s", "s", "s"};
+        TEST_ASSERT(std::equal(store.begin(), store.end(), values.begin(), values.end()));
+
+        store.resize(8, "K");
+        TEST_ASSERT(store.at(7) == "K");
+        store.resize(2);
+        TEST_ASSERT(store.size() == 2u);
+
+        try
+        {
+            [[maybe_unused]] auto v = std::as_const(store).at(2);
+            TEST_ASSERT(!"exception should have been thrown");
+        }
+        catch (const std::out_of_range&)
+        {
+            // expected
+        }
+
+        // Vectors with different pools compare by value.
+        store_type other(2, "kg");
+        TEST_ASSERT(other.pool() != store.pool());
+        TEST_ASSERT(other == store);
+        other[1] = "m";
+        TEST_ASSERT(other != store);
+
+        store.clear();
+        TEST_ASSERT(store.empty());
+        TEST_ASSERT(store.begin() == store.end());
+    }
+
+    {
+        // Vectors constructed with the same pool share it until one of them
+        // adds a value the pool does not contain.
+        using store_type = mdds::mtv::dict_vector<std::string_view>;
+
+        auto pool = std::make_shared<store_type::pool_type>();
+        pool->intern("red");
+        pool->intern("green");
+
+        store_type store1(pool), store2(pool);
+        store1.push_back("green");
+        store2.push_back("green");
+        TEST_ASSERT(store1.pool() == pool && store2.pool() == pool);
+        TEST_ASSERT(store1.ids()[0] == 1u);
+        TEST_ASSERT(store1 == store2);
+
+        store1.push_back("blue");
+        TEST_ASSERT(store1.pool() != pool);
+        TEST_ASSERT(pool->size() == 2u);
+        TEST_ASSERT(store1.pool()->size() == 3u);
+        TEST_ASSERT(store1.ids()[0] == 1u);
+        TEST_ASSERT(pool->find("blue") == store_type::pool_type::npos);
+
+        // Views of the values stay valid for as long as the pool exists.
+        std::string_view green = std::as_const(store2)[0];
+        store2.assign(store1.begin(), store1.end());
+        TEST_ASSERT(store2.pool() == store1.pool());
+        TEST_ASSERT(green == "green");
+        pool.reset();
+    }
+
+    // Use it as the store of an element block.
+    constexpr mdds::mtv::element_t element_type_str = mdds::mtv::element_type_user_start + 24;
+    using this_block = mdds::mtv::default_element_block<element_type_str, std::string_view, mdds::mtv::dict_vector>;
+
+    static_assert(std::is_same_v<this_block::store_type, mdds::mtv::dict_vector<std::string_view>>);
+
+    std::vector<std::string_view> values = {"a", "b", "a", "c"};
+    auto* blk1 = this_block::create_block(0);
+    this_block::assign_values(*blk1, values.begin(), values.end());
+    auto* blk2 = this_block::create_block(3);
+    this_block::set_value(*blk2, 1, "d");
+    TEST_ASSERT(this_block::get_value(*blk2, 0) == "");
+    TEST_ASSERT(this_block::get_value(*blk2, 1) == "d");
+
+    // Swap values between blocks with different pools.
+    this_block::swap_values(*blk1, *blk2, 1, 0, 2);
+    TEST_ASSERT(this_block::get_value(*blk1, 1) == "");
+    TEST_ASSERT(this_block::get_value(*blk1, 2) == "d");
+    TEST_ASSERT(this_block::get_value(*blk2, 0) == "b");
+    TEST_ASSERT(this_block::get_value(*blk2, 1) == "a");
+    TEST_ASSERT(this_block::get_value(*blk2, 2) == "");
+
+    // Merging a block with another pool maps its ids.
+    this_block::append_block(*blk1, *blk2);
+    values = {"a", "", "d", "c", "b", "a", ""};
+    TEST_ASSERT(std::equal(this_block::cbegin(*blk1), this_block::cend(*blk1), values.begin(), values.end()));
+    TEST_ASSERT(this_block::get(*blk1).store().pool()->size() == 5u);
+
+    // Blocks assigned values from another block share its pool.
+    auto* blk3 = this_block::create_block(0);
+    this_block::assign_values_from_block(*blk3, *blk1, 2, 3);
+    TEST_ASSERT(this_block::get(*blk3).store().pool() == this_block::get(*blk1).store().pool());
+    this_block::prepend_values_from_block(*blk3, *blk1, 0, 1);
+    values = {"a", "d", "c", "b"};
+    TEST_ASSERT(std::equal(this_block::cbegin(*blk3), this_block::cend(*blk3), values.begin(), values.end()));
+
+    auto usage = this_block::memory_usage(*blk3);
+    TEST_ASSERT(usage.value_bytes == 4u * sizeof(std::uint32_t));
+
+    this_block::delete_block(blk3);
+    this_block::delete_block(blk2);
+    this_block::delete_block(blk1);
+}
+
+void mtv_test_element_blocks_bit_vector()
+{
+    stack_printer __stack_printer__(__func__);
+
+    using store_type = mdds::mtv::bit_vector<bool>;
+
+    auto check_values = [](const store_type& store, const std::vector<bool>& expected) {
+        TEST_ASSERT(store.size() == expected.size());
+        TEST_ASSERT(std::equal(store.begin(), store.end(), expected.begin(), expected.end()));
+        TEST_ASSERT(std::equal(store.rbegin(), store.rend(), expected.rbegin(), expected.rend()));
+        TEST_ASSERT(store.count() == std::size_t(std::count(expected.begin(), expected.end(), true)));
+
+        // The bits past the last value must be zero.
+        auto words = store.words();
+        TEST_ASSERT(words.size() == (expected.size() + 63) / 64);
+        if (expected.size() % 64)
+            TEST_ASSERT(!(words.back() >> (expected.size() % 64)));
+    };
+
+    // Build a pattern that spans several words.
+    std::vector<bool> expected(200);
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        expected[i] = (i % 3 == 0) || (i % 7 == 0);
+
+    store_type store(expected.begin(), expected.end());
+    check_values(store, expected);
+
+    TEST_ASSERT(store.count(10, 100) == std::size_t(std::count(expected.begin() + 10, expected.begin() + 110, true)));
+    TEST_ASSERT(store.count(63, 2) == std::size_t(expected[63] + expected[64]));
+
+    // Find the first occurrence of either value from every start position,
+    // with ranges that cross word boundaries.
+    for (std::size_t pos = 0; pos < expected.size(); pos += 13)
+    {
+        std::size_t len = expected.size() - pos;
+        for (bool value : {true, false})
+        {
+            auto it = std::find(expected.begin() + pos, expected.end(), value);
+            TEST_ASSERT(store.find(value, pos, len) == std::size_t(std::distance(expected.begin() + pos, it)));
+        }
+    }
+
+    TEST_ASSERT(store.find(true, 64, 2) == 2u); // 64 and 65 are both false
+    TEST_ASSERT(store.find(false, 63, 1) == 1u); // 63 is true
+
+    std::vector<std::size_t> positions;
+    store.for_each_true([&positions](std::size_t pos) { positions.push_back(pos); });
+    TEST_ASSERT(positions.size() == store.count());
+    for (std::size_t pos : positions)
+        TEST_ASSERT(expected[pos]);
+
+    // Set a range that straddles word boundaries.
+    store.set(60, 75, true);
+    std::fill(expected.begin() + 60, expected.begin() + 135, true);
+    check_values(store, expected);
+    store.set(5, 130, false);
+    std::fill(expected.begin() + 5, expected.begin() + 135, false);
+    check_values(store, expected);
+
+    // Assign through the proxy objects.
+    store[70] = true;
+    *(store.begin() + 71) = store[70];
+    store.at(199) = false;
+    expected[70] = expected[71] = true;
+    expected[199] = false;
+    check_values(store, expected);
+
+    // Insert values at an unaligned position, including the values of the
+    // store itself.
+    std::vector<bool> values = {true, false, true, true};
+    store.insert(store.begin() + 30, values.begin(), values.end());
+    expected.insert(expected.begin() + 30, values.begin(), values.end());
+    check_values(store, expected);
+
+    store.insert(store.begin() + 3, std::as_const(store).begin() + 60, std::as_const(store).end());
+    values.assign(expected.begin() + 60, expected.end());
+    expected.insert(expected.begin() + 3, values.begin(), values.end());
+    check_values(store, expected);
+
+    store.insert(store.end(), true);
+    store.push_back(true);
+    store.emplace_back(false);
+    expected.insert(expected.end(), {true, true, false});
+    check_values(store, expected);
+
+    // Replace a range with the values of another store.
+    store_type other(expected.begin(), expected.begin() + 130);
+    store.replace(65, other.begin() + 1, other.end());
+    std::copy(other.begin() + 1, other.end(), expected.begin() + 65);
+    check_values(store, expected);
+
+    values = {true, false, true, true};
+    store.replace(2, values.begin(), values.end());
+    std::copy(values.begin(), values.end(), expected.begin() + 2);
+    check_values(store, expected);
+
+    // Erase ranges at unaligned positions.
+    store.erase(store.begin() + 17, store.begin() + 150);
+    expected.erase(expected.begin() + 17, expected.begin() + 150);
+    check_values(store, expected);
+    store.erase(store.begin());
+    expected.erase(expected.begin());
+    check_values(store, expected);
+
+    store.resize(300, true);
+    expected.resize(300, true);
+    check_values(store, expected);
+    store.resize(65);
+    expected.resize(65);
+    check_values(store, expected);
+    store.pop_back();
+    expected.pop_back();
+    check_values(store, expected);
+
+    try
+    {
+        [[maybe_unused]] bool v = std::as_const(store).at(64);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    store_type copied = store;
+    TEST_ASSERT(copied == store);
+    copied[0] = !copied[0];
+    TEST_ASSERT(copied != store);
+
+    store.clear();
+    TEST_ASSERT(store.empty());
+    TEST_ASSERT(store.count() == 0u);
+    TEST_ASSERT(store.begin() == store.end());
+
+    // Use it as the store of an element block.
+    constexpr mdds::mtv::element_t element_type_bool = mdds::mtv::element_type_user_start + 25;
+    using this_block = mdds::mtv::default_element_block<element_type_bool, bool, mdds::mtv::bit_vector>;
+
+    static_assert(std::is_same_v<this_block::store_type, mdds::mtv::bit_vector<bool>>);
+    static_assert(mdds::mtv::detail::has_std_vector_bool_store<this_block>::type::value);
+
+    auto* blk1 = this_block::create_block(100);
+    this_block::set_value(*blk1, 99, true);
+    TEST_ASSERT(mdds::mtv::detail::get_block_element_at<this_block>(*blk1, 99));
+    TEST_ASSERT(!mdds::mtv::detail::get_block_element_at<this_block>(*blk1, 98));
+
+    auto* blk2 = this_block::create_block(0);
+    this_block::assign_values(*blk2, expected.begin(), expected.end());
+
+    // Merge the blocks.
+    this_block::append_block(*blk1, *blk2);
+    TEST_ASSERT(this_block::size(*blk1) == 164u);
+    TEST_ASSERT(this_block::get(*blk1).store().count() == 1u + this_block::get(*blk2).store().count());
+    TEST_ASSERT(std::equal(this_block::cbegin(*blk1) + 100, this_block::cend(*blk1), expected.begin(), expected.end()));
+
+    this_block::set_values(*blk1, 0, this_block::cbegin(*blk2), this_block::cend(*blk2));
+    TEST_ASSERT(
+        std::equal(this_block::cbegin(*blk1), this_block::cbegin(*blk1) + 64, expected.begin(), expected.end()));
+
+    this_block::erase_values(*blk1, 0, 100);
+    TEST_ASSERT(this_block::get(*blk1) == this_block::get(*blk2));
+
+    auto usage = this_block::memory_usage(*blk1);
+    TEST_ASSERT(usage.value_bytes == sizeof(std::uint64_t));
+
+    this_block::delete_block(blk2);
+    this_block::delete_block(blk1);
+}
+
+void mtv_test_element_blocks_summary_vector()
+{
+    stack_printer __stack_printer__(__func__);
+
+    using store_type = mdds::mtv::summary_vector<std::int32_t>;
+    static_assert(mdds::mtv::detail::has_summary_method<store_type>);
+    static_assert(!mdds::mtv::detail::has_summary_method<std::vector<std::int32_t>>);
+
+    auto check_summary = [](const store_type& store) {
+        auto summary = store.summary();
+        TEST_ASSERT(store.is_summary_valid());
+        TEST_ASSERT(summary.count == store.size());
+        if (store.empty())
+            return;
+
+        std::int64_t sum = 0;
+        for (std::int32_t v : store)
+            sum += v;
+
+        TEST_ASSERT(summary.sum == sum);
+        TEST_ASSERT(summary.min == *std::min_element(store.begin(), store.end()));
+        TEST_ASSERT(summary.max == *std::max_element(store.begin(), store.end()));
+    };
+
+    std::vector<std::int32_t> values = {3, -7, 12, 5, 0};
+    store_type store(values.begin(), values.end());
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+    TEST_ASSERT(store.summary().min == -7);
+    TEST_ASSERT(store.summary().max == 12);
+    TEST_ASSERT(store.summary().sum == 13);
+
+    // Const access keeps the summary.
+    TEST_ASSERT(std::as_const(store)[2] == 12);
+    TEST_ASSERT(*std::as_const(store).begin() == 3);
+    TEST_ASSERT(std::as_const(store).data()[4] == 0);
+    TEST_ASSERT(store.is_summary_valid());
+
+    // Each non-const access invalidates the summary.
+    store[0] = 100;
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+    TEST_ASSERT(store.summary().max == 100);
+
+    *(store.begin() + 1) = -50;
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+
+    store.data()[2] = 1;
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+
+    store.at(3) = 2;
+    check_summary(store);
+
+    store.push_back(-100);
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+
+    store.insert(store.begin(), values.begin(), values.end());
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+
+    store.erase(store.begin() + 4, store.end() - 1);
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+
+    store.pop_back();
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+    TEST_ASSERT(std::equal(store.begin(), store.end(), values.begin(), values.begin() + 4));
+
+    store.resize(6);
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+
+    // Copies and moves carry the summary with them.
+    store_type copied = store;
+    TEST_ASSERT(copied.is_summary_valid());
+    TEST_ASSERT(copied == store);
+
+    store_type moved = std::move(copied);
+    TEST_ASSERT(moved.is_summary_valid());
+    check_summary(moved);
+
+    store_type other(3, 9);
+    other.swap(moved);
+    TEST_ASSERT(!other.is_summary_valid());
+    check_summary(other);
+    check_summary(moved);
+    TEST_ASSERT(moved.summary().sum == 27);
+
+    moved.swap(other);
+    TEST_ASSERT(moved.is_summary_valid());
+    TEST_ASSERT(other.is_summary_valid());
+    TEST_ASSERT(other.summary().sum == 27);
+    TEST_ASSERT(moved == store);
+
+    store.clear();
+    TEST_ASSERT(!store.is_summary_valid());
+    check_summary(store);
+
+    try
+    {
+        [[maybe_unused]] auto v = std::as_const(store).at(0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    {
+        // Floating-point values.
+        std::vector<double> dvalues = {1.5, -2.25, 8.0, 0.5, 3.0, -9.5, 4.0};
+        mdds::mtv::summary_vector<double> dstore(dvalues.begin(), dvalues.end());
+        auto summary = dstore.summary();
+        TEST_ASSERT(summary.count == 7u);
+        TEST_ASSERT(summary.sum == 5.25);
+        TEST_ASSERT(summary.min == -9.5);
+        TEST_ASSERT(summary.max == 8.0);
+    }
+
+    // Use it as the store of an element block.
+    constexpr mdds::mtv::element_t element_type_int32 = mdds::mtv::element_type_user_start + 26;
+    using this_block = mdds::mtv::default_element_block<element_type_int32, std::int32_t, mdds::mtv::summary_vector>;
+
+    auto* blk1 = this_block::create_block(0);
+    this_block::assign_values(*blk1, values.begin(), values.end());
+    TEST_ASSERT(this_block::get(*blk1).store().summary().max == 12);
+
+    this_block::set_value(*blk1, 1, 20);
+    TEST_ASSERT(!this_block::get(*blk1).store().is_summary_valid());
+    TEST_ASSERT(this_block::get(*blk1).store().summary().max == 20);
+
+    auto* blk2 = this_block::create_block(0);
+    this_block::assign_values(*blk2, values.begin(), values.end());
+    this_block::get(*blk2).store().summary();
+
+    this_block::append_block(*blk1, *blk2);
+    TEST_ASSERT(!this_block::get(*blk1).store().is_summary_valid());
+    TEST_ASSERT(this_block::get(*blk1).store().summary().count == 10u);
+    TEST_ASSERT(this_block::get(*blk1).store().summary().min == -7);
+
+    this_block::erase_values(*blk1, 0, 5);
+    TEST_ASSERT(this_block::get(*blk1).store().summary().sum == 13);
+    TEST_ASSERT(this_block::get(*blk1) == this_block::get(*blk2));
+
+    this_block::delete_block(blk2);
+    this_block::delete_block(blk1);
+}
+
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -165,6 +165,19 @@ void mtv_test_block_counter()
         TEST_ASSERT(db.event_handler().block_count_numeric == 1);
         TEST_ASSERT(db.event_handler().block_count_string == 1);
 
+        std::vector<std::string> strs = {"bar", "baz"};
+        db.append_range(strs.begin(), strs.end()); // no new block creation.
+        TEST_ASSERT(db.event_handler().block_count == 2);
+        TEST_ASSERT(db.event_handler().block_count_string == 1);
+        std::vector<double> values = {1.0, 2.0};
+        db.append_range(values.begin(), values.end()); // another new block.
+        TEST_ASSERT(db.event_handler().block_count == 3);
+        TEST_ASSERT(db.event_handler().block_count_numeric == 2);
+        TEST_ASSERT(db.event_handler().block_count_string == 1);
+        db.resize(4); // remove the last numeric block.
+        TEST_ASSERT(db.event_handler().block_count == 2);
+        TEST_ASSERT(db.event_handler().block_count_numeric == 1);
+
         // This should remove the last string block.
         db.resize(2);
         TEST_ASSERT(db.event_handler().block_count == 1);
@@ -9,6 +9,9 @@
 #include <mdds/multi_type_vector/standard_element_blocks.hpp>
 #include <mdds/multi_type_vector/types.hpp>
 
+#include <atomic>
+#include <cstddef>
+#include <exception>
 #include <execution> // inclusion of this header requires linking to libtbb on linux if present
 #include <string>
 
@@ -17,6 +20,18 @@ struct seq_policy_traits : mdds::mtv::standard_element_blocks_traits
     using exec_policy = std::execution::sequenced_policy;
 };
 
+struct par_policy_traits : mdds::mtv::standard_element_blocks_traits
+{
+    using exec_policy = std::execution::parallel_policy;
+};
+
+/**
+ * Numbers of custom values created by cloning and destroyed, for checking
+ * that the values cloned before a failed clone all get freed.
+ */
+inline std::atomic<std::size_t> custom_values_cloned{0};
+inline std::atomic<std::size_t> custom_values_destroyed{0};
+
 constexpr mdds::mtv::element_t block1_id = mdds::mtv::element_type_user_start;
 constexpr mdds::mtv::element_t block2_id = mdds::mtv::element_type_user_start + 1;
 
@@ -24,6 +39,11 @@ struct custom_str
 {
     std::string value;
 
+    ~custom_str()
+    {
+        ++custom_values_destroyed;
+    }
+
     bool operator==(const custom_str& other) const
     {
         return value == other.value;
@@ -39,6 +59,11 @@ struct custom_int
 {
     int64_t value;
 
+    ~custom_int()
+    {
+        ++custom_values_destroyed;
+    }
+
     bool operator==(const custom_int& other) const
     {
         return value == other.value;
@@ -62,6 +87,17 @@ struct noncopyable_traits : mdds::mtv::default_traits
     using exec_policy = std::execution::sequenced_policy;
 };
 
+struct noncopyable_par_traits : noncopyable_traits
+{
+    using exec_policy = std::execution::parallel_policy;
+};
+
+/**
+ * Exception thrown when cloning a custom_str instance whose value is "throw".
+ */
+class clone_error : public std::exception
+{};
+
 namespace mdds { namespace mtv {
 
 template<>
@@ -69,6 +105,10 @@ struct clone_value<custom_str*>
 {
     custom_str* operator()(const custom_str* src) const
     {
+        if (src->value == "throw")
+            throw clone_error();
+
+        ++custom_values_cloned;
         return new custom_str{src->value};
     }
 };
@@ -80,6 +120,7 @@ struct clone_value<custom_int*>
 
     custom_int* operator()(const custom_int* src) const
     {
+        ++custom_values_cloned;
         return new custom_int{src->value};
     }
 };
@@ -0,0 +1,244 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#include "test_main.hpp"
+
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct deferred_par_policy_traits : par_policy_traits
+{
+    static constexpr mdds::mtv::position_shift_t position_shift = mdds::mtv::position_shift_t::deferred;
+};
+
+using block_entry = std::tuple<mdds::mtv::element_t, std::size_t, std::size_t, const mdds::mtv::base_element_block*>;
+
+/**
+ * Build a container whose blocks alternate between double values, empty
+ * elements and int32 values, with their sizes varying from block to block.
+ */
+template<typename MtvT>
+MtvT build_store(std::size_t block_count)
+{
+    MtvT store;
+
+    for (std::size_t i = 0; i < block_count; ++i)
+    {
+        std::size_t n = i % 7 + 1;
+        switch (i % 3)
+        {
+            case 0:
+            {
+                std::vector<double> values(n);
+                std::iota(values.begin(), values.end(), double(i));
+                store.append_range(values.begin(), values.end());
+                break;
+            }
+            case 1:
+                store.resize(store.size() + n);
+                break;
+            case 2:
+            {
+                std::vector<int32_t> values(n, int32_t(i));
+                store.append_range(values.begin(), values.end());
+                break;
+            }
+        }
+    }
+
+    return store;
+}
+
+template<typename MtvT>
+std::vector<block_entry> collect_sequential(const MtvT& store)
+{
+    std::vector<block_entry> entries;
+    for (const auto& blk : store)
+        entries.emplace_back(blk.type, blk.position, blk.size, blk.data);
+
+    return entries;
+}
+
+template<typename MtvT, typename ExecPolicy>
+std::vector<block_entry> collect_parallel(const MtvT& store, ExecPolicy&& policy)
+{
+    std::mutex mtx;
+    std::map<std::size_t, block_entry> entries;
+
+    store.parallel_for_each_block(
+        std::forward<ExecPolicy>(policy), [&](mdds::mtv::element_t type, std::size_t position, std::size_t size,
+                                              const mdds::mtv::base_element_block* data) {
+            std::lock_guard lock(mtx);
+            entries.emplace(position, block_entry(type, position, size, data));
+        });
+
+    std::vector<block_entry> ret;
+    for (const auto& entry : entries)
+        ret.push_back(entry.second);
+
+    return ret;
+}
+
+/**
+ * Map a block to the sum of its double values, or to zero for a block of
+ * any other type.
+ */
+double sum_doubles(
+    mdds::mtv::element_t type, std::size_t /*position*/, std::size_t /*size*/,
+    const mdds::mtv::base_element_block* data)
+{
+    if (type != mdds::mtv::element_type_double)
+        return 0.0;
+
+    const auto& blk = mdds::mtv::double_element_block::get(*data);
+    return std::accumulate(blk.store().begin(), blk.store().end(), 0.0);
+}
+
+} // anonymous namespace
+
+void test_parallel_for_each_block()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mdds::mtv::soa::multi_type_vector<par_policy_traits>;
+
+    for (std::size_t block_count : {0u, 1u, 2u, 5u, 1000u})
+    {
+        auto store = build_store<mtv_type>(block_count);
+        TEST_ASSERT(store.block_size() == block_count);
+
+        auto expected = collect_sequential(store);
+        TEST_ASSERT(collect_parallel(store, std::execution::par) == expected);
+        TEST_ASSERT(collect_parallel(store, std::execution::seq) == expected);
+        TEST_ASSERT(collect_parallel(store, mdds::mtv::default_exec_policy{}) == expected);
+
+        // Default policy visits the blocks in order.
+        std::vector<block_entry> visited;
+        store.parallel_for_each_block(
+            mdds::mtv::default_exec_policy{},
+            [&visited](mdds::mtv::element_t type, std::size_t position, std::size_t size,
+                       const mdds::mtv::base_element_block* data) {
+                visited.emplace_back(type, position, size, data);
+            });
+        TEST_ASSERT(visited == expected);
+    }
+}
+
+void test_parallel_for_each_block_deferred_shifts()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mdds::mtv::soa::multi_type_vector<deferred_par_policy_traits>;
+
+    auto store = build_store<mtv_type>(300);
+
+    // Leave some position shifts pending before the traversal.
+    store.insert_empty(3, 5);
+    store.erase(20, 29);
+    store.insert_empty(100, 2);
+
+    auto expected = collect_sequential(store);
+    TEST_ASSERT(collect_parallel(store, std::execution::par) == expected);
+
+    auto view = store.snapshot();
+    TEST_ASSERT(collect_parallel(view, std::execution::par) == collect_sequential(view));
+}
+
+void test_parallel_reduce_blocks()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mdds::mtv::soa::multi_type_vector<par_policy_traits>;
+
+    auto store = build_store<mtv_type>(2000);
+
+    double expected = 0.0;
+    for (const auto& blk : store)
+        expected += sum_doubles(blk.type, blk.position, blk.size, blk.data);
+
+    auto sum = [](double a, double b) { return a + b; };
+
+    // The values are integral, so that the sums are exact regardless of the
+    // order of the additions.
+    TEST_ASSERT(store.parallel_reduce_blocks(std::execution::par, 0.0, sum_doubles, sum) == expected);
+    TEST_ASSERT(store.parallel_reduce_blocks(mdds::mtv::default_exec_policy{}, 0.0, sum_doubles, sum) == expected);
+    TEST_ASSERT(store.parallel_reduce_blocks(std::execution::par, 1.5, sum_doubles, sum) == expected + 1.5);
+
+    auto view = store.snapshot();
+    TEST_ASSERT(view.parallel_reduce_blocks(std::execution::par, 0.0, sum_doubles, sum) == expected);
+
+    // The chunks get combined in block order, so a non-commutative reduction
+    // yields the same result as a sequential one.
+    auto map_size = [](mdds::mtv::element_t, std::size_t, std::size_t size, const mdds::mtv::base_element_block*) {
+        return std::vector<std::size_t>{size};
+    };
+
+    auto concat = [](std::vector<std::size_t> a, std::vector<std::size_t> b) {
+        a.insert(a.end(), b.begin(), b.end());
+        return a;
+    };
+
+    std::vector<std::size_t> sizes;
+    for (const auto& blk : store)
+        sizes.push_back(blk.size);
+
+    TEST_ASSERT(
+        store.parallel_reduce_blocks(std::execution::par, std::vector<std::size_t>{}, map_size, concat) == sizes);
+
+    mtv_type empty_store;
+    TEST_ASSERT(empty_store.parallel_reduce_blocks(std::execution::par, 4.0, sum_doubles, sum) == 4.0);
+}
+
+void test_parallel_for_each_block_exception()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    using mtv_type = mdds::mtv::soa::multi_type_vector<par_policy_traits>;
+
+    auto store = build_store<mtv_type>(1000);
+    std::size_t throw_pos = store.size() / 2;
+
+    try
+    {
+        store.parallel_for_each_block(
+            std::execution::par, [throw_pos](mdds::mtv::element_t, std::size_t position, std::size_t size,
+                                             const mdds::mtv::base_element_block*) {
+                if (position <= throw_pos && throw_pos < position + size)
+                    throw std::runtime_error("block traversal failed");
+            });
+
+        TEST_ASSERT(!"exception was expected");
+    }
+    catch (const std::runtime_error& e)
+    {
+        TEST_ASSERT(std::string_view{e.what()} == "block traversal failed");
+    }
+
+    try
+    {
+        auto map = [](mdds::mtv::element_t type, std::size_t, std::size_t, const mdds::mtv::base_element_block*) {
+            if (type == mdds::mtv::element_type_empty)
+                throw std::runtime_error("empty block");
+            return 1;
+        };
+
+        store.parallel_reduce_blocks(std::execution::par, 0, map, std::plus<int>{});
+        TEST_ASSERT(!"exception was expected");
+    }
+    catch (const std::runtime_error& e)
+    {
+        TEST_ASSERT(std::string_view{e.what()} == "empty block");
+    }
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
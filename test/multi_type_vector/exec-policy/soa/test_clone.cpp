@@ -8,6 +8,7 @@
 
 using mtv_type = mdds::mtv::soa::multi_type_vector<seq_policy_traits>;
 using mtv_type_noncopyable = mdds::mtv::soa::multi_type_vector<noncopyable_traits>;
+using mtv_type_noncopyable_par = mdds::mtv::soa::multi_type_vector<noncopyable_par_traits>;
 
 void test_clone()
 {
@@ -42,4 +43,84 @@ void test_clone_noncopyable()
     TEST_ASSERT(src == cloned);
 }
 
+void test_clone_noncopyable_exception()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    mtv_type_noncopyable src;
+    src.push_back(new custom_str{"value1"});
+    src.push_back(new custom_int{12});
+    src.push_back(new custom_str{"value2"});
+    src.push_back(new custom_int{34});
+    src.push_back(new custom_str{"throw"}); // cloning of this block will throw
+    src.push_back(new custom_int{56});
+
+    try
+    {
+        auto cloned = src.clone();
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const clone_error&)
+    {
+        // expected; the partially cloned blocks must have been freed.
+    }
+
+    // The source must be intact.
+    TEST_ASSERT(src.block_size() == 6);
+    TEST_ASSERT(src.get<custom_str*>(0)->value == "value1");
+    TEST_ASSERT(src.get<custom_str*>(4)->value == "throw");
+}
+
+void test_clone_noncopyable_exception_par()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    // Enough blocks for the parallel policy to split them into multiple
+    // chunks, with the block that throws somewhere in the middle.
+    constexpr std::size_t block_count = 4000;
+    constexpr std::size_t throw_block = 2500;
+
+    mtv_type_noncopyable_par src;
+    for (std::size_t i = 0; i < block_count; ++i)
+    {
+        if (i % 2)
+        {
+            src.push_back(new custom_int{int64_t(i)});
+            src.push_back(new custom_int{int64_t(i) + 1});
+        }
+        else
+            src.push_back(new custom_str{i == throw_block ? "throw" : std::to_string(i)});
+    }
+
+    TEST_ASSERT(src.block_size() == block_count);
+
+    std::size_t cloned_before = custom_values_cloned;
+    std::size_t destroyed_before = custom_values_destroyed;
+
+    try
+    {
+        auto cloned = src.clone();
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const clone_error&)
+    {
+        // expected
+    }
+
+    // Every value cloned before the failure must have been freed along with
+    // its block, and no source value must have been touched.
+    std::size_t cloned = custom_values_cloned - cloned_before;
+    std::size_t destroyed = custom_values_destroyed - destroyed_before;
+    TEST_ASSERT(cloned == destroyed);
+
+    TEST_ASSERT(src.block_size() == block_count);
+    TEST_ASSERT(src.get<custom_str*>(0)->value == "0");
+    TEST_ASSERT(src.get<custom_str*>(throw_block / 2 * 3)->value == "throw");
+
+    // Cloning succeeds once the offending value is replaced.
+    src.set(throw_block / 2 * 3, new custom_str{"value"});
+    auto cloned_db = src.clone();
+    TEST_ASSERT(cloned_db == src);
+}
+
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -51,6 +51,16 @@ int main()
     test_shrink_to_fit();
     test_clone();
     test_clone_noncopyable();
+    test_clone_noncopyable_exception();
+    test_clone_noncopyable_exception_par();
+    test_parallel_for_each_block();
+    test_parallel_for_each_block_deferred_shifts();
+    test_parallel_reduce_blocks();
+    test_parallel_for_each_block_exception();
+    test_transfer_multiple();
+    test_swap_multiple();
+    test_transfer_multiple_invalid();
+    test_apply_permutation_multiple();
 
     return EXIT_SUCCESS;
 }
@@ -14,5 +14,15 @@ void test_copy_construction_and_equal();
 void test_shrink_to_fit();
 void test_clone();
 void test_clone_noncopyable();
+void test_clone_noncopyable_exception();
+void test_clone_noncopyable_exception_par();
+void test_parallel_for_each_block();
+void test_parallel_for_each_block_deferred_shifts();
+void test_parallel_reduce_blocks();
+void test_parallel_for_each_block_exception();
+void test_transfer_multiple();
+void test_swap_multiple();
+void test_transfer_multiple_invalid();
+void test_apply_permutation_multiple();
 
 /* vim:set shiftwidth=4 softtabstop=4 expandtab: */
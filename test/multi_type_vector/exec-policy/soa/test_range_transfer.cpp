@@ -0,0 +1,331 @@
+/* -*- Mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+
+// SPDX-FileCopyrightText: 2026 Kohei Yoshida
+//
+// SPDX-License-Identifier: MIT
+
+#include "test_main.hpp"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using mtv_type = mdds::mtv::soa::multi_type_vector<par_policy_traits>;
+
+/**
+ * Build a set of columns whose blocks differ from column to column, so that
+ * the same row range falls on different block boundaries in each of them.
+ */
+std::vector<mtv_type> build_columns(std::size_t column_count, std::size_t row_count)
+{
+    std::vector<mtv_type> columns;
+
+    for (std::size_t col = 0; col < column_count; ++col)
+    {
+        mtv_type column(row_count);
+        std::size_t step = col % 5 + 2;
+
+        for (std::size_t row = col % 3; row < row_count; row += step)
+        {
+            switch ((row / step + col) % 4)
+            {
+                case 0:
+                    column.set(row, double(row + col));
+                    break;
+                case 1:
+                    column.set(row, int32_t(row * col));
+                    break;
+                case 2:
+                    column.set(row, std::to_string(row) + ":" + std::to_string(col));
+                    break;
+                default:
+                    // leave it empty.
+                    ;
+            }
+        }
+
+        columns.push_back(std::move(column));
+    }
+
+    return columns;
+}
+
+std::vector<mtv_type*> to_pointers(std::vector<mtv_type>& columns)
+{
+    std::vector<mtv_type*> ptrs;
+    for (auto& column : columns)
+        ptrs.push_back(&column);
+
+    return ptrs;
+}
+
+} // anonymous namespace
+
+void test_transfer_multiple()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    for (std::size_t column_count : {0u, 1u, 3u, 64u})
+    {
+        auto sources = build_columns(column_count, 200);
+        auto dests = build_columns(column_count, 150);
+        std::reverse(dests.begin(), dests.end());
+
+        // Expected results via the single-container variant.
+        auto expected_sources = sources;
+        auto expected_dests = dests;
+        for (std::size_t i = 0; i < column_count; ++i)
+            expected_sources[i].transfer(40, 139, expected_dests[i], 20);
+
+        auto sources_seq = sources;
+        auto dests_seq = dests;
+
+        mtv_type::transfer(std::execution::par, to_pointers(sources), 40, 139, to_pointers(dests), 20);
+        TEST_ASSERT(sources == expected_sources);
+        TEST_ASSERT(dests == expected_dests);
+
+        mtv_type::transfer(
+            mdds::mtv::default_exec_policy{}, to_pointers(sources_seq), 40, 139, to_pointers(dests_seq), 20);
+        TEST_ASSERT(sources_seq == expected_sources);
+        TEST_ASSERT(dests_seq == expected_dests);
+
+        for (const auto& column : sources)
+        {
+            for (std::size_t row = 40; row <= 139; ++row)
+                TEST_ASSERT(column.is_empty(row));
+        }
+    }
+}
+
+void test_swap_multiple()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    auto columns1 = build_columns(50, 300);
+    auto columns2 = build_columns(50, 100);
+    std::rotate(columns2.begin(), columns2.begin() + 7, columns2.end());
+
+    auto expected1 = columns1;
+    auto expected2 = columns2;
+    for (std::size_t i = 0; i < columns1.size(); ++i)
+        expected1[i].swap(150, 219, expected2[i], 10);
+
+    mtv_type::swap(std::execution::par, to_pointers(columns1), 150, 219, to_pointers(columns2), 10);
+    TEST_ASSERT(columns1 == expected1);
+    TEST_ASSERT(columns2 == expected2);
+
+    // Swapping the same ranges back restores the original contents.
+    mtv_type::swap(mdds::mtv::default_exec_policy{}, to_pointers(columns1), 150, 219, to_pointers(columns2), 10);
+    TEST_ASSERT(columns1 == build_columns(50, 300));
+
+    auto original2 = build_columns(50, 100);
+    std::rotate(original2.begin(), original2.begin() + 7, original2.end());
+    TEST_ASSERT(columns2 == original2);
+}
+
+void test_transfer_multiple_invalid()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    auto sources = build_columns(10, 100);
+    auto dests = build_columns(10, 100);
+    const auto original_sources = sources;
+    const auto original_dests = dests;
+
+    auto src_ptrs = to_pointers(sources);
+    auto dest_ptrs = to_pointers(dests);
+
+    auto check_untouched = [&]() {
+        TEST_ASSERT(sources == original_sources);
+        TEST_ASSERT(dests == original_dests);
+    };
+
+    // One destination too small for the range.  No container gets modified,
+    // not even those listed before it.
+    dests[7].resize(50);
+    const auto resized_dests = dests;
+
+    try
+    {
+        mtv_type::transfer(std::execution::par, src_ptrs, 10, 49, dest_ptrs, 20);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    TEST_ASSERT(sources == original_sources);
+    TEST_ASSERT(dests == resized_dests);
+    dests = original_dests;
+
+    // End position out of bound in a source.
+    try
+    {
+        mtv_type::swap(std::execution::par, src_ptrs, 90, 100, dest_ptrs, 0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    check_untouched();
+
+    // Reversed range.
+    try
+    {
+        mtv_type::transfer(std::execution::par, src_ptrs, 20, 10, dest_ptrs, 0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const std::out_of_range&)
+    {
+        // expected
+    }
+
+    check_untouched();
+
+    // Mismatched numbers of containers.
+    try
+    {
+        mtv_type::transfer(
+            std::execution::par, src_ptrs, 0, 9, std::span<mtv_type* const>(dest_ptrs).first(9), 0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    check_untouched();
+
+    // The same container appearing twice, either in a single pair or across
+    // pairs.
+    auto dup_ptrs = dest_ptrs;
+    dup_ptrs[5] = src_ptrs[5];
+
+    try
+    {
+        mtv_type::transfer(std::execution::par, src_ptrs, 0, 9, dup_ptrs, 0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    dup_ptrs = dest_ptrs;
+    dup_ptrs[5] = dest_ptrs[2];
+
+    try
+    {
+        mtv_type::swap(std::execution::par, src_ptrs, 0, 9, dup_ptrs, 0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    // Null container.
+    dup_ptrs = dest_ptrs;
+    dup_ptrs[9] = nullptr;
+
+    try
+    {
+        mtv_type::swap(std::execution::par, src_ptrs, 0, 9, dup_ptrs, 0);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    check_untouched();
+}
+
+void test_apply_permutation_multiple()
+{
+    MDDS_TEST_FUNC_SCOPE;
+
+    auto columns = build_columns(40, 500);
+
+    // Reverse the rows in chunks of 7, so that some runs of rows keep their
+    // relative order.
+    std::vector<mtv_type::size_type> perm;
+    for (std::size_t start = 0; start < 500; start += 7)
+    {
+        std::size_t end = std::min<std::size_t>(start + 7, 500);
+        for (std::size_t row = end; row > start; --row)
+            perm.push_back(row - 1);
+    }
+
+    std::reverse(perm.begin(), perm.end());
+
+    auto expected = columns;
+    for (auto& column : expected)
+        column.apply_permutation(perm);
+
+    auto columns_seq = columns;
+
+    mtv_type::apply_permutation(std::execution::par, to_pointers(columns), perm);
+    TEST_ASSERT(columns == expected);
+
+    mtv_type::apply_permutation(mdds::mtv::default_exec_policy{}, to_pointers(columns_seq), perm);
+    TEST_ASSERT(columns_seq == expected);
+
+    // Invalid arguments leave all containers unchanged.
+    auto ptrs = to_pointers(columns);
+
+    auto bad_perm = perm;
+    bad_perm[10] = bad_perm[11];
+
+    try
+    {
+        mtv_type::apply_permutation(std::execution::par, ptrs, bad_perm);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    TEST_ASSERT(columns == expected);
+
+    columns[30].resize(499);
+    const auto resized = columns;
+
+    try
+    {
+        mtv_type::apply_permutation(std::execution::par, ptrs, perm);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    TEST_ASSERT(columns == resized);
+    columns[30] = expected[30];
+
+    auto dup_ptrs = ptrs;
+    dup_ptrs[3] = ptrs[4];
+
+    try
+    {
+        mtv_type::apply_permutation(std::execution::par, dup_ptrs, perm);
+        TEST_ASSERT(!"exception should have been thrown");
+    }
+    catch (const mdds::invalid_arg_error&)
+    {
+        // expected
+    }
+
+    TEST_ASSERT(columns == expected);
+}
+
+/* vim:set shiftwidth=4 softtabstop=4 expandtab: */
@@ -5,11 +5,17 @@
 #include "test_global.hpp" // This must be the first header to be included.
 
 #include <mdds/multi_type_vector.hpp>
+#include <mdds/multi_type_vector/soa/block_util.hpp>
 
 #include <cassert>
+#include <execution> // inclusion of this header requires linking to libtbb on linux if present
+#include <span>
 #include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 #include <deque>
+#include <iomanip>
 
 using namespace std;
 using namespace mdds;
@@ -93,6 +99,284 @@ void mtv_perf_test_insert_via_position_object()
     }
 }
 
+struct position_blocks_type
+{
+    std::vector<std::size_t> positions;
+    std::vector<std::size_t> sizes;
+    std::vector<void*> element_blocks;
+};
+
+template<mdds::mtv::lu_factor_t Factor>
+void mtv_perf_test_adjust_block_positions(const char* name, position_blocks_type& blocks, int repeats)
+{
+    using mdds::mtv::soa::detail::adjust_block_positions;
+
+    stack_watch sw;
+    for (int i = 0; i < repeats; ++i)
+        adjust_block_positions<position_blocks_type, Factor>{}(blocks, 0, (i & 1) ? -1 : 1);
+
+    double duration = sw.get_duration();
+
+    // Each pass reads and writes every position value once.
+    double bytes = double(blocks.positions.size()) * sizeof(std::size_t) * 2.0 * repeats;
+
+    cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(6)
+         << std::setw(10) << duration << " sec  " << std::setprecision(2) << std::setw(8) << (bytes / duration / 1.0e9)
+         << " GB/s" << endl;
+}
+
+void mtv_perf_test_block_position_adjustment()
+{
+    using mdds::mtv::lu_factor_t;
+    using mdds::mtv::soa::detail::adjust_positions_kernel_t;
+    using mdds::mtv::soa::detail::get_selected_adjust_positions_kernel;
+
+    // Measure the throughput of each block position adjustment variant.  The
+    // first block count fits in the L1 cache while the last one doesn't fit
+    // in the L2 cache.
+
+    for (std::size_t block_count : {1000u, 100000u, 1000000u})
+    {
+        position_blocks_type blocks;
+        blocks.positions.reserve(block_count);
+
+        for (std::size_t i = 0; i < block_count; ++i)
+            blocks.positions.push_back(i * 2);
+
+        blocks.sizes.assign(block_count, 2);
+
+        int repeats = int(100000000 / block_count);
+
+        cout << "block position adjustment (block count: " << block_count << "; repeats: " << repeats << ")" << endl;
+
+        mtv_perf_test_adjust_block_positions<lu_factor_t::none>("none", blocks, repeats);
+        mtv_perf_test_adjust_block_positions<lu_factor_t::lu16>("lu16", blocks, repeats);
+#if SIZEOF_VOID_P == 8 && defined(__SSE2__)
+        mtv_perf_test_adjust_block_positions<lu_factor_t::sse2_x64>("sse2_x64", blocks, repeats);
+        mtv_perf_test_adjust_block_positions<lu_factor_t::sse2_x64_lu8>("sse2_x64_lu8", blocks, repeats);
+#endif
+#if SIZEOF_VOID_P == 8 && defined(__AVX2__)
+        mtv_perf_test_adjust_block_positions<lu_factor_t::avx2_x64>("avx2_x64", blocks, repeats);
+        mtv_perf_test_adjust_block_positions<lu_factor_t::avx2_x64_lu4>("avx2_x64_lu4", blocks, repeats);
+#endif
+#if SIZEOF_VOID_P == 8 && defined(__AVX512F__)
+        mtv_perf_test_adjust_block_positions<lu_factor_t::avx512_x64>("avx512_x64", blocks, repeats);
+        mtv_perf_test_adjust_block_positions<lu_factor_t::avx512_x64_lu4>("avx512_x64_lu4", blocks, repeats);
+#endif
+        mtv_perf_test_adjust_block_positions<lu_factor_t::runtime_dispatch>("runtime_dispatch", blocks, repeats);
+
+        // The values must be back to where they started after an even number
+        // of passes.
+        assert(repeats % 2 || blocks.positions.back() == (block_count - 1) * 2);
+    }
+
+    const char* kernel_names[] = {"scalar", "sse2", "avx2", "avx512"};
+    cout << "runtime dispatch selected the " << kernel_names[int(get_selected_adjust_positions_kernel())]
+         << " kernel." << endl;
+}
+
+template<typename MtvT>
+MtvT build_many_blocks(std::size_t block_count, std::size_t block_size)
+{
+    MtvT db;
+    std::vector<double> values(block_size);
+    std::vector<std::string> strs(block_size);
+
+    for (std::size_t i = 0; i < block_count; ++i)
+    {
+        if (i % 2)
+        {
+            for (std::size_t j = 0; j < block_size; ++j)
+                strs[j] = std::to_string(i * block_size + j);
+            db.append_range(strs.begin(), strs.end());
+        }
+        else
+        {
+            for (std::size_t j = 0; j < block_size; ++j)
+                values[j] = i * block_size + j;
+            db.append_range(values.begin(), values.end());
+        }
+    }
+
+    return db;
+}
+
+template<typename ExecPolicy>
+struct exec_policy_traits : mdds::mtv::standard_element_blocks_traits
+{
+    using exec_policy = ExecPolicy;
+};
+
+template<typename MtvT>
+double mtv_perf_test_clone(const char* name, std::size_t block_count, std::size_t block_size)
+{
+    const MtvT src = build_many_blocks<MtvT>(block_count, block_size);
+    assert(src.block_size() == block_count);
+
+    constexpr int repeats = 3;
+    double best = 0.0;
+
+    for (int i = 0; i < repeats; ++i)
+    {
+        stack_watch sw;
+        MtvT cloned = src.clone();
+        double duration = sw.get_duration();
+        if (!i || duration < best)
+            best = duration;
+
+        assert(cloned == src);
+    }
+
+    cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(6)
+         << std::setw(10) << best << " sec" << endl;
+
+    return best;
+}
+
+void mtv_perf_test_clone_exec_policy()
+{
+    namespace soa = mdds::mtv::soa;
+
+    // Clone a container with a large number of blocks, with the block-level
+    // loop run under different execution policies.
+    constexpr std::size_t block_count = 20000;
+    constexpr std::size_t block_size = 16;
+
+    cout << "clone (block count: " << block_count << "; block size: " << block_size << ")" << endl;
+
+    double t_default = mtv_perf_test_clone<soa::multi_type_vector<mdds::mtv::standard_element_blocks_traits>>(
+        "default", block_count, block_size);
+    double t_seq = mtv_perf_test_clone<soa::multi_type_vector<exec_policy_traits<std::execution::sequenced_policy>>>(
+        "sequenced", block_count, block_size);
+    double t_par = mtv_perf_test_clone<soa::multi_type_vector<exec_policy_traits<std::execution::parallel_policy>>>(
+        "parallel", block_count, block_size);
+
+    cout << "speed-up of parallel over sequenced: " << std::setprecision(2) << (t_seq / t_par) << "x" << endl;
+    cout << "speed-up of parallel over default: " << std::setprecision(2) << (t_default / t_par) << "x" << endl;
+}
+
+struct cow_traits : mdds::mtv::standard_element_blocks_traits
+{
+    static constexpr bool enable_cow = true;
+};
+
+template<typename MtvT>
+double mtv_perf_test_snapshot_set(
+    const char* name, std::size_t block_count, std::size_t block_size, std::size_t snapshot_count)
+{
+    MtvT db = build_many_blocks<MtvT>(block_count, block_size);
+    std::vector<MtvT> snapshots;
+    snapshots.reserve(snapshot_count);
+
+    stack_watch sw;
+
+    for (std::size_t i = 0; i < snapshot_count; ++i)
+    {
+        snapshots.push_back(db);
+
+        // Overwrite one value in one of the numeric blocks.
+        std::size_t pos = (i * 2 % block_count) * block_size + i % block_size;
+        db.set(pos, -double(i));
+    }
+
+    double duration = sw.get_duration();
+
+    cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(6)
+         << std::setw(10) << duration << " sec" << endl;
+
+    return duration;
+}
+
+void mtv_perf_test_snapshot_detach()
+{
+    namespace soa = mdds::mtv::soa;
+
+    // Take a snapshot of a container before each set() call, and keep all
+    // the snapshots alive.  Without copy-on-write, each snapshot copies all
+    // blocks, which is what the first set() after each snapshot used to do
+    // when the whole store got detached at once.  With copy-on-write, each
+    // set() only detaches the block it modifies.
+    constexpr std::size_t block_count = 1000;
+    constexpr std::size_t block_size = 100;
+    constexpr std::size_t snapshot_count = 100;
+
+    cout << "snapshot then set (block count: " << block_count << "; block size: " << block_size
+         << "; snapshots: " << snapshot_count << ")" << endl;
+
+    double t_full = mtv_perf_test_snapshot_set<soa::multi_type_vector<mdds::mtv::standard_element_blocks_traits>>(
+        "whole store", block_count, block_size, snapshot_count);
+    double t_cow = mtv_perf_test_snapshot_set<soa::multi_type_vector<cow_traits>>(
+        "per block", block_count, block_size, snapshot_count);
+
+    cout << "speed-up of per-block detach over whole-store copy: " << std::setprecision(2) << (t_full / t_cow) << "x"
+         << endl;
+}
+
+template<typename T>
+void mtv_perf_test_set_batch(
+    const char* name, std::size_t block_size, const std::vector<std::pair<std::size_t, T>>& values)
+{
+    constexpr int repeats = 5;
+    double best_loop = 0.0, best_batch = 0.0;
+
+    for (int i = 0; i < repeats; ++i)
+    {
+        mtv_type db1(block_size, 1.0);
+        mtv_type db2(block_size, 1.0);
+
+        {
+            stack_watch sw;
+            mtv_type::iterator pos_hint = db1.begin();
+            for (const auto& [pos, v] : values)
+                pos_hint = db1.set(pos_hint, pos, v);
+
+            double duration = sw.get_duration();
+            if (!i || duration < best_loop)
+                best_loop = duration;
+        }
+
+        {
+            stack_watch sw;
+            db2.set_batch(std::span{values});
+
+            double duration = sw.get_duration();
+            if (!i || duration < best_batch)
+                best_batch = duration;
+        }
+
+        assert(db1 == db2);
+    }
+
+    cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(6)
+         << "set loop: " << std::setw(10) << best_loop << " sec  set_batch: " << std::setw(10) << best_batch
+         << " sec" << endl;
+}
+
+void mtv_perf_test_set_batch_large_block()
+{
+    // Set values scattered across a single large block of doubles, both of
+    // the same type as the block, which get overwritten in place, and of a
+    // different type, which split the block.
+    constexpr std::size_t block_size = 1000000;
+    constexpr std::size_t value_count = 100;
+    constexpr std::size_t step = block_size / value_count;
+
+    std::vector<std::pair<std::size_t, double>> doubles;
+    std::vector<std::pair<std::size_t, std::string>> strs;
+
+    for (std::size_t i = 0; i < value_count; ++i)
+    {
+        doubles.emplace_back(i * step + 7, double(i));
+        strs.emplace_back(i * step + 7, std::to_string(i));
+    }
+
+    cout << "set_batch on a large block (block size: " << block_size << "; value count: " << value_count << ")"
+         << endl;
+
+    mtv_perf_test_set_batch("same type", block_size, doubles);
+    mtv_perf_test_set_batch("different type", block_size, strs);
+}
+
 } // namespace
 
 int main()
@@ -100,6 +384,10 @@ try
 {
     mtv_perf_test_block_position_lookup();
     mtv_perf_test_insert_via_position_object();
+    mtv_perf_test_block_position_adjustment();
+    mtv_perf_test_clone_exec_policy();
+    mtv_perf_test_set_batch_large_block();
+    mtv_perf_test_snapshot_detach();
 
     return EXIT_SUCCESS;
 }
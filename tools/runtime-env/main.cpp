@@ -29,9 +29,12 @@ std::string to_string(lu_factor_t lu)
     int lu_value = int(lu) & 0xFF;
     bool sse2 = (int(lu) & 0x100) != 0;
     bool avx2 = (int(lu) & 0x200) != 0;
+    bool avx512 = (int(lu) & 0x400) != 0;
+    bool dispatch = (int(lu) & 0x800) != 0;
 
     std::ostringstream os;
-    os << (sse2 ? "sse2+" : "") << (avx2 ? "avx2+" : "") << std::setw(2) << std::setfill('0') << lu_value;
+    os << (sse2 ? "sse2+" : "") << (avx2 ? "avx2+" : "") << (avx512 ? "avx512+" : "") << (dispatch ? "dispatch+" : "")
+       << std::setw(2) << std::setfill('0') << lu_value;
 
     return os.str();
 }
@@ -439,6 +442,12 @@ public:
         measure_duration<lu_factor_t::avx2_x64_lu4>(blocks, block_size, repeats);
         measure_duration<lu_factor_t::avx2_x64_lu8>(blocks, block_size, repeats);
 #endif
+#if SIZEOF_VOID_P == 8 && defined(__AVX512F__)
+        measure_duration<lu_factor_t::avx512_x64>(blocks, block_size, repeats);
+        measure_duration<lu_factor_t::avx512_x64_lu4>(blocks, block_size, repeats);
+        measure_duration<lu_factor_t::avx512_x64_lu8>(blocks, block_size, repeats);
+#endif
+        measure_duration<lu_factor_t::runtime_dispatch>(blocks, block_size, repeats);
     }
 };
 